@@ -134,6 +134,15 @@ public:
     void setPrefetchZoomDelta(uint8_t delta);
     uint8_t getPrefetchZoomDelta() const;
 
+    // Tile cache
+    //
+    // Tiles that are no longer needed are kept in a per-source cache sized in tiles after the
+    // viewport. When `budget` is greater than 0, each cache also evicts its least recently added
+    // tiles until the buckets and textures of the remaining ones fit into `budget` bytes. The
+    // default is 0, no byte limit.
+    void setTileCacheBudget(std::size_t budget);
+    std::size_t getTileCacheBudget() const;
+
     // Debug
     void setDebug(MapDebugOptions);
     MapDebugOptions getDebug() const;
@@ -67,6 +67,9 @@ public:
     unsigned cacheDatabaseMaximumSize() const;
     void setCacheDatabaseMaximumSize(unsigned);
 
+    unsigned tileCacheMaximumSize() const;
+    void setTileCacheMaximumSize(unsigned);
+
     QString cacheDatabasePath() const;
     void setCacheDatabasePath(const QString &);
 
@@ -104,6 +107,7 @@ private:
     ViewportMode m_viewportMode;
 
     unsigned m_cacheMaximumSize;
+    unsigned m_tileCacheMaximumSize;
     QString m_cacheDatabasePath;
     QString m_assetPath;
     QString m_apiKey;
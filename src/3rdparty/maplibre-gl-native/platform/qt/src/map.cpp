@@ -1394,6 +1394,7 @@ MapPrivate::MapPrivate(Map *q, const Settings &settings, const QSize &size, qrea
                                          mapOptionsFromSettings(settings, size, m_pixelRatio),
                                          resourceOptions,
                                          clientOptionsFromSettings(settings));
+    mapObj->setTileCacheBudget(settings.tileCacheMaximumSize());
 
      if (settings.resourceTransform()) {
          m_resourceTransform = std::make_unique<mbgl::Actor<mbgl::ResourceTransform::TransformCallback>>(
@@ -130,6 +130,7 @@ Settings::Settings()
     , m_constrainMode(Settings::ConstrainHeightOnly)
     , m_viewportMode(Settings::DefaultViewport)
     , m_cacheMaximumSize(mbgl::util::DEFAULT_MAX_CACHE_SIZE)
+    , m_tileCacheMaximumSize(0)
     , m_cacheDatabasePath(":memory:")
     , m_assetPath(QCoreApplication::applicationDirPath())
     , m_apiKey(qgetenv("MGL_API_KEY"))
@@ -240,6 +241,29 @@ void Settings::setCacheDatabaseMaximumSize(unsigned size)
     m_cacheMaximumSize = size;
 }
 
+/*!
+    Returns the maximum size in bytes of the in-memory cache that keeps
+    recently used tiles of each source around after they leave the view.
+    The buckets and textures of the cached tiles of a source are kept
+    below this size, on top of the limit in number of tiles derived from
+    the viewport size.
+
+    By default, it is set to 0, meaning only the number of tiles is limited.
+*/
+unsigned Settings::tileCacheMaximumSize() const
+{
+    return m_tileCacheMaximumSize;
+}
+
+/*!
+    Sets the maximum \a size in bytes of the in-memory tile cache of each
+    source.
+*/
+void Settings::setTileCacheMaximumSize(unsigned size)
+{
+    m_tileCacheMaximumSize = size;
+}
+
 /*!
     Returns the cache database path. The cache is used for storing
     recently used resources like tiles and also an offline tile database
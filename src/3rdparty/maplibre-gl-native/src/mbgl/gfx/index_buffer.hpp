@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <cassert>
 
@@ -21,6 +22,10 @@ public:
 
     std::size_t elements;
 
+    std::size_t bytes() const {
+        return elements * sizeof(uint16_t);
+    }
+
     template <typename T = IndexBufferResource>
     T& getResource() const {
         assert(resource);
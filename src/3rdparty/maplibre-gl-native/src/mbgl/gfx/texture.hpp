@@ -40,6 +40,11 @@ public:
 
     Size size;
 
+    // Textures are uploaded as RGBA or alpha; count the larger one.
+    std::size_t bytes() const {
+        return std::size_t(size.area()) * 4;
+    }
+
 protected:
     std::unique_ptr<TextureResource> resource;
 };
@@ -13,9 +13,10 @@ public:
     virtual ~VertexBufferResource() = default;
 };
 
-// This class has a template argument that we use to specify the vertex type. It is not used by
-// the implementation, but serves type checking purposes during build time.
-template <class>
+// This class has a template argument that we use to specify the vertex type. It is only used by
+// the implementation to report the size of the buffer, and serves type checking purposes during
+// build time.
+template <class V>
 class VertexBuffer {
 public:
     VertexBuffer(const std::size_t elements_, std::unique_ptr<VertexBufferResource>&& resource_)
@@ -24,6 +25,10 @@ public:
 
     std::size_t elements;
 
+    std::size_t bytes() const {
+        return elements * sizeof(V);
+    }
+
     template <typename T = VertexBufferResource>
     T& getResource() const {
         assert(resource);
@@ -497,6 +497,14 @@ uint8_t Map::getPrefetchZoomDelta() const {
     return impl->prefetchZoomDelta;
 }
 
+void Map::setTileCacheBudget(std::size_t budget) {
+    impl->tileCacheBudget = budget;
+}
+
+std::size_t Map::getTileCacheBudget() const {
+    return impl->tileCacheBudget;
+}
+
 bool Map::isFullyLoaded() const {
     return impl->style->impl->isLoaded() && impl->rendererFullyLoaded;
 }
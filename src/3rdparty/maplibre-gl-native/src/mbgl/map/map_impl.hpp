@@ -70,6 +70,7 @@ public:
     bool cameraMutated = false;
 
     uint8_t prefetchZoomDelta = util::DEFAULT_PREFETCH_ZOOM_DELTA;
+    std::size_t tileCacheBudget = 0;
 
     bool loading = false;
     bool rendererFullyLoaded;
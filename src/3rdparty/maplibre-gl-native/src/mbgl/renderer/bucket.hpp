@@ -4,6 +4,7 @@
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/util/optional.hpp>
 #include <atomic>
 
 namespace mbgl {
@@ -51,6 +52,12 @@ public:
         return 0;
     };
 
+    // Bytes held by the vertex and index data, whether still on the CPU or
+    // already uploaded, plus any textures owned by the bucket.
+    virtual std::size_t getMemoryUsage() const {
+        return 0;
+    }
+
     bool needsUpload() const {
         return hasData() && !uploaded;
     }
@@ -70,6 +77,12 @@ public:
 
 protected:
     Bucket() = default;
+
+    // Bytes of the data not yet uploaded plus the bytes of the uploaded buffer.
+    template <class Data, class Uploaded>
+    static std::size_t memoryUsage(const Data& data, const optional<Uploaded>& uploaded) {
+        return data.bytes() + (uploaded ? uploaded->bytes() : 0);
+    }
     std::atomic<bool> uploaded { false };
 };
 
@@ -67,4 +67,9 @@ void CircleBucket::update(const FeatureStates& states, const GeometryTileLayer&
     }
 }
 
+std::size_t CircleBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) +
+           memoryUsage(triangles, indexBuffer);
+}
+
 } // namespace mbgl
@@ -166,4 +166,10 @@ void FillBucket::update(const FeatureStates& states, const GeometryTileLayer& la
     }
 }
 
+std::size_t FillBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) +
+           memoryUsage(lines, lineIndexBuffer) +
+           memoryUsage(triangles, triangleIndexBuffer);
+}
+
 } // namespace mbgl
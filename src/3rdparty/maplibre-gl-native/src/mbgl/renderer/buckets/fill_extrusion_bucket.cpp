@@ -209,4 +209,9 @@ void FillExtrusionBucket::update(const FeatureStates& states, const GeometryTile
     }
 }
 
+std::size_t FillExtrusionBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) +
+           memoryUsage(triangles, indexBuffer);
+}
+
 } // namespace mbgl
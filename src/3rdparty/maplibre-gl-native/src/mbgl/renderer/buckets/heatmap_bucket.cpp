@@ -100,4 +100,9 @@ float HeatmapBucket::getQueryRadius(const RenderLayer& layer) const {
     return 0;
 }
 
+std::size_t HeatmapBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) +
+           memoryUsage(triangles, indexBuffer);
+}
+
 } // namespace mbgl
@@ -29,6 +29,7 @@ public:
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
+    std::size_t getMemoryUsage() const override;
 
     gfx::VertexVector<HeatmapLayoutVertex> vertices;
     gfx::IndexVector<gfx::Triangles> triangles;
@@ -117,4 +117,10 @@ bool HillshadeBucket::hasData() const {
 }
 
 
+std::size_t HillshadeBucket::getMemoryUsage() const {
+    const PremultipliedImage* image = demdata.getImage();
+    return (image ? image->bytes() : 0) + (dem ? dem->bytes() : 0) + (texture ? texture->bytes() : 0) +
+           memoryUsage(vertices, vertexBuffer) + memoryUsage(indices, indexBuffer);
+}
+
 } // namespace mbgl
@@ -24,6 +24,7 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void clear();
     void setMask(TileMask&&);
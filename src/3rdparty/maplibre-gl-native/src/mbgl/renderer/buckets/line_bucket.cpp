@@ -568,4 +568,9 @@ void LineBucket::update(const FeatureStates& states, const GeometryTileLayer& la
     }
 }
 
+std::size_t LineBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) +
+           memoryUsage(triangles, indexBuffer);
+}
+
 } // namespace mbgl
@@ -109,4 +109,9 @@ bool RasterBucket::hasData() const {
 }
 
 
+std::size_t RasterBucket::getMemoryUsage() const {
+    return (image ? image->bytes() : 0) + (texture ? texture->bytes() : 0) + memoryUsage(vertices, vertexBuffer) +
+           memoryUsage(indices, indexBuffer);
+}
+
 } // namespace mbgl
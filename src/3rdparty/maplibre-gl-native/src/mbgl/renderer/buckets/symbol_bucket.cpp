@@ -337,4 +337,16 @@ void SymbolBucket::updateVertices(const Placement& placement,
     }
 }
 
+std::size_t SymbolBucket::getMemoryUsage() const {
+    // Collision boxes and circles only exist while debugging and are left out.
+    std::size_t bytes = 0;
+    for (const Buffer* buffer : {&text, &icon, &sdfIcon}) {
+        bytes += memoryUsage(buffer->vertices, buffer->vertexBuffer) +
+                 memoryUsage(buffer->dynamicVertices, buffer->dynamicVertexBuffer) +
+                 memoryUsage(buffer->opacityVertices, buffer->opacityVertexBuffer) +
+                 memoryUsage(buffer->triangles, buffer->indexBuffer);
+    }
+    return bytes;
+}
+
 } // namespace mbgl
@@ -172,7 +172,8 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
                                         updateParameters->annotationManager,
                                         *imageManager,
                                         *glyphManager,
-                                        updateParameters->prefetchZoomDelta};
+                                        updateParameters->prefetchZoomDelta,
+                                        updateParameters->tileCacheBudget};
 
     glyphManager->setURL(updateParameters->glyphURL);
 
@@ -25,6 +25,7 @@ public:
     ImageManager& imageManager;
     GlyphManager& glyphManager;
     const uint8_t prefetchZoomDelta;
+    const std::size_t tileCacheBudget = 0;
 };
 
 } // namespace mbgl
@@ -219,6 +219,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
             (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) * 0.5
         );
         cache.setSize(conservativeCacheSize);
+        cache.setMaximumBytes(parameters.tileCacheBudget);
     }
 
     // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
@@ -44,6 +44,8 @@ public:
     const bool stillImageRequest;
 
     const bool crossSourceCollisions;
+
+    const std::size_t tileCacheBudget = 0;
 };
 
 } // namespace mbgl
@@ -22,6 +22,7 @@
 #include <mbgl/util/logging.hpp>
 
 #include <mbgl/gfx/upload_pass.hpp>
+#include <unordered_set>
 #include <utility>
 
 namespace mbgl {
@@ -319,6 +320,29 @@ float GeometryTile::getQueryPadding(const std::unordered_map<std::string, const
     return queryPadding;
 }
 
+std::size_t GeometryTile::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    if (layoutResult) {
+        // Layers with the same layout properties share a bucket.
+        std::unordered_set<const Bucket*> buckets;
+        for (const auto& pair : layoutResult->layerRenderData) {
+            const Bucket* bucket = pair.second.bucket.get();
+            if (bucket && buckets.insert(bucket).second) {
+                bytes += bucket->getMemoryUsage();
+            }
+        }
+        if (layoutResult->glyphAtlasImage) {
+            bytes += layoutResult->glyphAtlasImage->bytes();
+        }
+        bytes += layoutResult->iconAtlas.image.bytes();
+    }
+    if (atlasTextures) {
+        bytes += atlasTextures->glyph ? atlasTextures->glyph->bytes() : 0;
+        bytes += atlasTextures->icon ? atlasTextures->icon->bytes() : 0;
+    }
+    return bytes;
+}
+
 void GeometryTile::queryRenderedFeatures(std::unordered_map<std::string, std::vector<Feature>>& result,
                                          const GeometryCoordinates& queryGeometry, const TransformState& transformState,
                                          const std::unordered_map<std::string, const RenderLayer*>& layers,
@@ -63,6 +63,8 @@ public:
 
     float getQueryPadding(const std::unordered_map<std::string, const RenderLayer*>&) override;
 
+    std::size_t getMemoryUsage() const override;
+
     void cancel() override;
 
     class LayoutResult {
@@ -118,6 +118,10 @@ void RasterDEMTile::setMask(TileMask&& mask) {
     }
 }
 
+std::size_t RasterDEMTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 void RasterDEMTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
@@ -84,6 +84,7 @@ public:
     DEMTileNeighbors neighboringTiles = DEMTileNeighbors::Empty;
     
     void setMask(TileMask&&) override;
+    std::size_t getMemoryUsage() const override;
 
     void onParsed(std::unique_ptr<HillshadeBucket> result, uint64_t correlationID);
     void onError(std::exception_ptr, uint64_t correlationID);
@@ -33,6 +33,7 @@ public:
     bool layerPropertiesUpdated(const Immutable<style::LayerProperties>& layerProperties) override;
 
     void setMask(TileMask&&) override;
+    std::size_t getMemoryUsage() const override;
 
     void onParsed(std::unique_ptr<RasterBucket> result, uint64_t correlationID);
     void onError(std::exception_ptr, uint64_t correlationID);
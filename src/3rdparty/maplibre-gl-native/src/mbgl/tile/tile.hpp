@@ -141,6 +141,12 @@ public:
 
     virtual void setFeatureState(const LayerFeatureStates&) {}
 
+    // Approximate number of bytes held by the buckets and textures of this
+    // tile, both on the CPU and uploaded. Used to budget the tile cache.
+    virtual std::size_t getMemoryUsage() const {
+        return 0;
+    }
+
     void dumpDebugLogs() const;
 
     const Kind kind;
@@ -6,13 +6,19 @@ namespace mbgl {
 void TileCache::setSize(size_t size_) {
     size = size_;
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.remove(key);
-        tiles.erase(key);
+    while (overBudget()) {
+        erase(entries.begin());
     }
 
-    assert(orderedKeys.size() <= size);
+    assert(entries.size() <= size);
+}
+
+void TileCache::setMaximumBytes(size_t maximumBytes_) {
+    maximumBytes = maximumBytes_;
+
+    while (overBudget()) {
+        erase(entries.begin());
+    }
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -20,27 +26,35 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (!tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    const size_t tileBytes = tile->getMemoryUsage();
+    if (maximumBytes && tileBytes > maximumBytes) {
+        // would evict everything else and still not fit
+        return;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // keep the existing tile, as the map did before, but mark it as newest
+        entries.splice(entries.end(), entries, it->second);
+    } else {
+        entries.push_back({key, std::move(tile), tileBytes});
+        index.emplace(key, std::prev(entries.end()));
+        bytes += tileBytes;
+    }
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        pop(orderedKeys.front());
+    // purge oldest keys/tiles if necessary
+    while (overBudget()) {
+        erase(entries.begin());
     }
 
-    assert(orderedKeys.size() <= size);
+    assert(entries.size() <= size);
+    assert(entries.size() == index.size());
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
-    auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        return it->second.get();
+    auto it = index.find(key);
+    if (it != index.end()) {
+        return it->second->tile.get();
     } else {
         return nullptr;
     }
@@ -50,11 +64,13 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 
     std::unique_ptr<Tile> tile;
 
-    auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        auto entry = it->second;
+        tile = std::move(entry->tile);
+        bytes -= entry->bytes;
+        entries.erase(entry);
+        index.erase(it);
         assert(tile->isRenderable());
     }
 
@@ -62,12 +78,23 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 }
 
 bool TileCache::has(const OverscaledTileID& key) {
-    return tiles.find(key) != tiles.end();
+    return index.find(key) != index.end();
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
-    tiles.clear();
+    index.clear();
+    entries.clear();
+    bytes = 0;
+}
+
+bool TileCache::overBudget() const {
+    return !entries.empty() && (entries.size() > size || (maximumBytes && bytes > maximumBytes));
+}
+
+void TileCache::erase(Entries::iterator entry) {
+    bytes -= entry->bytes;
+    index.erase(entry->key);
+    entries.erase(entry);
 }
 
 } // namespace mbgl
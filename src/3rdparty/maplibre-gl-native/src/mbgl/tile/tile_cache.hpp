@@ -6,16 +6,23 @@
 
 #include <list>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
+// Least recently added tiles are evicted first, once the cache holds more than
+// `size` tiles or, with a byte budget set, more than `maximumBytes` bytes as
+// reported by Tile::getMemoryUsage() when the tile was added.
 class TileCache {
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    TileCache(size_t size_ = 0, size_t maximumBytes_ = 0) : size(size_), maximumBytes(maximumBytes_) {}
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+    // A budget of 0 disables the byte limit.
+    void setMaximumBytes(size_t);
+    size_t getMaximumBytes() const { return maximumBytes; }
+    size_t getBytes() const { return bytes; }
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> tile);
     std::unique_ptr<Tile> pop(const OverscaledTileID& key);
     Tile* get(const OverscaledTileID& key);
@@ -23,10 +30,24 @@ public:
     void clear();
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    struct Entry {
+        OverscaledTileID key;
+        std::unique_ptr<Tile> tile;
+        size_t bytes;
+    };
+    using Entries = std::list<Entry>;
+
+    bool overBudget() const;
+    void erase(Entries::iterator);
+
+    // Oldest entry first; the index points into it so that lookups, moves and
+    // removals never walk the list.
+    Entries entries;
+    std::unordered_map<OverscaledTileID, Entries::iterator> index;
 
     size_t size;
+    size_t maximumBytes;
+    size_t bytes = 0;
 };
 
 } // namespace mbgl
@@ -56,6 +56,17 @@ public:
     }
 };
 
+class SizedTileMock : public VectorTileMock {
+public:
+    SizedTileMock(const OverscaledTileID& id_, const VectorTileTest& test, std::size_t bytes_)
+        : VectorTileMock(id_, "source", test.tileParameters, test.tileset), bytes(bytes_) {}
+
+    std::size_t getMemoryUsage() const override { return bytes; }
+
+private:
+    std::size_t bytes;
+};
+
 TEST(TileCache, Smoke) {
     VectorTileTest test;
     TileCache cache(1);
@@ -85,3 +96,67 @@ TEST(TileCache, Issue15926) {
     EXPECT_FALSE(cache.has(id0));
     EXPECT_TRUE(cache.has(id1));
 }
+
+TEST(TileCache, LeastRecentlyAddedFirst) {
+    VectorTileTest test;
+    TileCache cache(2);
+    OverscaledTileID id0(1, 0, 0);
+    OverscaledTileID id1(1, 1, 0);
+    OverscaledTileID id2(1, 0, 1);
+
+    cache.add(id0, std::make_unique<VectorTileMock>(id0, "source", test.tileParameters, test.tileset));
+    cache.add(id1, std::make_unique<VectorTileMock>(id1, "source", test.tileParameters, test.tileset));
+    // Adding an existing key keeps its tile and makes it the newest
+    cache.add(id0, std::make_unique<VectorTileMock>(id0, "source", test.tileParameters, test.tileset));
+    cache.add(id2, std::make_unique<VectorTileMock>(id2, "source", test.tileParameters, test.tileset));
+
+    EXPECT_TRUE(cache.has(id0));
+    EXPECT_FALSE(cache.has(id1));
+    EXPECT_TRUE(cache.has(id2));
+
+    EXPECT_NE(nullptr, cache.pop(id0));
+    EXPECT_FALSE(cache.has(id0));
+    EXPECT_EQ(nullptr, cache.pop(id0));
+}
+
+TEST(TileCache, ByteBudget) {
+    VectorTileTest test;
+    TileCache cache(10, 100);
+    OverscaledTileID id0(1, 0, 0);
+    OverscaledTileID id1(1, 1, 0);
+    OverscaledTileID id2(1, 0, 1);
+    OverscaledTileID id3(1, 1, 1);
+
+    cache.add(id0, std::make_unique<SizedTileMock>(id0, test, 40));
+    cache.add(id1, std::make_unique<SizedTileMock>(id1, test, 40));
+    EXPECT_EQ(80u, cache.getBytes());
+
+    cache.add(id2, std::make_unique<SizedTileMock>(id2, test, 40));
+    EXPECT_FALSE(cache.has(id0));
+    EXPECT_TRUE(cache.has(id1));
+    EXPECT_TRUE(cache.has(id2));
+    EXPECT_EQ(80u, cache.getBytes());
+
+    EXPECT_NE(nullptr, cache.pop(id1));
+    EXPECT_EQ(40u, cache.getBytes());
+
+    // A tile larger than the whole budget is not kept, and doesn't evict the others
+    cache.add(id3, std::make_unique<SizedTileMock>(id3, test, 200));
+    EXPECT_FALSE(cache.has(id3));
+    EXPECT_TRUE(cache.has(id2));
+    EXPECT_EQ(40u, cache.getBytes());
+
+    cache.add(id1, std::make_unique<SizedTileMock>(id1, test, 40));
+    cache.setMaximumBytes(50);
+    EXPECT_FALSE(cache.has(id2));
+    EXPECT_TRUE(cache.has(id1));
+    EXPECT_EQ(40u, cache.getBytes());
+
+    cache.setMaximumBytes(0);
+    cache.add(id0, std::make_unique<SizedTileMock>(id0, test, 400));
+    EXPECT_TRUE(cache.has(id0));
+    EXPECT_EQ(440u, cache.getBytes());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getBytes());
+}
@@ -1,3 +1,7 @@
+if(QT_FEATURE_system_zlib)
+    qt_find_package(WrapZLIB PROVIDED_TARGETS WrapZLIB::WrapZLIB)
+endif()
+
 qt_feature("geoservices_osm" PRIVATE
     LABEL "Provides access to OpenStreetMap geoservices"
     CONDITION TRUE
@@ -0,0 +1,401 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdeclarativegeojsonmodel_p.h"
+
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlFile>
+#include <QtQml/QQmlInfo>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype GeoJsonModel
+    \instantiates QDeclarativeGeoJsonModel
+    \inqmlmodule QtLocation
+    \ingroup qml-QtLocation5-maps
+    \since QtLocation 6.4
+
+    \brief The GeoJsonModel type provides the features of a GeoJSON document
+    as a list model.
+
+    The GeoJsonModel reads the GeoJSON document found at \l source in a worker
+    thread, and appends the features to the model in batches of \l batchSize
+    while the document is being read. The first features can therefore be
+    shown by a MapItemView long before a large document has been read in full.
+
+    Multi geometries and geometry collections are flattened: every part of a
+    feature becomes its own row, sharing the \c featureIndex, \c featureId and
+    \c properties of the feature it came from.
+
+    The model provides the following roles:
+
+    \table
+        \header
+            \li Role
+            \li Type
+            \li Description
+        \row
+            \li type
+            \li string
+            \li The type of the geometry: \c Point, \c LineString or \c Polygon.
+        \row
+            \li geoShape
+            \li \l geoShape
+            \li A \l geocircle for points, a \l geopath for line strings and
+                a \l geopolygon for polygons.
+        \row
+            \li properties
+            \li object
+            \li The \c properties member of the feature.
+        \row
+            \li featureId
+            \li variant
+            \li The \c id member of the feature, if any.
+        \row
+            \li featureIndex
+            \li int
+            \li The index of the feature in the document.
+    \endtable
+
+    \section2 Example Usage
+
+    \code
+    Map {
+        MapItemView {
+            model: GeoJsonModel {
+                source: "countries.geojson"
+            }
+            delegate: MapPolygon {
+                geoShape: model.geoShape
+                color: model.properties.color
+            }
+        }
+    }
+    \endcode
+*/
+
+QDeclarativeGeoJsonModel::QDeclarativeGeoJsonModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    connect(&importer_, &QGeoJsonImporter::featuresImported,
+            this, &QDeclarativeGeoJsonModel::featuresImported);
+    connect(&importer_, &QGeoJsonImporter::progressChanged,
+            this, &QDeclarativeGeoJsonModel::importProgress);
+    connect(&importer_, &QGeoJsonImporter::finished,
+            this, &QDeclarativeGeoJsonModel::importFinished);
+    connect(&importer_, &QGeoJsonImporter::errorOccurred,
+            this, &QDeclarativeGeoJsonModel::importError);
+}
+
+QDeclarativeGeoJsonModel::~QDeclarativeGeoJsonModel()
+{
+    importer_.cancel();
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoJsonModel::componentComplete()
+{
+    complete_ = true;
+    reload();
+}
+
+/*!
+    \internal
+*/
+int QDeclarativeGeoJsonModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return features_.size();
+}
+
+/*!
+    \internal
+*/
+QVariant QDeclarativeGeoJsonModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= features_.size())
+        return QVariant();
+
+    const QGeoJsonFeature &feature = features_.at(index.row());
+    switch (role) {
+    case TypeRole:
+        return feature.type;
+    case GeoShapeRole:
+        switch (feature.geometry.type()) {
+        case QGeoShape::CircleType:
+            return QVariant::fromValue(QGeoCircle(feature.geometry));
+        case QGeoShape::PathType:
+            return QVariant::fromValue(QGeoPath(feature.geometry));
+        case QGeoShape::PolygonType:
+            return QVariant::fromValue(QGeoPolygon(feature.geometry));
+        default:
+            return QVariant::fromValue(feature.geometry);
+        }
+    case PropertiesRole:
+        // Parsed on demand, delegates that don't use them don't pay for them
+        return feature.properties();
+    case FeatureIdRole:
+        return feature.id;
+    case FeatureIndexRole:
+        return feature.featureIndex;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> QDeclarativeGeoJsonModel::roleNames() const
+{
+    QHash<int, QByteArray> roleNames = QAbstractListModel::roleNames();
+    roleNames.insert(TypeRole, "type");
+    roleNames.insert(GeoShapeRole, "geoShape");
+    roleNames.insert(PropertiesRole, "properties");
+    roleNames.insert(FeatureIdRole, "featureId");
+    roleNames.insert(FeatureIndexRole, "featureIndex");
+    return roleNames;
+}
+
+/*!
+    \qmlproperty url QtLocation::GeoJsonModel::source
+
+    This property holds the location of the GeoJSON document, a local file or
+    a resource. Changing it clears the model and reads the new document.
+*/
+QUrl QDeclarativeGeoJsonModel::source() const
+{
+    return source_;
+}
+
+void QDeclarativeGeoJsonModel::setSource(const QUrl &source)
+{
+    if (source_ == source)
+        return;
+
+    source_ = source;
+    emit sourceChanged();
+    if (complete_)
+        reload();
+}
+
+/*!
+    \qmlproperty int QtLocation::GeoJsonModel::batchSize
+
+    This property holds the number of features appended to the model at a
+    time while the document is being read. The default is 256.
+*/
+int QDeclarativeGeoJsonModel::batchSize() const
+{
+    return importer_.batchSize();
+}
+
+void QDeclarativeGeoJsonModel::setBatchSize(int batchSize)
+{
+    if (importer_.batchSize() == qMax(1, batchSize))
+        return;
+
+    importer_.setBatchSize(batchSize);
+    emit batchSizeChanged();
+}
+
+/*!
+    \qmlproperty enumeration QtLocation::GeoJsonModel::status
+
+    This read-only property holds the status of the model.
+
+    \list
+    \li GeoJsonModel.Null - No document has been read.
+    \li GeoJsonModel.Loading - The document is being read, features may
+        still be appended to the model.
+    \li GeoJsonModel.Ready - The document has been read in full.
+    \li GeoJsonModel.Error - The document could not be read, see
+        \l errorString. The features read before the error stay in the model.
+    \endlist
+*/
+QDeclarativeGeoJsonModel::Status QDeclarativeGeoJsonModel::status() const
+{
+    return status_;
+}
+
+/*!
+    \qmlproperty string QtLocation::GeoJsonModel::errorString
+
+    This read-only property holds the reason the document could not be read.
+*/
+QString QDeclarativeGeoJsonModel::errorString() const
+{
+    return errorString_;
+}
+
+/*!
+    \qmlproperty real QtLocation::GeoJsonModel::progress
+
+    This read-only property holds the part of the document read so far,
+    between 0 and 1.
+*/
+qreal QDeclarativeGeoJsonModel::progress() const
+{
+    return progress_;
+}
+
+/*!
+    \qmlproperty int QtLocation::GeoJsonModel::count
+
+    This read-only property holds the number of rows in the model.
+*/
+int QDeclarativeGeoJsonModel::count() const
+{
+    return features_.size();
+}
+
+/*!
+    \qmlmethod object QtLocation::GeoJsonModel::get(int index)
+
+    Returns the row at \a index, in the layout used by QGeoJson::importGeoJson:
+    a map with \c type, \c data and, if present, \c properties and \c id.
+*/
+QVariantMap QDeclarativeGeoJsonModel::get(int index) const
+{
+    if (index < 0 || index >= features_.size())
+        return QVariantMap();
+    return features_.at(index).toVariantMap();
+}
+
+/*!
+    \qmlmethod void QtLocation::GeoJsonModel::reload()
+
+    Clears the model and reads the document at \l source again.
+*/
+void QDeclarativeGeoJsonModel::reload()
+{
+    importer_.cancel();
+    clear();
+    setErrorString(QString());
+
+    if (source_.isEmpty()) {
+        setStatus(Null);
+        return;
+    }
+
+    const QQmlContext *context = qmlContext(this);
+    const QUrl url = context ? context->resolvedUrl(source_) : source_;
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(url);
+    if (fileName.isEmpty()) {
+        qmlWarning(this) << "Only local files and resources are supported:" << url;
+        setErrorString(tr("Unsupported source %1").arg(url.toString()));
+        setStatus(Error);
+        return;
+    }
+
+    setStatus(Loading);
+    importer_.importFile(fileName);
+}
+
+void QDeclarativeGeoJsonModel::featuresImported(const QList<QGeoJsonFeature> &features)
+{
+    if (features.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), features_.size(), features_.size() + features.size() - 1);
+    features_.append(features);
+    endInsertRows();
+    emit countChanged();
+}
+
+void QDeclarativeGeoJsonModel::importProgress(qint64 bytesRead, qint64 bytesTotal)
+{
+    const qreal progress = bytesTotal > 0 ? qreal(bytesRead) / bytesTotal : 1.0;
+    if (qFuzzyCompare(progress_, progress))
+        return;
+
+    progress_ = progress;
+    emit progressChanged();
+}
+
+void QDeclarativeGeoJsonModel::importFinished()
+{
+    setStatus(Ready);
+}
+
+void QDeclarativeGeoJsonModel::importError(const QString &errorString)
+{
+    setErrorString(errorString);
+    setStatus(Error);
+}
+
+void QDeclarativeGeoJsonModel::clear()
+{
+    if (progress_ != 0.0) {
+        progress_ = 0.0;
+        emit progressChanged();
+    }
+    if (features_.isEmpty())
+        return;
+
+    beginResetModel();
+    features_.clear();
+    endResetModel();
+    emit countChanged();
+}
+
+void QDeclarativeGeoJsonModel::setStatus(Status status)
+{
+    if (status_ == status)
+        return;
+
+    status_ = status;
+    emit statusChanged();
+}
+
+void QDeclarativeGeoJsonModel::setErrorString(const QString &errorString)
+{
+    if (errorString_ == errorString)
+        return;
+
+    errorString_ = errorString;
+    emit errorStringChanged();
+}
+
+QT_END_NAMESPACE
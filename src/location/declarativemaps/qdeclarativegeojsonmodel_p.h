@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDECLARATIVEGEOJSONMODEL_P_H
+#define QDECLARATIVEGEOJSONMODEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeojsonimporter_p.h>
+
+#include <QtQml/qqml.h>
+#include <QtQml/QQmlParserStatus>
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QUrl>
+
+QT_BEGIN_NAMESPACE
+
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoJsonModel : public QAbstractListModel, public QQmlParserStatus
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(GeoJsonModel)
+    QML_ADDED_IN_VERSION(6, 4)
+
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize NOTIFY batchSizeChanged)
+    Q_PROPERTY(Status status READ status NOTIFY statusChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY errorStringChanged)
+    Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_INTERFACES(QQmlParserStatus)
+
+public:
+    enum Status {
+        Null,
+        Ready,
+        Loading,
+        Error
+    };
+    Q_ENUM(Status)
+
+    enum Roles {
+        TypeRole = Qt::UserRole + 1,
+        GeoShapeRole,
+        PropertiesRole,
+        FeatureIdRole,
+        FeatureIndexRole
+    };
+
+    explicit QDeclarativeGeoJsonModel(QObject *parent = nullptr);
+    ~QDeclarativeGeoJsonModel();
+
+    // From QQmlParserStatus
+    void classBegin() override {}
+    void componentComplete() override;
+
+    // From QAbstractListModel
+    int rowCount(const QModelIndex &parent) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QUrl source() const;
+    void setSource(const QUrl &source);
+
+    int batchSize() const;
+    void setBatchSize(int batchSize);
+
+    Status status() const;
+    QString errorString() const;
+    qreal progress() const;
+    int count() const;
+
+    Q_INVOKABLE QVariantMap get(int index) const;
+
+public Q_SLOTS:
+    void reload();
+
+Q_SIGNALS:
+    void sourceChanged();
+    void batchSizeChanged();
+    void statusChanged();
+    void errorStringChanged();
+    void progressChanged();
+    void countChanged();
+
+private Q_SLOTS:
+    void featuresImported(const QList<QGeoJsonFeature> &features);
+    void importProgress(qint64 bytesRead, qint64 bytesTotal);
+    void importFinished();
+    void importError(const QString &errorString);
+
+private:
+    void clear();
+    void setStatus(Status status);
+    void setErrorString(const QString &errorString);
+
+    QGeoJsonImporter importer_;
+    QList<QGeoJsonFeature> features_;
+    QUrl source_;
+    QString errorString_;
+    Status status_ = Null;
+    qreal progress_ = 0.0;
+    bool complete_ = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDECLARATIVEGEOJSONMODEL_P_H
@@ -51,6 +51,8 @@
 #include <QtLocation/QPlaceProposedSearchResult>
 #include <QtLocation/private/qplacesearchrequest_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -609,9 +611,21 @@ void QDeclarativeSearchResultModel::clearData(bool suppressSignal)
 {
     QDeclarativeSearchModelBase::clearData(suppressSignal);
 
-    qDeleteAll(m_places);
+    // Places that are not waiting for a reply are kept for the next results
+    static const qsizetype maxRecycledPlaces = 64;
+    for (QDeclarativePlace *place : qAsConst(m_places)) {
+        if (!place)
+            continue;
+        if (place->status() == QDeclarativePlace::Ready && m_recycledPlaces.size() < maxRecycledPlaces) {
+            place->setFavorite(nullptr);
+            m_recycledPlaces.append(place);
+        } else {
+            delete place;
+        }
+    }
     m_places.clear();
-    m_icons.clear();
+    m_favorites.clear();
+    m_rows.clear();
     if (!m_results.isEmpty()) {
         m_results.clear();
 
@@ -622,7 +636,7 @@ void QDeclarativeSearchResultModel::clearData(bool suppressSignal)
 
 QVariant QDeclarativeSearchResultModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() > m_results.count())
+    if (index.row() < 0 || index.row() >= m_results.count())
         return QVariant();
 
     const QPlaceSearchResult &result = m_results.at(index.row());
@@ -634,7 +648,7 @@ QVariant QDeclarativeSearchResultModel::data(const QModelIndex &index, int role)
     case TitleRole:
         return result.title();
     case IconRole:
-        return QVariant::fromValue(m_icons.at(index.row()));
+        return QVariant::fromValue(result.icon());
     case DistanceRole:
         if (result.type() == QPlaceSearchResult::PlaceResult) {
             QPlaceResult placeResult = result;
@@ -643,7 +657,7 @@ QVariant QDeclarativeSearchResultModel::data(const QModelIndex &index, int role)
         break;
     case PlaceRole:
         if (result.type() == QPlaceSearchResult::PlaceResult)
-            return QVariant::fromValue(static_cast<QObject *>(m_places.at(index.row())));
+            return QVariant::fromValue(static_cast<QObject *>(place(index.row())));
         break;
     case SponsoredRole:
         if (result.type() == QPlaceSearchResult::PlaceResult) {
@@ -891,47 +905,85 @@ void QDeclarativeSearchResultModel::onContentUpdated()
 void QDeclarativeSearchResultModel::updateLayout(const QList<QPlace> &favoritePlaces)
 {
     const int oldRowCount = rowCount();
-    int start = 0;
 
     if (m_incremental) {
         if (!m_resultsBuffer.size())
             return;
 
+        // The rows already there are left as they are
         beginInsertRows(QModelIndex(), oldRowCount , oldRowCount + m_resultsBuffer.size() - 1);
-        m_results = resultsFromPages();
-        start = oldRowCount;
+        appendRows(m_resultsBuffer, favoritePlaces);
+        m_resultsBuffer.clear();
+        endInsertRows();
     } else {
         beginResetModel();
         clearData(true);
-        m_results = m_resultsBuffer;
+        appendRows(m_resultsBuffer, favoritePlaces);
+        m_resultsBuffer.clear();
+        endResetModel();
     }
 
-    m_resultsBuffer.clear();
-    for (qsizetype i = start; i < m_results.count(); ++i) {
-        const QPlaceSearchResult &result = m_results.at(i);
+    if (m_results.count() != oldRowCount)
+        emit rowCountChanged();
+}
 
-        if (result.type() == QPlaceSearchResult::PlaceResult) {
-            QPlaceResult placeResult = result;
-            QDeclarativePlace *place = new QDeclarativePlace(placeResult.place(), plugin(), this);
-            m_places.append(place);
-
-            if ((favoritePlaces.count() == m_results.count()) && favoritePlaces.at(i) != QPlace())
-                m_places[i]->setFavorite(new QDeclarativePlace(favoritePlaces.at(i),
-                                                               m_favoritesPlugin, m_places[i]));
-        } else if (result.type() == QPlaceSearchResult::ProposedSearchResult) {
-            m_places.append(0);
-        }
+/*!
+    \internal
+    Appends the rows of a page. The places are only created by place(),
+    favoritePlaces, if any, has one entry per result.
+*/
+void QDeclarativeSearchResultModel::appendRows(const QList<QPlaceSearchResult> &results,
+                                               const QList<QPlace> &favoritePlaces)
+{
+    const qsizetype start = m_results.size();
+    const bool matched = favoritePlaces.size() == results.size();
+    const QPlace noFavorite;
+
+    m_results.append(results);
+    m_places.resize(m_results.size());
+    for (qsizetype i = 0; i < results.size(); ++i) {
+        const QPlaceSearchResult &result = results.at(i);
+        if (result.type() != QPlaceSearchResult::PlaceResult)
+            continue;
 
-        if (!result.icon().isEmpty())
-            m_icons.append(result.icon());
+        const QString placeId = QPlaceResult(result).place().placeId();
+        if (placeId.isEmpty())
+            continue;
+        m_rows[placeId].append(start + i);
+        if (matched && favoritePlaces.at(i) != noFavorite)
+            m_favorites.insert(placeId, favoritePlaces.at(i));
     }
+}
 
-    if (m_incremental)
-        endInsertRows();
-    else
-        endResetModel();
-    if (m_results.count() != oldRowCount)
-        emit rowCountChanged();
+/*!
+    \internal
+    The place of a row, created the first time it is asked for.
+*/
+QDeclarativePlace *QDeclarativeSearchResultModel::place(qsizetype row) const
+{
+    if (QDeclarativePlace *place = m_places.at(row))
+        return place;
+
+    const QPlaceSearchResult &result = m_results.at(row);
+    if (result.type() != QPlaceSearchResult::PlaceResult || !plugin())
+        return nullptr;
+
+    const QPlace src = QPlaceResult(result).place();
+    QDeclarativePlace *place;
+    if (!m_recycledPlaces.isEmpty()) {
+        place = m_recycledPlaces.takeLast();
+        place->setPlugin(plugin());
+        place->setPlace(src);
+    } else {
+        place = new QDeclarativePlace(src, plugin(), const_cast<QDeclarativeSearchResultModel *>(this));
+    }
+
+    const auto favorite = m_favorites.constFind(src.placeId());
+    if (favorite != m_favorites.constEnd())
+        place->setFavorite(new QDeclarativePlace(*favorite, m_favoritesPlugin, place));
+
+    m_places[row] = place;
+    return place;
 }
 
 /*!
@@ -939,12 +991,11 @@ void QDeclarativeSearchResultModel::updateLayout(const QList<QPlace> &favoritePl
 */
 void QDeclarativeSearchResultModel::placeUpdated(const QString &placeId)
 {
-    int row = getRow(placeId);
-    if (row < 0 || row > m_places.count())
-        return;
-
-    if (m_places.at(row))
-        m_places.at(row)->getDetails();
+    const QList<qsizetype> rows = m_rows.value(placeId);
+    for (qsizetype row : rows) {
+        if (QDeclarativePlace *p = place(row))
+            p->getDetails();
+    }
 }
 
 /*!
@@ -952,26 +1003,28 @@ void QDeclarativeSearchResultModel::placeUpdated(const QString &placeId)
 */
 void QDeclarativeSearchResultModel::placeRemoved(const QString &placeId)
 {
-    int row = getRow(placeId);
-    if (row < 0 || row > m_places.count())
+    const QList<qsizetype> rows = m_rows.take(placeId);
+    if (rows.isEmpty())
         return;
 
-    beginRemoveRows(QModelIndex(), row, row);
-    delete m_places.at(row);
-    m_places.removeAt(row);
-    m_results.removeAt(row);
-    removePageRow(row);
-    endRemoveRows();
+    // From the last row, the rows before it keep their index
+    for (auto row = rows.crbegin(), end = rows.crend(); row != end; ++row) {
+        beginRemoveRows(QModelIndex(), int(*row), int(*row));
+        delete m_places.at(*row);
+        m_places.removeAt(*row);
+        m_results.removeAt(*row);
+        removePageRow(int(*row));
+        endRemoveRows();
+    }
+    m_favorites.remove(placeId);
 
-    emit rowCountChanged();
-}
+    // Shifted down by the number of removed rows before them
+    for (auto it = m_rows.begin(), end = m_rows.end(); it != end; ++it) {
+        for (qsizetype &row : it.value())
+            row -= std::lower_bound(rows.cbegin(), rows.cend(), row) - rows.cbegin();
+    }
 
-QList<QPlaceSearchResult> QDeclarativeSearchResultModel::resultsFromPages() const
-{
-    QList<QPlaceSearchResult> res;
-    for (const auto &e : m_pages)
-        res.append(e);
-    return res;
+    emit rowCountChanged();
 }
 
 void QDeclarativeSearchResultModel::removePageRow(int row)
@@ -987,21 +1040,6 @@ void QDeclarativeSearchResultModel::removePageRow(int row)
     }
 }
 
-/*!
-    \internal
-*/
-int QDeclarativeSearchResultModel::getRow(const QString &placeId) const
-{
-    for (qsizetype i = 0; i < m_places.count(); ++i) {
-        if (!m_places.at(i))
-            continue;
-        else if (m_places.at(i)->placeId() == placeId)
-            return i;
-    }
-
-    return -1;
-}
-
 /*!
     \qmlsignal PlaceSearchResultModel::dataChanged()
 
@@ -170,8 +170,8 @@ private:
         SponsoredRole
     };
 
-    int getRow(const QString &placeId) const;
-    QList<QPlaceSearchResult> resultsFromPages() const;
+    QDeclarativePlace *place(qsizetype row) const;
+    void appendRows(const QList<QPlaceSearchResult> &results, const QList<QPlace> &favoritePlaces);
     void removePageRow(int row);
 
     QList<QDeclarativeCategory *> m_categories;
@@ -180,8 +180,13 @@ private:
     QMap<int, QList<QPlaceSearchResult>> m_pages;
     QList<QPlaceSearchResult> m_results;
     QList<QPlaceSearchResult> m_resultsBuffer;
-    QList<QDeclarativePlace *> m_places;
-    QList<QPlaceIcon> m_icons;
+    // One per row, null until data() is asked for the place of the row
+    mutable QList<QDeclarativePlace *> m_places;
+    // Places of cleared rows, reused by data() instead of allocating new ones
+    mutable QList<QDeclarativePlace *> m_recycledPlaces;
+    QHash<QString, QPlace> m_favorites;
+    // The rows of each place, ascending. A place can be in several results
+    QHash<QString, QList<qsizetype>> m_rows;
 
     QDeclarativeGeoServiceProvider *m_favoritesPlugin = nullptr;
     QVariantMap m_matchParameters;
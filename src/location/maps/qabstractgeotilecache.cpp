@@ -74,6 +74,33 @@ void QAbstractGeoTileCache::handleError(const QGeoTileSpec &, const QString &err
     qWarning() << "tile request error " << error;
 }
 
+void QAbstractGeoTileCache::setTileValidators(const QGeoTileSpec &, const QGeoTileValidators &)
+{
+}
+
+qint64 QAbstractGeoTileCache::diskTileSize(const QGeoTileSpec &spec) const
+{
+    Q_UNUSED(spec);
+    return -1;
+}
+
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::getLoaded(const QGeoTileSpec &spec)
+{
+    // Caches without background loading keep answering synchronously
+    return get(spec);
+}
+
+bool QAbstractGeoTileCache::loadAsync(const QGeoTileSpec &spec)
+{
+    Q_UNUSED(spec);
+    return false;
+}
+
+void QAbstractGeoTileCache::cancelLoads(const QSet<QGeoTileSpec> &specs)
+{
+    Q_UNUSED(specs);
+}
+
 void QAbstractGeoTileCache::setMaxDiskUsage(int diskUsage)
 {
     Q_UNUSED(diskUsage);
@@ -104,6 +131,30 @@ int QAbstractGeoTileCache::memoryUsage() const
     return 0;
 }
 
+void QAbstractGeoTileCache::setMetrics(QGeoTileMetrics *metrics)
+{
+    metrics_ = metrics;
+}
+
+QGeoTileMetrics *QAbstractGeoTileCache::metrics() const
+{
+    return metrics_;
+}
+
+void QAbstractGeoTileCache::collectMetrics(QGeoTileMetrics::Snapshot *snapshot) const
+{
+    // Without per tier counters, report what the usage accessors tell
+    QGeoTileMetrics::TierStats &texture = snapshot->tiers[QGeoTileMetrics::TextureTier];
+    texture.bytes = textureUsage();
+    texture.maxBytes = maxTextureUsage();
+    QGeoTileMetrics::TierStats &memory = snapshot->tiers[QGeoTileMetrics::MemoryTier];
+    memory.bytes = memoryUsage();
+    memory.maxBytes = maxMemoryUsage();
+    QGeoTileMetrics::TierStats &disk = snapshot->tiers[QGeoTileMetrics::DiskTier];
+    disk.bytes = diskUsage();
+    disk.maxBytes = maxDiskUsage();
+}
+
 QString QAbstractGeoTileCache::baseCacheDirectory()
 {
     QString dir;
@@ -51,13 +51,18 @@
 //
 
 #include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotileformat_p.h>
 
 #include <QtCore/QSharedPointer>
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QSet>
 #include <QtGui/QImage>
 
 #include "qgeotilespec_p.h"
+#include "qgeotilecompression_p.h"
+#include "qgeotilemetrics_p.h"
+#include "qgeotilevalidators_p.h"
 
 
 QT_BEGIN_NAMESPACE
@@ -70,11 +75,15 @@ class QAbstractGeoTileCache;
 
 class QThread;
 
-/* This is also used in the mapgeometry */
+/* This is also used in the mapgeometry. A tile is either an image, or
+ * compressed when the cache is set to keep compressed textures */
 struct QGeoTileTexture
 {
+    bool isNull() const { return image.isNull() && compressed.isNull(); }
+
     QGeoTileSpec spec;
     QImage image;
+    QGeoCompressedTileImage compressed;
     bool textureBound = false;
 };
 
@@ -119,20 +128,48 @@ public:
 
     virtual QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) = 0;
 
+    /* Non-blocking lookups. getLoaded() only returns textures that are ready
+     * to be used, loadAsync() schedules a background read and decode and
+     * returns false if the tile is not cached at all. Completion is reported
+     * through tileLoaded() or tileLoadFailed() */
+    virtual QSharedPointer<QGeoTileTexture> getLoaded(const QGeoTileSpec &spec);
+    virtual bool loadAsync(const QGeoTileSpec &spec);
+    virtual void cancelLoads(const QSet<QGeoTileSpec> &specs);
+
     virtual void insert(const QGeoTileSpec &spec,
                 const QByteArray &bytes,
-                const QString &format,
+                QGeoTileFormat format,
                 QAbstractGeoTileCache::CacheAreas areas = QAbstractGeoTileCache::AllCaches) = 0;
     virtual void handleError(const QGeoTileSpec &spec, const QString &errorString);
+
+    /* Validators of a stored tile, as received with it or refreshed by a
+     * conditional request. Caches that keep them emit tileStale() when
+     * serving a tile past its expiry */
+    virtual void setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+    // The size of a fresh copy of the tile on disk, -1 if there is none
+    virtual qint64 diskTileSize(const QGeoTileSpec &spec) const;
     virtual void init() = 0;
 
+    /* The metrics are owned by the engine. collectMetrics() fills in the
+     * per tier part of a snapshot */
+    void setMetrics(QGeoTileMetrics *metrics);
+    QGeoTileMetrics *metrics() const;
+    virtual void collectMetrics(QGeoTileMetrics::Snapshot *snapshot) const;
+
     static QString baseCacheDirectory();
     static QString baseLocationCacheDirectory();
 
+Q_SIGNALS:
+    void tileLoaded(const QGeoTileSpec &spec);
+    void tileLoadFailed(const QGeoTileSpec &spec);
+    void tileStale(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+
 protected:
     QAbstractGeoTileCache(QObject *parent = nullptr);
     virtual void printStats() = 0;
 
+    QGeoTileMetrics *metrics_ = nullptr;
+
     friend class QGeoTiledMappingManagerEngine;
 };
 
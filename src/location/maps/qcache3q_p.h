@@ -155,29 +155,41 @@ public:
     inline void setPromoteAt(int p) { promote_ = p; }
 
     inline int totalCost() const { return q1_->cost + q2_->cost + q3_->cost; }
+    inline int size() const { return q1_->size + q2_->size + q3_->size; }
+
+    // Lifetime counters, for the tile cache metrics
+    inline int hitCount() const { return hitCount_; }
+    inline int missCount() const { return missCount_; }
+    inline int evictionCount() const { return evictCount_; }
 
     void clear();
     bool insert(const Key &key, QSharedPointer<T> object, int cost = 1);
     QSharedPointer<T> object(const Key &key) const;
     QSharedPointer<T> operator[](const Key &key) const;
+    // Looks up without counting a hit or changing popularity
+    QSharedPointer<T> peek(const Key &key) const;
 
     void remove(const Key &key, bool force = false);
     QList<Key> keys() const;
     void printStats();
 
-    // Copy data directly into a queue. Designed for single use after construction
+    // Copy data directly into the back of a queue, in the order produced by
+    // serializeQueue(). Designed for use right after construction
     void deserializeQueue(int queueNumber, const QList<Key> &keys,
-                          const QList<QSharedPointer<T> > &values, const QList<int> &costs);
-    // Copy data from specific queue into list
-    void serializeQueue(int queueNumber, QList<QSharedPointer<T> > &buffer);
+                          const QList<QSharedPointer<T> > &values, const QList<int> &costs,
+                          const QList<quint64> &popularities);
+    // Copy data from specific queue into lists, front (most recent) first
+    void serializeQueue(int queueNumber, QList<Key> &keys, QList<QSharedPointer<T> > &values,
+                        QList<int> &costs, QList<quint64> &popularities) const;
 
 private:
     int maxCost_, minRecent_, maxOldPopular_;
-    int hitCount_, missCount_, promote_;
+    int hitCount_, missCount_, evictCount_, promote_;
 
     void rebalance();
     void unlink(Node *n);
     void link_front(Node *n, Queue *q);
+    void link_back(Node *n, Queue *q);
 
 private:
     // make these private so they can't be used
@@ -189,9 +201,9 @@ template <class Key, class T, class EvPolicy>
 void QCache3Q<Key,T,EvPolicy>::printStats()
 {
     qDebug("\n=== cache %p ===", this);
-    qDebug("hits: %d (%.2f%%)\tmisses: %d\tfill: %.2f%%", hitCount_,
+    qDebug("hits: %d (%.2f%%)\tmisses: %d\tevictions: %d\tfill: %.2f%%", hitCount_,
            100.0 * float(hitCount_) / (float(hitCount_ + missCount_)),
-           missCount_,
+           missCount_, evictCount_,
            100.0 * float(totalCost()) / float(maxCost()));
     qDebug("q1g: size=%d, pop=%llu", q1_evicted_->size, q1_evicted_->pop);
     qDebug("q1:  cost=%d, size=%d, pop=%llu", q1_->cost, q1_->size, q1_->pop);
@@ -203,7 +215,7 @@ template <class Key, class T, class EvPolicy>
 QCache3Q<Key,T,EvPolicy>::QCache3Q(int maxCost, int minRecent, int maxOldPopular)
     : q1_(new Queue), q2_(new Queue), q3_(new Queue), q1_evicted_(new Queue),
       maxCost_(maxCost), minRecent_(minRecent), maxOldPopular_(maxOldPopular),
-      hitCount_(0), missCount_(0), promote_(0)
+      hitCount_(0), missCount_(0), evictCount_(0), promote_(0)
 {
     if (minRecent_ < 0)
         minRecent_ = maxCost_ / 3;
@@ -212,38 +224,55 @@ QCache3Q<Key,T,EvPolicy>::QCache3Q(int maxCost, int minRecent, int maxOldPopular
 }
 
 template <class Key, class T, class EvPolicy>
-void QCache3Q<Key,T,EvPolicy>::serializeQueue(int queueNumber, QList<QSharedPointer<T> > &buffer)
+void QCache3Q<Key,T,EvPolicy>::serializeQueue(int queueNumber, QList<Key> &keys,
+                                              QList<QSharedPointer<T> > &values,
+                                              QList<int> &costs, QList<quint64> &popularities) const
 {
     Q_ASSERT(queueNumber >= 1 && queueNumber <= 4);
-    Queue *queue = queueNumber == 1 ? q1_ :
-                   queueNumber == 2 ? q2_ :
-                   queueNumber == 3 ? q3_ :
-                                      q1_evicted_;
-    for (Node *node = queue->f; node; node = node->n)
-        buffer.append(node->v);
+    const Queue *queue = queueNumber == 1 ? q1_ :
+                         queueNumber == 2 ? q2_ :
+                         queueNumber == 3 ? q3_ :
+                                            q1_evicted_;
+    keys.reserve(keys.size() + queue->size);
+    values.reserve(values.size() + queue->size);
+    costs.reserve(costs.size() + queue->size);
+    popularities.reserve(popularities.size() + queue->size);
+    for (const Node *node = queue->f; node; node = node->n) {
+        keys.append(node->k);
+        values.append(node->v);
+        costs.append(node->cost);
+        popularities.append(node->pop);
+    }
 }
 
 template <class Key, class T, class EvPolicy>
 void QCache3Q<Key,T,EvPolicy>::deserializeQueue(int queueNumber, const QList<Key> &keys,
-                       const QList<QSharedPointer<T> > &values, const QList<int> &costs)
+                       const QList<QSharedPointer<T> > &values, const QList<int> &costs,
+                       const QList<quint64> &popularities)
 {
     Q_ASSERT(queueNumber >= 1 && queueNumber <= 4);
-    int bufferSize = keys.size();
+    Q_ASSERT(values.size() == keys.size() && costs.size() == keys.size()
+             && popularities.size() == keys.size());
+    const qsizetype bufferSize = keys.size();
     if (bufferSize == 0)
         return;
-    clear();
     Queue *queue = queueNumber == 1 ? q1_ :
                    queueNumber == 2 ? q2_ :
                    queueNumber == 3 ? q3_ :
                                       q1_evicted_;
-    for (int i = 0; i<bufferSize; ++i) {
+    for (qsizetype i = 0; i < bufferSize; ++i) {
+        if (lookup_.contains(keys[i]))
+            continue;
         Node *node = new Node;
         node->v = values[i];
         node->k = keys[i];
         node->cost = costs[i];
-        link_front(node, queue);
+        node->pop = popularities[i];
+        link_back(node, queue);
         lookup_[keys[i]] = node;
     }
+    // The maximum cost may have been lowered since the queues were saved
+    rebalance();
 }
 
 
@@ -371,6 +400,23 @@ void QCache3Q<Key,T,EvPolicy>::link_front(Node *n, Queue *q)
     q->size++;
 }
 
+template <class Key, class T, class EvPolicy>
+void QCache3Q<Key,T,EvPolicy>::link_back(Node *n, Queue *q)
+{
+    n->n = 0;
+    n->p = q->l;
+    n->q = q;
+    if (q->l)
+        q->l->n = n;
+    q->l = n;
+    if (!q->f)
+        q->f = n;
+
+    q->pop += n->pop;
+    q->cost += n->cost;
+    q->size++;
+}
+
 template <class Key, class T, class EvPolicy>
 void QCache3Q<Key,T,EvPolicy>::rebalance()
 {
@@ -386,12 +432,14 @@ void QCache3Q<Key,T,EvPolicy>::rebalance()
             Node *n = q3_->l;
             unlink(n);
             EvPolicy::aboutToBeEvicted(n->k, n->v);
+            ++evictCount_;
             lookup_.remove(n->k);
             delete n;
         } else if (q1_->cost > minRecent_) {
             Node *n = q1_->l;
             unlink(n);
             EvPolicy::aboutToBeEvicted(n->k, n->v);
+            ++evictCount_;
             n->v.clear();
             n->cost = 0;
             link_front(n, q1_evicted_);
@@ -402,6 +450,7 @@ void QCache3Q<Key,T,EvPolicy>::rebalance()
                 link_front(n, q3_);
             } else {
                 EvPolicy::aboutToBeEvicted(n->k, n->v);
+                ++evictCount_;
                 n->v.clear();
                 n->cost = 0;
                 link_front(n, q1_evicted_);
@@ -472,6 +521,13 @@ inline QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::operator[](const Key &key) co
     return object(key);
 }
 
+template <class Key, class T, class EvPolicy>
+QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::peek(const Key &key) const
+{
+    Node *n = lookup_.value(key, nullptr);
+    return n ? n->v : QSharedPointer<T>();
+}
+
 QT_END_NAMESPACE
 
 #endif // QCACHE3Q_H
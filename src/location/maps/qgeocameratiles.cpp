@@ -39,7 +39,6 @@
 #include "qgeocameratiles_p.h"
 #include "qgeocameratiles_p_p.h"
 #include "qgeocameradata_p.h"
-#include "qgeotilespec_p.h"
 #include "qgeomaptype_p.h"
 
 #include <QtGui/QMatrix4x4>
@@ -117,6 +116,7 @@ void QGeoCameraTiles::setPluginString(const QString &pluginString)
 
     d_ptr->m_dirtyMetadata = true;
     d_ptr->m_pluginString = pluginString;
+    d_ptr->m_pluginId = QGeoTileKey::pluginId(pluginString);
 }
 
 void QGeoCameraTiles::setMapType(const QGeoMapType &mapType)
@@ -162,11 +162,18 @@ int QGeoCameraTiles::tileSize() const
     return d_ptr->m_tileSize;
 }
 
-const QSet<QGeoTileSpec>& QGeoCameraTiles::createTiles()
+const QSet<QGeoTileKey> &QGeoCameraTiles::createTiles()
 {
+    d_ptr->m_addedTiles.clear();
+    d_ptr->m_removedTiles.clear();
+
+    // Moving the camera at the same integer zoom level keeps the tile grid,
+    // the change to the tile set can then be worked out on the row ranges
+    d_ptr->m_hasTileDelta = !d_ptr->m_dirtyMetadata
+            && d_ptr->m_spansZoomLevel == d_ptr->m_intZoomLevel;
+
     if (d_ptr->m_dirtyGeometry) {
-        d_ptr->m_tiles.clear();
-        d_ptr->updateGeometry();
+        d_ptr->updateGeometry(d_ptr->m_hasTileDelta);
         d_ptr->m_dirtyGeometry = false;
     }
 
@@ -178,25 +185,40 @@ const QSet<QGeoTileSpec>& QGeoCameraTiles::createTiles()
     return d_ptr->m_tiles;
 }
 
+/*!
+    \internal
+    Returns whether addedTiles() and removedTiles() describe how the set
+    returned by the last createTiles() call differs from the one before.
+    This is the case as long as the integer zoom level, the plugin, the map
+    type and the map version stay the same.
+*/
+bool QGeoCameraTiles::hasTileDelta() const
+{
+    return d_ptr->m_hasTileDelta;
+}
 
-void QGeoCameraTilesPrivate::updateMetadata()
+const QSet<QGeoTileKey> &QGeoCameraTiles::addedTiles() const
 {
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
+    return d_ptr->m_addedTiles;
+}
 
-    QSet<QGeoTileSpec> newTiles;
+const QSet<QGeoTileKey> &QGeoCameraTiles::removedTiles() const
+{
+    return d_ptr->m_removedTiles;
+}
 
-    iter i = m_tiles.constBegin();
-    iter end = m_tiles.constEnd();
+void QGeoCameraTilesPrivate::updateMetadata()
+{
+    QSet<QGeoTileKey> newTiles;
+    newTiles.reserve(m_tiles.size());
 
-    for (; i != end; ++i) {
-        QGeoTileSpec tile = *i;
-        newTiles.insert(QGeoTileSpec(m_pluginString, m_mapType.mapId(), tile.zoom(), tile.x(), tile.y(), m_mapVersion));
-    }
+    for (const QGeoTileKey &tile : qAsConst(m_tiles))
+        newTiles.insert(QGeoTileKey(m_pluginId, m_mapType.mapId(), tile.zoom(), tile.x(), tile.y(), m_mapVersion));
 
     m_tiles = newTiles;
 }
 
-void QGeoCameraTilesPrivate::updateGeometry()
+void QGeoCameraTilesPrivate::updateGeometry(bool incremental)
 {
     // Find the frustum from the camera / screen / viewport information
     // The larger frustum when stationary is a form of prefetching
@@ -217,20 +239,76 @@ void QGeoCameraTilesPrivate::updateGeometry()
     m_clippedFootprint = polygons;
 #endif
 
+    // Merge on row ranges, a key is only built for the tiles that changed
+    TileSpans spans;
+
+    if (!polygons.left.isEmpty())
+        addSpans(spans, tilesFromPolygon(polygons.left));
 
-    if (!polygons.left.isEmpty()) {
-        QSet<QGeoTileSpec> tilesLeft = tilesFromPolygon(polygons.left);
-        m_tiles.unite(tilesLeft);
+    if (!polygons.right.isEmpty())
+        addSpans(spans, tilesFromPolygon(polygons.right));
+
+    if (!polygons.mid.isEmpty())
+        addSpans(spans, tilesFromPolygon(polygons.mid));
+
+    if (incremental) {
+        subtractSpans(spans, m_spans, m_addedTiles);
+        subtractSpans(m_spans, spans, m_removedTiles);
+        m_tiles -= m_removedTiles;
+        m_tiles += m_addedTiles;
+    } else {
+        m_tiles.clear();
+        subtractSpans(spans, TileSpans(), m_tiles);
     }
 
-    if (!polygons.right.isEmpty()) {
-        QSet<QGeoTileSpec> tilesRight = tilesFromPolygon(polygons.right);
-        m_tiles.unite(tilesRight);
+    m_spans = spans;
+    m_spansZoomLevel = m_intZoomLevel;
+}
+
+void QGeoCameraTilesPrivate::addSpans(TileSpans &spans, const TileMap &map)
+{
+    for (auto it = map.data.cbegin(); it != map.data.cend(); ++it) {
+        QList<QPair<int, int> > &row = spans[it.key()];
+        QPair<int, int> span = it.value();
+
+        // Insert sorted, merging with the overlapping or adjacent ranges
+        qsizetype i = 0;
+        while (i < row.size() && row.at(i).second < span.first - 1)
+            ++i;
+        while (i < row.size() && row.at(i).first <= span.second + 1) {
+            span.first = qMin(span.first, row.at(i).first);
+            span.second = qMax(span.second, row.at(i).second);
+            row.removeAt(i);
+        }
+        row.insert(i, span);
     }
+}
 
-    if (!polygons.mid.isEmpty()) {
-        QSet<QGeoTileSpec> tilesRight = tilesFromPolygon(polygons.mid);
-        m_tiles.unite(tilesRight);
+/*
+    Adds to result the tiles covered by from but not by spans.
+*/
+void QGeoCameraTilesPrivate::subtractSpans(const TileSpans &from, const TileSpans &spans,
+                                           QSet<QGeoTileKey> &result) const
+{
+    const int z = m_intZoomLevel;
+    const int mapId = m_mapType.mapId();
+    for (auto it = from.cbegin(); it != from.cend(); ++it) {
+        const int y = it.key();
+        const QList<QPair<int, int> > other = spans.value(y);
+        qsizetype j = 0;
+        for (const QPair<int, int> &span : it.value()) {
+            int x = span.first;
+            while (x <= span.second) {
+                while (j < other.size() && other.at(j).second < x)
+                    ++j;
+                // Tiles up to the next range of spans, or to the end of this one
+                const int end = (j < other.size()) ? qMin(span.second, other.at(j).first - 1) : span.second;
+                for (; x <= end; ++x)
+                    result.insert(QGeoTileKey(m_pluginId, mapId, z, x, y, m_mapVersion));
+                if (j < other.size() && x >= other.at(j).first)
+                    x = other.at(j).second + 1;
+            }
+        }
     }
 }
 
@@ -642,12 +720,12 @@ QList<QPair<double, int>> QGeoCameraTilesPrivate::tileIntersections(double p1, i
     return results;
 }
 
-QSet<QGeoTileSpec> QGeoCameraTilesPrivate::tilesFromPolygon(const PolygonVector &polygon) const
+QGeoCameraTilesPrivate::TileMap QGeoCameraTilesPrivate::tilesFromPolygon(const PolygonVector &polygon) const
 {
     const qsizetype numPoints = polygon.size();
 
     if (numPoints == 0)
-        return QSet<QGeoTileSpec>();
+        return TileMap();
 
     QList<int> tilesX(polygon.size());
     QList<int> tilesY(polygon.size());
@@ -826,18 +904,7 @@ QSet<QGeoTileSpec> QGeoCameraTilesPrivate::tilesFromPolygon(const PolygonVector
         }
     }
 
-    QSet<QGeoTileSpec> results;
-
-    const int z = m_intZoomLevel;
-    for (auto i = map.data.constBegin(); i != map.data.constEnd(); ++i) {
-        int y = i.key();
-        int minX = i->first;
-        int maxX = i->second;
-        for (int x = minX; x <= maxX; ++x)
-            results.insert(QGeoTileSpec(m_pluginString, m_mapType.mapId(), z, x, y, m_mapVersion));
-    }
-
-    return results;
+    return map;
 }
 
 QGeoCameraTilesPrivate::TileMap::TileMap() {}
@@ -56,7 +56,7 @@
 QT_BEGIN_NAMESPACE
 
 class QGeoCameraData;
-class QGeoTileSpec;
+class QGeoTileKey;
 class QGeoMapType;
 class QGeoCameraTilesPrivate;
 class QSize;
@@ -78,7 +78,10 @@ public:
     void setMapType(const QGeoMapType &mapType);
     QGeoMapType activeMapType() const;
     void setMapVersion(int mapVersion);
-    const QSet<QGeoTileSpec>& createTiles();
+    const QSet<QGeoTileKey> &createTiles();
+    bool hasTileDelta() const;
+    const QSet<QGeoTileKey> &addedTiles() const;
+    const QSet<QGeoTileKey> &removedTiles() const;
 
 protected:
     std::unique_ptr<QGeoCameraTilesPrivate> d_ptr;
@@ -53,7 +53,7 @@
 #include "qgeocameratiles_p.h"
 #include "qgeomaptype_p.h"
 #include "qgeocameradata_p.h"
-#include "qgeotilespec_p.h"
+#include "qgeotilekey_p.h"
 
 #include <QtCore/qlist.h>
 #include <QtCore/qset.h>
@@ -103,8 +103,13 @@ public:
         QMap<int, QPair<int, int> > data;
     };
 
+    // Sorted, disjoint [minX, maxX] tile ranges per tile row
+    typedef QMap<int, QList<QPair<int, int> > > TileSpans;
+
     void updateMetadata();
-    void updateGeometry();
+    void updateGeometry(bool incremental);
+    static void addSpans(TileSpans &spans, const TileMap &map);
+    void subtractSpans(const TileSpans &from, const TileSpans &spans, QSet<QGeoTileKey> &result) const;
 
     Frustum createFrustum(double viewExpansion) const;
     PolygonVector frustumFootprint(const Frustum &frustum) const;
@@ -113,7 +118,7 @@ public:
     ClippedFootprint clipFootprintToMap(const PolygonVector &footprint) const;
 
     QList<QPair<double, int> > tileIntersections(double p1, int t1, double p2, int t2) const;
-    QSet<QGeoTileSpec> tilesFromPolygon(const PolygonVector &polygon) const;
+    TileMap tilesFromPolygon(const PolygonVector &polygon) const;
 
     static QGeoCameraTilesPrivate *get(QGeoCameraTiles *o) {
         return o->d_ptr.get();
@@ -121,13 +126,21 @@ public:
 
 public:
     QString m_pluginString;
+    quint16 m_pluginId = 0; // m_pluginString, interned
     QGeoMapType m_mapType;
     int m_mapVersion = -1;
     QGeoCameraData m_camera;
     QSize m_screenSize;
     QRectF m_visibleArea;
     int m_tileSize = 0;
-    QSet<QGeoTileSpec> m_tiles;
+    QSet<QGeoTileKey> m_tiles;
+    TileSpans m_spans; // m_tiles, as ranges
+    int m_spansZoomLevel = -1;
+
+    // What the last createTiles() changed, if it could be expressed as a delta
+    QSet<QGeoTileKey> m_addedTiles;
+    QSet<QGeoTileKey> m_removedTiles;
+    bool m_hasTileDelta = false;
 
     int m_intZoomLevel = 0;
     int m_sideLength = 0;
@@ -39,15 +39,22 @@
 #include "qgeofiletilecache_p.h"
 
 #include "qgeotilespec_p.h"
+#include "qgeotilearchive_p.h"
 
 #include "qgeomappingmanager_p.h"
 
 #include <QDir>
+#include <QDataStream>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QtEndian>
+#include <QThread>
 #include <QMetaType>
 #include <QPixmap>
 #include <QDebug>
 
+#include <utility>
+
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
 Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
 
@@ -65,9 +72,107 @@ public:
     QGeoTileSpec spec;
     QGeoFileTileCache *cache;
     QByteArray bytes;
-    QString format;
+    QGeoTileFormat format;
+};
+
+/* State of one background tile load. Written by the pool thread, read back on
+ * the cache thread once the load has been handed over with a queued call */
+class QGeoCachedTileLoad
+{
+public:
+    QGeoTileSpec spec;
+    QGeoTileDiskStorage *storage = nullptr;
+    QString name;
+    QGeoTileDiskStorage *fallbackStorage = nullptr; // read when storage misses the tile
+    QString fallbackName;
+    bool fellBack = false;
+    QByteArray bytes;
+    QGeoTileFormat format;
+    QGeoFileTileCache::TextureFormat textureFormat = QGeoFileTileCache::TextureArgb32;
+    QImage image;
+    QGeoCompressedTileImage compressed;
+    QGeoTileMetrics *metrics = nullptr; // set while the metrics are enabled
+    QAtomicInt cancelled;
 };
 
+// Converts a decoded tile to the form kept in the texture cache
+static void prepareTexture(QImage *image, QGeoCompressedTileImage *compressed,
+                           QGeoFileTileCache::TextureFormat format)
+{
+    switch (format) {
+    case QGeoFileTileCache::TextureArgb32:
+        break;
+    case QGeoFileTileCache::TextureRgb565:
+        if (QGeoCompressedTileImage::isOpaque(*image))
+            *image = image->convertToFormat(QImage::Format_RGB16);
+        break;
+    case QGeoFileTileCache::TextureBC1:
+    case QGeoFileTileCache::TextureETC2:
+        *compressed = QGeoCompressedTileImage::compress(*image, format == QGeoFileTileCache::TextureBC1
+                                                        ? QGeoCompressedTileImage::BC1
+                                                        : QGeoCompressedTileImage::ETC2_RGB8);
+        if (!compressed->isNull())
+            *image = QImage();
+        break;
+    }
+}
+
+static void readAndDecodeTile(QGeoCachedTileLoad *load)
+{
+    if (load->cancelled.loadRelaxed())
+        return;
+
+    QGeoTileMetrics *metrics = load->metrics;
+    qint64 start = metrics ? metrics->now() : 0;
+    if (load->storage) {
+        load->bytes = load->storage->read(load->name);
+        if (load->bytes.isEmpty() && load->fallbackStorage && !load->cancelled.loadRelaxed()) {
+            load->fellBack = true;
+            load->bytes = load->fallbackStorage->read(load->fallbackName);
+        }
+        load->format = QGeoTileFormat::fromName(QFileInfo(load->fellBack ? load->fallbackName
+                                                                         : load->name).suffix());
+        if (metrics) {
+            const qint64 read = metrics->now();
+            metrics->record(QGeoTileMetrics::DiskReadStage, read - start);
+            start = read;
+        }
+    }
+
+    if (load->cancelled.loadRelaxed())
+        return;
+    // Tiles already decoded on the cache thread are only transcoded
+    if (load->image.isNull() && !load->image.loadFromData(load->bytes))
+        return;
+
+    // Converting it here, instead of in each QSGTexture::bind()
+    if (load->image.format() != QImage::Format_RGB32
+            && load->image.format() != QImage::Format_ARGB32_Premultiplied) {
+        load->image = load->image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+    prepareTexture(&load->image, &load->compressed, load->textureFormat);
+    if (metrics)
+        metrics->recordSince(QGeoTileMetrics::DecodeStage, start);
+}
+
+// Disk storages address tiles relative to the cache directory
+static inline QString tileFileName(const QString &filename)
+{
+    return filename.mid(filename.lastIndexOf(QLatin1Char('/')) + 1);
+}
+
+static const quint32 ManifestMagic = 0x4d544751; // "QGTM"
+static const quint32 ManifestVersion = 3;
+
+// Periodic save, in case the application doesn't close down properly
+static const int ManifestSaveInterval = 5 * 60 * 1000;
+
+// Queued disk writes are handed to the writer after this delay, or as soon
+// as a batch is full
+static const int DiskWriteBatchInterval = 250;
+static const int MaxDiskWriteBatchTiles = 64;
+static const qint64 MaxDiskWriteBatchSize = 4 * 1024 * 1024;
+
 void QCache3QTileEvictionPolicy::aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj)
 {
     Q_UNUSED(key);
@@ -91,6 +196,15 @@ QGeoCachedTileDisk::~QGeoCachedTileDisk()
 QGeoFileTileCache::QGeoFileTileCache(const QString &directory, QObject *parent)
     : QAbstractGeoTileCache(parent), directory_(directory)
 {
+    // Reads are mostly I/O bound and decoding competes with the render thread,
+    // so keep the number of concurrent loads small
+    loadPool_.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+
+    // A single writer keeps the batches in order
+    writePool_.setMaxThreadCount(1);
+    writeTimer_.setSingleShot(true);
+    writeTimer_.setInterval(DiskWriteBatchInterval);
+    connect(&writeTimer_, &QTimer::timeout, this, &QGeoFileTileCache::flushDiskWrites);
 }
 
 void QGeoFileTileCache::init()
@@ -122,6 +236,11 @@ void QGeoFileTileCache::init()
     if (!directoryCreated)
         qWarning() << "Failed to create cache directory " << directory_;
 
+    if (!diskStorage_)
+        diskStorage_.reset(new QGeoTileFileStorage);
+    if (!diskStorage_->open(directory_))
+        qWarning() << "Failed to open tile storage in " << directory_;
+
     // default values
     if (!isDiskCostSet_) { // If setMaxDiskUsage has not been called yet
         if (costStrategyDisk_ == ByteSize)
@@ -145,92 +264,262 @@ void QGeoFileTileCache::init()
     }
 
     loadTiles();
+
+    manifestTimer_.setInterval(ManifestSaveInterval);
+    connect(&manifestTimer_, &QTimer::timeout, this, [this]() {
+        if (diskCacheChanged_)
+            saveDiskCacheManifest(false);
+    });
+    manifestTimer_.start();
 }
 
 void QGeoFileTileCache::loadTiles()
 {
-    QStringList formats;
-    formats << QLatin1String("*.*");
+    // 1. restore the cache queues from the manifest written by the last session
+    if (restoreDiskCacheManifest())
+        return;
 
+    // 2. no usable manifest, push every tile found in the storage into the cache
     QDir dir(directory_);
-    const QStringList files = dir.entryList(formats, QDir::Files);
-#if 0 // workaround for QTBUG-60581
-    // Method:
-    // 1. read each queue file then, if each file exists, deserialize the data into the appropriate
-    // cache queue.
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::ReadOnly))
+    const QList<QGeoTileDiskStorage::Entry> files = diskStorage_->entries();
+    for (const auto &file : files) {
+        QGeoTileSpec spec = filenameToTileSpec(file.name);
+        if (spec.zoom() == -1)
             continue;
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        QList<QGeoTileSpec> specs;
-        QList<int> costs;
-        while (!file.atEnd()) {
-            QByteArray line = file.readLine().trimmed();
-            QString filename = QString::fromLatin1(line.constData(), line.length());
-            if (dir.exists(filename)){
-                files.removeOne(filename);
-                QGeoTileSpec spec = filenameToTileSpec(filename);
-                if (spec.zoom() == -1)
-                    continue;
-                QSharedPointer<QGeoCachedTileDisk> tileDisk(new QGeoCachedTileDisk);
-                tileDisk->filename = dir.filePath(filename);
-                tileDisk->cache = this;
-                tileDisk->spec = spec;
-                QFileInfo fi(tileDisk->filename);
-                specs.append(spec);
-                queue.append(tileDisk);
-                if (costStrategyDisk_ == ByteSize)
-                    costs.append(fi.size());
-                else
-                    costs.append(1);
+        QString filename = dir.filePath(file.name);
+        addToDiskCache(spec, filename, file.size);
+        updateNewestTileTimestamp(spec, file.lastModified);
+    }
+}
 
-            }
+void QGeoFileTileCache::updateNewestTileTimestamp(const QGeoTileSpec &spec, const QDateTime &lastModified)
+{
+    QDateTime &newest = newestTileTimestamps_[spec.mapId()];
+    if (lastModified > newest)
+        newest = lastModified;
+}
+
+/* The manifest records the content of the 3Q queues of the disk cache, so that
+ * a restart restores the hot/warm/cold classification and the costs without
+ * touching every tile. Queues are stored front first, tiles by name, ghosts
+ * of evicted tiles by tile spec, followed by the time the newest tile of each
+ * map id was written.
+ *
+ * It is consumed when loaded. A manifest written on shutdown is trusted as is,
+ * one written by the periodic save may miss the last tiles and is reconciled
+ * with the storage content. A corrupt manifest is discarded. */
+QString QGeoFileTileCache::manifestFilename() const
+{
+    return QDir(directory_).filePath(QStringLiteral("tiles.manifest"));
+}
+
+bool QGeoFileTileCache::saveDiskCacheManifest(bool clean)
+{
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << ManifestMagic << ManifestVersion << diskStorage_->kind()
+            << quint8(costStrategyDisk_) << clean;
+
+        for (int i = 1; i <= 3; ++i) {
+            QList<QGeoTileSpec> keys;
+            QList<QSharedPointer<QGeoCachedTileDisk> > values;
+            QList<int> costs;
+            QList<quint64> popularities;
+            diskCache_.serializeQueue(i, keys, values, costs, popularities);
+            out << quint32(values.size());
+            for (qsizetype j = 0; j < values.size(); ++j)
+                out << tileFileName(values.at(j)->filename) << qint32(costs.at(j)) << popularities.at(j)
+                    << values.at(j)->validators;
+        }
+
+        QList<QGeoTileSpec> ghosts;
+        QList<QSharedPointer<QGeoCachedTileDisk> > values;
+        QList<int> costs;
+        QList<quint64> popularities;
+        diskCache_.serializeQueue(4, ghosts, values, costs, popularities);
+        out << quint32(ghosts.size());
+        for (qsizetype j = 0; j < ghosts.size(); ++j) {
+            const QGeoTileSpec &spec = ghosts.at(j);
+            out << spec.plugin() << qint32(spec.mapId()) << qint32(spec.zoom()) << qint32(spec.x())
+                << qint32(spec.y()) << qint32(spec.version()) << popularities.at(j);
         }
 
-        diskCache_.deserializeQueue(i, specs, queue, costs);
-        file.close();
+        out << newestTileTimestamps_;
     }
-#endif
-    // 2. remaining tiles that aren't registered in a queue get pushed into cache here
-    // this is a backup, in case the queue manifest files get deleted or out of sync due to
-    // the application not closing down properly
-    for (const auto &file : files) {
-        QGeoTileSpec spec = filenameToTileSpec(file);
-        if (spec.zoom() == -1)
-            continue;
-        QString filename = dir.filePath(file);
-        addToDiskCache(spec, filename);
+    uchar checksum[sizeof(quint16)];
+    qToLittleEndian<quint16>(qChecksum(data), checksum);
+    data.append(reinterpret_cast<const char *>(checksum), sizeof(checksum));
+
+    QSaveFile file(manifestFilename());
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Unable to write tile cache manifest " << manifestFilename();
+        return false;
     }
+    diskCacheChanged_ = false;
+    return true;
 }
 
-QGeoFileTileCache::~QGeoFileTileCache()
+bool QGeoFileTileCache::restoreDiskCacheManifest()
 {
-#if 0 // workaround for QTBUG-60581
-    // write disk cache queues to disk
+    QFile file(manifestFilename());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();
+    file.close();
+    // Consumed: if this session doesn't close down properly, the next one rescans
+    file.remove();
+
+    if (data.size() < qsizetype(sizeof(quint16)))
+        return false;
+    const qsizetype payloadSize = data.size() - sizeof(quint16);
+    if (qChecksum(QByteArrayView(data.constData(), payloadSize))
+            != qFromLittleEndian<quint16>(data.constData() + payloadSize)) {
+        qWarning() << "Discarding corrupt tile cache manifest " << manifestFilename();
+        return false;
+    }
+
+    QDataStream in(data.left(payloadSize));
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString kind;
+    quint8 costStrategy = 0;
+    bool clean = false;
+    in >> magic >> version >> kind >> costStrategy >> clean;
+    if (in.status() != QDataStream::Ok || magic != ManifestMagic || version != ManifestVersion
+            || kind != diskStorage_->kind() || costStrategy != quint8(costStrategyDisk_)) {
+        return false;
+    }
+
+    struct ManifestEntry
+    {
+        QGeoTileSpec spec;
+        QString name;
+        int cost;
+        quint64 popularity;
+        QGeoTileValidators validators;
+    };
+    QList<ManifestEntry> queues[3];
+    for (auto &queue : queues) {
+        quint32 count = 0;
+        in >> count;
+        if (in.status() != QDataStream::Ok)
+            return false;
+        queue.reserve(count);
+        for (quint32 j = 0; j < count; ++j) {
+            ManifestEntry entry;
+            qint32 cost = 0;
+            in >> entry.name >> cost >> entry.popularity >> entry.validators;
+            if (in.status() != QDataStream::Ok)
+                return false;
+            entry.spec = filenameToTileSpec(entry.name);
+            entry.cost = cost;
+            if (entry.spec.zoom() != -1)
+                queue.append(entry);
+        }
+    }
+
+    QList<QGeoTileSpec> ghosts;
+    QList<quint64> ghostPopularities;
+    quint32 ghostCount = 0;
+    in >> ghostCount;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    ghosts.reserve(ghostCount);
+    ghostPopularities.reserve(ghostCount);
+    for (quint32 j = 0; j < ghostCount; ++j) {
+        QString plugin;
+        qint32 mapId = 0, zoom = 0, x = 0, y = 0, tileVersion = -1;
+        quint64 popularity = 0;
+        in >> plugin >> mapId >> zoom >> x >> y >> tileVersion >> popularity;
+        if (in.status() != QDataStream::Ok)
+            return false;
+        ghosts.append(QGeoTileSpec(plugin, mapId, zoom, x, y, tileVersion));
+        ghostPopularities.append(popularity);
+    }
+
+    QHash<int, QDateTime> newestTileTimestamps;
+    in >> newestTileTimestamps;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    newestTileTimestamps_ = newestTileTimestamps;
+
+    // A manifest from the periodic save can be behind the storage: drop what
+    // is gone, and append the tiles written since to the newbies queue
     QDir dir(directory_);
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::WriteOnly)){
-            qWarning() << "Unable to write tile cache file " << filename;
-            continue;
+    QList<QGeoTileDiskStorage::Entry> newFiles;
+    if (!clean) {
+        const QList<QGeoTileDiskStorage::Entry> files = diskStorage_->entries();
+        QHash<QString, qint64> sizes;
+        sizes.reserve(files.size());
+        for (const auto &file : files)
+            sizes.insert(file.name, file.size);
+
+        for (auto &queue : queues) {
+            queue.removeIf([&sizes](const ManifestEntry &entry) {
+                return !sizes.contains(entry.name);
+            });
+            for (const ManifestEntry &entry : qAsConst(queue))
+                sizes.remove(entry.name);
         }
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        diskCache_.serializeQueue(i, queue);
-        for (const QSharedPointer<QGeoCachedTileDisk> &tile : queue) {
-            if (tile.isNull())
-                continue;
+        for (const auto &file : files) {
+            if (sizes.contains(file.name))
+                newFiles.append(file);
+        }
+    }
 
-            // we just want the filename here, not the full path
-            int index = tile->filename.lastIndexOf(QLatin1Char('/'));
-            QByteArray filename = tile->filename.mid(index + 1).toLatin1() + '\n';
-            file.write(filename);
+    for (int i = 0; i < 3; ++i) {
+        QList<QGeoTileSpec> specs;
+        QList<QSharedPointer<QGeoCachedTileDisk> > values;
+        QList<int> costs;
+        QList<quint64> popularities;
+        specs.reserve(queues[i].size());
+        values.reserve(queues[i].size());
+        costs.reserve(queues[i].size());
+        popularities.reserve(queues[i].size());
+        for (const ManifestEntry &entry : qAsConst(queues[i])) {
+            QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
+            td->spec = entry.spec;
+            td->filename = dir.filePath(entry.name);
+            td->validators = entry.validators;
+            td->cache = this;
+            specs.append(entry.spec);
+            values.append(td);
+            costs.append(entry.cost);
+            popularities.append(entry.popularity);
         }
-        file.close();
+        diskCache_.deserializeQueue(i + 1, specs, values, costs, popularities);
+    }
+    diskCache_.deserializeQueue(4, ghosts, QList<QSharedPointer<QGeoCachedTileDisk> >(ghosts.size()),
+                                QList<int>(ghosts.size(), 0), ghostPopularities);
+
+    for (const auto &file : qAsConst(newFiles)) {
+        QGeoTileSpec spec = filenameToTileSpec(file.name);
+        if (spec.zoom() == -1)
+            continue;
+        addToDiskCache(spec, dir.filePath(file.name), file.size);
+        updateNewestTileTimestamp(spec, file.lastModified);
+    }
+
+    diskCacheChanged_ = !newFiles.isEmpty();
+    return true;
+}
+
+QGeoFileTileCache::~QGeoFileTileCache()
+{
+    for (const QSharedPointer<QGeoCachedTileLoad> &load : qAsConst(pendingLoads_))
+        load->cancelled.storeRelaxed(1);
+    pendingLoads_.clear();
+    loadPool_.clear();
+    loadPool_.waitForDone();
+
+    if (diskStorage_) {
+        waitForDiskWrites();
+        saveDiskCacheManifest(true);
     }
-#endif
 }
 
 void QGeoFileTileCache::printStats()
@@ -240,6 +529,27 @@ void QGeoFileTileCache::printStats()
     diskCache_.printStats();
 }
 
+template <class Cache>
+static void collectTierMetrics(const Cache &cache, bool byteSize, QGeoTileMetrics::TierStats *stats)
+{
+    stats->hits = cache.hitCount();
+    stats->misses = cache.missCount();
+    stats->evictions = cache.evictionCount();
+    stats->tiles = cache.size();
+    stats->bytes = byteSize ? cache.totalCost() : -1;
+    stats->maxBytes = byteSize ? cache.maxCost() : -1;
+}
+
+void QGeoFileTileCache::collectMetrics(QGeoTileMetrics::Snapshot *snapshot) const
+{
+    collectTierMetrics(textureCache_, costStrategyTexture_ == ByteSize,
+                       &snapshot->tiers[QGeoTileMetrics::TextureTier]);
+    collectTierMetrics(memoryCache_, costStrategyMemory_ == ByteSize,
+                       &snapshot->tiers[QGeoTileMetrics::MemoryTier]);
+    collectTierMetrics(diskCache_, costStrategyDisk_ == ByteSize,
+                       &snapshot->tiers[QGeoTileMetrics::DiskTier]);
+}
+
 void QGeoFileTileCache::setMaxDiskUsage(int diskUsage)
 {
     diskCache_.setMaxCost(diskUsage);
@@ -306,12 +616,9 @@ void QGeoFileTileCache::clearAll()
     textureCache_.clear();
     memoryCache_.clear();
     diskCache_.clear();
-    QDir dir(directory_);
-    dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
-    dir.setFilter(QDir::Files);
-    for (const QString &dirFile : dir.entryList()) {
-        dir.remove(dirFile);
-    }
+    waitForDiskWrites();
+    diskStorage_->clear();
+    diskCacheChanged_ = true;
 }
 
 void QGeoFileTileCache::clearMapId(const int mapId)
@@ -329,17 +636,31 @@ void QGeoFileTileCache::clearMapId(const int mapId)
     // TODO: It seems the cache leaves residues, like some tiles do not get picked up.
     // After the above calls, files that shouldnt be left behind are still on disk.
     // Do an additional pass and make sure what has to be deleted gets deleted.
-    QDir dir(directory_);
-    QStringList formats;
-    formats << QLatin1String("*.*");
-    const QStringList files = dir.entryList(formats, QDir::Files);
+    waitForDiskWrites();
+    const QList<QGeoTileDiskStorage::Entry> files = diskStorage_->entries();
     qWarning() << "Old tile data detected. Cache eviction left out "<< files.size() << "tiles";
-    for (const QString &tileFileName : files) {
-        QGeoTileSpec spec = filenameToTileSpec(tileFileName);
+    for (const QGeoTileDiskStorage::Entry &file : files) {
+        QGeoTileSpec spec = filenameToTileSpec(file.name);
         if (spec.mapId() != mapId)
             continue;
-        QFile::remove(dir.filePath(tileFileName));
+        diskStorage_->remove(file.name);
     }
+    diskCacheChanged_ = true;
+}
+
+/* Unlike clearMapId(), keeps the tiles: they are shown until refreshed, and
+ * those with validators are refreshed with conditional requests */
+void QGeoFileTileCache::expireMapId(int mapId)
+{
+    const QDateTime expired = QDateTime::fromSecsSinceEpoch(0, Qt::UTC);
+    for (const QGeoTileSpec &k : diskCache_.keys()) {
+        if (k.mapId() != mapId)
+            continue;
+        QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(k);
+        if (td)
+            td->validators.expires = expired;
+    }
+    diskCacheChanged_ = true;
 }
 
 void QGeoFileTileCache::setCostStrategyDisk(QAbstractGeoTileCache::CostStrategy costStrategy)
@@ -372,29 +693,218 @@ QAbstractGeoTileCache::CostStrategy QGeoFileTileCache::costStrategyTexture() con
     return costStrategyTexture_;
 }
 
+void QGeoFileTileCache::setDiskSyncPolicy(QGeoFileTileCache::DiskSyncPolicy policy)
+{
+    diskSyncPolicy_ = policy;
+}
+
+QGeoFileTileCache::DiskSyncPolicy QGeoFileTileCache::diskSyncPolicy() const
+{
+    return diskSyncPolicy_;
+}
+
+/*
+    Sets how tiles are kept in the texture cache. Transcoding to \a format is
+    done once per tile, with the decoding. Tiles already in the texture cache
+    are left as they are.
+*/
+void QGeoFileTileCache::setTextureFormat(QGeoFileTileCache::TextureFormat format)
+{
+    textureFormat_ = format;
+}
+
+QGeoFileTileCache::TextureFormat QGeoFileTileCache::textureFormat() const
+{
+    return textureFormat_;
+}
+
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoTileTexture> tt = getFromMemory(spec);
     if (tt)
         return tt;
+    if ((tt = getFromOfflineArchive(spec)))
+        return tt;
     return getFromDisk(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getLoaded(const QGeoTileSpec &spec)
+{
+    return textureCache_.object(spec);
+}
+
+bool QGeoFileTileCache::loadAsync(const QGeoTileSpec &spec)
+{
+    if (pendingLoads_.contains(spec))
+        return true;
+
+    QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
+    if (tm) {
+        startDecode(spec, tm->bytes, tm->format, QImage());
+        return true;
+    }
+
+    // Whether the archive has the tile is only known once it is read in the
+    // pool, the disk cache is read there too when it doesn't
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    if (offlineArchiveCovers(spec)) {
+        QSharedPointer<QGeoCachedTileLoad> load(new QGeoCachedTileLoad);
+        load->spec = spec;
+        load->storage = offlineArchive_.get();
+        load->name = QGeoTileArchive::tileName(spec, offlineArchive_->format());
+        if (td && unwrittenTiles_.value(tileFileName(td->filename)).isNull()) {
+            load->fallbackStorage = diskStorage_.get();
+            load->fallbackName = tileFileName(td->filename);
+        }
+        if (!td || load->fallbackStorage) {
+            scheduleLoad(load);
+            return true;
+        }
+    }
+
+    if (td) {
+        checkFreshness(*td);
+        const QString name = tileFileName(td->filename);
+        const QByteArray unwritten = unwrittenTiles_.value(name);
+        if (!unwritten.isNull())
+            startDecode(spec, unwritten, QGeoTileFormat::fromName(QFileInfo(name).suffix()), QImage());
+        else
+            startLoad(spec, diskStorage_.get(), name);
+        return true;
+    }
+
+    return false;
+}
+
+void QGeoFileTileCache::cancelLoads(const QSet<QGeoTileSpec> &specs)
+{
+    for (const QGeoTileSpec &spec : specs) {
+        QSharedPointer<QGeoCachedTileLoad> load = pendingLoads_.take(spec);
+        if (load)
+            load->cancelled.storeRelaxed(1);
+    }
+}
+
+// Reads the tile from a disk storage and decodes it in the pool
+void QGeoFileTileCache::startLoad(const QGeoTileSpec &spec, QGeoTileDiskStorage *storage,
+                                  const QString &name)
+{
+    QSharedPointer<QGeoCachedTileLoad> load(new QGeoCachedTileLoad);
+    load->spec = spec;
+    load->storage = storage;
+    load->name = name;
+    scheduleLoad(load);
+}
+
+// Decodes tile data that is already in memory in the pool, or only
+// transcodes the decoded image if one is given
+void QGeoFileTileCache::startDecode(const QGeoTileSpec &spec, const QByteArray &bytes,
+                                    QGeoTileFormat format, const QImage &decoded)
+{
+    QSharedPointer<QGeoCachedTileLoad> load(new QGeoCachedTileLoad);
+    load->spec = spec;
+    load->bytes = bytes;
+    load->format = format;
+    load->image = decoded;
+    scheduleLoad(load);
+}
+
+void QGeoFileTileCache::scheduleLoad(const QSharedPointer<QGeoCachedTileLoad> &load)
+{
+    load->textureFormat = textureFormat_;
+    if (metrics_ && metrics_->isEnabled())
+        load->metrics = metrics_;
+    pendingLoads_.insert(load->spec, load);
+
+    // The pool is drained in the destructor, so this outlives every job
+    loadPool_.start([this, load]() {
+        readAndDecodeTile(load.data());
+        QMetaObject::invokeMethod(this, [this, load]() { finishLoad(load); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void QGeoFileTileCache::finishLoad(const QSharedPointer<QGeoCachedTileLoad> &load)
+{
+    // Cancelled, or superseded by a newer load of the same tile
+    auto it = pendingLoads_.find(load->spec);
+    if (it == pendingLoads_.end() || it.value() != load)
+        return;
+    pendingLoads_.erase(it);
+
+    const QGeoTileSpec spec = load->spec;
+    if (load->bytes.isEmpty()) {
+        emit tileLoadFailed(spec);
+        return;
+    }
+
+    // Tiles flagged with "NoRetry" must neither be shown nor fetched again,
+    // get() resolves them to an empty texture
+    if (isTileBogus(load->bytes)) {
+        emit tileLoaded(spec);
+        return;
+    }
+
+    // This is a truly invalid image. The fetcher should try again.
+    if (load->image.isNull() && load->compressed.isNull()) {
+        handleError(spec, QLatin1String("Problem with tile image"));
+        emit tileLoadFailed(spec);
+        return;
+    }
+
+    if (load->fellBack) {
+        if (QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(spec))
+            checkFreshness(*td);
+    }
+    if (load->storage)
+        addToMemoryCache(spec, load->bytes, load->format);
+    addToTextureCache(spec, load->image, load->compressed);
+    emit tileLoaded(spec);
+}
+
+void QGeoFileTileCache::setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(spec);
+    if (!td)
+        return;
+    td->validators = validators;
+    diskCacheChanged_ = true;
+}
+
+// Stale tiles don't count, they are worth fetching again
+qint64 QGeoFileTileCache::diskTileSize(const QGeoTileSpec &spec) const
+{
+    const QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(spec);
+    if (!td || td->validators.isStale())
+        return -1;
+    return td->size;
+}
+
+/* Stale tiles are still served, the engine refreshes them in the background
+ * with a conditional request */
+void QGeoFileTileCache::checkFreshness(const QGeoCachedTileDisk &td)
+{
+    if (td.validators.isStale())
+        emit tileStale(td.spec, td.validators);
+}
+
 void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
                            const QByteArray &bytes,
-                           const QString &format,
+                           QGeoTileFormat format,
                            QAbstractGeoTileCache::CacheAreas areas)
 {
     if (bytes.isEmpty())
         return;
 
     if (areas & QAbstractGeoTileCache::DiskCache) {
-        QString filename = tileSpecToFilename(spec, format, directory_);
+        QString filename = tileSpecToFilename(spec, format.name(), directory_);
         addToDiskCache(spec, filename, bytes);
     }
 
     if (areas & QAbstractGeoTileCache::MemoryCache) {
         addToMemoryCache(spec, bytes, format);
+        // A refreshed tile replaces the decoded copy of the old one
+        textureCache_.remove(spec);
     }
 
     /* inserts do not hit the texture cache -- this actually reduces overall
@@ -469,26 +979,29 @@ QGeoTileSpec QGeoFileTileCache::filenameToTileSpecDefault(const QString &filenam
 
 void QGeoFileTileCache::evictFromDiskCache(QGeoCachedTileDisk *td)
 {
-    QFile::remove(td->filename);
+    if (td->cache) {
+        td->cache->queueDiskWrite({ tileFileName(td->filename), QByteArray(), true });
+        td->cache->diskCacheChanged_ = true;
+    }
 }
 
 void QGeoFileTileCache::evictFromMemoryCache(QGeoCachedTileMemory * /* tm  */)
 {
 }
 
-QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &filename)
+QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &filename, qint64 size)
 {
     QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
     td->spec = spec;
     td->filename = filename;
+    td->size = size;
     td->cache = this;
 
     int cost = 1;
-    if (costStrategyDisk_ == ByteSize) {
-        QFileInfo fi(filename);
-        cost = fi.size();
-    }
+    if (costStrategyDisk_ == ByteSize)
+        cost = size;
     diskCache_.insert(spec, td, cost);
+    diskCacheChanged_ = true;
     return td;
 }
 
@@ -497,6 +1010,7 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
     QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
     td->spec = spec;
     td->filename = filename;
+    td->size = bytes.size();
     td->cache = this;
 
     int cost = 1;
@@ -504,16 +1018,15 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
         cost = bytes.size();
 
     if (diskCache_.insert(spec, td, cost)) {
-        QFile file(filename);
-        file.open(QIODevice::WriteOnly);
-        file.write(bytes);
-        file.close();
+        queueDiskWrite({ tileFileName(filename), bytes });
+        updateNewestTileTimestamp(spec, QDateTime::currentDateTimeUtc());
+        diskCacheChanged_ = true;
         return true;
     }
     return false;
 }
 
-void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
+void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, QGeoTileFormat format)
 {
     if (isTileBogus(bytes))
         return;
@@ -530,15 +1043,34 @@ void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteAr
     memoryCache_.insert(spec, tm, cost);
 }
 
-QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image)
+/*
+    Adds a tile decoded on this thread from bytes. It is served as it is
+    until the pool has converted it to the texture format, the converted
+    tile then replaces it and tileLoaded() is emitted.
+*/
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image,
+                                                                     const QByteArray &bytes, QGeoTileFormat format)
+{
+    QSharedPointer<QGeoTileTexture> tt = addToTextureCache(spec, image, QGeoCompressedTileImage());
+    if (textureFormat_ != TextureArgb32 && !pendingLoads_.contains(spec))
+        startDecode(spec, bytes, format, image);
+    return tt;
+}
+
+// Adds a tile already in the form given by the texture format
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image,
+                                                                     const QGeoCompressedTileImage &compressed)
 {
     QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
     tt->spec = spec;
     tt->image = image;
+    tt->compressed = compressed;
 
     int cost = 1;
-    if (costStrategyTexture_ == ByteSize)
-        cost = image.width() * image.height() * image.depth() / 8;
+    if (costStrategyTexture_ == ByteSize) {
+        cost = compressed.isNull() ? image.width() * image.height() * image.depth() / 8
+                                   : int(compressed.data().size());
+    }
     textureCache_.insert(spec, tt, cost);
 
     return tt;
@@ -557,7 +1089,7 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileS
             handleError(spec, QLatin1String("Problem with tile image"));
             return QSharedPointer<QGeoTileTexture>();
         }
-        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(spec, image);
+        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(spec, image, tm->bytes, tm->format);
         if (tt)
             return tt;
     }
@@ -568,11 +1100,9 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
 {
     QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
     if (td) {
-        const QString format = QFileInfo(td->filename).suffix();
-        QFile file(td->filename);
-        file.open(QIODevice::ReadOnly);
-        QByteArray bytes = file.readAll();
-        file.close();
+        checkFreshness(*td);
+        const QGeoTileFormat format = QGeoTileFormat::fromName(QFileInfo(td->filename).suffix());
+        QByteArray bytes = readFromDisk(tileFileName(td->filename));
 
         QImage image;
         // Some tiles from the servers could be valid images but the tile fetcher
@@ -596,7 +1126,7 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
             image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
 
         addToMemoryCache(spec, bytes, format);
-        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(td->spec, image);
+        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(td->spec, image, bytes, format);
         if (tt)
             return tt;
     }
@@ -604,6 +1134,116 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
     return QSharedPointer<QGeoTileTexture>();
 }
 
+// Whether the archive may have the tile, without looking it up
+bool QGeoFileTileCache::offlineArchiveCovers(const QGeoTileSpec &spec) const
+{
+    if (!offlineArchive_ || (offlineArchiveMapId_ != 0 && spec.mapId() != offlineArchiveMapId_))
+        return false;
+    return spec.zoom() >= offlineArchive_->minimumZoomLevel()
+            && spec.zoom() <= offlineArchive_->maximumZoomLevel();
+}
+
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromOfflineArchive(const QGeoTileSpec &spec)
+{
+    if (!offlineArchiveCovers(spec))
+        return QSharedPointer<QGeoTileTexture>();
+
+    const QByteArray bytes = offlineArchive_->tile(spec.zoom(), spec.x(), spec.y());
+    if (bytes.isEmpty())
+        return QSharedPointer<QGeoTileTexture>();
+    QImage image;
+    if (!image.loadFromData(bytes)) {
+        handleError(spec, QLatin1String("Problem with tile image"));
+        return QSharedPointer<QGeoTileTexture>();
+    }
+    if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const QGeoTileFormat format = QGeoTileFormat::fromName(offlineArchive_->format());
+    addToMemoryCache(spec, bytes, format);
+    return addToTextureCache(spec, image, bytes, format);
+}
+
+// Tiles queued for writing are served from memory until they are on disk
+QByteArray QGeoFileTileCache::readFromDisk(const QString &name) const
+{
+    const QByteArray unwritten = unwrittenTiles_.value(name);
+    if (!unwritten.isNull())
+        return unwritten;
+    return diskStorage_->read(name);
+}
+
+/* Disk writes and removals are queued on the cache thread and handed to the
+ * writer thread in batches, instead of blocking the cache thread on the file
+ * system for every tile. The tile data is implicitly shared all along, from
+ * the reply to the storage, it is never copied. */
+void QGeoFileTileCache::queueDiskWrite(const PendingDiskWrite &write)
+{
+    if (write.remove)
+        unwrittenTiles_.remove(write.name);
+    else
+        unwrittenTiles_.insert(write.name, write.bytes);
+
+    diskWrites_.append(write);
+    diskWritesSize_ += write.bytes.size();
+    if (diskWrites_.size() >= MaxDiskWriteBatchTiles || diskWritesSize_ >= MaxDiskWriteBatchSize)
+        flushDiskWrites();
+    else if (!writeTimer_.isActive())
+        writeTimer_.start();
+}
+
+void QGeoFileTileCache::flushDiskWrites()
+{
+    writeTimer_.stop();
+    if (diskWrites_.isEmpty())
+        return;
+
+    const QList<PendingDiskWrite> batch = std::exchange(diskWrites_, QList<PendingDiskWrite>());
+    diskWritesSize_ = 0;
+    QGeoTileDiskStorage *storage = diskStorage_.get();
+    const DiskSyncPolicy policy = diskSyncPolicy_;
+
+    // The pool is drained in the destructor, so this outlives every job
+    writePool_.start([this, storage, policy, batch]() {
+        for (const PendingDiskWrite &write : batch) {
+            if (write.remove) {
+                storage->remove(write.name);
+                continue;
+            }
+            if (!storage->write(write.name, write.bytes))
+                qWarning() << "Unable to write tile" << write.name;
+            else if (policy == SyncEachTile)
+                storage->sync();
+        }
+        if (policy == SyncEachBatch)
+            storage->sync();
+        else if (policy == NoDiskSync)
+            storage->discardUnsynced();
+        QMetaObject::invokeMethod(this, [this, batch]() { finishDiskWrites(batch); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+// Blocks until everything queued so far is in the storage
+void QGeoFileTileCache::waitForDiskWrites()
+{
+    flushDiskWrites();
+    writePool_.waitForDone();
+    unwrittenTiles_.clear();
+}
+
+void QGeoFileTileCache::finishDiskWrites(const QList<PendingDiskWrite> &batch)
+{
+    for (const PendingDiskWrite &write : batch) {
+        if (write.remove)
+            continue;
+        // Unless the tile was written again since
+        auto it = unwrittenTiles_.find(write.name);
+        if (it != unwrittenTiles_.end() && it.value().constData() == write.bytes.constData())
+            unwrittenTiles_.erase(it);
+    }
+}
+
 bool QGeoFileTileCache::isTileBogus(const QByteArray &bytes) const
 {
     if (bytes.size() == 7 && bytes == QByteArrayLiteral("NoRetry"))
@@ -621,6 +1261,39 @@ QGeoTileSpec QGeoFileTileCache::filenameToTileSpec(const QString &filename) cons
     return filenameToTileSpecDefault(filename);
 }
 
+/*
+    Sets the backend used to store the disk cache. Takes ownership of \a storage.
+    Has to be called before init(), by default every tile is stored in its own file.
+*/
+void QGeoFileTileCache::setDiskStorage(QGeoTileDiskStorage *storage)
+{
+    Q_ASSERT_X(!diskStorage_, Q_FUNC_INFO, "The disk storage can't be changed after init()");
+    diskStorage_.reset(storage);
+}
+
+QGeoTileDiskStorage *QGeoFileTileCache::diskStorage() const
+{
+    return diskStorage_.get();
+}
+
+/*
+    Sets an archive of tiles shipped with the application, served before the
+    disk cache and the network. Tiles read from it are never written to the
+    disk cache. Takes ownership of archive, to be set before any tile is
+    requested. Only tiles of mapId come from the archive, or those of all the
+    map types if mapId is 0.
+*/
+void QGeoFileTileCache::setOfflineArchive(QGeoTileArchive *archive, int mapId)
+{
+    offlineArchive_.reset(archive);
+    offlineArchiveMapId_ = mapId;
+}
+
+QGeoTileArchive *QGeoFileTileCache::offlineArchive() const
+{
+    return offlineArchive_.get();
+}
+
 QString QGeoFileTileCache::directory() const
 {
     return directory_;
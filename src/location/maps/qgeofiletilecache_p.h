@@ -53,9 +53,13 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 
 #include <QObject>
+#include <QHash>
+#include <QThreadPool>
+#include <QTimer>
 #include "qcache3q_p.h"
 
 #include "qabstractgeotilecache_p.h"
+#include "qgeotilediskstorage_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -63,7 +67,9 @@ class QGeoMappingManager;
 
 class QGeoTile;
 class QGeoCachedTileMemory;
+class QGeoCachedTileLoad;
 class QGeoFileTileCache;
+class QGeoTileArchive;
 
 class QImage;
 
@@ -77,6 +83,8 @@ public:
     QGeoTileSpec spec;
     QString filename;
     QString format;
+    qint64 size = 0;
+    QGeoTileValidators validators;
     QGeoFileTileCache *cache = nullptr;
 };
 
@@ -93,6 +101,25 @@ class Q_LOCATION_PRIVATE_EXPORT QGeoFileTileCache : public QAbstractGeoTileCache
 {
     Q_OBJECT
 public:
+    /* When the tiles written to the disk storage are flushed to the device:
+     * left to the OS, after each batch of writes or after every tile */
+    enum DiskSyncPolicy {
+        NoDiskSync,
+        SyncEachBatch,
+        SyncEachTile
+    };
+
+    /* How decoded tiles are kept in the texture cache and handed to the
+     * scene: as ARGB32 images, as RGB565 images taking half the memory, or
+     * block compressed for the GPU, taking an eighth. Tiles with transparent
+     * pixels are always kept as ARGB32 */
+    enum TextureFormat {
+        TextureArgb32,
+        TextureRgb565,
+        TextureBC1,
+        TextureETC2
+    };
+
     QGeoFileTileCache(const QString &directory = QString(), QObject *parent = nullptr);
     ~QGeoFileTileCache();
 
@@ -111,15 +138,29 @@ public:
     int textureUsage() const override;
     void clearAll() override;
     void clearMapId(int mapId);
+    void expireMapId(int mapId);
+    void setDiskStorage(QGeoTileDiskStorage *storage);
+    QGeoTileDiskStorage *diskStorage() const;
+    void setOfflineArchive(QGeoTileArchive *archive, int mapId = 0);
+    QGeoTileArchive *offlineArchive() const;
     void setCostStrategyDisk(CostStrategy costStrategy) override;
     CostStrategy costStrategyDisk() const override;
     void setCostStrategyMemory(CostStrategy costStrategy) override;
     CostStrategy costStrategyMemory() const override;
     void setCostStrategyTexture(CostStrategy costStrategy) override;
     CostStrategy costStrategyTexture() const override;
-
+    void setDiskSyncPolicy(DiskSyncPolicy policy);
+    DiskSyncPolicy diskSyncPolicy() const;
+    void setTextureFormat(TextureFormat format);
+    TextureFormat textureFormat() const;
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    QSharedPointer<QGeoTileTexture> getLoaded(const QGeoTileSpec &spec) override;
+    bool loadAsync(const QGeoTileSpec &spec) override;
+    void cancelLoads(const QSet<QGeoTileSpec> &specs) override;
+    void setTileValidators(const QGeoTileSpec &spec, const QGeoTileValidators &validators) override;
+    qint64 diskTileSize(const QGeoTileSpec &spec) const override;
+    void collectMetrics(QGeoTileMetrics::Snapshot *snapshot) const override;
 
     // can be called without a specific tileCache pointer
     static void evictFromDiskCache(QGeoCachedTileDisk *td);
@@ -127,7 +168,7 @@ public:
 
     void insert(const QGeoTileSpec &spec,
                 const QByteArray &bytes,
-                const QString &format,
+                QGeoTileFormat format,
                 QAbstractGeoTileCache::CacheAreas areas = QAbstractGeoTileCache::AllCaches) override;
 
     static QString tileSpecToFilenameDefault(const QGeoTileSpec &spec, const QString &format, const QString &directory);
@@ -137,26 +178,74 @@ protected:
     void init() override;
     void printStats() override;
     void loadTiles();
+    QString manifestFilename() const;
+    bool saveDiskCacheManifest(bool clean);
+    bool restoreDiskCacheManifest();
+    void updateNewestTileTimestamp(const QGeoTileSpec &spec, const QDateTime &lastModified);
 
     QString directory() const;
 
-    QSharedPointer<QGeoCachedTileDisk> addToDiskCache(const QGeoTileSpec &spec, const QString &filename);
+    QSharedPointer<QGeoCachedTileDisk> addToDiskCache(const QGeoTileSpec &spec, const QString &filename, qint64 size);
     bool addToDiskCache(const QGeoTileSpec &spec, const QString &filename, const QByteArray &bytes);
-    void addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
-    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image);
+    void addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, QGeoTileFormat format);
+    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image,
+                                                      const QByteArray &bytes, QGeoTileFormat format);
+    QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image,
+                                                      const QGeoCompressedTileImage &compressed);
     QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> getFromDisk(const QGeoTileSpec &spec);
+    void checkFreshness(const QGeoCachedTileDisk &td);
+    bool offlineArchiveCovers(const QGeoTileSpec &spec) const;
+    QSharedPointer<QGeoTileTexture> getFromOfflineArchive(const QGeoTileSpec &spec);
+    void startLoad(const QGeoTileSpec &spec, QGeoTileDiskStorage *storage, const QString &name);
+    void startDecode(const QGeoTileSpec &spec, const QByteArray &bytes, QGeoTileFormat format,
+                     const QImage &decoded);
+    void scheduleLoad(const QSharedPointer<QGeoCachedTileLoad> &load);
+    void finishLoad(const QSharedPointer<QGeoCachedTileLoad> &load);
+
+    struct PendingDiskWrite
+    {
+        QString name;
+        QByteArray bytes;
+        bool remove = false;
+    };
+    QByteArray readFromDisk(const QString &name) const;
+    void queueDiskWrite(const PendingDiskWrite &write);
+    void flushDiskWrites();
+    void waitForDiskWrites();
+    void finishDiskWrites(const QList<PendingDiskWrite> &batch);
 
     virtual bool isTileBogus(const QByteArray &bytes) const;
     virtual QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const;
     virtual QGeoTileSpec filenameToTileSpec(const QString &filename) const;
 
+    std::unique_ptr<QGeoTileDiskStorage> diskStorage_;
+    std::unique_ptr<QGeoTileArchive> offlineArchive_;
+    int offlineArchiveMapId_ = 0; // 0 for all the map types
     QCache3Q<QGeoTileSpec, QGeoCachedTileDisk, QCache3QTileEvictionPolicy> diskCache_;
     QCache3Q<QGeoTileSpec, QGeoCachedTileMemory> memoryCache_;
     QCache3Q<QGeoTileSpec, QGeoTileTexture> textureCache_;
 
     QString directory_;
 
+    QThreadPool loadPool_;
+    QHash<QGeoTileSpec, QSharedPointer<QGeoCachedTileLoad>> pendingLoads_;
+
+    QTimer manifestTimer_;
+    bool diskCacheChanged_ = false;
+    // When the newest tile of each map id was written, kept in the manifest
+    QHash<int, QDateTime> newestTileTimestamps_;
+
+    // Disk writes are queued, then handed to a single writer thread in batches.
+    // Until written, a tile is read back from unwrittenTiles_
+    QList<PendingDiskWrite> diskWrites_;
+    qint64 diskWritesSize_ = 0;
+    QHash<QString, QByteArray> unwrittenTiles_;
+    QThreadPool writePool_;
+    QTimer writeTimer_;
+    DiskSyncPolicy diskSyncPolicy_ = NoDiskSync;
+
+    TextureFormat textureFormat_ = TextureArgb32;
     int minTextureUsage_ = 0;
     int extraTextureUsage_ = 0;
     CostStrategy costStrategyDisk_ = ByteSize;
@@ -0,0 +1,712 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeojsonimporter_p.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const int maxGeometryDepth = 32;
+
+/* A single pass reader working on the raw document bytes. Instead of building
+   a QJsonDocument and a QVariant tree of the whole file, features are read one
+   at a time straight into QGeoCoordinate lists and handed to the sink. Members
+   of an object may come in any order, so the geometry of a feature and the
+   coordinates of a geometry are only located in the first pass over the object
+   and read once it is known what they contain. Like QGeoJson::importGeoJson
+   this does little validation beyond what is needed to find its way. */
+class GeoJsonReader
+{
+public:
+    GeoJsonReader(QByteArrayView data, const QGeoJsonImporter::Sink &sink)
+        : begin_(data.data()), p_(data.data()), end_(data.data() + data.size()), sink_(sink)
+    {
+    }
+
+    bool readDocument();
+    QString errorString() const { return error_; }
+
+private:
+    bool fail(const QString &what);
+    void skipWhitespace();
+    bool consume(char c);
+    bool expect(char c);
+    bool readRawString(QByteArrayView *out);
+    bool readString(QString *out);
+    bool readNumber(double *out);
+    bool readId(QVariant *out);
+    bool skipValue();
+    template <typename F> bool readObject(F member);
+    template <typename F> bool readArray(F element);
+
+    bool readPosition(QGeoCoordinate *out);
+    bool readPositions(QList<QGeoCoordinate> *out);
+    bool readPolygon(QGeoPolygon *out);
+    bool readCoordinates(QByteArrayView type, const QGeoJsonFeature &feature);
+    bool readGeometry(const QGeoJsonFeature &feature, int depth);
+    bool readFeature();
+    bool emitPart(const QGeoJsonFeature &feature, const QString &type, const QGeoShape &shape);
+
+    const char *begin_;
+    const char *p_;
+    const char *end_;
+    const QGeoJsonImporter::Sink &sink_;
+    qsizetype featureCount_ = 0;
+    QString error_;
+};
+
+bool GeoJsonReader::fail(const QString &what)
+{
+    if (error_.isEmpty())
+        error_ = QStringLiteral("GeoJSON: %1 at offset %2").arg(what).arg(p_ - begin_);
+    return false;
+}
+
+void GeoJsonReader::skipWhitespace()
+{
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t'))
+        ++p_;
+}
+
+bool GeoJsonReader::consume(char c)
+{
+    skipWhitespace();
+    if (p_ < end_ && *p_ == c) {
+        ++p_;
+        return true;
+    }
+    return false;
+}
+
+bool GeoJsonReader::expect(char c)
+{
+    return consume(c) || fail(QStringLiteral("expected '%1'").arg(QLatin1Char(c)));
+}
+
+// The string as it is in the document, escapes included
+bool GeoJsonReader::readRawString(QByteArrayView *out)
+{
+    skipWhitespace();
+    if (p_ >= end_ || *p_ != '"')
+        return fail(QStringLiteral("expected a string"));
+    const char *start = ++p_;
+    while (p_ < end_) {
+        if (*p_ == '\\') {
+            p_ += 2;
+        } else if (*p_ == '"') {
+            *out = QByteArrayView(start, p_ - start);
+            ++p_;
+            return true;
+        } else {
+            ++p_;
+        }
+    }
+    p_ = end_;
+    return fail(QStringLiteral("unterminated string"));
+}
+
+bool GeoJsonReader::readString(QString *out)
+{
+    QByteArrayView raw;
+    if (!readRawString(&raw))
+        return false;
+    if (!std::memchr(raw.data(), '\\', raw.size())) {
+        *out = QString::fromUtf8(raw);
+        return true;
+    }
+
+    QString result;
+    result.reserve(raw.size());
+    const char *q = raw.data();
+    const char *end = q + raw.size();
+    const char *chunk = q;
+    while (q < end) {
+        if (*q != '\\') {
+            ++q;
+            continue;
+        }
+        result += QString::fromUtf8(chunk, q - chunk);
+        if (++q == end)
+            return fail(QStringLiteral("invalid escape sequence"));
+        switch (*q) {
+        case 'b': result += QLatin1Char('\b'); break;
+        case 'f': result += QLatin1Char('\f'); break;
+        case 'n': result += QLatin1Char('\n'); break;
+        case 'r': result += QLatin1Char('\r'); break;
+        case 't': result += QLatin1Char('\t'); break;
+        case 'u': {
+            bool ok = false;
+            const ushort unit = end - q > 4 ? QByteArrayView(q + 1, 4).toUShort(&ok, 16) : 0;
+            if (!ok)
+                return fail(QStringLiteral("invalid escape sequence"));
+            // Surrogate pairs come as two escapes and end up next to each other
+            result += QChar(unit);
+            q += 4;
+            break;
+        }
+        default:
+            result += QLatin1Char(*q);
+            break;
+        }
+        chunk = ++q;
+    }
+    result += QString::fromUtf8(chunk, end - chunk);
+    *out = result;
+    return true;
+}
+
+bool GeoJsonReader::readNumber(double *out)
+{
+    skipWhitespace();
+    const char *start = p_;
+    while (p_ < end_ && ((*p_ >= '0' && *p_ <= '9') || *p_ == '-' || *p_ == '+'
+                         || *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+        ++p_;
+    }
+    bool ok = false;
+    if (p_ != start)
+        *out = QByteArrayView(start, p_ - start).toDouble(&ok);
+    return ok || fail(QStringLiteral("expected a number"));
+}
+
+// Matches what QJsonValue::toVariant() gives for the feature id
+bool GeoJsonReader::readId(QVariant *out)
+{
+    skipWhitespace();
+    if (p_ < end_ && *p_ == '"') {
+        QString id;
+        if (!readString(&id))
+            return false;
+        *out = id;
+        return true;
+    }
+    if (p_ < end_ && *p_ == 'n') {
+        *out = QVariant::fromValue(nullptr);
+        return skipValue();
+    }
+
+    const char *start = p_;
+    double number;
+    if (!readNumber(&number))
+        return false;
+    const QByteArrayView text(start, p_ - start);
+    bool isInteger = false;
+    const qlonglong integer = text.toLongLong(&isInteger);
+    *out = isInteger ? QVariant(integer) : QVariant(number);
+    return true;
+}
+
+bool GeoJsonReader::skipValue()
+{
+    skipWhitespace();
+    if (p_ >= end_)
+        return fail(QStringLiteral("unexpected end of data"));
+
+    QByteArrayView string;
+    if (*p_ == '"')
+        return readRawString(&string);
+
+    if (*p_ != '{' && *p_ != '[') {
+        // Number, true, false or null
+        const char *start = p_;
+        while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ']' && *p_ != ' '
+               && *p_ != '\n' && *p_ != '\r' && *p_ != '\t') {
+            ++p_;
+        }
+        return p_ != start || fail(QStringLiteral("expected a value"));
+    }
+
+    int depth = 0;
+    while (p_ < end_) {
+        switch (*p_) {
+        case '"':
+            if (!readRawString(&string))
+                return false;
+            continue;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0) {
+                ++p_;
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+        ++p_;
+    }
+    return fail(QStringLiteral("unexpected end of data"));
+}
+
+template <typename F>
+bool GeoJsonReader::readObject(F member)
+{
+    if (!expect('{'))
+        return false;
+    if (consume('}'))
+        return true;
+    do {
+        QByteArrayView key;
+        if (!readRawString(&key) || !expect(':') || !member(key))
+            return false;
+    } while (consume(','));
+    return expect('}');
+}
+
+template <typename F>
+bool GeoJsonReader::readArray(F element)
+{
+    if (!expect('['))
+        return false;
+    if (consume(']'))
+        return true;
+    do {
+        if (!element())
+            return false;
+    } while (consume(','));
+    return expect(']');
+}
+
+bool GeoJsonReader::readPosition(QGeoCoordinate *out)
+{
+    int i = 0;
+    return readArray([&]() {
+        double value;
+        if (!readNumber(&value))
+            return false;
+        switch (i++) {
+        case 0:
+            out->setLongitude(value);
+            break;
+        case 1:
+            out->setLatitude(value);
+            break;
+        case 2:
+            out->setAltitude(value);
+            break;
+        default:
+            break;
+        }
+        return true;
+    });
+}
+
+bool GeoJsonReader::readPositions(QList<QGeoCoordinate> *out)
+{
+    return readArray([&]() {
+        QGeoCoordinate position;
+        if (!readPosition(&position))
+            return false;
+        out->append(position);
+        return true;
+    });
+}
+
+bool GeoJsonReader::readPolygon(QGeoPolygon *out)
+{
+    bool perimeter = true;
+    return readArray([&]() {
+        QList<QGeoCoordinate> ring;
+        if (!readPositions(&ring))
+            return false;
+        if (perimeter)
+            out->setPerimeter(ring);
+        else
+            out->addHole(ring);
+        perimeter = false;
+        return true;
+    });
+}
+
+bool GeoJsonReader::emitPart(const QGeoJsonFeature &feature, const QString &type,
+                             const QGeoShape &shape)
+{
+    QGeoJsonFeature part = feature;
+    part.type = type;
+    part.geometry = shape;
+    return sink_(std::move(part), p_ - begin_);
+}
+
+bool GeoJsonReader::readCoordinates(QByteArrayView type, const QGeoJsonFeature &feature)
+{
+    const QString point = QStringLiteral("Point");
+    const QString lineString = QStringLiteral("LineString");
+    const QString polygon = QStringLiteral("Polygon");
+
+    const auto readPoint = [&]() {
+        QGeoCoordinate center;
+        return readPosition(&center) && emitPart(feature, point, QGeoCircle(center));
+    };
+    const auto readLineString = [&]() {
+        QList<QGeoCoordinate> path;
+        return readPositions(&path) && emitPart(feature, lineString, QGeoPath(path));
+    };
+    const auto readSinglePolygon = [&]() {
+        QGeoPolygon shape;
+        return readPolygon(&shape) && emitPart(feature, polygon, shape);
+    };
+
+    if (type == "Point")
+        return readPoint();
+    if (type == "MultiPoint")
+        return readArray(readPoint);
+    if (type == "LineString")
+        return readLineString();
+    if (type == "MultiLineString")
+        return readArray(readLineString);
+    if (type == "Polygon")
+        return readSinglePolygon();
+    if (type == "MultiPolygon")
+        return readArray(readSinglePolygon);
+    return true; // Unknown geometries are ignored, as in QGeoJson::importGeoJson
+}
+
+bool GeoJsonReader::readGeometry(const QGeoJsonFeature &feature, int depth)
+{
+    skipWhitespace();
+    if (p_ < end_ && *p_ == 'n')
+        return skipValue(); // "geometry": null
+    if (depth > maxGeometryDepth)
+        return fail(QStringLiteral("geometry collections nested too deep"));
+
+    QByteArrayView type;
+    const char *coordinates = nullptr;
+    const char *geometries = nullptr;
+    const bool ok = readObject([&](QByteArrayView key) {
+        if (key == "type")
+            return readRawString(&type);
+        skipWhitespace();
+        if (key == "coordinates")
+            coordinates = p_;
+        else if (key == "geometries")
+            geometries = p_;
+        return skipValue();
+    });
+    if (!ok)
+        return false;
+
+    const char *end = p_;
+    if (type == "GeometryCollection") {
+        if (geometries) {
+            p_ = geometries;
+            if (!readArray([&]() { return readGeometry(feature, depth + 1); }))
+                return false;
+        }
+    } else if (coordinates) {
+        p_ = coordinates;
+        if (!readCoordinates(type, feature))
+            return false;
+    }
+    p_ = end;
+    return true;
+}
+
+bool GeoJsonReader::readFeature()
+{
+    QGeoJsonFeature feature;
+    feature.featureIndex = featureCount_++;
+    const char *geometry = nullptr;
+    const bool ok = readObject([&](QByteArrayView key) {
+        if (key == "id")
+            return readId(&feature.id);
+        skipWhitespace();
+        const char *start = p_;
+        if (key == "geometry")
+            geometry = start;
+        if (!skipValue())
+            return false;
+        if (key == "properties")
+            feature.rawProperties = QByteArray(start, p_ - start);
+        return true;
+    });
+    if (!ok)
+        return false;
+
+    if (geometry) {
+        const char *end = p_;
+        p_ = geometry;
+        if (!readGeometry(feature, 0))
+            return false;
+        p_ = end;
+    }
+    return true;
+}
+
+bool GeoJsonReader::readDocument()
+{
+    skipWhitespace();
+    const char *start = p_;
+
+    // Features of a collection are read as they come, everything else once the
+    // type of the root object is known
+    QByteArrayView type;
+    const bool ok = readObject([&](QByteArrayView key) {
+        if (key == "type")
+            return readRawString(&type);
+        if (key == "features")
+            return readArray([this]() { return readFeature(); });
+        return skipValue();
+    });
+    if (!ok)
+        return false;
+    if (type.isEmpty())
+        return fail(QStringLiteral("missing GeoJSON type"));
+
+    const char *end = p_;
+    if (type == "Feature") {
+        p_ = start;
+        if (!readFeature())
+            return false;
+    } else if (type != "FeatureCollection") {
+        p_ = start;
+        QGeoJsonFeature feature;
+        feature.featureIndex = featureCount_++;
+        if (!readGeometry(feature, 0))
+            return false;
+    }
+    p_ = end;
+
+    skipWhitespace();
+    return p_ == end_ || fail(QStringLiteral("unexpected data after the root object"));
+}
+
+} // namespace
+
+QVariantMap QGeoJsonFeature::properties() const
+{
+    return QJsonDocument::fromJson(rawProperties).object().toVariantMap();
+}
+
+QVariantMap QGeoJsonFeature::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("type"), type);
+    switch (geometry.type()) {
+    case QGeoShape::CircleType:
+        map.insert(QStringLiteral("data"), QVariant::fromValue(QGeoCircle(geometry)));
+        break;
+    case QGeoShape::PathType:
+        map.insert(QStringLiteral("data"), QVariant::fromValue(QGeoPath(geometry)));
+        break;
+    case QGeoShape::PolygonType:
+        map.insert(QStringLiteral("data"), QVariant::fromValue(QGeoPolygon(geometry)));
+        break;
+    default:
+        break;
+    }
+    if (!rawProperties.isNull())
+        map.insert(QStringLiteral("properties"), properties());
+    if (id.isValid())
+        map.insert(QStringLiteral("id"), id);
+    return map;
+}
+
+/* Imports GeoJSON documents in a worker thread and delivers the features in
+   batches through featuresImported(), followed by finished() or
+   errorOccurred(). Starting a new import or calling cancel() drops whatever is
+   still in flight for the previous one. */
+QGeoJsonImporter::QGeoJsonImporter(QObject *parent)
+    : QObject(parent)
+{
+    pool_.setMaxThreadCount(1);
+}
+
+QGeoJsonImporter::~QGeoJsonImporter()
+{
+    cancel();
+    pool_.clear();
+    pool_.waitForDone();
+}
+
+void QGeoJsonImporter::setBatchSize(int features)
+{
+    batchSize_ = qMax(1, features);
+}
+
+int QGeoJsonImporter::batchSize() const
+{
+    return batchSize_;
+}
+
+void QGeoJsonImporter::importFile(const QString &fileName)
+{
+    start(fileName, QByteArray());
+}
+
+void QGeoJsonImporter::importData(const QByteArray &data)
+{
+    start(QString(), data);
+}
+
+void QGeoJsonImporter::cancel()
+{
+    generation_.fetchAndAddRelaxed(1);
+    running_ = false;
+}
+
+bool QGeoJsonImporter::isRunning() const
+{
+    return running_;
+}
+
+void QGeoJsonImporter::start(const QString &fileName, const QByteArray &data)
+{
+    const int generation = generation_.fetchAndAddRelaxed(1) + 1;
+    const int batchSize = batchSize_;
+    running_ = true;
+    // The pool is drained in the destructor, so this outlives every job
+    pool_.start([this, generation, fileName, data, batchSize]() {
+        run(generation, fileName, data, batchSize);
+    });
+}
+
+// Runs in the pool
+void QGeoJsonImporter::run(int generation, const QString &fileName, QByteArray data, int batchSize)
+{
+    if (generation != generation_.loadRelaxed())
+        return;
+
+    // Results of an import that has been cancelled or replaced in the meantime
+    // are dropped on arrival
+    const auto post = [this, generation](auto function) {
+        QMetaObject::invokeMethod(this, [this, generation, function]() {
+            if (generation == generation_.loadRelaxed())
+                function();
+        }, Qt::QueuedConnection);
+    };
+
+    QFile file;
+    QByteArrayView view = data;
+    if (!fileName.isEmpty()) {
+        file.setFileName(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            const QString message = file.errorString();
+            post([this, message]() {
+                running_ = false;
+                emit errorOccurred(message);
+            });
+            return;
+        }
+        if (const uchar *mapped = file.map(0, file.size())) {
+            view = QByteArrayView(mapped, file.size());
+        } else {
+            data = file.readAll();
+            view = data;
+        }
+    }
+
+    const qint64 total = view.size();
+    QList<QGeoJsonFeature> batch;
+    batch.reserve(batchSize);
+    const auto flush = [&](qint64 bytesRead) {
+        post([this, features = std::move(batch), bytesRead, total]() {
+            emit featuresImported(features);
+            emit progressChanged(bytesRead, total);
+        });
+        batch = QList<QGeoJsonFeature>();
+        batch.reserve(batchSize);
+    };
+
+    QString errorString;
+    qint64 bytesRead = 0;
+    const bool ok = read(view, [&](QGeoJsonFeature &&feature, qint64 offset) {
+        if (generation != generation_.loadRelaxed())
+            return false;
+        bytesRead = offset;
+        batch.append(std::move(feature));
+        if (batch.size() >= batchSize)
+            flush(bytesRead);
+        return true;
+    }, &errorString);
+
+    if (ok) {
+        if (!batch.isEmpty())
+            flush(total);
+        post([this, total]() {
+            running_ = false;
+            emit progressChanged(total, total);
+            emit finished();
+        });
+    } else if (!errorString.isEmpty()) {
+        if (!batch.isEmpty())
+            flush(bytesRead);
+        post([this, errorString]() {
+            running_ = false;
+            emit errorOccurred(errorString);
+        });
+    }
+}
+
+/* Returns false if the document could not be read, with the reason in
+   errorString, or if the sink asked to stop, with errorString left empty. */
+bool QGeoJsonImporter::read(QByteArrayView data, const Sink &sink, QString *errorString)
+{
+    GeoJsonReader reader(data, sink);
+    const bool ok = reader.readDocument();
+    if (errorString)
+        *errorString = reader.errorString();
+    return ok;
+}
+
+QList<QGeoJsonFeature> QGeoJsonImporter::readAll(QByteArrayView data, QString *errorString)
+{
+    QList<QGeoJsonFeature> features;
+    read(data, [&features](QGeoJsonFeature &&feature, qint64) {
+        features.append(std::move(feature));
+        return true;
+    }, errorString);
+    return features;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOJSONIMPORTER_P_H
+#define QGEOJSONIMPORTER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/QGeoShape>
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QVariant>
+#include <QtCore/QThreadPool>
+#include <QtCore/QAtomicInt>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+/* One simple geometry read from a GeoJSON document. Multi geometries and
+   geometry collections are flattened, so every part of a feature becomes its
+   own QGeoJsonFeature sharing the featureIndex, id and properties of the
+   feature it came from. The properties are kept as JSON text and only turned
+   into a QVariantMap when asked for. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoJsonFeature
+{
+public:
+    QVariantMap properties() const;
+
+    // Same layout as a feature in the list returned by QGeoJson::importGeoJson
+    QVariantMap toVariantMap() const;
+
+    QString type;           // "Point", "LineString" or "Polygon"
+    QGeoShape geometry;     // QGeoCircle, QGeoPath or QGeoPolygon
+    QVariant id;
+    qsizetype featureIndex = -1;
+    QByteArray rawProperties;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoJsonImporter : public QObject
+{
+    Q_OBJECT
+public:
+    using Sink = std::function<bool(QGeoJsonFeature &&feature, qint64 bytesRead)>;
+
+    explicit QGeoJsonImporter(QObject *parent = nullptr);
+    ~QGeoJsonImporter();
+
+    void setBatchSize(int features);
+    int batchSize() const;
+
+    void importFile(const QString &fileName);
+    void importData(const QByteArray &data);
+    void cancel();
+    bool isRunning() const;
+
+    // Parses data in the calling thread. The sink returns false to stop.
+    static bool read(QByteArrayView data, const Sink &sink, QString *errorString = nullptr);
+    static QList<QGeoJsonFeature> readAll(QByteArrayView data, QString *errorString = nullptr);
+
+Q_SIGNALS:
+    void featuresImported(const QList<QGeoJsonFeature> &features);
+    void progressChanged(qint64 bytesRead, qint64 bytesTotal);
+    void finished();
+    void errorOccurred(const QString &errorString);
+
+private:
+    void start(const QString &fileName, const QByteArray &data);
+    void run(int generation, const QString &fileName, QByteArray data, int batchSize);
+
+    QThreadPool pool_;
+    QAtomicInt generation_;
+    bool running_ = false;
+    int batchSize_ = 256;
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoJsonFeature)
+
+#endif // QGEOJSONIMPORTER_P_H
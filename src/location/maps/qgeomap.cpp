@@ -219,11 +219,47 @@ void QGeoMap::prefetchData()
 
 }
 
+/*!
+    \internal
+    Hint that the camera is animated towards \a target, which it reaches in
+    \a msecs milliseconds, so that data along the way can be fetched ahead.
+*/
+void QGeoMap::prefetchCameraTarget(const QGeoCameraData &target, int msecs)
+{
+    Q_UNUSED(target);
+    Q_UNUSED(msecs);
+}
+
 void QGeoMap::clearData()
 {
 
 }
 
+/*!
+    \internal
+    Turns the collection of the performance metrics of the map data on or
+    off. Maps without metrics ignore it.
+*/
+void QGeoMap::setMetricsEnabled(bool enabled)
+{
+    Q_UNUSED(enabled);
+}
+
+bool QGeoMap::metricsEnabled() const
+{
+    return false;
+}
+
+/*!
+    \internal
+    Returns the performance metrics of the map data, empty if the map has
+    none.
+*/
+QVariantMap QGeoMap::metrics() const
+{
+    return QVariantMap();
+}
+
 QGeoMap::ItemTypes QGeoMap::supportedMapItemTypes() const
 {
     Q_D(const QGeoMap);
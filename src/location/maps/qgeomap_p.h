@@ -53,6 +53,7 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtCore/QObject>
+#include <QtCore/QVariantMap>
 #include <QTransform>
 
 QT_BEGIN_NAMESPACE
@@ -130,8 +131,13 @@ public:
     const QGeoProjection &geoProjection() const;
 
     virtual void prefetchData();
+    virtual void prefetchCameraTarget(const QGeoCameraData &target, int msecs);
     virtual void clearData();
 
+    virtual void setMetricsEnabled(bool enabled);
+    virtual bool metricsEnabled() const;
+    virtual QVariantMap metrics() const;
+
     ItemTypes supportedMapItemTypes() const;
 
     void addMapItem(QDeclarativeGeoMapItemBase *item);
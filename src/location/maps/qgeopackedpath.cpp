@@ -0,0 +1,257 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeopackedpath_p.h"
+
+#include <QtPositioning/QGeoRectangle>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+static void appendValues(QList<double> &list, const double *values, qsizetype count)
+{
+    const qsizetype size = list.size();
+    list.resize(size + count);
+    std::copy_n(values, count, list.data() + size);
+}
+
+QGeoPackedPath::QGeoPackedPath(const QList<QGeoCoordinate> &path)
+{
+    reserve(path.size());
+    for (const QGeoCoordinate &coordinate : path)
+        append(coordinate);
+}
+
+double QGeoPackedPath::altitude(qsizetype i) const
+{
+    if (d_->altitudes.isEmpty())
+        return qQNaN();
+    return d_->altitudes.at(offset_ + i);
+}
+
+// Through the setters, which keep each component as it was even if the
+// coordinate is not valid
+QGeoCoordinate QGeoPackedPath::at(qsizetype i) const
+{
+    QGeoCoordinate coordinate;
+    coordinate.setLatitude(latitude(i));
+    coordinate.setLongitude(longitude(i));
+    if (!d_->altitudes.isEmpty())
+        coordinate.setAltitude(altitude(i));
+    return coordinate;
+}
+
+const double *QGeoPackedPath::constData() const
+{
+    return d_ ? d_->coordinates.constData() + 2 * offset_ : nullptr;
+}
+
+void QGeoPackedPath::reserve(qsizetype size)
+{
+    if (!isAppendable())
+        detach(size);
+    else
+        d_->coordinates.reserve(2 * (offset_ + size));
+}
+
+void QGeoPackedPath::append(double latitude, double longitude)
+{
+    if (!isAppendable())
+        detach(size_ + 1);
+    d_->coordinates.append(latitude);
+    d_->coordinates.append(longitude);
+    if (!d_->altitudes.isEmpty())
+        d_->altitudes.append(qQNaN());
+    ++size_;
+}
+
+void QGeoPackedPath::append(const QGeoCoordinate &coordinate)
+{
+    append(coordinate.latitude(), coordinate.longitude());
+    const double alt = coordinate.altitude();
+    if (qIsNaN(alt))
+        return;
+    if (d_->altitudes.isEmpty())
+        d_->altitudes.fill(qQNaN(), d_->coordinates.size() / 2);
+    d_->altitudes.last() = alt;
+}
+
+void QGeoPackedPath::append(const QGeoPackedPath &other)
+{
+    if (other.isEmpty())
+        return;
+    if (isEmpty() && !d_) {
+        *this = other;
+        return;
+    }
+    if (&other == this) {
+        const QGeoPackedPath copy = other;
+        append(copy);
+        return;
+    }
+    if (!isAppendable())
+        detach(size_ + other.size_);
+    appendValues(d_->coordinates, other.constData(), 2 * other.size_);
+    if (!other.d_->altitudes.isEmpty()) {
+        if (d_->altitudes.isEmpty())
+            d_->altitudes.fill(qQNaN(), d_->coordinates.size() / 2 - other.size_);
+        appendValues(d_->altitudes, other.d_->altitudes.constData() + other.offset_, other.size_);
+    } else if (!d_->altitudes.isEmpty()) {
+        d_->altitudes.insert(d_->altitudes.size(), other.size_, qQNaN());
+    }
+    size_ += other.size_;
+}
+
+void QGeoPackedPath::clear()
+{
+    d_.reset();
+    offset_ = 0;
+    size_ = 0;
+}
+
+QGeoPackedPath QGeoPackedPath::mid(qsizetype position, qsizetype length) const
+{
+    position = qBound<qsizetype>(0, position, size_);
+    if (length < 0 || position + length > size_)
+        length = size_ - position;
+
+    QGeoPackedPath range;
+    if (length == 0)
+        return range;
+    range.d_ = d_;
+    range.offset_ = offset_ + position;
+    range.size_ = length;
+    return range;
+}
+
+QList<QGeoCoordinate> QGeoPackedPath::toList() const
+{
+    QList<QGeoCoordinate> path;
+    path.reserve(size_);
+    for (qsizetype i = 0; i < size_; ++i)
+        path.append(at(i));
+    return path;
+}
+
+/*
+    Same bounds as QGeoPath computes: longitudes are unwrapped along the
+    path, so that a path crossing the dateline gets the narrow box.
+*/
+QGeoRectangle QGeoPackedPath::boundingGeoRectangle() const
+{
+    if (isEmpty())
+        return QGeoRectangle();
+
+    double minLatitude = latitude(0);
+    double maxLatitude = minLatitude;
+    double deltaX = 0.0;
+    double minX = 0.0;
+    double maxX = 0.0;
+    qsizetype minIndex = 0;
+    qsizetype maxIndex = 0;
+    for (qsizetype i = 1; i < size_; ++i) {
+        const double from = longitude(i - 1);
+        double to = longitude(i);
+        double delta = to - from;
+        if (qAbs(delta) > 180.0) {
+            to += to > 0.0 ? -360.0 : 360.0;
+            delta = to - from;
+        }
+        deltaX += delta;
+        if (deltaX < minX) {
+            minX = deltaX;
+            minIndex = i;
+        }
+        if (deltaX > maxX) {
+            maxX = deltaX;
+            maxIndex = i;
+        }
+        minLatitude = qMin(minLatitude, latitude(i));
+        maxLatitude = qMax(maxLatitude, latitude(i));
+    }
+    return QGeoRectangle(QGeoCoordinate(maxLatitude, longitude(minIndex)),
+                         QGeoCoordinate(minLatitude, longitude(maxIndex)));
+}
+
+bool QGeoPackedPath::equals(const QGeoPackedPath &other) const
+{
+    if (size_ != other.size_)
+        return false;
+    if (size_ == 0 || (d_ == other.d_ && offset_ == other.offset_))
+        return true;
+
+    const double *lhs = constData();
+    const double *rhs = other.constData();
+    const bool altitudes = !d_->altitudes.isEmpty() || !other.d_->altitudes.isEmpty();
+    for (qsizetype i = 0; i < size_; ++i) {
+        // Identical values are equal coordinates, anything else is compared
+        // the fuzzy way QGeoCoordinate does
+        if (lhs[2 * i] == rhs[2 * i] && lhs[2 * i + 1] == rhs[2 * i + 1]
+                && (!altitudes || altitude(i) == other.altitude(i))) {
+            continue;
+        }
+        if (at(i) != other.at(i))
+            return false;
+    }
+    return true;
+}
+
+// Whether this range ends the buffer and owns it, so that appending is safe
+bool QGeoPackedPath::isAppendable() const
+{
+    return d_ && d_->ref.loadRelaxed() == 1 && 2 * (offset_ + size_) == d_->coordinates.size();
+}
+
+// Moves the range to a buffer of its own, with room for capacity coordinates
+void QGeoPackedPath::detach(qsizetype capacity)
+{
+    QExplicitlySharedDataPointer<Data> d(new Data);
+    d->coordinates.reserve(2 * qMax(capacity, size_));
+    if (d_) {
+        appendValues(d->coordinates, constData(), 2 * size_);
+        if (!d_->altitudes.isEmpty())
+            appendValues(d->altitudes, d_->altitudes.constData() + offset_, size_);
+    }
+    d_ = d;
+    offset_ = 0;
+}
+
+QT_END_NAMESPACE
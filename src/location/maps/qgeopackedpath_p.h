@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOPACKEDPATH_P_H
+#define QGEOPACKEDPATH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QList>
+#include <QtCore/QSharedData>
+#include <QtPositioning/QGeoCoordinate>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRectangle;
+
+/* The coordinates of a path packed in one contiguous buffer of latitude,
+ * longitude pairs, instead of a list of individually allocated
+ * QGeoCoordinates. Copies and mid() share the buffer, which is how the
+ * segments and legs of a route are ranges of the path of the route.
+ * Altitudes are only stored if a coordinate has one. Appending to a range
+ * that is shared, or that does not end the buffer, copies it first */
+class Q_LOCATION_PRIVATE_EXPORT QGeoPackedPath
+{
+public:
+    QGeoPackedPath() = default;
+    explicit QGeoPackedPath(const QList<QGeoCoordinate> &path);
+
+    qsizetype size() const { return size_; }
+    bool isEmpty() const { return size_ == 0; }
+
+    double latitude(qsizetype i) const { return d_->coordinates.at(2 * (offset_ + i)); }
+    double longitude(qsizetype i) const { return d_->coordinates.at(2 * (offset_ + i) + 1); }
+    double altitude(qsizetype i) const;
+    QGeoCoordinate at(qsizetype i) const;
+    // latitude, longitude pairs, size() of them
+    const double *constData() const;
+
+    void reserve(qsizetype size);
+    void append(double latitude, double longitude);
+    void append(const QGeoCoordinate &coordinate);
+    void append(const QGeoPackedPath &other);
+    void clear();
+
+    QGeoPackedPath mid(qsizetype position, qsizetype length = -1) const;
+    bool sharesBuffer(const QGeoPackedPath &other) const { return d_ && d_ == other.d_; }
+
+    QList<QGeoCoordinate> toList() const;
+    QGeoRectangle boundingGeoRectangle() const;
+
+    // Same comparison as for lists of QGeoCoordinate
+    friend bool operator==(const QGeoPackedPath &lhs, const QGeoPackedPath &rhs)
+    { return lhs.equals(rhs); }
+    friend bool operator!=(const QGeoPackedPath &lhs, const QGeoPackedPath &rhs)
+    { return !lhs.equals(rhs); }
+
+private:
+    struct Data : public QSharedData
+    {
+        QList<double> coordinates;
+        QList<double> altitudes; // empty, or one per coordinate pair
+    };
+
+    bool equals(const QGeoPackedPath &other) const;
+    bool isAppendable() const;
+    void detach(qsizetype capacity);
+
+    QExplicitlySharedDataPointer<Data> d_;
+    qsizetype offset_ = 0;
+    qsizetype size_ = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOPACKEDPATH_P_H
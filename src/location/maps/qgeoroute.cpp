@@ -518,7 +518,7 @@ bool QGeoRoutePrivate::equals(const QGeoRoutePrivate &other) const
         && travelTime() == other.travelTime()
         && distance() == other.distance()
         && travelMode() == other.travelMode()
-        && path() == other.path()
+        && packedPath() == other.packedPath()
         && routeLegs() == other.routeLegs()
         && extendedAttributes() == other.extendedAttributes();
 }
@@ -585,10 +585,20 @@ QGeoRouteRequest::TravelMode QGeoRoutePrivate::travelMode() const
 
 void QGeoRoutePrivate::setPath(const QList<QGeoCoordinate> &path)
 {
-    m_path = path;
+    m_path = QGeoPackedPath(path);
 }
 
 QList<QGeoCoordinate> QGeoRoutePrivate::path() const
+{
+    return m_path.toList();
+}
+
+void QGeoRoutePrivate::setPackedPath(const QGeoPackedPath &path)
+{
+    m_path = path;
+}
+
+const QGeoPackedPath &QGeoRoutePrivate::packedPath() const
 {
     return m_path;
 }
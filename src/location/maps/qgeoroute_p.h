@@ -56,6 +56,7 @@
 #include "qgeorouterequest.h"
 #include "qgeorectangle.h"
 #include "qgeoroutesegment.h"
+#include "qgeopackedpath_p.h"
 
 #include <QSharedData>
 #include <QVariantMap>
@@ -68,6 +69,9 @@ class QGeoCoordinate;
 class Q_LOCATION_PRIVATE_EXPORT QGeoRoutePrivate : public QSharedData
 {
 public:
+    static QGeoRoutePrivate *get(QGeoRoute &route) { return route.d_ptr.data(); }
+    static const QGeoRoutePrivate *get(const QGeoRoute &route) { return route.d_ptr.data(); }
+
     bool operator==(const QGeoRoutePrivate &other) const;
     bool equals(const QGeoRoutePrivate &other) const;
 
@@ -91,6 +95,9 @@ public:
 
     void setPath(const QList<QGeoCoordinate> &path);
     QList<QGeoCoordinate> path() const;
+    // The path is stored packed, path() builds the list on each call
+    void setPackedPath(const QGeoPackedPath &path);
+    const QGeoPackedPath &packedPath() const;
 
     void setFirstSegment(const QGeoRouteSegment &firstSegment);
     QGeoRouteSegment firstSegment() const;
@@ -133,7 +140,7 @@ private:
 
     QGeoRouteRequest::TravelMode m_travelMode;
 
-    QList<QGeoCoordinate> m_path;
+    QGeoPackedPath m_path;
     QList<QGeoRoute> m_legs;
     QGeoRouteSegment m_firstSegment;
     mutable int m_numSegments = -1;
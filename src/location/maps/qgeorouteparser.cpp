@@ -64,13 +64,44 @@ QGeoRouteParserPrivate::~QGeoRouteParserPrivate()
 {
 }
 
+void QGeoRouteParserPrivate::parseReplyAsync(QGeoRouteParserJob *job, const QByteArray &reply) const
+{
+    threadPool.start([this, job, reply]() {
+        QList<QGeoRoute> routes;
+        QString errorString;
+        const QGeoRouteReply::Error error = parseReply(routes, errorString, reply);
+        finishJob(job, error, errorString, routes);
+    });
+}
+
+// Thread safe, the job lives in the thread that started the parsing
+void QGeoRouteParserPrivate::finishJob(QGeoRouteParserJob *job, QGeoRouteReply::Error error,
+                                       const QString &errorString, const QList<QGeoRoute> &routes)
+{
+    QMetaObject::invokeMethod(job, [job, error, errorString, routes]() {
+        Q_EMIT job->finished(error, errorString, routes);
+        job->deleteLater();
+    }, Qt::QueuedConnection);
+}
+
+QGeoRouteParserJob::QGeoRouteParserJob(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QGeoRouteParserJob::~QGeoRouteParserJob()
+{
+}
+
 /*
     Public class implementations
 */
 
 QGeoRouteParser::~QGeoRouteParser()
 {
-
+    Q_D(QGeoRouteParser);
+    // Jobs still parsing use the private, and the extensions of subclasses
+    d->threadPool.waitForDone();
 }
 
 QGeoRouteParser::QGeoRouteParser(QGeoRouteParserPrivate &dd, QObject *parent) : QObject(dd, parent)
@@ -84,6 +115,19 @@ QGeoRouteReply::Error QGeoRouteParser::parseReply(QList<QGeoRoute> &routes, QStr
     return d->parseReply(routes, errorString, reply);
 }
 
+/*
+    Same as parseReply(), but in a worker thread. The returned job emits
+    finished() in the calling thread, which needs an event loop, and then
+    deletes itself.
+*/
+QGeoRouteParserJob *QGeoRouteParser::parseReplyAsync(const QByteArray &reply) const
+{
+    Q_D(const QGeoRouteParser);
+    QGeoRouteParserJob *job = new QGeoRouteParserJob;
+    d->parseReplyAsync(job, reply);
+    return job;
+}
+
 QUrl QGeoRouteParser::requestUrl(const QGeoRouteRequest &request, const QString &prefix) const
 {
     Q_D(const QGeoRouteParser);
@@ -60,6 +60,23 @@ class QByteArray;
 class QUrl;
 class QGeoRouteRequest;
 class QGeoRouteParserPrivate;
+
+/* Result of QGeoRouteParser::parseReplyAsync(). finished() is emitted once, in
+   the thread the job was created in, after which the job deletes itself. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoRouteParserJob : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QGeoRouteParserJob(QObject *parent = nullptr);
+    ~QGeoRouteParserJob();
+
+Q_SIGNALS:
+    void finished(QGeoRouteReply::Error error, const QString &errorString, const QList<QGeoRoute> &routes);
+
+private:
+    Q_DISABLE_COPY(QGeoRouteParserJob)
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoRouteParser : public QObject
 {
     Q_OBJECT
@@ -73,6 +90,7 @@ public:
     };
     virtual ~QGeoRouteParser();
     QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const;
+    QGeoRouteParserJob *parseReplyAsync(const QByteArray &reply) const;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const;
 
     TrafficSide trafficSide() const;
@@ -53,11 +53,14 @@
 
 #include <QtCore/private/qobject_p.h>
 #include <QtCore/QUrl>
+#include <QtCore/QThreadPool>
 #include <QtLocation/qgeoroutereply.h>
 #include <QtLocation/qgeorouterequest.h>
 
 QT_BEGIN_NAMESPACE
 
+class QGeoRouteParserJob;
+
 class QGeoRouteParserPrivate :  public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QGeoRouteParser)
@@ -67,8 +70,14 @@ public:
 
     virtual QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const = 0;
     virtual QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const = 0;
+    // Parses reply in threadPool and ends with finishJob()
+    virtual void parseReplyAsync(QGeoRouteParserJob *job, const QByteArray &reply) const;
+
+    static void finishJob(QGeoRouteParserJob *job, QGeoRouteReply::Error error,
+                          const QString &errorString, const QList<QGeoRoute> &routes);
 
     QGeoRouteParser::TrafficSide trafficSide = QGeoRouteParser::RightHandTraffic;
+    mutable QThreadPool threadPool;
 };
 
 QT_END_NAMESPACE
@@ -39,7 +39,9 @@
 
 #include "qgeorouteparserosrmv4_p.h"
 #include "qgeorouteparser_p_p.h"
+#include "qgeoroute_p.h"
 #include "qgeoroutesegment.h"
+#include "qgeoroutesegment_p.h"
 #include "qgeomaneuver.h"
 
 #include <QtCore/private/qobject_p.h>
@@ -50,16 +52,17 @@
 
 QT_BEGIN_NAMESPACE
 
-static QList<QGeoCoordinate> parsePolyline(const QByteArray &data)
+static QGeoPackedPath parsePolyline(const QByteArray &data)
 {
-    QList<QGeoCoordinate> path;
+    QGeoPackedPath path;
 
     bool parsingLatitude = true;
 
     int shift = 0;
     int value = 0;
 
-    QGeoCoordinate coord(0, 0);
+    double latitude = 0.0;
+    double longitude = 0.0;
 
     for (int i = 0; i < data.length(); ++i) {
         unsigned char c = data.at(i) - 63;
@@ -74,10 +77,10 @@ static QList<QGeoCoordinate> parsePolyline(const QByteArray &data)
         int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
 
         if (parsingLatitude) {
-            coord.setLatitude(coord.latitude() + (double)diff/1e6);
+            latitude += (double)diff/1e6;
         } else {
-            coord.setLongitude(coord.longitude() + (double)diff/1e6);
-            path.append(coord);
+            longitude += (double)diff/1e6;
+            path.append(latitude, longitude);
         }
 
         parsingLatitude = !parsingLatitude;
@@ -253,7 +256,8 @@ static QGeoRoute constructRoute(const QByteArray &geometry, const QJsonArray &in
 {
     QGeoRoute route;
 
-    const QList<QGeoCoordinate> path = parsePolyline(geometry);
+    // The segments are ranges of the path of the route
+    const QGeoPackedPath path = parsePolyline(geometry);
 
     QGeoRouteSegment firstSegment;
     int firstPosition = -1;
@@ -287,10 +291,11 @@ static QGeoRoute constructRoute(const QByteArray &geometry, const QJsonArray &in
 
         segment.setManeuver(maneuver);
 
+        QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segment);
         if (firstPosition == -1)
-            segment.setPath(path.mid(position));
+            segmentPrivate->setPackedPath(path.mid(position));
         else
-            segment.setPath(path.mid(position, firstPosition - position));
+            segmentPrivate->setPackedPath(path.mid(position, firstPosition - position));
 
         segment.setTravelTime(time);
 
@@ -303,7 +308,7 @@ static QGeoRoute constructRoute(const QByteArray &geometry, const QJsonArray &in
     route.setDistance(summary.value(QStringLiteral("total_distance")).toDouble());
     route.setTravelTime(summary.value(QStringLiteral("total_time")).toDouble());
     route.setFirstRouteSegment(firstSegment);
-    route.setPath(path);
+    QGeoRoutePrivate::get(route)->setPackedPath(path);
 
     return route;
 }
@@ -49,45 +49,60 @@
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
 #include <QtCore/QUrlQuery>
-#include <QtPositioning/qgeopath.h>
+#include <QtCore/QAtomicInt>
 
 #include <QtCore/private/qobject_p.h>
 #include <QtPositioning/private/qlocationutils_p.h>
 
+#include <memory>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
-static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
+// Number of coordinates encoded in the polyline, each of them ends with the
+// last chunk of its longitude
+static qsizetype polylineSize(QStringView polyline)
 {
-    QList<QGeoCoordinate> path;
-    if (polylineString.isEmpty())
-        return path;
+    qsizetype values = 0;
+    for (QChar c : polyline)
+        values += ((c.unicode() - 63) & 0x20) == 0;
+    return values / 2;
+}
 
-    const QByteArray data = polylineString.toLatin1();
+// Appends the coordinates of the polyline to path. precision is the number of
+// decimals of the encoding: 5 for "polyline", 6 for "polyline6". The values
+// are summed as integers, so that long polylines don't accumulate rounding
+// errors.
+static void decodePolyline(QStringView polyline, int precision, QGeoPackedPath &path)
+{
+    const double factor = precision == 5 ? 1e5 : 1e6;
 
     bool parsingLatitude = true;
 
     int shift = 0;
-    int value = 0;
+    quint32 value = 0;
 
-    QGeoCoordinate coord(0, 0);
+    qint64 latitude = 0;
+    qint64 longitude = 0;
 
-    for (qsizetype i = 0; i < data.length(); ++i) {
-        unsigned char c = data.at(i) - 63;
+    for (QChar ch : polyline) {
+        const quint32 c = quint32(ch.unicode() - 63);
 
-        value |= (c & 0x1f) << shift;
+        if (shift < 32)
+            value |= (c & 0x1f) << shift;
         shift += 5;
 
         // another chunk
         if (c & 0x20)
             continue;
 
-        int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
+        const qint32 diff = (value & 1) ? ~qint32(value >> 1) : qint32(value >> 1);
 
         if (parsingLatitude) {
-            coord.setLatitude(coord.latitude() + (double)diff/1e6);
+            latitude += diff;
         } else {
-            coord.setLongitude(coord.longitude() + (double)diff/1e6);
-            path.append(coord);
+            longitude += diff;
+            path.append(latitude / factor, longitude / factor);
         }
 
         parsingLatitude = !parsingLatitude;
@@ -95,8 +110,6 @@ static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
         value = 0;
         shift = 0;
     }
-
-    return path;
 }
 
 static QString cardinalDirection4(QLocationUtils::CardinalDirection direction)
@@ -119,32 +132,33 @@ static QString cardinalDirection4(QLocationUtils::CardinalDirection direction)
 
 static QString exitOrdinal(int exit)
 {
-    static QList<QString> ordinals;
-
-    if (!ordinals.size()) {
-        ordinals.append(QLatin1String(""));
+    // Parsing runs in several threads at once
+    static const QList<QString> ordinals = []() {
+        QList<QString> o;
+        o.append(QLatin1String(""));
         //: always used in " and take the %1 exit [onto <street name>]"
-        ordinals.append(QGeoRouteParserOsrmV5::tr("first", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("second", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("third", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("fourth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("fifth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("sixth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("seventh", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("eighth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("ninth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("tenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("eleventh", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("twelfth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("thirteenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("fourteenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("fifteenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("sixteenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("seventeenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("eighteenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("nineteenth", "roundabout exit"));
-        ordinals.append(QGeoRouteParserOsrmV5::tr("twentieth", "roundabout exit"));
-    };
+        o.append(QGeoRouteParserOsrmV5::tr("first", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("second", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("third", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("fourth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("fifth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("sixth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("seventh", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("eighth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("ninth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("tenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("eleventh", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("twelfth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("thirteenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("fourteenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("fifteenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("sixteenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("seventeenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("eighteenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("nineteenth", "roundabout exit"));
+        o.append(QGeoRouteParserOsrmV5::tr("twentieth", "roundabout exit"));
+        return o;
+    }();
 
     if (exit < 1 || exit > ordinals.size())
         return QString();
@@ -814,7 +828,8 @@ public:
     QGeoRouteParserOsrmV5Private();
     virtual ~QGeoRouteParserOsrmV5Private();
 
-    QGeoRouteSegment parseStep(const QJsonObject &step, int legIndex, int stepIndex) const;
+    QGeoRouteSegment parseStep(const QJsonObject &step, int legIndex, int stepIndex,
+                               QGeoPackedPath &routePath) const;
 
     // QGeoRouteParserPrivate
 
@@ -835,7 +850,12 @@ QGeoRouteParserOsrmV5Private::~QGeoRouteParserOsrmV5Private()
     delete m_extension;
 }
 
-QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step, int legIndex, int stepIndex) const {
+/*
+    The geometry of the step is appended to routePath, the caller makes the
+    path of the segment a range of it once the route is complete.
+*/
+QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step, int legIndex, int stepIndex,
+                                                         QGeoPackedPath &routePath) const {
     // OSRM Instructions documentation: https://github.com/Project-OSRM/osrm-text-instructions
     // This goes on top of OSRM: https://github.com/Project-OSRM/osrm-backend/blob/master/docs/http.md
     // Mapbox however, includes this in the reply, under "instruction".
@@ -863,7 +883,7 @@ QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step
     QGeoCoordinate coord(latitude, longitude);
 
     QString geometry = step.value(QLatin1String("geometry")).toString();
-    QList<QGeoCoordinate> path = decodePolyline(geometry);
+    decodePolyline(geometry, routePath);
 
     QGeoManeuver::InstructionDirection maneuverInstructionDirection = instructionDirection(maneuver, trafficSide);
 
@@ -896,7 +916,6 @@ QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step
     geoManeuver.setExtendedAttributes(extraAttributes);
 
     segment.setDistance(distance);
-    segment.setPath(path);
     segment.setTravelTime(time);
     segment.setManeuver(geoManeuver);
     if (m_extension)
@@ -904,124 +923,208 @@ QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step
     return segment;
 }
 
-QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const
+bool QGeoRouteParserOsrmV5Private::parseRoute(const QJsonObject &routeObject, QGeoRoute &route) const
 {
-    // OSRM v5 specs: https://github.com/Project-OSRM/osrm-backend/blob/master/docs/http.md
-    // Mapbox Directions API spec: https://www.mapbox.com/api-documentation/#directions
-    QJsonDocument document = QJsonDocument::fromJson(reply);
-    if (document.isObject()) {
-        QJsonObject object = document.object();
-
-        QString status = object.value(QLatin1String("code")).toString();
-        if (status != QLatin1String("Ok")) {
-            errorString = status;
-            return QGeoRouteReply::UnknownError;
+    if (!routeObject.value(QLatin1String("legs")).isArray())
+        return false;
+    if (!routeObject.value(QLatin1String("duration")).isDouble())
+        return false;
+    if (!routeObject.value(QLatin1String("distance")).isDouble())
+        return false;
+
+    double distance = routeObject.value(QLatin1String("distance")).toDouble();
+    double travelTime = routeObject.value(QLatin1String("duration")).toDouble();
+    bool error = false;
+    QList<QGeoRouteSegment> segments;
+    // All the coordinates of the route, the segments and legs are ranges of it.
+    // The steps repeat the points where they meet, the overview geometry
+    // doesn't, so reserving for it leaves room for these few.
+    QGeoPackedPath routePath;
+    const QString overview = routeObject.value(QLatin1String("geometry")).toString();
+    if (!overview.isEmpty())
+        routePath.reserve(polylineSize(overview) * 9 / 8 + 16);
+    QList<qsizetype> segmentStarts;
+    QList<qsizetype> legStarts;
+
+    const QJsonArray legs = routeObject.value(QLatin1String("legs")).toArray();
+    QList<QGeoRoute> routeLegs;
+    for (int legIndex = 0; legIndex < legs.size(); ++legIndex) {
+        const QJsonValue &l = legs.at(legIndex);
+        QGeoRoute routeLeg;
+        QList<QGeoRouteSegment> legSegments;
+        if (!l.isObject()) { // invalid leg record
+            error = true;
+            break;
         }
-        if (!object.value(QLatin1String("routes")).isArray()) {
-            errorString = QLatin1String("No routes found");
-            return QGeoRouteReply::ParseError;
+        const QJsonObject leg = l.toObject();
+        if (!leg.value(QLatin1String("steps")).isArray()) { // Invalid steps field
+            error = true;
+            break;
         }
-
-        const QJsonArray osrmRoutes = object.value(QLatin1String("routes")).toArray();
-        for (const QJsonValueConstRef r : osrmRoutes) {
-            if (!r.isObject())
-                continue;
-            QJsonObject routeObject = r.toObject();
-            if (!routeObject.value(QLatin1String("legs")).isArray())
-                continue;
-            if (!routeObject.value(QLatin1String("duration")).isDouble())
-                continue;
-            if (!routeObject.value(QLatin1String("distance")).isDouble())
-                continue;
-
-            double distance = routeObject.value(QLatin1String("distance")).toDouble();
-            double travelTime = routeObject.value(QLatin1String("duration")).toDouble();
-            bool error = false;
-            QList<QGeoRouteSegment> segments;
-
-            const QJsonArray legs = routeObject.value(QLatin1String("legs")).toArray();
-            QList<QGeoRoute> routeLegs;
-            QGeoRoute route;
-            for (int legIndex = 0; legIndex < legs.size(); ++legIndex) {
-                const QJsonValue &l = legs.at(legIndex);
-                QGeoRoute routeLeg;
-                QList<QGeoRouteSegment> legSegments;
-                if (!l.isObject()) { // invalid leg record
-                    error = true;
-                    break;
-                }
-                const QJsonObject leg = l.toObject();
-                if (!leg.value(QLatin1String("steps")).isArray()) { // Invalid steps field
-                    error = true;
-                    break;
-                }
-                const double legDistance = leg.value(QLatin1String("distance")).toDouble();
-                const double legTravelTime = leg.value(QLatin1String("duration")).toDouble();
-                const QJsonArray steps = leg.value(QLatin1String("steps")).toArray();
-                QGeoRouteSegment segment;
-                for (int stepIndex = 0; stepIndex < steps.size(); ++stepIndex) {
-                    const QJsonValue &s = steps.at(stepIndex);
-                    if (!s.isObject()) {
-                        error = true;
-                        break;
-                    }
-                    segment = parseStep(s.toObject(), legIndex, stepIndex);
-                    if (segment.isValid()) {
-                        // setNextRouteSegment done below for all segments in the route.
-                        legSegments.append(segment);
-                    } else {
-                        error = true;
-                        break;
-                    }
-                }
-                if (error)
-                    break;
-
-                QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segment);
-                segmentPrivate->setLegLastSegment(true);
-                QList<QGeoCoordinate> path;
-                for (const QGeoRouteSegment &s: qAsConst(legSegments))
-                    path.append(s.path());
-                routeLeg.setLegIndex(legIndex);
-                routeLeg.setOverallRoute(route); // QGeoRoute::d_ptr is explicitlySharedDataPointer. Modifiers below won't detach it.
-                routeLeg.setDistance(legDistance);
-                routeLeg.setTravelTime(legTravelTime);
-                if (!path.isEmpty()) {
-                    routeLeg.setPath(path);
-                    routeLeg.setFirstRouteSegment(legSegments.first());
-                }
-                routeLegs << routeLeg;
-
-                segments.append(legSegments);
+        const double legDistance = leg.value(QLatin1String("distance")).toDouble();
+        const double legTravelTime = leg.value(QLatin1String("duration")).toDouble();
+        const QJsonArray steps = leg.value(QLatin1String("steps")).toArray();
+        QGeoRouteSegment segment;
+        legStarts.append(routePath.size());
+        for (int stepIndex = 0; stepIndex < steps.size(); ++stepIndex) {
+            const QJsonValue &s = steps.at(stepIndex);
+            if (!s.isObject()) {
+                error = true;
+                break;
             }
-
-            if (!error) {
-                QList<QGeoCoordinate> path;
-                for (const QGeoRouteSegment &s : segments)
-                    path.append(s.path());
-
-                for (qsizetype i = segments.size() - 1; i > 0; --i)
-                    segments[i-1].setNextRouteSegment(segments[i]);
-
-                route.setDistance(distance);
-                route.setTravelTime(travelTime);
-                if (!path.isEmpty()) {
-                    route.setPath(path);
-                    route.setBounds(QGeoPath(path).boundingGeoRectangle());
-                    route.setFirstRouteSegment(segments.first());
-                }
-                route.setRouteLegs(routeLegs);
-                //r.setTravelMode(QGeoRouteRequest::CarTravel); // The only one supported by OSRM demo service, but other OSRM servers might do cycle or pedestrian too
-                routes.append(route);
+            const qsizetype start = routePath.size();
+            segment = parseStep(s.toObject(), legIndex, stepIndex, routePath);
+            if (segment.isValid()) {
+                // setNextRouteSegment done below for all segments in the route.
+                legSegments.append(segment);
+                segmentStarts.append(start);
+            } else {
+                error = true;
+                break;
             }
         }
+        if (error)
+            break;
+
+        QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segment);
+        segmentPrivate->setLegLastSegment(true);
+        routeLeg.setLegIndex(legIndex);
+        routeLeg.setOverallRoute(route); // QGeoRoute::d_ptr is explicitlySharedDataPointer. Modifiers below won't detach it.
+        routeLeg.setDistance(legDistance);
+        routeLeg.setTravelTime(legTravelTime);
+        if (routePath.size() > legStarts.last())
+            routeLeg.setFirstRouteSegment(legSegments.first());
+        routeLegs << routeLeg;
+
+        segments.append(legSegments);
+    }
 
-        // setError(QGeoRouteReply::NoError, status);  // can't do this, or NoError is emitted and does damages
-        return QGeoRouteReply::NoError;
-    } else {
+    if (error)
+        return false;
+
+    // Only now that the buffer is complete, appending to it
+    // while sharing it would copy it each time
+    for (qsizetype i = 0; i < segments.size(); ++i) {
+        const qsizetype end = i + 1 < segments.size() ? segmentStarts.at(i + 1) : routePath.size();
+        QGeoRouteSegmentPrivate::get(segments[i])->setPackedPath(
+                    routePath.mid(segmentStarts.at(i), end - segmentStarts.at(i)));
+    }
+    for (qsizetype i = 0; i < routeLegs.size(); ++i) {
+        const qsizetype end = i + 1 < routeLegs.size() ? legStarts.at(i + 1) : routePath.size();
+        if (end > legStarts.at(i)) {
+            QGeoRoutePrivate::get(routeLegs[i])->setPackedPath(
+                        routePath.mid(legStarts.at(i), end - legStarts.at(i)));
+        }
+    }
+
+    for (qsizetype i = segments.size() - 1; i > 0; --i)
+        segments[i-1].setNextRouteSegment(segments[i]);
+
+    route.setDistance(distance);
+    route.setTravelTime(travelTime);
+    if (!routePath.isEmpty()) {
+        QGeoRoutePrivate::get(route)->setPackedPath(routePath);
+        route.setBounds(routePath.boundingGeoRectangle());
+        route.setFirstRouteSegment(segments.first());
+    }
+    route.setRouteLegs(routeLegs);
+    //r.setTravelMode(QGeoRouteRequest::CarTravel); // The only one supported by OSRM demo service, but other OSRM servers might do cycle or pedestrian too
+    return true;
+}
+
+// Checks the status of the reply and returns its routes
+static QGeoRouteReply::Error replyRoutes(const QByteArray &reply, QJsonArray &routes, QString &errorString)
+{
+    // OSRM v5 specs: https://github.com/Project-OSRM/osrm-backend/blob/master/docs/http.md
+    // Mapbox Directions API spec: https://www.mapbox.com/api-documentation/#directions
+    const QJsonDocument document = QJsonDocument::fromJson(reply);
+    if (!document.isObject()) {
         errorString = QLatin1String("Couldn't parse json.");
         return QGeoRouteReply::ParseError;
     }
+    const QJsonObject object = document.object();
+
+    QString status = object.value(QLatin1String("code")).toString();
+    if (status != QLatin1String("Ok")) {
+        errorString = status;
+        return QGeoRouteReply::UnknownError;
+    }
+    if (!object.value(QLatin1String("routes")).isArray()) {
+        errorString = QLatin1String("No routes found");
+        return QGeoRouteReply::ParseError;
+    }
+    routes = object.value(QLatin1String("routes")).toArray();
+    return QGeoRouteReply::NoError;
+}
+
+QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const
+{
+    QJsonArray osrmRoutes;
+    const QGeoRouteReply::Error error = replyRoutes(reply, osrmRoutes, errorString);
+    if (error != QGeoRouteReply::NoError)
+        return error;
+
+    for (const QJsonValueConstRef r : osrmRoutes) {
+        QGeoRoute route;
+        if (r.isObject() && parseRoute(r.toObject(), route))
+            routes.append(route);
+    }
+
+    // setError(QGeoRouteReply::NoError, status);  // can't do this, or NoError is emitted and does damages
+    return QGeoRouteReply::NoError;
+}
+
+namespace {
+struct ParsedRoutes
+{
+    explicit ParsedRoutes(qsizetype count)
+        : routes(count), valid(count, false), remaining(int(count))
+    {
+    }
+
+    // One element per thread, hence not QList which could detach
+    std::vector<QGeoRoute> routes;
+    std::vector<char> valid;
+    QAtomicInt remaining;
+};
+}
+
+/*
+    The routes of a reply don't share anything, each of them is parsed in a
+    task of its own and the last task to finish completes the job.
+*/
+void QGeoRouteParserOsrmV5Private::parseReplyAsync(QGeoRouteParserJob *job, const QByteArray &reply) const
+{
+    threadPool.start([this, job, reply]() {
+        QJsonArray osrmRoutes;
+        QString errorString;
+        const QGeoRouteReply::Error error = replyRoutes(reply, osrmRoutes, errorString);
+        if (error != QGeoRouteReply::NoError || osrmRoutes.isEmpty()) {
+            finishJob(job, error, errorString, QList<QGeoRoute>());
+            return;
+        }
+
+        auto parsed = std::make_shared<ParsedRoutes>(osrmRoutes.size());
+        const auto parse = [this, job, parsed](qsizetype i, const QJsonValue &value) {
+            if (value.isObject())
+                parsed->valid[i] = parseRoute(value.toObject(), parsed->routes[i]);
+            if (parsed->remaining.deref())
+                return;
+            QList<QGeoRoute> routes;
+            routes.reserve(qsizetype(parsed->routes.size()));
+            for (size_t r = 0; r < parsed->routes.size(); ++r) {
+                if (parsed->valid[r])
+                    routes.append(parsed->routes[r]);
+            }
+            finishJob(job, QGeoRouteReply::NoError, QString(), routes);
+        };
+        for (qsizetype i = 1; i < osrmRoutes.size(); ++i) {
+            threadPool.start([parse, i, value = osrmRoutes.at(i)]() {
+                parse(i, value);
+            });
+        }
+        parse(0, osrmRoutes.at(0));
+    });
 }
 
 QUrl QGeoRouteParserOsrmV5Private::requestUrl(const QGeoRouteRequest &request, const QString &prefix) const
@@ -1041,7 +1144,8 @@ QUrl QGeoRouteParserOsrmV5Private::requestUrl(const QGeoRouteRequest &request, c
     QUrlQuery query;
     query.addQueryItem(QLatin1String("overview"), QLatin1String("full"));
     query.addQueryItem(QLatin1String("steps"), QLatin1String("true"));
-    query.addQueryItem(QLatin1String("geometries"), QLatin1String("polyline6"));
+    query.addQueryItem(QLatin1String("geometries"), m_polylinePrecision == 5 ? QLatin1String("polyline")
+                                                                             : QLatin1String("polyline6"));
     query.addQueryItem(QLatin1String("alternatives"), QLatin1String("true"));
     if (m_extension)
         m_extension->updateQuery(query);
@@ -1065,4 +1169,21 @@ void QGeoRouteParserOsrmV5::setExtension(const QGeoRouteParserOsrmV5Extension *e
         d->m_extension = extension;
 }
 
+/*
+    Number of decimals of the geometries requested and decoded, 5 for the
+    "polyline" format, 6 for "polyline6", which is the default.
+*/
+void QGeoRouteParserOsrmV5::setPolylinePrecision(int precision)
+{
+    Q_D(QGeoRouteParserOsrmV5);
+    if (precision == 5 || precision == 6)
+        d->m_polylinePrecision = precision;
+}
+
+int QGeoRouteParserOsrmV5::polylinePrecision() const
+{
+    Q_D(const QGeoRouteParserOsrmV5);
+    return d->m_polylinePrecision;
+}
+
 QT_END_NAMESPACE
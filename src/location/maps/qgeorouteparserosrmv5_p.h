@@ -84,6 +84,8 @@ public:
     virtual ~QGeoRouteParserOsrmV5();
 
     void setExtension(const QGeoRouteParserOsrmV5Extension *extension);
+    void setPolylinePrecision(int precision);
+    int polylinePrecision() const;
 
 private:
     Q_DISABLE_COPY(QGeoRouteParserOsrmV5)
@@ -365,10 +365,20 @@ void QGeoRouteSegmentPrivate::setDistance(qreal distance)
 
 QList<QGeoCoordinate> QGeoRouteSegmentPrivate::path() const
 {
-    return m_path;
+    return m_path.toList();
 }
 
 void QGeoRouteSegmentPrivate::setPath(const QList<QGeoCoordinate> &path)
+{
+    m_path = QGeoPackedPath(path);
+}
+
+const QGeoPackedPath &QGeoRouteSegmentPrivate::packedPath() const
+{
+    return m_path;
+}
+
+void QGeoRouteSegmentPrivate::setPackedPath(const QGeoPackedPath &path)
 {
     m_path = path;
 }
@@ -54,6 +54,7 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/qgeomaneuver.h>
 #include <QtLocation/qgeoroutesegment.h>
+#include <QtLocation/private/qgeopackedpath_p.h>
 
 
 #include <QSharedData>
@@ -84,6 +85,9 @@ public:
 
     QList<QGeoCoordinate> path() const;
     void setPath(const QList<QGeoCoordinate> &path);
+    // Usually a range of the packed path of the route
+    const QGeoPackedPath &packedPath() const;
+    void setPackedPath(const QGeoPackedPath &path);
 
     QGeoManeuver maneuver() const;
     void setManeuver(const QGeoManeuver &maneuver);
@@ -96,7 +100,7 @@ public:
     bool m_legLastSegment = false;
     int m_travelTime = 0;
     qreal m_distance = 0.0;
-    QList<QGeoCoordinate> m_path;
+    QGeoPackedPath m_path;
     QGeoManeuver m_maneuver;
 
     friend bool operator==(const QGeoRouteSegmentPrivate &lhs, const QGeoRouteSegmentPrivate &rhs);
@@ -0,0 +1,569 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotilearchive_p.h"
+#include "qgeotilespec_p.h"
+
+#include <QtCore/QtEndian>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QDebug>
+#ifdef QT_LOCATION_MBTILES
+#include <QtCore/QAtomicInteger>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+QT_BEGIN_NAMESPACE
+
+static const char PMTilesMagic[] = "PMTiles";
+static const char SQLiteMagic[] = "SQLite format 3";
+static const qint64 PMTilesHeaderSize = 127;
+static const quint8 PMTilesVersion = 3;
+
+// Compressions, of the directories and metadata or of the tiles
+static const quint8 CompressionUnknown = 0;
+static const quint8 CompressionNone = 1;
+static const quint8 CompressionGzip = 2;
+
+// Largest number of directory entries kept decoded, beside the root directory
+static const int LeafCacheCost = 1 << 18;
+static const int MaxDirectoryDepth = 4;
+
+QGeoTileArchive::~QGeoTileArchive()
+{
+}
+
+QGeoTileArchive *QGeoTileArchive::create(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Unable to open tile archive" << fileName << file.errorString();
+        return nullptr;
+    }
+    const QByteArray magic = file.read(16);
+    file.close();
+
+    QGeoTileArchive *archive = nullptr;
+    if (magic.startsWith(PMTilesMagic)) {
+        archive = new QGeoTilePMTilesArchive;
+    } else if (magic.startsWith(SQLiteMagic)) {
+#ifdef QT_LOCATION_MBTILES
+        archive = new QGeoTileMBTilesArchive;
+#else
+        qWarning() << "MBTiles archives need Qt SQL, unable to use" << fileName;
+        return nullptr;
+#endif
+    } else {
+        qWarning() << "Not an MBTiles or PMTiles archive" << fileName;
+        return nullptr;
+    }
+
+    if (!archive->open(fileName)) {
+        delete archive;
+        return nullptr;
+    }
+    return archive;
+}
+
+QString QGeoTileArchive::tileName(const QGeoTileSpec &spec, const QString &format)
+{
+    return QString::number(spec.zoom()) + QLatin1Char('/') + QString::number(spec.x())
+            + QLatin1Char('/') + QString::number(spec.y()) + QLatin1Char('.') + format;
+}
+
+QList<QGeoTileDiskStorage::Entry> QGeoTileArchive::entries() const
+{
+    return QList<Entry>();
+}
+
+bool QGeoTileArchive::write(const QString &name, const QByteArray &bytes)
+{
+    Q_UNUSED(name);
+    Q_UNUSED(bytes);
+    return false;
+}
+
+QByteArray QGeoTileArchive::read(const QString &name) const
+{
+    const QStringView path = QStringView(name).left(name.lastIndexOf(QLatin1Char('.')));
+    const QList<QStringView> fields = path.split(QLatin1Char('/'));
+    if (fields.size() != 3)
+        return QByteArray();
+
+    bool okZoom = false;
+    bool okX = false;
+    bool okY = false;
+    const int zoom = fields.at(0).toInt(&okZoom);
+    const int x = fields.at(1).toInt(&okX);
+    const int y = fields.at(2).toInt(&okY);
+    if (!okZoom || !okX || !okY)
+        return QByteArray();
+    return tile(zoom, x, y);
+}
+
+void QGeoTileArchive::remove(const QString &name)
+{
+    Q_UNUSED(name);
+}
+
+void QGeoTileArchive::clear()
+{
+}
+
+// The image format of the tiles, as a file suffix
+QString QGeoTileArchive::format() const
+{
+    return format_;
+}
+
+int QGeoTileArchive::minimumZoomLevel() const
+{
+    return minimumZoomLevel_;
+}
+
+int QGeoTileArchive::maximumZoomLevel() const
+{
+    return maximumZoomLevel_;
+}
+
+static inline bool validTile(int zoom, int x, int y)
+{
+    return zoom >= 0 && zoom <= 26 && x >= 0 && y >= 0 && x < (1 << zoom) && y < (1 << zoom);
+}
+
+static bool readVarint(const uchar *&p, const uchar *end, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uchar byte = *p++;
+        result |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+QGeoTilePMTilesArchive::QGeoTilePMTilesArchive()
+{
+    leaves_.setMaxCost(LeafCacheCost);
+}
+
+QGeoTilePMTilesArchive::~QGeoTilePMTilesArchive()
+{
+    if (map_)
+        file_.unmap(const_cast<uchar *>(map_));
+}
+
+QString QGeoTilePMTilesArchive::kind() const
+{
+    return QStringLiteral("pmtiles");
+}
+
+bool QGeoTilePMTilesArchive::open(const QString &fileName)
+{
+    file_.setFileName(fileName);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        qWarning() << "Unable to open tile archive" << fileName << file_.errorString();
+        return false;
+    }
+    size_ = file_.size();
+    if (size_ >= PMTilesHeaderSize)
+        map_ = file_.map(0, size_);
+    if (!map_) {
+        qWarning() << "Unable to map tile archive" << fileName;
+        return false;
+    }
+
+    const uchar *header = map_;
+    if (memcmp(header, PMTilesMagic, 7) != 0 || header[7] != PMTilesVersion) {
+        qWarning() << "Unsupported PMTiles version" << header[7] << "in" << fileName;
+        return false;
+    }
+
+    const quint64 rootOffset = qFromLittleEndian<quint64>(header + 8);
+    const quint64 rootLength = qFromLittleEndian<quint64>(header + 16);
+    leafDirectoriesOffset_ = qFromLittleEndian<quint64>(header + 40);
+    tileDataOffset_ = qFromLittleEndian<quint64>(header + 56);
+    internalCompression_ = header[97];
+    tileCompression_ = header[98];
+    minimumZoomLevel_ = header[100];
+    maximumZoomLevel_ = header[101];
+
+    switch (header[99]) {
+    case 1:
+        format_ = QStringLiteral("pbf");
+        break;
+    case 2:
+        format_ = QStringLiteral("png");
+        break;
+    case 3:
+        format_ = QStringLiteral("jpg");
+        break;
+    case 4:
+        format_ = QStringLiteral("webp");
+        break;
+    case 5:
+        format_ = QStringLiteral("avif");
+        break;
+    default:
+        break;
+    }
+
+    if (!decodeDirectory(rootOffset, rootLength, &root_)) {
+        qWarning() << "Unreadable root directory in tile archive" << fileName;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Returns the position of the tile on the Hilbert curve covering its zoom
+    level, after the tiles of all the lower zoom levels.
+*/
+quint64 QGeoTilePMTilesArchive::tileId(int zoom, int x, int y)
+{
+    const quint64 n = quint64(1) << zoom;
+    quint64 id = ((n * n) - 1) / 3;
+    quint64 tx = x;
+    quint64 ty = y;
+    for (quint64 s = n / 2; s > 0; s /= 2) {
+        const quint64 rx = (tx & s) ? 1 : 0;
+        const quint64 ry = (ty & s) ? 1 : 0;
+        id += s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                tx = n - 1 - tx;
+                ty = n - 1 - ty;
+            }
+            std::swap(tx, ty);
+        }
+    }
+    return id;
+}
+
+QByteArray QGeoTilePMTilesArchive::decompress(const char *data, qint64 size, quint8 compression) const
+{
+    if (compression == CompressionNone || compression == CompressionUnknown)
+        return QByteArray(data, size);
+    if (compression != CompressionGzip) {
+        qWarning() << "Unsupported compression" << compression << "in tile archive" << file_.fileName();
+        return QByteArray();
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+        return QByteArray();
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = uInt(size);
+
+    QByteArray result;
+    result.resize(qMax<qint64>(size * 4, 1024));
+    int status = Z_OK;
+    while (status == Z_OK) {
+        if (stream.total_out == uLong(result.size()))
+            result.resize(result.size() * 2);
+        stream.next_out = reinterpret_cast<Bytef *>(result.data() + stream.total_out);
+        stream.avail_out = uInt(result.size() - stream.total_out);
+        status = inflate(&stream, Z_NO_FLUSH);
+    }
+    inflateEnd(&stream);
+    if (status != Z_STREAM_END)
+        return QByteArray();
+    result.resize(stream.total_out);
+    return result;
+}
+
+bool QGeoTilePMTilesArchive::decodeDirectory(quint64 offset, quint64 length, Directory *directory) const
+{
+    if (offset > quint64(size_) || length > quint64(size_) - offset)
+        return false;
+    const QByteArray data = decompress(reinterpret_cast<const char *>(map_ + offset), length,
+                                       internalCompression_);
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *end = p + data.size();
+
+    // Column oriented: the ids, run lengths, lengths and offsets of all entries in turn
+    quint64 count = 0;
+    if (!readVarint(p, end, &count) || count > quint64(data.size()))
+        return false;
+    directory->resize(qsizetype(count));
+
+    quint64 value = 0;
+    quint64 tileId = 0;
+    for (DirectoryEntry &entry : *directory) {
+        if (!readVarint(p, end, &value))
+            return false;
+        tileId += value;
+        entry.tileId = tileId;
+    }
+    for (DirectoryEntry &entry : *directory) {
+        if (!readVarint(p, end, &value))
+            return false;
+        entry.runLength = quint32(value);
+    }
+    for (DirectoryEntry &entry : *directory) {
+        if (!readVarint(p, end, &value))
+            return false;
+        entry.length = quint32(value);
+    }
+    for (qsizetype i = 0; i < directory->size(); ++i) {
+        if (!readVarint(p, end, &value))
+            return false;
+        DirectoryEntry &entry = (*directory)[i];
+        // 0 stands for right after the previous entry
+        if (value == 0 && i > 0)
+            entry.offset = directory->at(i - 1).offset + directory->at(i - 1).length;
+        else
+            entry.offset = value - 1;
+    }
+    return true;
+}
+
+bool QGeoTilePMTilesArchive::findTile(quint64 tileId, quint64 *offset, quint32 *length) const
+{
+    Directory directory = root_;
+    for (int depth = 0; depth < MaxDirectoryDepth; ++depth) {
+        // The last entry starting at or before the tile
+        auto it = std::upper_bound(directory.cbegin(), directory.cend(), tileId,
+                                   [](quint64 id, const DirectoryEntry &entry) {
+            return id < entry.tileId;
+        });
+        if (it == directory.cbegin())
+            return false;
+        --it;
+
+        if (it->runLength > 0) {
+            if (tileId - it->tileId >= it->runLength)
+                return false;
+            *offset = tileDataOffset_ + it->offset;
+            *length = it->length;
+            return true;
+        }
+
+        const quint64 leafOffset = leafDirectoriesOffset_ + it->offset;
+        const quint64 leafLength = it->length;
+        {
+            QMutexLocker locker(&mutex_);
+            if (Directory *leaf = leaves_.object(leafOffset)) {
+                directory = *leaf;
+                continue;
+            }
+        }
+        if (!decodeDirectory(leafOffset, leafLength, &directory))
+            return false;
+        QMutexLocker locker(&mutex_);
+        leaves_.insert(leafOffset, new Directory(directory), qMax<qsizetype>(1, directory.size()));
+    }
+    return false;
+}
+
+bool QGeoTilePMTilesArchive::contains(int zoom, int x, int y) const
+{
+    if (!validTile(zoom, x, y) || zoom < minimumZoomLevel_ || zoom > maximumZoomLevel_)
+        return false;
+    quint64 offset = 0;
+    quint32 length = 0;
+    return findTile(tileId(zoom, x, y), &offset, &length);
+}
+
+QByteArray QGeoTilePMTilesArchive::tile(int zoom, int x, int y) const
+{
+    if (!validTile(zoom, x, y) || zoom < minimumZoomLevel_ || zoom > maximumZoomLevel_)
+        return QByteArray();
+    quint64 offset = 0;
+    quint32 length = 0;
+    if (!findTile(tileId(zoom, x, y), &offset, &length)
+            || offset > quint64(size_) || length > quint64(size_) - offset) {
+        return QByteArray();
+    }
+    return decompress(reinterpret_cast<const char *>(map_ + offset), length, tileCompression_);
+}
+
+#ifdef QT_LOCATION_MBTILES
+
+// Deleted by QThreadStorage in the thread owning the connection, when it finishes
+struct QGeoTileMBTilesArchive::Connection
+{
+    ~Connection()
+    {
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    QString name;
+    bool open = false;
+};
+
+QGeoTileMBTilesArchive::QGeoTileMBTilesArchive()
+{
+}
+
+/*
+    The connections of the threads still running are closed here: the
+    QThreadStorage doesn't delete the data of other threads once destroyed.
+    They are idle by now, the tile loads are finished before an archive goes.
+*/
+QGeoTileMBTilesArchive::~QGeoTileMBTilesArchive()
+{
+    connection_.setLocalData(nullptr);
+    QMutexLocker locker(&mutex_);
+    for (const QString &name : qAsConst(connections_))
+        QSqlDatabase::removeDatabase(name);
+}
+
+QString QGeoTileMBTilesArchive::kind() const
+{
+    return QStringLiteral("mbtiles");
+}
+
+/*
+    Returns the connection of the calling thread, opening it on first use.
+    Returns an empty name if the database could not be opened.
+*/
+QString QGeoTileMBTilesArchive::connection() const
+{
+    if (const Connection *connection = connection_.localData())
+        return connection->open ? connection->name : QString();
+
+    // Thread ids and QThread addresses get reused, a serial number doesn't
+    static QAtomicInteger<quint64> serial;
+    Connection *connection = new Connection;
+    connection->name = connectionPrefix_ + QString::number(serial.fetchAndAddRelaxed(1));
+    connection_.setLocalData(connection);
+    {
+        QMutexLocker locker(&mutex_);
+        connections_.append(connection->name);
+    }
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connection->name);
+    db.setDatabaseName(fileName_);
+    db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+    if (!db.open()) {
+        qWarning() << "Unable to open tile archive" << fileName_ << db.lastError().text();
+        return QString();
+    }
+    // Tiles are then read from the page cache, without a copy into SQLite's
+    QSqlQuery(QStringLiteral("PRAGMA mmap_size = 268435456"), db);
+    connection->open = true;
+    return connection->name;
+}
+
+bool QGeoTileMBTilesArchive::open(const QString &fileName)
+{
+    fileName_ = fileName;
+    connectionPrefix_ = QStringLiteral("qgeotilearchive-%1-")
+            .arg(reinterpret_cast<quintptr>(this), 0, 16);
+
+    const QString name = connection();
+    if (name.isEmpty())
+        return false;
+    QSqlDatabase db = QSqlDatabase::database(name, false);
+
+    bool hasMinimumZoom = false;
+    bool hasMaximumZoom = false;
+    QSqlQuery metadata(QStringLiteral("SELECT name, value FROM metadata"), db);
+    while (metadata.next()) {
+        const QString key = metadata.value(0).toString();
+        if (key == QLatin1String("format"))
+            format_ = metadata.value(1).toString();
+        else if (key == QLatin1String("minzoom"))
+            minimumZoomLevel_ = metadata.value(1).toInt(&hasMinimumZoom);
+        else if (key == QLatin1String("maxzoom"))
+            maximumZoomLevel_ = metadata.value(1).toInt(&hasMaximumZoom);
+    }
+    if (format_ == QLatin1String("jpeg"))
+        format_ = QStringLiteral("jpg");
+
+    if (!hasMinimumZoom || !hasMaximumZoom) {
+        QSqlQuery zoom(QStringLiteral("SELECT MIN(zoom_level), MAX(zoom_level) FROM tiles"), db);
+        if (!zoom.next()) {
+            qWarning() << "Not an MBTiles archive" << fileName << zoom.lastError().text();
+            return false;
+        }
+        minimumZoomLevel_ = zoom.value(0).toInt();
+        maximumZoomLevel_ = zoom.value(1).toInt();
+    }
+    return true;
+}
+
+bool QGeoTileMBTilesArchive::contains(int zoom, int x, int y) const
+{
+    if (!validTile(zoom, x, y) || zoom < minimumZoomLevel_ || zoom > maximumZoomLevel_)
+        return false;
+    const QString name = connection();
+    if (name.isEmpty())
+        return false;
+
+    QSqlQuery query(QSqlDatabase::database(name, false));
+    query.prepare(QStringLiteral("SELECT 1 FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?"));
+    query.addBindValue(zoom);
+    query.addBindValue(x);
+    query.addBindValue((1 << zoom) - 1 - y); // rows grow northwards
+    return query.exec() && query.next();
+}
+
+QByteArray QGeoTileMBTilesArchive::tile(int zoom, int x, int y) const
+{
+    if (!validTile(zoom, x, y) || zoom < minimumZoomLevel_ || zoom > maximumZoomLevel_)
+        return QByteArray();
+    const QString name = connection();
+    if (name.isEmpty())
+        return QByteArray();
+
+    QSqlQuery query(QSqlDatabase::database(name, false));
+    query.prepare(QStringLiteral("SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?"));
+    query.addBindValue(zoom);
+    query.addBindValue(x);
+    query.addBindValue((1 << zoom) - 1 - y);
+    if (!query.exec() || !query.next())
+        return QByteArray();
+    return query.value(0).toByteArray();
+}
+
+#endif // QT_LOCATION_MBTILES
+
+QT_END_NAMESPACE
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILEARCHIVE_P_H
+#define QGEOTILEARCHIVE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotilediskstorage_p.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QCache>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadStorage>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoTileSpec;
+
+/* A read-only set of tiles in a single file, for shipping offline maps.
+ * It is a disk storage so that QGeoFileTileCache can load from it in the
+ * background like from its own cache, tiles being named zoom/x/y.format
+ * with y growing southwards. Nothing is ever written to an archive, nor
+ * listed by entries(), they can hold millions of tiles.
+ *
+ * tile() and read() may be called from any thread. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileArchive : public QGeoTileDiskStorage
+{
+public:
+    ~QGeoTileArchive();
+
+    // An MBTiles or PMTiles archive, told apart by their content
+    static QGeoTileArchive *create(const QString &fileName);
+    static QString tileName(const QGeoTileSpec &spec, const QString &format);
+
+    QList<Entry> entries() const override;
+    bool write(const QString &name, const QByteArray &bytes) override;
+    QByteArray read(const QString &name) const override;
+    void remove(const QString &name) override;
+    void clear() override;
+
+    virtual bool contains(int zoom, int x, int y) const = 0;
+    virtual QByteArray tile(int zoom, int x, int y) const = 0;
+
+    QString format() const;
+    int minimumZoomLevel() const;
+    int maximumZoomLevel() const;
+
+protected:
+    QString format_;
+    int minimumZoomLevel_ = 0;
+    int maximumZoomLevel_ = 30;
+};
+
+/* PMTiles version 3 archive. The file is memory mapped, a tile is found
+ * through the directories indexing the tiles by their position on the
+ * Hilbert curve of their zoom level, and read in place. Leaf directories
+ * are decoded on demand and the most recently used ones kept. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTilePMTilesArchive : public QGeoTileArchive
+{
+public:
+    QGeoTilePMTilesArchive();
+    ~QGeoTilePMTilesArchive();
+
+    QString kind() const override;
+    bool open(const QString &fileName) override;
+
+    bool contains(int zoom, int x, int y) const override;
+    QByteArray tile(int zoom, int x, int y) const override;
+
+    static quint64 tileId(int zoom, int x, int y);
+
+private:
+    struct DirectoryEntry
+    {
+        quint64 tileId = 0;
+        quint64 offset = 0;
+        quint32 length = 0;
+        quint32 runLength = 0; // 0 for a leaf directory
+    };
+    typedef QList<DirectoryEntry> Directory;
+
+    bool findTile(quint64 tileId, quint64 *offset, quint32 *length) const;
+    bool decodeDirectory(quint64 offset, quint64 length, Directory *directory) const;
+    QByteArray decompress(const char *data, qint64 size, quint8 compression) const;
+
+    mutable QFile file_;
+    const uchar *map_ = nullptr;
+    qint64 size_ = 0;
+    Directory root_;
+    quint64 leafDirectoriesOffset_ = 0;
+    quint64 tileDataOffset_ = 0;
+    quint8 internalCompression_ = 0;
+    quint8 tileCompression_ = 0;
+
+    mutable QMutex mutex_;
+    mutable QCache<quint64, Directory> leaves_;
+};
+
+#ifdef QT_LOCATION_MBTILES
+/* MBTiles archive, an SQLite database read through QtSql. Every thread
+ * reading tiles gets its own read-only connection, with the database
+ * memory mapped by SQLite. A connection belongs to its QThread and is
+ * closed by that thread when it finishes. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileMBTilesArchive : public QGeoTileArchive
+{
+public:
+    QGeoTileMBTilesArchive();
+    ~QGeoTileMBTilesArchive();
+
+    QString kind() const override;
+    bool open(const QString &fileName) override;
+
+    bool contains(int zoom, int x, int y) const override;
+    QByteArray tile(int zoom, int x, int y) const override;
+
+private:
+    struct Connection;
+    QString connection() const;
+
+    QString fileName_;
+    QString connectionPrefix_;
+    mutable QThreadStorage<Connection *> connection_;
+    mutable QMutex mutex_;
+    mutable QStringList connections_; // of all the threads, for the destructor
+};
+#endif
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEARCHIVE_P_H
@@ -0,0 +1,436 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotilecompression_p.h"
+
+#include <QtCore/QtEndian>
+
+#include <climits>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Both formats take 8 bytes per block of 4x4 pixels
+const int BlockSize = 8;
+
+struct Rgb
+{
+    int c[3];
+};
+
+// The 16 pixels of a block, row by row
+void readBlock(const QImage &image, int bx, int by, Rgb *block)
+{
+    for (int y = 0; y < 4; ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(by + y)) + bx;
+        for (int x = 0; x < 4; ++x)
+            block[y * 4 + x] = { { qRed(line[x]), qGreen(line[x]), qBlue(line[x]) } };
+    }
+}
+
+void writeBlock(QImage *image, int bx, int by, const Rgb *block)
+{
+    for (int y = 0; y < 4; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image->scanLine(by + y)) + bx;
+        for (int x = 0; x < 4; ++x) {
+            const Rgb &p = block[y * 4 + x];
+            line[x] = qRgb(p.c[0], p.c[1], p.c[2]);
+        }
+    }
+}
+
+inline int distance(const Rgb &a, const Rgb &b)
+{
+    int d = 0;
+    for (int i = 0; i < 3; ++i)
+        d += (a.c[i] - b.c[i]) * (a.c[i] - b.c[i]);
+    return d;
+}
+
+inline int expand4(int v) { return (v << 4) | v; }
+inline int expand5(int v) { return (v << 3) | (v >> 2); }
+inline int expand6(int v) { return (v << 2) | (v >> 4); }
+
+/* BC1: two RGB565 endpoints, little endian, then 2 bit indices into the
+ * palette they span, pixels row by row from the low bits. Only the four
+ * color mode (color0 > color1) is emitted. */
+
+inline quint16 toRgb565(const Rgb &p)
+{
+    return quint16(((p.c[0] * 31 + 127) / 255) << 11 | ((p.c[1] * 63 + 127) / 255) << 5
+                   | ((p.c[2] * 31 + 127) / 255));
+}
+
+inline Rgb fromRgb565(quint16 v)
+{
+    return { { expand5(v >> 11), expand6((v >> 5) & 0x3f), expand5(v & 0x1f) } };
+}
+
+void bc1Palette(quint16 color0, quint16 color1, Rgb *palette)
+{
+    palette[0] = fromRgb565(color0);
+    palette[1] = fromRgb565(color1);
+    for (int i = 0; i < 3; ++i) {
+        const int c0 = palette[0].c[i];
+        const int c1 = palette[1].c[i];
+        if (color0 > color1) {
+            palette[2].c[i] = (2 * c0 + c1) / 3;
+            palette[3].c[i] = (c0 + 2 * c1) / 3;
+        } else {
+            palette[2].c[i] = (c0 + c1) / 2;
+            palette[3].c[i] = 0;
+        }
+    }
+}
+
+/* Endpoints on the bounding box of the block, inset by 1/16th against
+ * outliers, along the diagonal following the sign of the red/green and
+ * blue/green covariances */
+void encodeBc1Block(const Rgb *block, uchar *out)
+{
+    Rgb lo = block[0];
+    Rgb hi = block[0];
+    int sum[3] = {};
+    for (int k = 0; k < 16; ++k) {
+        for (int i = 0; i < 3; ++i) {
+            lo.c[i] = qMin(lo.c[i], block[k].c[i]);
+            hi.c[i] = qMax(hi.c[i], block[k].c[i]);
+            sum[i] += block[k].c[i];
+        }
+    }
+    int covariance[3] = {};
+    for (int k = 0; k < 16; ++k) {
+        const int dg = 16 * block[k].c[1] - sum[1];
+        covariance[0] += (16 * block[k].c[0] - sum[0]) * dg;
+        covariance[2] += (16 * block[k].c[2] - sum[2]) * dg;
+    }
+    for (int i : { 0, 2 }) {
+        if (covariance[i] < 0)
+            std::swap(lo.c[i], hi.c[i]);
+    }
+    for (int i = 0; i < 3; ++i) {
+        const int inset = (hi.c[i] - lo.c[i]) / 16;
+        hi.c[i] -= inset;
+        lo.c[i] += inset;
+    }
+
+    quint16 color0 = toRgb565(hi);
+    quint16 color1 = toRgb565(lo);
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    quint32 indices = 0;
+    if (color0 != color1) {
+        Rgb palette[4];
+        bc1Palette(color0, color1, palette);
+        for (int k = 0; k < 16; ++k) {
+            int best = 0;
+            int bestDistance = distance(block[k], palette[0]);
+            for (int j = 1; j < 4; ++j) {
+                const int d = distance(block[k], palette[j]);
+                if (d < bestDistance) {
+                    best = j;
+                    bestDistance = d;
+                }
+            }
+            indices |= quint32(best) << (2 * k);
+        }
+    }
+
+    qToLittleEndian<quint16>(color0, out);
+    qToLittleEndian<quint16>(color1, out + 2);
+    qToLittleEndian<quint32>(indices, out + 4);
+}
+
+void decodeBc1Block(const uchar *in, Rgb *block)
+{
+    Rgb palette[4];
+    bc1Palette(qFromLittleEndian<quint16>(in), qFromLittleEndian<quint16>(in + 2), palette);
+    const quint32 indices = qFromLittleEndian<quint32>(in + 4);
+    for (int k = 0; k < 16; ++k)
+        block[k] = palette[(indices >> (2 * k)) & 3];
+}
+
+/* ETC1, a big endian 64 bit word: two subblocks of 2x4 pixels, side by side
+ * or stacked (flip bit), each with a base color and a table of intensity
+ * modifiers. Bases are either two RGB444 colors, or an RGB555 color and a
+ * 3 bit signed difference to the second one (diff bit). Every pixel picks
+ * one of the four modifiers of its table with a 2 bit index, split in a
+ * most and a least significant bit plane, pixels column by column. */
+
+const int EtcModifiers[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+// Pixel index 0 and 1 add the small and the large modifier, 2 and 3 subtract them
+inline int etcModifier(int table, int index)
+{
+    const int modifier = EtcModifiers[table][index & 1];
+    return (index & 2) ? -modifier : modifier;
+}
+
+inline Rgb etcModify(const Rgb &base, int modifier)
+{
+    return { { qBound(0, base.c[0] + modifier, 255), qBound(0, base.c[1] + modifier, 255),
+               qBound(0, base.c[2] + modifier, 255) } };
+}
+
+inline bool inFirstSubblock(int k, bool flip)
+{
+    return flip ? k / 4 < 2 : k % 4 < 2;
+}
+
+// Picks the table and the pixel indices of a subblock for its base color
+int fitEtcSubblock(const Rgb *block, bool flip, bool first, const Rgb &base,
+                   int *table, quint8 *indices)
+{
+    int bestError = INT_MAX;
+    for (int t = 0; t < 8; ++t) {
+        Rgb colors[4];
+        for (int j = 0; j < 4; ++j)
+            colors[j] = etcModify(base, etcModifier(t, j));
+
+        int error = 0;
+        quint8 choice[16];
+        for (int k = 0; k < 16; ++k) {
+            if (inFirstSubblock(k, flip) != first)
+                continue;
+            int best = 0;
+            int bestDistance = distance(block[k], colors[0]);
+            for (int j = 1; j < 4; ++j) {
+                const int d = distance(block[k], colors[j]);
+                if (d < bestDistance) {
+                    best = j;
+                    bestDistance = d;
+                }
+            }
+            choice[k] = quint8(best);
+            error += bestDistance;
+        }
+
+        if (error < bestError) {
+            bestError = error;
+            *table = t;
+            for (int k = 0; k < 16; ++k) {
+                if (inFirstSubblock(k, flip) == first)
+                    indices[k] = choice[k];
+            }
+        }
+    }
+    return bestError;
+}
+
+// Bases are the subblock averages, tried with both orientations
+void encodeEtc1Block(const Rgb *block, uchar *out)
+{
+    quint64 bestBits = 0;
+    int bestError = INT_MAX;
+    for (int flip = 0; flip < 2; ++flip) {
+        int sum[2][3] = {};
+        for (int k = 0; k < 16; ++k) {
+            const int s = inFirstSubblock(k, flip) ? 0 : 1;
+            for (int i = 0; i < 3; ++i)
+                sum[s][i] += block[k].c[i];
+        }
+
+        // Rounded averages of the 8 pixels, on 5 and on 4 bits
+        int q5[2][3];
+        int q4[2][3];
+        bool differential = true;
+        for (int s = 0; s < 2; ++s) {
+            for (int i = 0; i < 3; ++i) {
+                q5[s][i] = (sum[s][i] * 31 + 1020) / 2040;
+                q4[s][i] = (sum[s][i] * 15 + 1020) / 2040;
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            const int d = q5[1][i] - q5[0][i];
+            if (d < -4 || d > 3)
+                differential = false;
+        }
+
+        Rgb bases[2];
+        for (int s = 0; s < 2; ++s) {
+            for (int i = 0; i < 3; ++i)
+                bases[s].c[i] = differential ? expand5(q5[s][i]) : expand4(q4[s][i]);
+        }
+
+        int tables[2] = {};
+        quint8 indices[16] = {};
+        const int error = fitEtcSubblock(block, flip, true, bases[0], &tables[0], indices)
+                + fitEtcSubblock(block, flip, false, bases[1], &tables[1], indices);
+        if (error >= bestError)
+            continue;
+        bestError = error;
+
+        quint64 bits = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (differential) {
+                bits |= quint64(q5[0][i]) << (59 - 8 * i);
+                bits |= quint64((q5[1][i] - q5[0][i]) & 7) << (56 - 8 * i);
+            } else {
+                bits |= quint64(q4[0][i]) << (60 - 8 * i);
+                bits |= quint64(q4[1][i]) << (56 - 8 * i);
+            }
+        }
+        bits |= quint64(tables[0]) << 37 | quint64(tables[1]) << 34;
+        bits |= quint64(differential) << 33 | quint64(flip) << 32;
+        for (int k = 0; k < 16; ++k) {
+            const int bit = (k % 4) * 4 + k / 4;
+            bits |= quint64(indices[k] >> 1) << (16 + bit);
+            bits |= quint64(indices[k] & 1) << bit;
+        }
+        bestBits = bits;
+    }
+    qToBigEndian<quint64>(bestBits, out);
+}
+
+void decodeEtc1Block(const uchar *in, Rgb *block)
+{
+    const quint64 bits = qFromBigEndian<quint64>(in);
+    const bool flip = (bits >> 32) & 1;
+    const bool differential = (bits >> 33) & 1;
+
+    Rgb bases[2];
+    for (int i = 0; i < 3; ++i) {
+        if (differential) {
+            const int base = (bits >> (59 - 8 * i)) & 0x1f;
+            int delta = (bits >> (56 - 8 * i)) & 7;
+            if (delta >= 4)
+                delta -= 8;
+            bases[0].c[i] = expand5(base);
+            bases[1].c[i] = expand5(qBound(0, base + delta, 31));
+        } else {
+            bases[0].c[i] = expand4((bits >> (60 - 8 * i)) & 0xf);
+            bases[1].c[i] = expand4((bits >> (56 - 8 * i)) & 0xf);
+        }
+    }
+    const int tables[2] = { int((bits >> 37) & 7), int((bits >> 34) & 7) };
+
+    for (int k = 0; k < 16; ++k) {
+        const int bit = (k % 4) * 4 + k / 4;
+        const int index = int(((bits >> (16 + bit)) & 1) << 1 | ((bits >> bit) & 1));
+        const int s = inFirstSubblock(k, flip) ? 0 : 1;
+        block[k] = etcModify(bases[s], etcModifier(tables[s], index));
+    }
+}
+
+}
+
+bool QGeoCompressedTileImage::isOpaque(const QImage &image)
+{
+    if (!image.hasAlphaChannel())
+        return true;
+    const QImage argb = (image.format() == QImage::Format_ARGB32
+                         || image.format() == QImage::Format_ARGB32_Premultiplied)
+            ? image : image.convertToFormat(QImage::Format_ARGB32);
+    for (int y = 0; y < argb.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(argb.constScanLine(y));
+        for (int x = 0; x < argb.width(); ++x) {
+            if (qAlpha(line[x]) != 255)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool QGeoCompressedTileImage::canCompress(const QImage &image)
+{
+    return !image.isNull() && image.width() == image.height() && image.width() % 4 == 0
+            && isOpaque(image);
+}
+
+/*
+    Returns \a image compressed to \a format, or a null image if it can't be
+    compressed. Compressing a 256x256 tile takes a few milliseconds, it is
+    meant to be done once, off the render thread.
+*/
+QGeoCompressedTileImage QGeoCompressedTileImage::compress(const QImage &image, Format format)
+{
+    QGeoCompressedTileImage result;
+    if (format == NoCompression || !canCompress(image))
+        return result;
+
+    const QImage rgb = image.convertToFormat(QImage::Format_RGB32);
+    const int blocksX = rgb.width() / 4;
+    const int blocksY = rgb.height() / 4;
+    result.m_data.resize(qsizetype(blocksX) * blocksY * BlockSize);
+    uchar *out = reinterpret_cast<uchar *>(result.m_data.data());
+
+    Rgb block[16];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            readBlock(rgb, bx * 4, by * 4, block);
+            if (format == BC1)
+                encodeBc1Block(block, out);
+            else
+                encodeEtc1Block(block, out);
+            out += BlockSize;
+        }
+    }
+    result.m_size = rgb.size();
+    result.m_format = format;
+    return result;
+}
+
+QImage QGeoCompressedTileImage::toImage() const
+{
+    if (isNull())
+        return QImage();
+
+    QImage image(m_size, QImage::Format_RGB32);
+    const uchar *in = reinterpret_cast<const uchar *>(m_data.constData());
+    Rgb block[16];
+    for (int by = 0; by < m_size.height(); by += 4) {
+        for (int bx = 0; bx < m_size.width(); bx += 4) {
+            if (m_format == BC1)
+                decodeBc1Block(in, block);
+            else
+                decodeEtc1Block(in, block);
+            writeBlock(&image, bx, by, block);
+            in += BlockSize;
+        }
+    }
+    return image;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILECOMPRESSION_P_H
+#define QGEOTILECOMPRESSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSize>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+/* Tile image block compressed on the CPU into a format the GPU samples as
+ * is, at 4 bits per pixel: an eighth of the ARGB32 image, uploaded without
+ * decoding. BC1 (DXT1) is the desktop format, ETC2_RGB8 the one of OpenGL ES 3
+ * and mobile Vulkan GPUs; the encoder only emits ETC1 blocks, which are valid
+ * ETC2 ones.
+ *
+ * Both formats are opaque and work on 4x4 blocks, so only opaque square tiles
+ * with a side multiple of 4 are compressed. toImage() decodes the blocks back,
+ * for the graphics backends lacking the format. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoCompressedTileImage
+{
+public:
+    enum Format : quint8 {
+        NoCompression,
+        BC1,
+        ETC2_RGB8
+    };
+
+    QGeoCompressedTileImage() = default;
+
+    static bool isOpaque(const QImage &image);
+    static bool canCompress(const QImage &image);
+    static QGeoCompressedTileImage compress(const QImage &image, Format format);
+    QImage toImage() const;
+
+    bool isNull() const { return m_format == NoCompression; }
+    Format format() const { return m_format; }
+    QSize size() const { return m_size; }
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+    QSize m_size;
+    Format m_format = NoCompression;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILECOMPRESSION_P_H
@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeotilediskstorage_p.h"
+
+#include <QDir>
+#include <QFile>
+
+#if defined(Q_OS_WIN)
+#  include <io.h>
+#elif defined(Q_OS_UNIX)
+#  include <unistd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QGeoTileDiskStorage::~QGeoTileDiskStorage()
+{
+}
+
+bool QGeoTileDiskStorage::sync()
+{
+    return true;
+}
+
+void QGeoTileDiskStorage::discardUnsynced()
+{
+}
+
+// Flushes the file down to the storage device, not only to the OS
+bool QGeoTileDiskStorage::syncFile(QFile &file)
+{
+    if (!file.flush())
+        return false;
+#if defined(Q_OS_WIN)
+    return ::_commit(file.handle()) == 0;
+#elif defined(Q_OS_UNIX)
+    return ::fsync(file.handle()) == 0;
+#else
+    return true;
+#endif
+}
+
+QString QGeoTileFileStorage::kind() const
+{
+    return QStringLiteral("files");
+}
+
+bool QGeoTileFileStorage::open(const QString &directory)
+{
+    directory_ = directory;
+    return QDir(directory_).exists();
+}
+
+QList<QGeoTileDiskStorage::Entry> QGeoTileFileStorage::entries() const
+{
+    QList<Entry> result;
+    QDir dir(directory_);
+    const QFileInfoList files = dir.entryInfoList({ QLatin1String("*.*") }, QDir::Files);
+    result.reserve(files.size());
+    for (const QFileInfo &fi : files)
+        result.append({ fi.fileName(), fi.size(), fi.lastModified() });
+    return result;
+}
+
+bool QGeoTileFileStorage::write(const QString &name, const QByteArray &bytes)
+{
+    QFile file(QDir(directory_).filePath(name));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    const bool ok = file.write(bytes) == bytes.size();
+    file.close();
+    if (ok)
+        unsynced_.append(name);
+    return ok;
+}
+
+QByteArray QGeoTileFileStorage::read(const QString &name) const
+{
+    QFile file(QDir(directory_).filePath(name));
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+void QGeoTileFileStorage::remove(const QString &name)
+{
+    QFile::remove(QDir(directory_).filePath(name));
+}
+
+bool QGeoTileFileStorage::sync()
+{
+    // Reopened for writing, Windows can't flush a read-only handle
+    bool ok = true;
+    const QDir dir(directory_);
+    for (const QString &name : qAsConst(unsynced_)) {
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::ReadWrite | QIODevice::ExistingOnly))
+            continue; // removed in the meantime
+        ok = syncFile(file) && ok;
+    }
+    unsynced_.clear();
+    return ok;
+}
+
+void QGeoTileFileStorage::discardUnsynced()
+{
+    unsynced_.clear();
+}
+
+void QGeoTileFileStorage::clear()
+{
+    QDir dir(directory_);
+    dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
+    dir.setFilter(QDir::Files);
+    for (const QString &dirFile : dir.entryList())
+        dir.remove(dirFile);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOTILEDISKSTORAGE_P_H
+#define QGEOTILEDISKSTORAGE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+QT_BEGIN_NAMESPACE
+
+class QFile;
+
+/* Backend of the QGeoFileTileCache disk cache. Tiles are addressed by the
+ * file name produced by QGeoFileTileCache::tileSpecToFilename(), relative to
+ * the cache directory, so subclasses keep their own naming schemes.
+ *
+ * read() may be called from the tile loading threads. write(), remove() and
+ * sync() are called from the cache's writer thread, one call at a time and
+ * in the order the cache queued them. Everything else is only called from
+ * the thread owning the cache, once the writes queued so far are done.
+ *
+ * sync() flushes what was written so far to the storage device, so that it
+ * survives a power loss, the cache calls it according to its sync policy.
+ * Without one, it calls discardUnsynced() after each batch of writes
+ * instead, the flushing is then left to the OS. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileDiskStorage
+{
+public:
+    struct Entry
+    {
+        QString name;
+        qint64 size = 0;
+        QDateTime lastModified;
+    };
+
+    virtual ~QGeoTileDiskStorage();
+
+    // Identifies the layout, a cache manifest is only valid for the same one
+    virtual QString kind() const = 0;
+    virtual bool open(const QString &directory) = 0;
+    virtual QList<Entry> entries() const = 0;
+
+    virtual bool write(const QString &name, const QByteArray &bytes) = 0;
+    virtual QByteArray read(const QString &name) const = 0;
+    virtual void remove(const QString &name) = 0;
+    virtual void clear() = 0;
+    virtual bool sync();
+    virtual void discardUnsynced();
+
+protected:
+    static bool syncFile(QFile &file);
+};
+
+/* One file per tile, the historical layout of the cache directory */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileFileStorage : public QGeoTileDiskStorage
+{
+public:
+    QString kind() const override;
+    bool open(const QString &directory) override;
+    QList<Entry> entries() const override;
+
+    bool write(const QString &name, const QByteArray &bytes) override;
+    QByteArray read(const QString &name) const override;
+    void remove(const QString &name) override;
+    void clear() override;
+    bool sync() override;
+    void discardUnsynced() override;
+
+private:
+    QString directory_;
+    QStringList unsynced_; // written since the last sync(), writer thread only
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEDISKSTORAGE_P_H
@@ -47,11 +47,22 @@
 #include "qgeotilerequestmanager_p.h"
 #include "qgeotiledmapscene_p.h"
 #include "qgeocameracapabilities_p.h"
+#include "qgeotilemetrics_p.h"
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
 #include <cmath>
 
 QT_BEGIN_NAMESPACE
 #define PREFETCH_FRUSTUM_SCALE 2.0
 
+// Motion prefetching: how far ahead the camera path is extrapolated, in seconds,
+// and the speeds below which the camera is considered at rest
+static const double PrefetchLookAhead[] = { 0.25, 0.5, 1.0 };
+static const double MinimumPrefetchSpeed = 0.5; // tiles per second
+static const double MinimumPrefetchZoomSpeed = 0.1; // zoom levels per second
+static const qint64 PathPrefetchInterval = 100; // ms
+static const qint64 MotionSampleTimeout = 250; // ms, longer pauses restart the estimate
+
 static const double invLog2 = 1.0 / std::log(2.0);
 
 static double zoomLevelFrom256(double zoomLevelFor256, double tileSize)
@@ -59,6 +70,16 @@ static double zoomLevelFrom256(double zoomLevelFor256, double tileSize)
     return std::log( std::pow(2.0, zoomLevelFor256) * 256.0 / tileSize ) * invLog2;
 }
 
+// The scene and the request manager work on keys, copyrights are evaluated on specs
+static QSet<QGeoTileSpec> tileSpecs(const QSet<QGeoTileKey> &keys)
+{
+    QSet<QGeoTileSpec> specs;
+    specs.reserve(keys.size());
+    for (const QGeoTileKey &key : keys)
+        specs.insert(QGeoTileSpec(key));
+    return specs;
+}
+
 QGeoTiledMap::QGeoTiledMap(QGeoTiledMappingManagerEngine *engine, QObject *parent)
     : QGeoMap(*new QGeoTiledMapPrivate(engine), parent)
 {
@@ -68,6 +89,8 @@ QGeoTiledMap::QGeoTiledMap(QGeoTiledMappingManagerEngine *engine, QObject *paren
 
     QObject::connect(engine,&QGeoTiledMappingManagerEngine::tileVersionChanged,
                      this,&QGeoTiledMap::handleTileVersionChanged);
+    QObject::connect(engine, &QGeoTiledMappingManagerEngine::tileUpdated,
+                     this, &QGeoTiledMap::updateTile);
     QObject::connect(this, &QGeoMap::cameraCapabilitiesChanged,
                      [d](const QGeoCameraCapabilities &oldCameraCapabilities) {
                        d->onCameraCapabilitiesChanged(oldCameraCapabilities);
@@ -83,6 +106,8 @@ QGeoTiledMap::QGeoTiledMap(QGeoTiledMapPrivate &dd, QGeoTiledMappingManagerEngin
 
     QObject::connect(engine,&QGeoTiledMappingManagerEngine::tileVersionChanged,
                      this,&QGeoTiledMap::handleTileVersionChanged);
+    QObject::connect(engine, &QGeoTiledMappingManagerEngine::tileUpdated,
+                     this, &QGeoTiledMap::updateTile);
     QObject::connect(this, &QGeoMap::cameraCapabilitiesChanged,
                      [d](const QGeoCameraCapabilities &oldCameraCapabilities) {
                        d->onCameraCapabilitiesChanged(oldCameraCapabilities);
@@ -114,6 +139,26 @@ void QGeoTiledMap::updateTile(const QGeoTileSpec &spec)
     d->updateTile(spec);
 }
 
+// The number of visible tiles still waiting for their texture
+int QGeoTiledMap::pendingVisibleTiles() const
+{
+    Q_D(const QGeoTiledMap);
+    return (d->m_mapScene->visibleTiles() - d->m_mapScene->texturedTiles()).size();
+}
+
+// The visible tile under the center of the viewport
+QGeoTileSpec QGeoTiledMap::centerTile() const
+{
+    Q_D(const QGeoTiledMap);
+    const QGeoCameraData camera = d->m_visibleTiles->cameraData();
+    const int zoom = static_cast<int>(std::floor(camera.zoomLevel()));
+    const int sideLength = 1 << zoom;
+    const QDoubleVector2D center = QWebMercator::coordToMercator(camera.center()) * sideLength;
+    return QGeoTileSpec(QString(), d->m_visibleTiles->activeMapType().mapId(), zoom,
+                        qBound(0, static_cast<int>(center.x()), sideLength - 1),
+                        qBound(0, static_cast<int>(center.y()), sideLength - 1));
+}
+
 void QGeoTiledMap::setPrefetchStyle(QGeoTiledMap::PrefetchStyle style)
 {
     Q_D(QGeoTiledMap);
@@ -132,6 +177,29 @@ QSGNode *QGeoTiledMap::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
     return d->updateSceneGraph(oldNode, window);
 }
 
+/*!
+    \internal
+    Sets the maximum number of tiles requested ahead of a moving camera.
+    Zero disables motion prefetching.
+*/
+void QGeoTiledMap::setPrefetchTileBudget(int tiles)
+{
+    Q_D(QGeoTiledMap);
+    d->m_prefetchTileBudget = qMax(0, tiles);
+}
+
+void QGeoTiledMap::prefetchCameraTarget(const QGeoCameraData &target, int msecs)
+{
+    Q_D(QGeoTiledMap);
+    d->m_cameraTarget = target;
+    // Same zoom level adaptation as in changeCameraData
+    if (d->m_visibleTiles->tileSize() != 256)
+        d->m_cameraTarget.setZoomLevel(zoomLevelFrom256(target.zoomLevel(), d->m_visibleTiles->tileSize()));
+    d->m_cameraTargetTime = d->m_motionClock.elapsed() + qMax(0, msecs);
+    d->m_lastPathPrefetch = -1;
+    d->prefetchCameraPath();
+}
+
 void QGeoTiledMap::prefetchData()
 {
     Q_D(QGeoTiledMap);
@@ -143,10 +211,38 @@ void QGeoTiledMap::clearData()
     Q_D(QGeoTiledMap);
     d->m_cache->clearAll();
     d->m_mapScene->clearTexturedTiles();
+    d->m_incrementalTiles = false; // the visible tiles need to be requested again
     d->updateScene();
     sgNodeChanged();
 }
 
+/*
+    The tile metrics belong to the engine, so they are shared with the other
+    maps of the same plugin.
+*/
+void QGeoTiledMap::setMetricsEnabled(bool enabled)
+{
+    Q_D(QGeoTiledMap);
+    if (QGeoTiledMappingManagerEngine *engine = qobject_cast<QGeoTiledMappingManagerEngine *>(d->m_engine))
+        engine->tileMetrics()->setEnabled(enabled);
+}
+
+bool QGeoTiledMap::metricsEnabled() const
+{
+    Q_D(const QGeoTiledMap);
+    QGeoTiledMappingManagerEngine *engine = qobject_cast<QGeoTiledMappingManagerEngine *>(d->m_engine);
+    return engine && engine->tileMetrics()->isEnabled();
+}
+
+QVariantMap QGeoTiledMap::metrics() const
+{
+    Q_D(const QGeoTiledMap);
+    QGeoTiledMappingManagerEngine *engine = qobject_cast<QGeoTiledMappingManagerEngine *>(d->m_engine);
+    if (!engine)
+        return QVariantMap();
+    return engine->tileMetricsSnapshot().toVariantMap();
+}
+
 QGeoMap::Capabilities QGeoTiledMap::capabilities() const
 {
     return Capabilities(SupportsVisibleRegion
@@ -163,7 +259,7 @@ void QGeoTiledMap::setCopyrightVisible(bool visible)
 
     QGeoMap::setCopyrightVisible(visible);
     if (visible)
-        evaluateCopyrights(d->m_mapScene->visibleTiles());
+        evaluateCopyrights(tileSpecs(d->m_mapScene->visibleTiles()));
 }
 
 void QGeoTiledMap::clearScene(int mapId)
@@ -206,6 +302,8 @@ QGeoTiledMapPrivate::QGeoTiledMapPrivate(QGeoTiledMappingManagerEngine *engine)
     m_visibleTiles->setPluginString(pluginString);
     m_prefetchTiles->setPluginString(pluginString);
     m_mapScene->setTileSize(tileSize);
+    m_mapScene->setMetrics(engine->tileMetrics());
+    m_motionClock.start();
 }
 
 QGeoTiledMapPrivate::~QGeoTiledMapPrivate()
@@ -224,7 +322,7 @@ void QGeoTiledMapPrivate::prefetchTiles()
 {
     if (m_tileRequests && m_prefetchStyle != QGeoTiledMap::NoPrefetching) {
 
-        QSet<QGeoTileSpec> tiles;
+        QSet<QGeoTileKey> tiles;
         QGeoCameraData camera = m_visibleTiles->cameraData();
         int currentIntZoom = static_cast<int>(std::floor(camera.zoomLevel()));
 
@@ -272,8 +370,126 @@ void QGeoTiledMapPrivate::prefetchTiles()
             break;
         }
 
-        m_tileRequests->requestTiles(tiles - m_mapScene->texturedTiles());
+        // The visible tiles are requested by updateScene()
+        m_tileRequests->prefetchTiles(tiles - m_mapScene->visibleTiles());
+    }
+
+    // At rest: the prefetched tiles replace those along the last predicted path
+    m_cameraTargetTime = -1;
+    m_centerVelocity = QDoubleVector2D();
+    m_zoomVelocity = 0.0;
+}
+
+/*
+    Estimates the camera velocity from the successive camera changes, whatever
+    drives them: gestures, animations or the application.
+*/
+void QGeoTiledMapPrivate::updateCameraMotion(const QGeoCameraData &cameraData)
+{
+    const qint64 now = m_motionClock.elapsed();
+    const qint64 elapsed = now - m_lastMotionSample;
+    if (m_lastMotionSample >= 0 && elapsed <= 0)
+        return; // more than one change within the same ms, wait for the next sample
+
+    const QDoubleVector2D center = QWebMercator::coordToMercator(cameraData.center());
+    QDoubleVector2D delta = center - m_lastCenter;
+    if (delta.x() > 0.5) // across the dateline
+        delta.setX(delta.x() - 1.0);
+    else if (delta.x() < -0.5)
+        delta.setX(delta.x() + 1.0);
+
+    // Jumping by more than a screen or half a zoom level at once is not moving
+    const double mapSize = std::pow(2.0, cameraData.zoomLevel()) * m_visibleTiles->tileSize();
+    const bool jump = delta.length() * mapSize > qMax(m_viewportSize.width(), m_viewportSize.height())
+            || qAbs(cameraData.zoomLevel() - m_lastZoomLevel) > 0.5;
+
+    if (m_lastMotionSample >= 0 && elapsed < MotionSampleTimeout && !jump) {
+        const double seconds = elapsed / 1000.0;
+
+        // Smooth out the jitter of the input events and of the frame timing
+        m_centerVelocity = 0.5 * m_centerVelocity + (0.5 / seconds) * delta;
+        m_zoomVelocity = 0.5 * m_zoomVelocity + 0.5 * (cameraData.zoomLevel() - m_lastZoomLevel) / seconds;
+    } else {
+        m_centerVelocity = QDoubleVector2D();
+        m_zoomVelocity = 0.0;
+    }
+
+    m_lastMotionSample = now;
+    m_lastCenter = center;
+    m_lastZoomLevel = cameraData.zoomLevel();
+}
+
+/*
+    Returns where the camera is expected to be in the given number of seconds:
+    along the way to the target hinted by prefetchCameraTarget() if there is
+    one, extrapolated from the current velocity otherwise.
+*/
+QGeoCameraData QGeoTiledMapPrivate::predictCamera(double seconds) const
+{
+    QGeoCameraData camera = m_visibleTiles->cameraData();
+    QDoubleVector2D center = QWebMercator::coordToMercator(camera.center());
+    double zoomLevel = camera.zoomLevel();
+
+    const qint64 now = m_motionClock.elapsed();
+    if (m_cameraTargetTime > now) {
+        const double fraction = qMin(1.0, seconds * 1000.0 / (m_cameraTargetTime - now));
+        QDoubleVector2D delta = QWebMercator::coordToMercator(m_cameraTarget.center()) - center;
+        if (delta.x() > 0.5)
+            delta.setX(delta.x() - 1.0);
+        else if (delta.x() < -0.5)
+            delta.setX(delta.x() + 1.0);
+        center += fraction * delta;
+        zoomLevel += fraction * (m_cameraTarget.zoomLevel() - zoomLevel);
+    } else {
+        center += seconds * m_centerVelocity;
+        zoomLevel += seconds * m_zoomVelocity;
+    }
+
+    center.setX(center.x() - std::floor(center.x()));
+    center.setY(qBound(0.0, center.y(), 1.0));
+    camera.setCenter(QWebMercator::mercatorToCoord(center));
+    camera.setZoomLevel(qBound<double>(m_minZoomLevel, zoomLevel, m_maxZoomLevel));
+    return camera;
+}
+
+/*
+    Requests, within m_prefetchTileBudget, the tiles the moving camera will
+    show next, nearest in time first. The tiles of the previous prediction
+    that are not on the path anymore get cancelled.
+*/
+void QGeoTiledMapPrivate::prefetchCameraPath()
+{
+    if (!m_tileRequests || m_prefetchStyle == QGeoTiledMap::NoPrefetching || m_prefetchTileBudget <= 0)
+        return;
+
+    const qint64 now = m_motionClock.elapsed();
+    const QGeoCameraData camera = m_visibleTiles->cameraData();
+    const double sideLength = std::pow(2.0, std::floor(camera.zoomLevel()));
+    const bool animating = m_cameraTargetTime > now;
+    const bool moving = m_centerVelocity.length() * sideLength > MinimumPrefetchSpeed
+            || qAbs(m_zoomVelocity) > MinimumPrefetchZoomSpeed;
+    if (!animating && !moving)
+        return;
+
+    // The predicted tiles change by a row or a column at a time, no need to redo it every frame
+    if (m_lastPathPrefetch >= 0 && now - m_lastPathPrefetch < PathPrefetchInterval)
+        return;
+    m_lastPathPrefetch = now;
+
+    const QSet<QGeoTileKey> &visibleTiles = m_mapScene->visibleTiles();
+    QSet<QGeoTileKey> tiles;
+    m_prefetchTiles->setViewExpansion(1.0);
+    for (double seconds : PrefetchLookAhead) {
+        m_prefetchTiles->setCameraData(predictCamera(seconds));
+        for (const QGeoTileKey &tile : m_prefetchTiles->createTiles()) {
+            if (tiles.size() >= m_prefetchTileBudget)
+                break;
+            if (!visibleTiles.contains(tile))
+                tiles.insert(tile);
+        }
     }
+
+    m_tileRequests->prefetchTiles(tiles);
 }
 
 QGeoMapType QGeoTiledMapPrivate::activeMapType() const
@@ -331,23 +547,41 @@ void QGeoTiledMapPrivate::changeCameraData(const QGeoCameraData &cameraData)
     m_mapScene->setCameraData(cam);
 
     updateScene();
+    updateCameraMotion(cam);
+    prefetchCameraPath();
     q->sgNodeChanged(); // ToDo: explain why emitting twice
 }
 
 void QGeoTiledMapPrivate::updateScene()
 {
     Q_Q(QGeoTiledMap);
-    // detect if new tiles introduced
-    const QSet<QGeoTileSpec>& tiles = m_visibleTiles->createTiles();
-    bool newTilesIntroduced = !m_mapScene->visibleTiles().contains(tiles);
-    m_mapScene->setVisibleTiles(tiles);
-
-    if (newTilesIntroduced && m_copyrightVisible)
-        q->evaluateCopyrights(tiles);
-
-    // don't request tiles that are already built and textured
-    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > cachedTiles =
-            m_tileRequests->requestTiles(m_visibleTiles->createTiles() - m_mapScene->texturedTiles());
+    const QSet<QGeoTileKey> &tiles = m_visibleTiles->createTiles();
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > cachedTiles;
+
+    if (m_incrementalTiles && m_visibleTiles->hasTileDelta()) {
+        // Panning at the same zoom level, only pass on what changed
+        const QSet<QGeoTileKey> &added = m_visibleTiles->addedTiles();
+        const QSet<QGeoTileKey> &removed = m_visibleTiles->removedTiles();
+        m_mapScene->updateVisibleTiles(added, removed);
+
+        if (!added.isEmpty() && m_copyrightVisible)
+            q->evaluateCopyrights(tileSpecs(tiles));
+
+        // added tiles were not visible, so they can't be textured yet
+        if (!added.isEmpty() || !removed.isEmpty())
+            cachedTiles = m_tileRequests->requestTileChanges(added, removed);
+    } else {
+        // detect if new tiles introduced
+        bool newTilesIntroduced = !m_mapScene->visibleTiles().contains(tiles);
+        m_mapScene->setVisibleTiles(tiles);
+
+        if (newTilesIntroduced && m_copyrightVisible)
+            q->evaluateCopyrights(tileSpecs(tiles));
+
+        // don't request tiles that are already built and textured
+        cachedTiles = m_tileRequests->requestTiles(tiles - m_mapScene->texturedTiles());
+        m_incrementalTiles = true;
+    }
 
     for (auto it = cachedTiles.cbegin(); it != cachedTiles.cend(); ++it)
         m_mapScene->addTile(it.key(), it.value());
@@ -371,7 +605,7 @@ void QGeoTiledMapPrivate::setVisibleArea(const QRectF &visibleArea)
     m_mapScene->setVisibleArea(va);
 
      if (m_copyrightVisible)
-        q->evaluateCopyrights(m_mapScene->visibleTiles());
+        q->evaluateCopyrights(tileSpecs(m_mapScene->visibleTiles()));
     updateScene();
     q->sgNodeChanged(); // ToDo: explain why emitting twice
 }
@@ -402,7 +636,8 @@ void QGeoTiledMapPrivate::changeTileVersion(int version)
 void QGeoTiledMapPrivate::clearScene()
 {
     m_mapScene->clearTexturedTiles();
-    m_mapScene->setVisibleTiles(QSet<QGeoTileSpec>());
+    m_mapScene->setVisibleTiles(QSet<QGeoTileKey>());
+    m_incrementalTiles = false;
     updateScene();
 }
 
@@ -430,7 +665,7 @@ void QGeoTiledMapPrivate::changeViewportSize(const QSize& size)
     }
 
     if (m_copyrightVisible)
-        q->evaluateCopyrights(m_mapScene->visibleTiles());
+        q->evaluateCopyrights(tileSpecs(m_mapScene->visibleTiles()));
     updateScene();
 }
 
@@ -438,9 +673,9 @@ void QGeoTiledMapPrivate::updateTile(const QGeoTileSpec &spec)
 {
      Q_Q(QGeoTiledMap);
     // Only promote the texture up to GPU if it is visible
-    if (m_visibleTiles->createTiles().contains(spec)){
+    if (m_mapScene->visibleTiles().contains(spec.key())){
         QSharedPointer<QGeoTileTexture> tex = m_tileRequests->tileTexture(spec);
-        if (!tex.isNull() && !tex->image.isNull()) {
+        if (!tex.isNull() && !tex->isNull()) {
             m_mapScene->addTile(spec, tex);
             emit q->sgNodeChanged();
         }
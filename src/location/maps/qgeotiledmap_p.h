@@ -81,10 +81,17 @@ public:
     QAbstractGeoTileCache *tileCache();
     QGeoTileRequestManager *requestManager();
     void updateTile(const QGeoTileSpec &spec);
+    QGeoTileSpec centerTile() const;
+    int pendingVisibleTiles() const;
     void setPrefetchStyle(PrefetchStyle style);
+    void setPrefetchTileBudget(int tiles);
 
     void prefetchData() override;
+    void prefetchCameraTarget(const QGeoCameraData &target, int msecs) override;
     void clearData() override;
+    void setMetricsEnabled(bool enabled) override;
+    bool metricsEnabled() const override;
+    QVariantMap metrics() const override;
     Capabilities capabilities() const override;
 
     void setCopyrightVisible(bool visible) override;
@@ -51,6 +51,7 @@
 //
 
 #include <QtCore/QPointer>
+#include <QtCore/QElapsedTimer>
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeomap_p_p.h>
@@ -83,6 +84,9 @@ public:
 
     void updateTile(const QGeoTileSpec &spec);
     void prefetchTiles();
+    void updateCameraMotion(const QGeoCameraData &cameraData);
+    void prefetchCameraPath();
+    QGeoCameraData predictCamera(double seconds) const;
     QGeoMapType activeMapType() const;
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
 
@@ -112,6 +116,19 @@ protected:
     int m_maxZoomLevel;
     int m_minZoomLevel;
     QGeoTiledMap::PrefetchStyle m_prefetchStyle;
+    bool m_incrementalTiles = false; // the scene and m_tileRequests hold the last m_visibleTiles set
+
+    // Camera motion, to prefetch the tiles along the predicted path
+    QElapsedTimer m_motionClock;
+    qint64 m_lastMotionSample = -1;
+    qint64 m_lastPathPrefetch = -1;
+    QDoubleVector2D m_lastCenter;     // in mercator coordinates
+    double m_lastZoomLevel = 0.0;
+    QDoubleVector2D m_centerVelocity; // mercator units per second
+    double m_zoomVelocity = 0.0;      // zoom levels per second
+    QGeoCameraData m_cameraTarget;
+    qint64 m_cameraTargetTime = -1;   // when m_cameraTarget is reached, on m_motionClock
+    int m_prefetchTileBudget = 64;
     Q_DISABLE_COPY(QGeoTiledMapPrivate)
 };
 
@@ -44,6 +44,7 @@
 
 #include "qgeotiledmap_p.h"
 #include "qgeotilerequestmanager_p.h"
+#include "qgeotileseedjob_p.h"
 #include "qgeofiletilecache_p.h"
 #include "qgeotilespec_p.h"
 
@@ -65,6 +66,9 @@ QGeoTiledMappingManagerEngine::QGeoTiledMappingManagerEngine(QObject *parent)
 */
 QGeoTiledMappingManagerEngine::~QGeoTiledMappingManagerEngine()
 {
+    // The fetcher is a child, deleted after the metrics
+    if (d_ptr->fetcher_)
+        d_ptr->fetcher_->setMetrics(nullptr);
     delete d_ptr;
 }
 
@@ -75,16 +79,24 @@ void QGeoTiledMappingManagerEngine::setTileFetcher(QGeoTileFetcher *fetcher)
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
-    if (d->fetcher_)
+    if (d->fetcher_) {
+        d->fetcher_->setMetrics(nullptr);
         d->fetcher_->deleteLater();
+    }
     fetcher->setParent(this);
+    fetcher->setMetrics(&d->metrics_);
     d->fetcher_ = fetcher;
 
     qRegisterMetaType<QGeoTileSpec>();
+    qRegisterMetaType<QGeoTileFormat>();
+    qRegisterMetaType<QGeoTileValidators>();
 
     connect(d->fetcher_, &QGeoTileFetcher::tileFinished,
             this, &QGeoTiledMappingManagerEngine::engineTileFinished,
             Qt::QueuedConnection);
+    connect(d->fetcher_, &QGeoTileFetcher::tileNotModified,
+            this, &QGeoTiledMappingManagerEngine::engineTileNotModified,
+            Qt::QueuedConnection);
     connect(d->fetcher_, &QGeoTileFetcher::tileError,
             this, &QGeoTiledMappingManagerEngine::engineTileError,
             Qt::QueuedConnection);
@@ -122,6 +134,19 @@ void QGeoTiledMappingManagerEngine::releaseMap(QGeoTiledMap *map)
         }
     }
     d_ptr->tileHash_ = newTileHash;
+
+    QSet<QGeoTileSpec> cancelLoads;
+    for (auto it = d_ptr->loadHash_.begin(); it != d_ptr->loadHash_.end();) {
+        it.value().remove(map);
+        if (it.value().isEmpty()) {
+            cancelLoads.insert(it.key());
+            it = d_ptr->loadHash_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!cancelLoads.isEmpty() && d_ptr->tileCache_)
+        d_ptr->tileCache_->cancelLoads(cancelLoads);
 }
 
 void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
@@ -160,7 +185,8 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
         QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(*rem);
         mapSet.remove(map);
         if (mapSet.isEmpty()) {
-            cancelTiles.insert(*rem);
+            if (!d->seedHash_.contains(*rem) && !d->revalidating_.contains(*rem))
+                cancelTiles.insert(*rem);
             d->tileHash_.remove(*rem);
         } else {
             d->tileHash_.insert(*rem, mapSet);
@@ -170,7 +196,7 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
     add = tilesAdded.constBegin();
     for (; add != addEnd; ++add) {
         QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(*add);
-        if (mapSet.isEmpty()) {
+        if (mapSet.isEmpty() && !d->seedHash_.contains(*add) && !d->revalidating_.contains(*add)) {
             reqTiles.insert(*add);
         }
         mapSet.insert(map);
@@ -179,16 +205,75 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
 
     cancelTiles -= reqTiles;
 
+    QMetaObject::invokeMethod(d->fetcher_, "updateTileRequests",
+                              Qt::QueuedConnection,
+                              Q_ARG(QSet<QGeoTileSpec>, reqTiles),
+                              Q_ARG(QSet<QGeoTileSpec>, cancelTiles),
+                              Q_ARG(QGeoTileSpec, map->centerTile()));
+}
+
+/*!
+    Creates a job downloading the tiles of \a mapType covering \a region into
+    the disk cache, from \a minimumZoomLevel to \a maximumZoomLevel included.
+    The job is owned by \a parent, and does nothing until started.
+
+    \sa QGeoTileSeedJob
+*/
+QGeoTileSeedJob *QGeoTiledMappingManagerEngine::createSeedJob(const QGeoShape &region,
+                                                              int minimumZoomLevel,
+                                                              int maximumZoomLevel,
+                                                              const QGeoMapType &mapType,
+                                                              QObject *parent)
+{
+    return new QGeoTileSeedJob(this, region, minimumZoomLevel, maximumZoomLevel, mapType, parent);
+}
+
+/*
+    Same as updateTileRequests(), for the tiles \a job is downloading.
+    Tiles requested by both maps and seed jobs are fetched once.
+*/
+void QGeoTiledMappingManagerEngine::updateSeedRequests(QGeoTileSeedJob *job,
+                                                       const QSet<QGeoTileSpec> &tilesAdded,
+                                                       const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QSet<QGeoTileSpec> reqTiles;
+    QSet<QGeoTileSpec> cancelTiles;
+
+    for (const QGeoTileSpec &spec : tilesRemoved) {
+        if (!d->seedHash_.remove(spec, job))
+            continue;
+        if (!d->seedHash_.contains(spec) && !d->tileHash_.contains(spec)
+                && !d->revalidating_.contains(spec)) {
+            cancelTiles.insert(spec);
+        }
+    }
+
+    for (const QGeoTileSpec &spec : tilesAdded) {
+        if (!d->seedHash_.contains(spec) && !d->tileHash_.contains(spec)
+                && !d->revalidating_.contains(spec)) {
+            reqTiles.insert(spec);
+        }
+        d->seedHash_.insert(spec, job);
+    }
+
+    cancelTiles -= reqTiles;
+
+    // No focus, the one of the maps is kept
     QMetaObject::invokeMethod(d->fetcher_, "updateTileRequests",
                               Qt::QueuedConnection,
                               Q_ARG(QSet<QGeoTileSpec>, reqTiles),
                               Q_ARG(QSet<QGeoTileSpec>, cancelTiles));
 }
 
-void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
+void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, QGeoTileFormat format,
+                                                       const QGeoTileValidators &validators)
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
+    const bool refreshed = d->revalidating_.remove(spec);
+
     QSet<QGeoTiledMap *> maps = d->tileHash_.value(spec);
 
     typedef QSet<QGeoTiledMap *>::const_iterator map_iter;
@@ -205,19 +290,94 @@ void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec,
     }
 
     d->tileHash_.remove(spec);
-    tileCache()->insert(spec, bytes, format, d->cacheHint_);
+
+    // Seeded tiles are for offline use: on disk, whatever the hint, and only
+    // in memory if a map is waiting for them
+    const QList<QGeoTileSeedJob *> jobs = d->seedHash_.values(spec);
+    d->seedHash_.remove(spec);
+    QAbstractGeoTileCache::CacheAreas areas = d->cacheHint_;
+    if (!jobs.isEmpty()) {
+        areas = maps.isEmpty() ? QAbstractGeoTileCache::DiskCache
+                               : areas | QAbstractGeoTileCache::DiskCache;
+    }
+    if (refreshed)
+        areas |= QAbstractGeoTileCache::DiskCache;
+    tileCache()->insert(spec, bytes, format, areas);
+    tileCache()->setTileValidators(spec, validators);
 
     map = maps.constBegin();
     mapEnd = maps.constEnd();
     for (; map != mapEnd; ++map) {
         (*map)->requestManager()->tileFetched(spec);
     }
+    for (QGeoTileSeedJob *job : jobs)
+        job->tileFetched(spec, bytes.size());
+
+    // Maps still showing the stale tile swap it for the new one
+    if (refreshed)
+        emit tileUpdated(spec);
+}
+
+/*
+    The server confirmed that the stale tile \a spec did not change: the
+    cached bytes are kept, with the new \a validators. Maps and seed jobs
+    that asked for the tile meanwhile are served from the cache.
+*/
+void QGeoTiledMappingManagerEngine::engineTileNotModified(const QGeoTileSpec &spec,
+                                                          const QGeoTileValidators &validators)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    d->revalidating_.remove(spec);
+    tileCache()->setTileValidators(spec, validators);
+
+    const QSet<QGeoTiledMap *> maps = d->tileHash_.take(spec);
+    for (QGeoTiledMap *map : maps) {
+        QSet<QGeoTileSpec> tileSet = d->mapHash_.value(map);
+        tileSet.remove(spec);
+        if (tileSet.isEmpty())
+            d->mapHash_.remove(map);
+        else
+            d->mapHash_.insert(map, tileSet);
+    }
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileFetched(spec);
+
+    const QList<QGeoTileSeedJob *> jobs = d->seedHash_.values(spec);
+    d->seedHash_.remove(spec);
+    for (QGeoTileSeedJob *job : jobs)
+        job->tileFetched(spec, 0);
+}
+
+/*
+    The cache served the tile \a spec past its expiry. It stays on screen
+    while a conditional request sent with \a validators refreshes it.
+*/
+void QGeoTiledMappingManagerEngine::engineTileStale(const QGeoTileSpec &spec,
+                                                    const QGeoTileValidators &validators)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    // Already being fetched or refreshed
+    if (!d->fetcher_ || d->revalidating_.contains(spec) || d->tileHash_.contains(spec)
+            || d->seedHash_.contains(spec)) {
+        return;
+    }
+    d->revalidating_.insert(spec);
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    QMetaObject::invokeMethod(fetcher, [fetcher, spec, validators]() {
+        fetcher->revalidateTile(spec, validators);
+    }, Qt::QueuedConnection);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, const QString &errorString)
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
+    // A stale tile that could not be refreshed is kept as it is
+    d->revalidating_.remove(spec);
+
     QSet<QGeoTiledMap *> maps = d->tileHash_.value(spec);
     typedef QSet<QGeoTiledMap *>::const_iterator map_iter;
     map_iter map = maps.constBegin();
@@ -237,9 +397,32 @@ void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, co
         (*map)->requestManager()->tileError(spec, errorString);
     }
 
+    const QList<QGeoTileSeedJob *> jobs = d->seedHash_.values(spec);
+    d->seedHash_.remove(spec);
+    for (QGeoTileSeedJob *job : jobs)
+        job->tileError(spec, errorString);
+
     emit tileError(spec, errorString);
 }
 
+void QGeoTiledMappingManagerEngine::engineTileLoaded(const QGeoTileSpec &spec)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    const QSet<QGeoTiledMap *> maps = d->loadHash_.take(spec);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileLoaded(spec);
+}
+
+void QGeoTiledMappingManagerEngine::engineTileLoadFailed(const QGeoTileSpec &spec)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    const QSet<QGeoTiledMap *> maps = d->loadHash_.take(spec);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileLoadFailed(spec);
+}
+
 void QGeoTiledMappingManagerEngine::setTileSize(const QSize &tileSize)
 {
     Q_D(QGeoTiledMappingManagerEngine);
@@ -287,7 +470,14 @@ void QGeoTiledMappingManagerEngine::setTileCache(QAbstractGeoTileCache *cache)
     Q_D(QGeoTiledMappingManagerEngine);
     Q_ASSERT_X(!d->tileCache_, Q_FUNC_INFO, "This should be called only once");
     cache->setParent(this);
+    cache->setMetrics(&d->metrics_);
     d->tileCache_.reset(cache);
+    connect(cache, &QAbstractGeoTileCache::tileLoaded,
+            this, &QGeoTiledMappingManagerEngine::engineTileLoaded);
+    connect(cache, &QAbstractGeoTileCache::tileLoadFailed,
+            this, &QGeoTiledMappingManagerEngine::engineTileLoadFailed);
+    connect(cache, &QAbstractGeoTileCache::tileStale,
+            this, &QGeoTiledMappingManagerEngine::engineTileStale);
     d->tileCache_->init();
 }
 
@@ -299,14 +489,92 @@ QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
         if (!managerName().isEmpty())
             cacheDirectory = QAbstractGeoTileCache::baseLocationCacheDirectory() + managerName();
         d->tileCache_.reset(new QGeoFileTileCache(cacheDirectory));
+        d->tileCache_->setMetrics(&d->metrics_);
+        connect(d->tileCache_.get(), &QAbstractGeoTileCache::tileLoaded,
+                this, &QGeoTiledMappingManagerEngine::engineTileLoaded);
+        connect(d->tileCache_.get(), &QAbstractGeoTileCache::tileLoadFailed,
+                this, &QGeoTiledMappingManagerEngine::engineTileLoadFailed);
+        connect(d->tileCache_.get(), &QAbstractGeoTileCache::tileStale,
+                this, &QGeoTiledMappingManagerEngine::engineTileStale);
         d->tileCache_->init();
     }
     return d->tileCache_.get();
 }
 
+/*
+    Returns the metrics of the tile pipeline of this engine, shared by its
+    maps, its cache and its fetcher. They are disabled by default.
+*/
+QGeoTileMetrics *QGeoTiledMappingManagerEngine::tileMetrics()
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    return &d->metrics_;
+}
+
+/*
+    Returns the current state of the tile metrics, along with the cache
+    counters and the requests in flight.
+*/
+QGeoTileMetrics::Snapshot QGeoTiledMappingManagerEngine::tileMetricsSnapshot()
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QGeoTileMetrics::Snapshot snapshot;
+    d->metrics_.snapshot(&snapshot);
+    if (d->tileCache_)
+        d->tileCache_->collectMetrics(&snapshot);
+    if (d->fetcher_) {
+        snapshot.requestsInFlight = d->fetcher_->requestsInFlight();
+        snapshot.requestsQueued = d->fetcher_->requestsQueued();
+    }
+    return snapshot;
+}
+
 QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::getTileTexture(const QGeoTileSpec &spec)
 {
     return d_ptr->tileCache_->get(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::getLoadedTileTexture(const QGeoTileSpec &spec)
+{
+    return d_ptr->tileCache_->getLoaded(spec);
+}
+
+/*
+    Schedules a background load of \a spec from the tile cache on behalf of \a map.
+    Returns false if the tile is not cached and has to be fetched instead.
+*/
+bool QGeoTiledMappingManagerEngine::loadTileTexture(QGeoTiledMap *map, const QGeoTileSpec &spec)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    auto it = d->loadHash_.find(spec);
+    if (it == d->loadHash_.end()) {
+        if (!d->tileCache_->loadAsync(spec))
+            return false;
+        it = d->loadHash_.insert(spec, QSet<QGeoTiledMap *>());
+    }
+    it.value().insert(map);
+    return true;
+}
+
+void QGeoTiledMappingManagerEngine::cancelTileTextureLoads(QGeoTiledMap *map, const QSet<QGeoTileSpec> &tiles)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QSet<QGeoTileSpec> cancelLoads;
+    for (const QGeoTileSpec &spec : tiles) {
+        auto it = d->loadHash_.find(spec);
+        if (it == d->loadHash_.end())
+            continue;
+        it.value().remove(map);
+        if (it.value().isEmpty()) {
+            cancelLoads.insert(spec);
+            d->loadHash_.erase(it);
+        }
+    }
+    if (!cancelLoads.isEmpty())
+        d->tileCache_->cancelLoads(cancelLoads);
+}
+
 QT_END_NAMESPACE
@@ -62,9 +62,11 @@ QT_BEGIN_NAMESPACE
 
 class QGeoTiledMappingManagerEnginePrivate;
 class QGeoTileFetcher;
+class QGeoTileSeedJob;
 struct QGeoTileTexture;
 class QGeoTileSpec;
 class QSize;
+class QGeoShape;
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMappingManagerEngine : public QGeoMappingManagerEngine
 {
@@ -88,16 +90,34 @@ public:
 
     QAbstractGeoTileCache *tileCache();
     virtual QSharedPointer<QGeoTileTexture> getTileTexture(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> getLoadedTileTexture(const QGeoTileSpec &spec);
+    bool loadTileTexture(QGeoTiledMap *map, const QGeoTileSpec &spec);
+    void cancelTileTextureLoads(QGeoTiledMap *map, const QSet<QGeoTileSpec> &tiles);
 
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
 
+    QGeoTileMetrics *tileMetrics();
+    QGeoTileMetrics::Snapshot tileMetricsSnapshot();
+
+    QGeoTileSeedJob *createSeedJob(const QGeoShape &region, int minimumZoomLevel, int maximumZoomLevel,
+                                   const QGeoMapType &mapType, QObject *parent = nullptr);
+    void updateSeedRequests(QGeoTileSeedJob *job,
+                            const QSet<QGeoTileSpec> &tilesAdded,
+                            const QSet<QGeoTileSpec> &tilesRemoved);
+
 protected Q_SLOTS:
-    virtual void engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
+    virtual void engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, QGeoTileFormat format,
+                                    const QGeoTileValidators &validators);
+    void engineTileNotModified(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+    void engineTileStale(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
     virtual void engineTileError(const QGeoTileSpec &spec, const QString &errorString);
+    void engineTileLoaded(const QGeoTileSpec &spec);
+    void engineTileLoadFailed(const QGeoTileSpec &spec);
 
 Q_SIGNALS:
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
     void tileVersionChanged();
+    void tileUpdated(const QGeoTileSpec &spec);
 
 protected:
     void setTileFetcher(QGeoTileFetcher *fetcher);
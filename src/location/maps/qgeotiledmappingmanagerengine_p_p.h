@@ -63,6 +63,7 @@ class QGeoTiledMap;
 class QAbstractGeoTileCache;
 class QGeoTileSpec;
 class QGeoTileFetcher;
+class QGeoTileSeedJob;
 
 class QGeoTiledMappingManagerEnginePrivate
 {
@@ -71,7 +72,11 @@ public:
     int m_tileVersion = -1;
     QHash<QGeoTiledMap *, QSet<QGeoTileSpec>> mapHash_;
     QHash<QGeoTileSpec, QSet<QGeoTiledMap *>> tileHash_;
+    QHash<QGeoTileSpec, QSet<QGeoTiledMap *>> loadHash_;
+    QMultiHash<QGeoTileSpec, QGeoTileSeedJob *> seedHash_;
+    QSet<QGeoTileSpec> revalidating_; // stale tiles being refreshed, for no map in particular
     QAbstractGeoTileCache::CacheAreas cacheHint_ = QAbstractGeoTileCache::AllCaches;
+    QGeoTileMetrics metrics_; // outlives the cache, which records into it
     std::unique_ptr<QAbstractGeoTileCache> tileCache_;
     QGeoTileFetcher *fetcher_ = nullptr;
 };
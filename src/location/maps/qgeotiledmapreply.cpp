@@ -196,6 +196,42 @@ void QGeoTiledMapReply::setCached(bool cached)
     d_ptr->isCached = cached;
 }
 
+/*!
+    Returns whether the server answered a conditional request with
+    "not modified", in which case there is no image data and the cached tile
+    remains valid.
+*/
+bool QGeoTiledMapReply::isNotModified() const
+{
+    return d_ptr->isNotModified;
+}
+
+/*!
+    Sets whether the server answered that the tile did not change to
+    \a notModified.
+*/
+void QGeoTiledMapReply::setNotModified(bool notModified)
+{
+    d_ptr->isNotModified = notModified;
+}
+
+/*!
+    Returns the validators and expiry the server sent with the tile.
+*/
+QGeoTileValidators QGeoTiledMapReply::validators() const
+{
+    return d_ptr->validators;
+}
+
+/*!
+    Sets the validators and expiry the server sent with the tile to
+    \a validators.
+*/
+void QGeoTiledMapReply::setValidators(const QGeoTileValidators &validators)
+{
+    d_ptr->validators = validators;
+}
+
 /*!
     Returns the request which corresponds to this reply.
 */
@@ -224,6 +260,15 @@ void QGeoTiledMapReply::setMapImageData(const QByteArray &data)
     Returns the format of the tile image.
 */
 QString QGeoTiledMapReply::mapImageFormat() const
+{
+    return d_ptr->mapImageFormat.name();
+}
+
+/*!
+    Returns the format of the tile image, as the interned id handed to the
+    tile caches.
+*/
+QGeoTileFormat QGeoTiledMapReply::mapImageTileFormat() const
 {
     return d_ptr->mapImageFormat;
 }
@@ -232,6 +277,14 @@ QString QGeoTiledMapReply::mapImageFormat() const
     Sets the format of the tile image to \a format.
 */
 void QGeoTiledMapReply::setMapImageFormat(const QString &format)
+{
+    d_ptr->mapImageFormat = QGeoTileFormat::fromName(format);
+}
+
+/*!
+    \overload
+*/
+void QGeoTiledMapReply::setMapImageFormat(QGeoTileFormat format)
 {
     d_ptr->mapImageFormat = format;
 }
@@ -52,6 +52,8 @@
 //
 
 #include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotileformat_p.h>
+#include <QtLocation/private/qgeotilevalidators_p.h>
 
 #include <QObject>
 
@@ -81,11 +83,14 @@ public:
     QString errorString() const;
 
     bool isCached() const;
+    bool isNotModified() const;
+    QGeoTileValidators validators() const;
 
     QGeoTileSpec tileSpec() const;
 
     QByteArray mapImageData() const;
     QString mapImageFormat() const;
+    QGeoTileFormat mapImageTileFormat() const;
 
     virtual void abort();
 
@@ -99,9 +104,12 @@ protected:
     void setFinished(bool finished);
 
     void setCached(bool cached);
+    void setNotModified(bool notModified);
+    void setValidators(const QGeoTileValidators &validators);
 
     void setMapImageData(const QByteArray &data);
     void setMapImageFormat(const QString &format);
+    void setMapImageFormat(QGeoTileFormat format);
 
 private:
     QGeoTiledMapReplyPrivate *d_ptr;
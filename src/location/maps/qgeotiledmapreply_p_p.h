@@ -66,10 +66,12 @@ public:
     QString errorString;
     bool isFinished = false;
     bool isCached = false;
+    bool isNotModified = false;
+    QGeoTileValidators validators;
 
     QGeoTileSpec spec;
     QByteArray mapImageData;
-    QString mapImageFormat;
+    QGeoTileFormat mapImageFormat;
 };
 
 QT_END_NAMESPACE
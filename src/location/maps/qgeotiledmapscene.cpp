@@ -43,8 +43,11 @@
 #include "qgeocameradata_p.h"
 #include "qabstractgeotilecache_p.h"
 #include "qgeotilespec_p.h"
+#include "qgeotilemetrics_p.h"
 
 #include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGTextureMaterial>
+#include <QtGui/private/qrhi_p.h>
 #include <QtGui/QVector3D>
 
 #include <QtCore/private/qobject_p.h>
@@ -112,16 +115,29 @@ void QGeoTiledMapScene::setVisibleArea(const QRectF &visibleArea)
     updateSceneParameters();
 }
 
-void QGeoTiledMapScene::setVisibleTiles(const QSet<QGeoTileSpec> &tiles)
+// Where the time spent staging textures into the atlas is recorded
+void QGeoTiledMapScene::setMetrics(QGeoTileMetrics *metrics)
+{
+    Q_D(QGeoTiledMapScene);
+    d->m_metrics = metrics;
+}
+
+void QGeoTiledMapScene::setVisibleTiles(const QSet<QGeoTileKey> &tiles)
 {
     Q_D(QGeoTiledMapScene);
     d->setVisibleTiles(tiles);
 }
 
-const QSet<QGeoTileSpec> &QGeoTiledMapScene::visibleTiles() const
+void QGeoTiledMapScene::updateVisibleTiles(const QSet<QGeoTileKey> &added, const QSet<QGeoTileKey> &removed)
+{
+    Q_D(QGeoTiledMapScene);
+    d->updateVisibleTiles(added, removed);
+}
+
+const QSet<QGeoTileKey> &QGeoTiledMapScene::visibleTiles() const
 {
     Q_D(const QGeoTiledMapScene);
-    return d->m_visibleTiles;
+    return d->m_visibleKeys;
 }
 
 void QGeoTiledMapScene::addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
@@ -130,12 +146,13 @@ void QGeoTiledMapScene::addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTil
     d->addTile(spec, texture);
 }
 
-QSet<QGeoTileSpec> QGeoTiledMapScene::texturedTiles()
+QSet<QGeoTileKey> QGeoTiledMapScene::texturedTiles()
 {
     Q_D(QGeoTiledMapScene);
-    QSet<QGeoTileSpec> textured;
+    QSet<QGeoTileKey> textured;
+    textured.reserve(d->m_textures.size());
     for (auto it = d->m_textures.cbegin(); it != d->m_textures.cend(); ++it)
-        textured += it.value()->spec;
+        textured.insert(it.key());
 
     return textured;
 }
@@ -156,7 +173,7 @@ QGeoTiledMapScenePrivate::~QGeoTiledMapScenePrivate()
 {
 }
 
-bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming)
+bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileKey &spec, QRectF &rect, QRectF &subRect, bool &overzooming)
 {
     overzooming = false;
     int x = spec.x();
@@ -185,8 +202,8 @@ bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageN
     y1 *= edge;
     y2 *= edge;
 
-    imageNode->setRect(QRectF(QPointF(x1, y2), QPointF(x2, y1)));
-    imageNode->setTextureCoordinatesTransform(QSGImageNode::MirrorVertically);
+    rect = QRectF(QPointF(x1, y2), QPointF(x2, y1));
+    subRect = QRectF(0, 0, 1, 1);
 
     // Calculate the texture mapping, in case we are magnifying some lower ZL tile
     const auto it = m_textures.find(spec); // This should be always found, but apparently sometimes it isn't, possibly due to memory shortage
@@ -194,17 +211,14 @@ bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageN
         if (it.value()->spec.zoom() < spec.zoom()) {
             // Currently only using lower ZL tiles for the overzoom.
             const int tilesPerTexture = 1 << (spec.zoom() - it.value()->spec.zoom());
-            const int mappedSize = imageNode->texture()->textureSize().width() / tilesPerTexture;
-            const int x = (spec.x() % tilesPerTexture) * mappedSize;
-            const int y = (spec.y() % tilesPerTexture) * mappedSize;
-            imageNode->setSourceRect(QRectF(x, y, mappedSize, mappedSize));
+            const qreal mappedSize = 1.0 / tilesPerTexture;
+            const qreal x = (spec.x() % tilesPerTexture) * mappedSize;
+            const qreal y = (spec.y() % tilesPerTexture) * mappedSize;
+            subRect = QRectF(x, y, mappedSize, mappedSize);
             overzooming = true;
-        } else {
-            imageNode->setSourceRect(QRectF(QPointF(0,0), imageNode->texture()->textureSize()));
         }
     } else {
         qWarning() << "!! buildGeometry: tileSpec not present in m_textures !!";
-        imageNode->setSourceRect(QRectF(QPointF(0,0), imageNode->texture()->textureSize()));
     }
 
     return true;
@@ -212,42 +226,55 @@ bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageN
 
 void QGeoTiledMapScenePrivate::addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
 {
-    if (!m_visibleTiles.contains(spec)) // Don't add the geometry if it isn't visible
+    const QGeoTileKey key = spec.key();
+    if (!m_visibleKeys.contains(key)) // Don't add the geometry if it isn't visible
         return;
 
-    if (m_textures.contains(spec))
-        m_updatedTextures.append(spec);
-    m_textures.insert(spec, texture);
+    if (m_textures.contains(key))
+        m_updatedTextures.append(key);
+    m_textures.insert(key, texture);
 }
 
-void QGeoTiledMapScenePrivate::setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles)
+void QGeoTiledMapScenePrivate::setVisibleTiles(const QSet<QGeoTileKey> &visibleKeys)
 {
     // work out the tile bounds for the new scene
-    updateTileBounds(visibleTiles);
+    updateTileBounds(visibleKeys);
 
     // set up the gl camera for the new scene
     setupCamera();
 
-    QSet<QGeoTileSpec> toRemove = m_visibleTiles - visibleTiles;
+    QSet<QGeoTileKey> toRemove = m_visibleKeys - visibleKeys;
     if (!toRemove.isEmpty())
         removeTiles(toRemove);
 
-    m_visibleTiles = visibleTiles;
+    m_visibleKeys = visibleKeys;
 }
 
-void QGeoTiledMapScenePrivate::removeTiles(const QSet<QGeoTileSpec> &oldTiles)
+/*
+    Incremental setVisibleTiles(), for camera changes at the same integer zoom
+    level. The tile bounds only need to be recomputed when the set changes.
+*/
+void QGeoTiledMapScenePrivate::updateVisibleTiles(const QSet<QGeoTileKey> &added, const QSet<QGeoTileKey> &removed)
 {
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
-    iter i = oldTiles.constBegin();
-    iter end = oldTiles.constEnd();
+    m_visibleKeys -= removed;
+    m_visibleKeys += added;
 
-    for (; i != end; ++i) {
-        QGeoTileSpec tile = *i;
+    if (!added.isEmpty() || !removed.isEmpty())
+        updateTileBounds(m_visibleKeys);
+
+    setupCamera();
+
+    if (!removed.isEmpty())
+        removeTiles(removed);
+}
+
+void QGeoTiledMapScenePrivate::removeTiles(const QSet<QGeoTileKey> &oldTiles)
+{
+    for (const QGeoTileKey &tile : oldTiles)
         m_textures.remove(tile);
-    }
 }
 
-void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
+void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileKey> &tiles)
 {
     if (tiles.isEmpty()) {
         m_minTileX = -1;
@@ -257,7 +284,7 @@ void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
         return;
     }
 
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
+    typedef QSet<QGeoTileKey>::const_iterator iter;
     iter i = tiles.constBegin();
     iter end = tiles.constEnd();
 
@@ -298,7 +325,7 @@ void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
     // finally, determine the min and max bounds
     i = tiles.constBegin();
 
-    QGeoTileSpec tile = *i;
+    QGeoTileKey tile = *i;
 
     int x = tile.x();
     if (tile.x() < m_tileXWrapsBelow)
@@ -470,6 +497,113 @@ static bool qgeotiledmapscene_isTileInViewport(const QRectF &tileRect, const QMa
     return qgeotiledmapscene_isTileInViewport_rotationTilt(tileRect, matrix);
 }
 
+void QGeoTiledMapTileContainerNode::addTile(const QGeoTileKey &key, const Tile &tile, QGeoTileAtlasPage *texture)
+{
+    Batch &batch = batches[tile.page];
+    if (!batch.node) {
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0, 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        QSGTextureMaterial *material = new QSGTextureMaterial();
+        material->setTexture(texture);
+        material->setFlag(QSGMaterial::Blending, texture->hasAlphaChannel());
+        batch.node = new QSGGeometryNode();
+        batch.node->setGeometry(geometry);
+        batch.node->setMaterial(material);
+        batch.node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        batch.page = texture;
+        appendChildNode(batch.node);
+    }
+
+    Tile &t = tiles[key];
+    t = tile;
+    t.quad = batch.keys.size();
+    batch.keys.append(key);
+}
+
+void QGeoTiledMapTileContainerNode::removeTile(const QGeoTileKey &key)
+{
+    const auto it = tiles.constFind(key);
+    if (it == tiles.cend())
+        return;
+    const Tile tile = it.value();
+    tiles.erase(it);
+
+    auto batchIt = batches.find(tile.page);
+    Q_ASSERT(batchIt != batches.end());
+    Batch &batch = batchIt.value();
+
+    // Move the last quad into the hole
+    const QGeoTileKey last = batch.keys.takeLast();
+    if (last != key) {
+        batch.keys[tile.quad] = last;
+        tiles[last].quad = tile.quad;
+    }
+
+    if (batch.keys.isEmpty()) {
+        delete batch.node;
+        batches.erase(batchIt);
+    }
+}
+
+void QGeoTiledMapTileContainerNode::clearTiles()
+{
+    for (const Batch &batch : qAsConst(batches))
+        delete batch.node;
+    batches.clear();
+    tiles.clear();
+}
+
+/*
+    Writes the quads of every batch. The positions depend on the tile bounds
+    of the scene and change with the camera, the texture coordinates when a
+    tile is added or its atlas page grows.
+*/
+void QGeoTiledMapTileContainerNode::updateBatches()
+{
+    static const quint16 quadIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+    for (Batch &batch : batches) {
+        QSGGeometry *geometry = batch.node->geometry();
+        const int quads = batch.keys.size();
+        if (geometry->vertexCount() != quads * 4)
+            geometry->allocate(quads * 4, quads * 6);
+
+        QSGGeometry::TexturedPoint2D *v = geometry->vertexDataAsTexturedPoint2D();
+        quint16 *indices = geometry->indexDataAsUShort();
+        for (int i = 0; i < quads; ++i) {
+            const Tile &tile = tiles[batch.keys.at(i)];
+            const QRectF &r = tile.rect;
+            const QRectF t = batch.page->textureRect(tile.slot, tile.subRect);
+            // The scene y axis points up, the texture one down: mirror vertically
+            v[0].set(r.left(), r.top(), t.left(), t.bottom());
+            v[1].set(r.right(), r.top(), t.right(), t.bottom());
+            v[2].set(r.left(), r.bottom(), t.left(), t.top());
+            v[3].set(r.right(), r.bottom(), t.right(), t.top());
+            v += 4;
+            for (quint16 index : quadIndices)
+                *indices++ = quint16(i * 4 + index);
+        }
+        batch.node->markDirty(QSGNode::DirtyGeometry);
+
+        QSGTextureMaterial *material = static_cast<QSGTextureMaterial *>(batch.node->material());
+        // With mipmapping QSGTexture::Nearest generates artifacts
+        const QSGTexture::Filtering filtering = (batch.linear || batch.mipmap)
+                ? QSGTexture::Linear : QSGTexture::Nearest;
+        const QSGTexture::Filtering mipmapFiltering = batch.mipmap ? QSGTexture::Linear : QSGTexture::None;
+        const bool blending = batch.page->hasAlphaChannel();
+        if (material->filtering() != filtering
+                || material->mipmapFiltering() != mipmapFiltering
+                || material->flags().testFlag(QSGMaterial::Blending) != blending
+                || batch.textureSize != batch.page->textureSize()) {
+            material->setFiltering(filtering);
+            material->setMipmapFiltering(mipmapFiltering);
+            material->setFlag(QSGMaterial::Blending, blending);
+            batch.textureSize = batch.page->textureSize();
+            batch.node->markDirty(QSGNode::DirtyMaterial);
+        }
+    }
+}
+
 void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
                                        QGeoTiledMapScenePrivate *d,
                                        double camAdjust,
@@ -484,78 +618,73 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
     cameraMatrix.lookAt(toVector3D(eye), toVector3D(center), toVector3D(d->m_cameraUp));
     root->setMatrix(d->m_projectionMatrix * cameraMatrix);
 
-    QSet<QGeoTileSpec> tilesInSG;
+    QSet<QGeoTileKey> tilesInSG;
+    tilesInSG.reserve(root->tiles.size());
     for (auto it = root->tiles.cbegin(), end = root->tiles.cend(); it != end; ++it)
         tilesInSG.insert(it.key());
-    const QSet<QGeoTileSpec> toRemove = tilesInSG - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - tilesInSG;
+    const QSet<QGeoTileKey> toRemove = tilesInSG - d->m_visibleKeys;
+    const QSet<QGeoTileKey> toAdd = d->m_visibleKeys - tilesInSG;
 
-    for (const QGeoTileSpec &s : toRemove)
-        delete root->tiles.take(s);
+    for (const QGeoTileKey &s : toRemove)
+        root->removeTile(s);
     bool straight = !d->isTiltedOrRotated();
     bool overzooming;
-    qreal pixelRatio = window->effectiveDevicePixelRatio();
+    QRectF subRect;
+    const qreal pixelRatio = window->effectiveDevicePixelRatio();
+    // Textures larger than the tile on screen, or seen at an angle, are mipmapped when the page
+    // has mipmaps, and at least linearly filtered otherwise
+    const auto updateFiltering = [&](QGeoTiledMapTileContainerNode::Batch &batch) {
+        const bool minified = batch.page->slotSize() > d->m_tileSize * pixelRatio;
+        batch.linear = d->m_linearScaling || minified;
+        batch.mipmap = batch.page->hasMipmaps() && (minified || d->m_cameraData.tilt() > 0.0);
+    };
+    for (auto it = root->batches.begin(); it != root->batches.end(); ++it)
+        updateFiltering(it.value());
 #ifdef QT_LOCATION_DEBUG
-    QList<QGeoTileSpec> droppedTiles;
+    QList<QGeoTileKey> droppedTiles;
 #endif
-    for (QHash<QGeoTileSpec, QSGImageNode *>::iterator it = root->tiles.begin();
-         it != root->tiles.end(); ) {
-        QSGImageNode *node = it.value();
-        bool ok = d->buildGeometry(it.key(), node, overzooming)
-                && qgeotiledmapscene_isTileInViewport(node->rect(), root->matrix(), straight);
-
-        QSGNode::DirtyState dirtyBits = {};
-
+    QList<QGeoTileKey> dropped;
+    for (auto it = root->tiles.begin(); it != root->tiles.end(); ++it) {
+        QGeoTiledMapTileContainerNode::Tile &tile = it.value();
+        const bool ok = d->buildGeometry(it.key(), tile.rect, subRect, overzooming)
+                && qgeotiledmapscene_isTileInViewport(tile.rect, root->matrix(), straight);
         if (!ok) {
-#ifdef QT_LOCATION_DEBUG
-            droppedTiles.append(it.key());
-#endif
-            it = root->tiles.erase(it);
-            delete node;
-        } else {
-            if (isTextureLinear != d->m_linearScaling) {
-                if (node->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
-                    node->setFiltering(QSGTexture::Linear); // With mipmapping QSGTexture::Nearest generates artifacts
-                    node->setMipmapFiltering(QSGTexture::Linear);
-                } else {
-                    node->setFiltering((d->m_linearScaling || overzooming) ? QSGTexture::Linear : QSGTexture::Nearest);
-                }
-                dirtyBits |= QSGNode::DirtyMaterial;
-            }
-            if (dirtyBits != 0)
-                node->markDirty(dirtyBits);
-            it++;
+            dropped.append(it.key());
+            continue;
         }
+        if (overzooming)
+            root->batches[tile.page].linear = true;
     }
-
-    for (const QGeoTileSpec &s : toAdd) {
-        QGeoTileTexture *tileTexture = d->m_textures.value(s).data();
-        if (!tileTexture || tileTexture->image.isNull()) {
+    for (const QGeoTileKey &s : qAsConst(dropped))
+        root->removeTile(s);
 #ifdef QT_LOCATION_DEBUG
-            droppedTiles.append(s);
+    droppedTiles += dropped;
 #endif
-            continue;
-        }
-        QSGImageNode *tileNode = window->createImageNode();
-        // note: setTexture will update coordinates so do it here, before we buildGeometry
-        tileNode->setTexture(textures.value(s));
-        if (d->buildGeometry(s, tileNode, overzooming)
-                && qgeotiledmapscene_isTileInViewport(tileNode->rect(), root->matrix(), straight)) {
-            if (tileNode->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
-                tileNode->setFiltering(QSGTexture::Linear); // with mipmapping QSGTexture::Nearest generates artifacts
-                tileNode->setMipmapFiltering(QSGTexture::Linear);
-            } else {
-                tileNode->setFiltering((d->m_linearScaling || overzooming) ? QSGTexture::Linear : QSGTexture::Nearest);
-            }
-            root->addChild(s, tileNode);
-        } else {
+
+    for (const QGeoTileKey &s : toAdd) {
+        const QGeoTileTextureAtlas::Slot slot = textures.value(s);
+        QGeoTiledMapTileContainerNode::Tile tile;
+        if (!slot.isValid()
+                || !d->buildGeometry(s, tile.rect, subRect, overzooming)
+                || !qgeotiledmapscene_isTileInViewport(tile.rect, root->matrix(), straight)) {
 #ifdef QT_LOCATION_DEBUG
             droppedTiles.append(s);
 #endif
-            delete tileNode;
+            continue;
         }
+        tile.page = slot.page;
+        tile.slot = slot.index;
+        tile.subRect = subRect;
+        const bool newBatch = !root->batches.contains(slot.page);
+        root->addTile(s, tile, atlas.page(slot.page));
+        QGeoTiledMapTileContainerNode::Batch &batch = root->batches[slot.page];
+        if (newBatch)
+            updateFiltering(batch);
+        batch.linear = batch.linear || overzooming;
     }
 
+    root->updateBatches();
+
 #ifdef QT_LOCATION_DEBUG
     m_droppedTiles[camAdjust] = droppedTiles;
 #endif
@@ -572,8 +701,13 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     }
 
     QGeoTiledMapRootNode *mapRoot = static_cast<QGeoTiledMapRootNode *>(oldNode);
-    if (!mapRoot)
-        mapRoot = new QGeoTiledMapRootNode();
+    if (!mapRoot) {
+        int maxTextureSize = 4096;
+        QSGRendererInterface *rif = window->rendererInterface();
+        if (QRhi *rhi = static_cast<QRhi *>(rif->getResource(window, QSGRendererInterface::RhiResource)))
+            maxTextureSize = qMin(maxTextureSize, rhi->resourceLimit(QRhi::TextureSizeMax));
+        mapRoot = new QGeoTiledMapRootNode(maxTextureSize);
+    }
 
 #ifdef QT_LOCATION_DEBUG
     mapRoot->m_droppedTiles.clear();
@@ -590,49 +724,51 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     mapRoot->root->setMatrix(itemSpaceMatrix);
 
     if (d->m_dropTextures) {
-        for (const QGeoTileSpec &s : mapRoot->tiles->tiles.keys())
-            delete mapRoot->tiles->tiles.take(s);
-        for (const QGeoTileSpec &s : mapRoot->wrapLeft->tiles.keys())
-            delete mapRoot->wrapLeft->tiles.take(s);
-        for (const QGeoTileSpec &s : mapRoot->wrapRight->tiles.keys())
-            delete mapRoot->wrapRight->tiles.take(s);
-        for (const QGeoTileSpec &spec : mapRoot->textures.keys())
-            mapRoot->textures.take(spec)->deleteLater();
+        mapRoot->tiles->clearTiles();
+        mapRoot->wrapLeft->clearTiles();
+        mapRoot->wrapRight->clearTiles();
+        mapRoot->textures.clear();
+        mapRoot->atlas.clear();
         d->m_dropTextures = false;
     }
 
     // Evicting loZL tiles temporarily used in place of hiZL ones
     if (d->m_updatedTextures.size()) {
-        const QList<QGeoTileSpec> &toRemove = d->m_updatedTextures;
-        for (const QGeoTileSpec &s : toRemove) {
-            if (mapRoot->tiles->tiles.contains(s))
-                delete mapRoot->tiles->tiles.take(s);
-
-            if (mapRoot->wrapLeft->tiles.contains(s))
-                delete mapRoot->wrapLeft->tiles.take(s);
-
-            if (mapRoot->wrapRight->tiles.contains(s))
-                delete mapRoot->wrapRight->tiles.take(s);
-
-            if (mapRoot->textures.contains(s))
-                mapRoot->textures.take(s)->deleteLater();
+        const QList<QGeoTileKey> &toRemove = d->m_updatedTextures;
+        for (const QGeoTileKey &s : toRemove) {
+            mapRoot->tiles->removeTile(s);
+            mapRoot->wrapLeft->removeTile(s);
+            mapRoot->wrapRight->removeTile(s);
+
+            const auto it = mapRoot->textures.constFind(s);
+            if (it != mapRoot->textures.cend()) {
+                mapRoot->atlas.release(it.value());
+                mapRoot->textures.erase(it);
+            }
         }
         d->m_updatedTextures.clear();
     }
 
-    QSet<QGeoTileSpec> textures;
+    QSet<QGeoTileKey> textures;
+    textures.reserve(mapRoot->textures.size());
     for (auto it = mapRoot->textures.cbegin(), end = mapRoot->textures.cend(); it != end; ++it)
         textures.insert(it.key());
-    const QSet<QGeoTileSpec> toRemove = textures - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - textures;
+    const QSet<QGeoTileKey> toRemove = textures - d->m_visibleKeys;
+    const QSet<QGeoTileKey> toAdd = d->m_visibleKeys - textures;
 
-    for (const QGeoTileSpec &spec : toRemove)
-        mapRoot->textures.take(spec)->deleteLater();
-    for (const QGeoTileSpec &spec : toAdd) {
+    for (const QGeoTileKey &spec : toRemove)
+        mapRoot->atlas.release(mapRoot->textures.take(spec));
+    const bool timed = d->m_metrics && d->m_metrics->isEnabled();
+    for (const QGeoTileKey &spec : toAdd) {
         QGeoTileTexture *tileTexture = d->m_textures.value(spec).data();
-        if (!tileTexture || tileTexture->image.isNull())
+        if (!tileTexture || tileTexture->isNull())
             continue;
-        mapRoot->textures.insert(spec, window->createTextureFromImage(tileTexture->image));
+        const qint64 start = timed ? d->m_metrics->now() : 0;
+        mapRoot->textures.insert(spec, tileTexture->compressed.isNull()
+                                 ? mapRoot->atlas.allocate(tileTexture->image)
+                                 : mapRoot->atlas.allocate(tileTexture->compressed));
+        if (timed)
+            d->m_metrics->recordSince(QGeoTileMetrics::UploadStage, start);
     }
 
     double sideLength = d->m_scaleFactor * d->m_tileSize * d->m_sideLength;
@@ -644,6 +780,7 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     mapRoot->updateTiles(mapRoot->wrapRight, d, -sideLength, window);
 
     mapRoot->isTextureLinear = d->m_linearScaling;
+    mapRoot->atlas.collectGarbage();
 
     return mapRoot;
 }
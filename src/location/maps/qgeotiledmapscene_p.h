@@ -57,11 +57,13 @@ QT_BEGIN_NAMESPACE
 
 class QGeoCameraData;
 class QGeoTileSpec;
+class QGeoTileKey;
 class QDoubleVector2D;
 struct QGeoTileTexture;
 class QSGNode;
 class QQuickWindow;
 class QGeoTiledMapScenePrivate;
+class QGeoTileMetrics;
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapScene : public QObject
 {
@@ -75,15 +77,17 @@ public:
     void setTileSize(int tileSize);
     void setCameraData(const QGeoCameraData &cameraData);
     void setVisibleArea(const QRectF &visibleArea);
+    void setMetrics(QGeoTileMetrics *metrics);
 
-    void setVisibleTiles(const QSet<QGeoTileSpec> &tiles);
-    const QSet<QGeoTileSpec> &visibleTiles() const;
+    void setVisibleTiles(const QSet<QGeoTileKey> &tiles);
+    void updateVisibleTiles(const QSet<QGeoTileKey> &added, const QSet<QGeoTileKey> &removed);
+    const QSet<QGeoTileKey> &visibleTiles() const;
 
     void addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
 
     QSGNode *updateSceneGraph(QSGNode *oldNode, QQuickWindow *window);
 
-    QSet<QGeoTileSpec> texturedTiles();
+    QSet<QGeoTileKey> texturedTiles();
 
     void clearTexturedTiles();
 
@@ -53,8 +53,9 @@
 #include "qgeotiledmapscene_p.h"
 #include "qgeocameradata_p.h"
 #include "qgeotilespec_p.h"
+#include "qgeotiletextureatlas_p.h"
 
-#include <QtQuick/QSGImageNode>
+#include <QtQuick/QSGGeometryNode>
 #include <QtQuick/QQuickWindow>
 
 #include <QtCore/private/qobject_p.h>
@@ -62,27 +63,53 @@
 
 QT_BEGIN_NAMESPACE
 
+/*
+    Draws all the tiles of one container with a single geometry node per atlas
+    page. Adding or removing a tile only touches its quad; the vertex data is
+    rewritten in one go by updateBatches().
+*/
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapTileContainerNode : public QSGTransformNode
 {
 public:
-    void addChild(const QGeoTileSpec &spec, QSGImageNode *node)
+    struct Tile
     {
-        tiles.insert(spec, node);
-        appendChildNode(node);
-    }
-    QHash<QGeoTileSpec, QSGImageNode *> tiles;
+        int page = -1;
+        int slot = -1;
+        int quad = -1;
+        QRectF rect;    // in scene coordinates
+        QRectF subRect; // part of the tile image drawn, normalized
+    };
+
+    struct Batch
+    {
+        QSGGeometryNode *node = nullptr;
+        QGeoTileAtlasPage *page = nullptr;
+        QList<QGeoTileKey> keys; // in quad order
+        QSize textureSize; // of the page when the material was last updated
+        bool linear = false;
+        bool mipmap = false;
+    };
+
+    void addTile(const QGeoTileKey &key, const Tile &tile, QGeoTileAtlasPage *texture);
+    void removeTile(const QGeoTileKey &key);
+    void clearTiles();
+    void updateBatches();
+
+    QHash<QGeoTileKey, Tile> tiles;
+    QHash<int, Batch> batches; // by atlas page
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapRootNode : public QSGClipNode
 {
 public:
-    QGeoTiledMapRootNode()
+    explicit QGeoTiledMapRootNode(int maxTextureSize)
         : isTextureLinear(false)
         , geometry(QSGGeometry::defaultAttributes_Point2D(), 4)
         , root(new QSGTransformNode())
         , tiles(new QGeoTiledMapTileContainerNode())
         , wrapLeft(new QGeoTiledMapTileContainerNode())
         , wrapRight(new QGeoTiledMapTileContainerNode())
+        , atlas(maxTextureSize)
     {
         setIsRectangular(true);
         setGeometry(&geometry);
@@ -94,7 +121,8 @@ public:
 
     ~QGeoTiledMapRootNode()
     {
-        qDeleteAll(textures);
+        // The tile nodes reference the atlas pages, delete them first
+        delete root;
     }
 
     void setClipRect(const QRect &rect)
@@ -123,11 +151,12 @@ public:
     QGeoTiledMapTileContainerNode *wrapLeft;     // When zoomed out, the tiles that wrap around on the left.
     QGeoTiledMapTileContainerNode *wrapRight;    // When zoomed out, the tiles that wrap around on the right
 
-    QHash<QGeoTileSpec, QSGTexture *> textures;
+    QGeoTileTextureAtlas atlas;
+    QHash<QGeoTileKey, QGeoTileTextureAtlas::Slot> textures;
 
 #ifdef QT_LOCATION_DEBUG
     double m_sideLengthPixel;
-    QMap<double, QList<QGeoTileSpec>> m_droppedTiles;
+    QMap<double, QList<QGeoTileKey>> m_droppedTiles;
 #endif
 };
 
@@ -140,10 +169,11 @@ public:
 
     void addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
 
-    void setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles);
-    void removeTiles(const QSet<QGeoTileSpec> &oldTiles);
-    bool buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming);
-    void updateTileBounds(const QSet<QGeoTileSpec> &tiles);
+    void setVisibleTiles(const QSet<QGeoTileKey> &visibleKeys);
+    void updateVisibleTiles(const QSet<QGeoTileKey> &added, const QSet<QGeoTileKey> &removed);
+    void removeTiles(const QSet<QGeoTileKey> &oldTiles);
+    bool buildGeometry(const QGeoTileKey &key, QRectF &rect, QRectF &subRect, bool &overzooming);
+    void updateTileBounds(const QSet<QGeoTileKey> &tiles);
     void setupCamera();
     inline bool isTiltedOrRotated() const { return (m_cameraData.tilt() > 0.0) || (m_cameraData.bearing() > 0.0); }
 
@@ -153,7 +183,7 @@ public:
     int m_tileSize = 0; // the pixel resolution for each tile
     QGeoCameraData m_cameraData;
     QRectF m_visibleArea;
-    QSet<QGeoTileSpec> m_visibleTiles;
+    QSet<QGeoTileKey> m_visibleKeys;
 
     QDoubleVector3D m_cameraUp;
     QDoubleVector3D m_cameraEye;
@@ -177,8 +207,8 @@ public:
     // it is 1<<zoomLevel
     int m_sideLength = 0;
 
-    QHash<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > m_textures;
-    QList<QGeoTileSpec> m_updatedTextures;
+    QHash<QGeoTileKey, QSharedPointer<QGeoTileTexture> > m_textures;
+    QList<QGeoTileKey> m_updatedTextures;
 
     // tilesToGrid transform
     int m_minTileX = -1; // the minimum tile index, i.e. 0 to sideLength which is 1<< zoomLevel
@@ -188,6 +218,7 @@ public:
     int m_tileXWrapsBelow = 0; // the wrap point as a tile index
     bool m_linearScaling = false;
     bool m_dropTextures = false;
+    QGeoTileMetrics *m_metrics = nullptr; // owned by the engine
 
 #ifdef QT_LOCATION_DEBUG
     double m_sideLengthPixel;
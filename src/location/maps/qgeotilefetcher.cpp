@@ -46,9 +46,10 @@
 #include "qgeotiledmapreply_p.h"
 #include "qgeotilespec_p.h"
 #include "qgeotiledmap_p.h"
+#include "qgeotilemetrics_p.h"
 
 #include <algorithm>
-#include <iterator>
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
@@ -75,6 +76,18 @@ QGeoTileFetcher::~QGeoTileFetcher()
 
 void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
                                                   const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    updateTileRequests(tilesAdded, tilesRemoved, QGeoTileSpec());
+}
+
+/*
+    Same as above, focus being the tile at the center of the viewport of
+    the map requesting the tiles. Queued tiles are fetched closest to the
+    focus first. An invalid focus keeps the previous one.
+*/
+void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
+                                         const QSet<QGeoTileSpec> &tilesRemoved,
+                                         const QGeoTileSpec &focus)
 {
     Q_D(QGeoTileFetcher);
 
@@ -82,12 +95,96 @@ void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
 
     cancelTileRequests(tilesRemoved);
 
-    std::copy(tilesAdded.cbegin(), tilesAdded.cend(), std::back_inserter(d->queue_));
+    if (focus.zoom() >= 0)
+        d->queue_.setFocus(focus);
+    for (const QGeoTileSpec &tile : tilesAdded)
+        d->queue_.enqueue(tile);
 
     if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
         d->timer_.start(0, this);
 }
 
+/*
+    Sets the maximum number of tile requests in flight to count. Tiles
+    are only handed to the network once a slot is free, so that they can be
+    reprioritized while waiting. Defaults to 6, the number of connections
+    QNetworkAccessManager opens per host.
+*/
+void QGeoTileFetcher::setMaxConcurrentRequests(int count)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    d->maxConcurrentRequests_ = qMax(1, count);
+    if (d->enabled_ && !d->queue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
+int QGeoTileFetcher::maxConcurrentRequests() const
+{
+    Q_D(const QGeoTileFetcher);
+    return d->maxConcurrentRequests_;
+}
+
+/*
+    Sets the metrics the requests are counted and timed in, owned by the
+    engine.
+*/
+void QGeoTileFetcher::setMetrics(QGeoTileMetrics *metrics)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    d->metrics_ = metrics;
+    d->requestStarts_.clear();
+}
+
+int QGeoTileFetcher::requestsInFlight() const
+{
+    Q_D(const QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    return d->invmap_.size();
+}
+
+int QGeoTileFetcher::requestsQueued() const
+{
+    Q_D(const QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    return d->queue_.size();
+}
+
+/*
+    Queues a conditional request for the stale tile \a spec, sent with
+    \a validators. A tile that did not change is reported through
+    tileNotModified(), a new one through tileFinished().
+*/
+void QGeoTileFetcher::revalidateTile(const QGeoTileSpec &spec, const QGeoTileValidators &validators)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    if (d->invmap_.contains(spec))
+        return;
+    d->validators_.insert(spec, validators);
+    d->queue_.enqueue(spec);
+
+    if (d->enabled_ && initialized() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
+/*
+    The validators getTileImage() should send for \a spec, null unless the
+    request revalidates a stale tile.
+*/
+QGeoTileValidators QGeoTileFetcher::tileValidators(const QGeoTileSpec &spec) const
+{
+    Q_D(const QGeoTileFetcher);
+    // No need to lock: called only in getTileImage
+    return d->validators_.value(spec);
+}
+
 void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
 {
     Q_D(QGeoTileFetcher);
@@ -100,11 +197,15 @@ void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
         QGeoTiledMapReply *reply = d->invmap_.value(*tile, 0);
         if (reply) {
             d->invmap_.remove(*tile);
+            d->requestStarts_.remove(*tile);
+            if (d->metrics_)
+                d->metrics_->increment(QGeoTileMetrics::FetchCancels);
             reply->abort();
             if (reply->isFinished())
                 reply->deleteLater();
         }
-        d->queue_.removeAll(*tile);
+        d->queue_.remove(*tile);
+        d->validators_.remove(*tile);
     }
 }
 
@@ -128,20 +229,31 @@ void QGeoTileFetcher::requestNextTile()
     const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
     // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
     // It gets denormalized in QGeoTiledMap.
-    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled())
+    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled()) {
+        d->validators_.remove(ts);
         return;
+    }
 
+    const bool timed = d->metrics_ && d->metrics_->isEnabled();
+    const qint64 start = timed ? d->metrics_->now() : 0;
     QGeoTiledMapReply *reply = getTileImage(ts);
+    d->validators_.remove(ts);
     if (!reply)
         return;
+    if (d->metrics_)
+        d->metrics_->increment(QGeoTileMetrics::FetchRequests);
 
     if (reply->isFinished()) {
+        if (timed)
+            d->metrics_->recordSince(QGeoTileMetrics::FetchStage, start);
         handleReply(reply, ts);
     } else {
         connect(reply, &QGeoTiledMapReply::finished,
                 this, &QGeoTileFetcher::finished, Qt::QueuedConnection);
 
         d->invmap_.insert(ts, reply);
+        if (timed)
+            d->requestStarts_.insert(ts, start);
     }
 }
 
@@ -164,7 +276,17 @@ void QGeoTileFetcher::finished()
 
     d->invmap_.remove(spec);
 
+    const auto start = d->requestStarts_.constFind(spec);
+    if (start != d->requestStarts_.constEnd()) {
+        d->metrics_->recordSince(QGeoTileMetrics::FetchStage, start.value());
+        d->requestStarts_.erase(start);
+    }
+
     handleReply(reply, spec);
+
+    // A request slot is free again
+    if (d->enabled_ && !d->queue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
 }
 
 void QGeoTileFetcher::timerEvent(QTimerEvent *event)
@@ -175,14 +297,17 @@ void QGeoTileFetcher::timerEvent(QTimerEvent *event)
         return;
     }
 
+    // Hand out a whole batch per event loop iteration, up to the
+    // concurrency limit. finished() restarts the timer when a slot frees up.
     QMutexLocker ml(&d->queueMutex_);
-    if (d->queue_.isEmpty() || !initialized()) {
-        d->timer_.stop();
-        return;
+    while (d->enabled_ && !d->queue_.isEmpty() && initialized()) {
+        if (d->invmap_.size() >= d->maxConcurrentRequests_)
+            break;
+        ml.unlock();
+        requestNextTile();
+        ml.relock();
     }
-    ml.unlock();
-
-    requestNextTile();
+    d->timer_.stop();
 }
 
 bool QGeoTileFetcher::initialized() const
@@ -205,8 +330,13 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
     }
 
     if (reply->error() == QGeoTiledMapReply::NoError) {
-        emit tileFinished(spec, reply->mapImageData(), reply->mapImageFormat());
+        if (reply->isNotModified())
+            emit tileNotModified(spec, reply->validators());
+        else
+            emit tileFinished(spec, reply->mapImageData(), reply->mapImageTileFormat(), reply->validators());
     } else {
+        if (d->metrics_)
+            d->metrics_->increment(QGeoTileMetrics::FetchErrors);
         emit tileError(spec, reply->errorString());
     }
 
@@ -216,4 +346,102 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
 /*******************************************************************************
 *******************************************************************************/
 
+void QGeoTileFetchQueue::setFocus(const QGeoTileSpec &focus)
+{
+    if (focus.zoom() == focus_.zoom() && focus.x() == focus_.x() && focus.y() == focus_.y())
+        return;
+    focus_ = focus;
+    rebuild();
+}
+
+void QGeoTileFetchQueue::enqueue(const QGeoTileSpec &spec)
+{
+    if (pending_.contains(spec))
+        return;
+
+    Entry entry;
+    entry.sequence = sequence_++;
+    entry.spec = spec;
+    prioritize(entry);
+    pending_.insert(spec, entry.sequence);
+    heap_.append(entry);
+    std::push_heap(heap_.begin(), heap_.end(), lowerPriority);
+}
+
+bool QGeoTileFetchQueue::remove(const QGeoTileSpec &spec)
+{
+    if (!pending_.remove(spec))
+        return false;
+
+    // Don't let cancelled entries pile up when the map keeps moving
+    if (heap_.size() > 2 * pending_.size() + 64)
+        rebuild();
+    return true;
+}
+
+QGeoTileSpec QGeoTileFetchQueue::takeFirst()
+{
+    while (!heap_.isEmpty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), lowerPriority);
+        const Entry entry = heap_.takeLast();
+        const auto it = pending_.constFind(entry.spec);
+        if (it != pending_.constEnd() && it.value() == entry.sequence) {
+            pending_.erase(it);
+            return entry.spec;
+        }
+    }
+    return QGeoTileSpec();
+}
+
+void QGeoTileFetchQueue::clear()
+{
+    heap_.clear();
+    pending_.clear();
+}
+
+bool QGeoTileFetchQueue::lowerPriority(const Entry &lhs, const Entry &rhs)
+{
+    if (lhs.zoomDistance != rhs.zoomDistance)
+        return lhs.zoomDistance > rhs.zoomDistance;
+    if (lhs.distance != rhs.distance)
+        return lhs.distance > rhs.distance;
+    return lhs.sequence > rhs.sequence;
+}
+
+void QGeoTileFetchQueue::prioritize(Entry &entry) const
+{
+    // Without a focus the queue is FIFO
+    if (focus_.zoom() < 0) {
+        entry.zoomDistance = 0;
+        entry.distance = 0.0;
+        return;
+    }
+
+    const QGeoTileSpec &spec = entry.spec;
+    entry.zoomDistance = qAbs(spec.zoom() - focus_.zoom());
+
+    // Distance between tile centers, in tiles of the focus zoom level
+    const double scale = std::ldexp(1.0, focus_.zoom() - spec.zoom());
+    const double side = std::ldexp(1.0, focus_.zoom());
+    double dx = qAbs((spec.x() + 0.5) * scale - (focus_.x() + 0.5));
+    const double dy = (spec.y() + 0.5) * scale - (focus_.y() + 0.5);
+    dx = qMin(dx, side - dx); // the shortest way may cross the dateline
+    entry.distance = dx * dx + dy * dy;
+}
+
+void QGeoTileFetchQueue::rebuild()
+{
+    QList<Entry> heap;
+    heap.reserve(pending_.size());
+    for (Entry &entry : heap_) {
+        const auto it = pending_.constFind(entry.spec);
+        if (it == pending_.constEnd() || it.value() != entry.sequence)
+            continue;
+        prioritize(entry);
+        heap.append(entry);
+    }
+    std::make_heap(heap.begin(), heap.end(), lowerPriority);
+    heap_.swap(heap);
+}
+
 QT_END_NAMESPACE
@@ -72,8 +72,19 @@ public:
     QGeoTileFetcher(QGeoMappingManagerEngine *parent);
     virtual ~QGeoTileFetcher();
 
+    void setMaxConcurrentRequests(int count);
+    int maxConcurrentRequests() const;
+
+    void setMetrics(QGeoTileMetrics *metrics);
+    int requestsInFlight() const;
+    int requestsQueued() const;
+
+    void revalidateTile(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
+
 public Q_SLOTS:
     void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved);
+    void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved,
+                            const QGeoTileSpec &focus);
 
 private Q_SLOTS:
     void cancelTileRequests(const QSet<QGeoTileSpec> &tiles);
@@ -81,7 +92,9 @@ private Q_SLOTS:
     void finished();
 
 Q_SIGNALS:
-    void tileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
+    void tileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, QGeoTileFormat format,
+                      const QGeoTileValidators &validators);
+    void tileNotModified(const QGeoTileSpec &spec, const QGeoTileValidators &validators);
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
 
 protected:
@@ -91,6 +104,7 @@ protected:
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
     virtual bool initialized() const;
     virtual bool fetchingEnabled() const;
+    QGeoTileValidators tileValidators(const QGeoTileSpec &spec) const;
 
 private:
 
@@ -63,22 +63,61 @@
 #include <QMutexLocker>
 #include <QHash>
 #include "qgeomaptype_p.h"
+#include "qgeotilespec_p.h"
 
 QT_BEGIN_NAMESPACE
 
-class QGeoTileSpec;
 class QGeoTiledMapReply;
 class QGeoMappingManagerEngine;
+class QGeoTileMetrics;
+
+/* Tiles waiting to be fetched, the ones closest to the focus tile (the
+ * center of the viewport) first. Tiles at other zoom levels, prefetched or
+ * used as fallback, come after the ones at the focus zoom level. Removal is
+ * O(1): the binary heap keeps stale entries, skipped when they surface. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileFetchQueue
+{
+public:
+    void setFocus(const QGeoTileSpec &focus);
+    void enqueue(const QGeoTileSpec &spec);
+    bool remove(const QGeoTileSpec &spec);
+    QGeoTileSpec takeFirst();
+    void clear();
+
+    bool isEmpty() const { return pending_.isEmpty(); }
+    qsizetype size() const { return pending_.size(); }
+
+private:
+    struct Entry
+    {
+        int zoomDistance;
+        double distance;
+        quint64 sequence;
+        QGeoTileSpec spec;
+    };
+    static bool lowerPriority(const Entry &lhs, const Entry &rhs);
+    void prioritize(Entry &entry) const;
+    void rebuild();
+
+    QList<Entry> heap_;
+    QHash<QGeoTileSpec, quint64> pending_; // live entries, by sequence
+    quint64 sequence_ = 0;
+    QGeoTileSpec focus_;
+};
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTileFetcherPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QGeoTileFetcher)
 public:
     QBasicTimer timer_;
-    QMutex queueMutex_;
-    QList<QGeoTileSpec> queue_;
+    mutable QMutex queueMutex_;
+    QGeoTileFetchQueue queue_;
     QHash<QGeoTileSpec, QGeoTiledMapReply *> invmap_;
+    QGeoTileMetrics *metrics_ = nullptr;
+    QHash<QGeoTileSpec, qint64> requestStarts_; // only while the metrics are enabled
+    QHash<QGeoTileSpec, QGeoTileValidators> validators_; // of the queued revalidations
     QGeoMappingManagerEngine *engine_ = nullptr;
+    int maxConcurrentRequests_ = 6;
     bool enabled_ = false;
 };
 
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotileformat_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QReadWriteLock>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Same layout as the plugin registry of QGeoTileKey, seeded with the fixed ids
+struct QGeoTileFormatRegistry
+{
+    QGeoTileFormatRegistry()
+    {
+        names = { QString(), QStringLiteral("png"), QStringLiteral("jpg"),
+                  QStringLiteral("jpeg"), QStringLiteral("gif"), QStringLiteral("webp"),
+                  QStringLiteral("pbf") };
+        for (qsizetype i = 1; i < names.size(); ++i)
+            ids.insert(names.at(i), quint16(i));
+    }
+
+    QReadWriteLock lock;
+    QHash<QString, quint16> ids;
+    QList<QString> names; // indexed by id, 0 is the empty name
+};
+
+}
+
+Q_GLOBAL_STATIC(QGeoTileFormatRegistry, formatRegistry)
+
+QGeoTileFormat QGeoTileFormat::fromName(const QString &name)
+{
+    if (name.isEmpty())
+        return QGeoTileFormat();
+
+    QGeoTileFormatRegistry *registry = formatRegistry();
+    {
+        QReadLocker locker(&registry->lock);
+        const auto it = registry->ids.constFind(name);
+        if (it != registry->ids.constEnd())
+            return QGeoTileFormat(it.value());
+    }
+
+    QWriteLocker locker(&registry->lock);
+    const auto it = registry->ids.constFind(name);
+    if (it != registry->ids.constEnd())
+        return QGeoTileFormat(it.value());
+    if (registry->names.size() > 0xffff) {
+        qWarning("QGeoTileFormat: too many tile formats");
+        return QGeoTileFormat();
+    }
+    const quint16 id = quint16(registry->names.size());
+    registry->names.append(name);
+    registry->ids.insert(name, id);
+    return QGeoTileFormat(id);
+}
+
+QString QGeoTileFormat::name() const
+{
+    QGeoTileFormatRegistry *registry = formatRegistry();
+    QReadLocker locker(&registry->lock);
+    return registry->names.value(id_);
+}
+
+QDebug operator<<(QDebug dbg, QGeoTileFormat format)
+{
+    dbg << format.name();
+    return dbg;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILEFORMAT_P_H
+#define QGEOTILEFORMAT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QHashFunctions>
+#include <QtCore/QMetaType>
+#include <QtCore/QString>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+/* Image format of a tile, the suffix of its cache file name ("png", "jpg"),
+ * interned in a process wide registry the way QGeoTileKey interns plugin
+ * names. Tiles travel from the fetcher to the caches with this 16 bit id
+ * instead of a QString, the name is only looked up to build file names.
+ *
+ * The common formats have fixed ids, other names are registered on first
+ * use and never unregistered. Names are case sensitive, they end up in the
+ * file names of existing caches. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileFormat
+{
+public:
+    enum Id : quint16 {
+        Unknown = 0,
+        Png,
+        Jpg,
+        Jpeg,
+        Gif,
+        Webp,
+        Pbf
+    };
+
+    constexpr QGeoTileFormat() noexcept = default;
+    constexpr QGeoTileFormat(Id id) noexcept : id_(id) {}
+
+    static QGeoTileFormat fromName(const QString &name);
+    QString name() const;
+
+    constexpr quint16 id() const noexcept { return id_; }
+    constexpr bool isValid() const noexcept { return id_ != Unknown; }
+
+    friend constexpr bool operator==(QGeoTileFormat lhs, QGeoTileFormat rhs) noexcept
+    { return lhs.id_ == rhs.id_; }
+    friend constexpr bool operator!=(QGeoTileFormat lhs, QGeoTileFormat rhs) noexcept
+    { return lhs.id_ != rhs.id_; }
+    friend size_t qHash(QGeoTileFormat format, size_t seed = 0) noexcept
+    { return qHash(format.id_, seed); }
+
+private:
+    constexpr explicit QGeoTileFormat(quint16 id) noexcept : id_(id) {}
+
+    quint16 id_ = Unknown;
+};
+
+Q_DECLARE_TYPEINFO(QGeoTileFormat, Q_PRIMITIVE_TYPE);
+
+Q_LOCATION_PRIVATE_EXPORT QDebug operator<<(QDebug, QGeoTileFormat);
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoTileFormat)
+
+#endif // QGEOTILEFORMAT_P_H
@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotilekey_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QReadWriteLock>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Plugin names are never unregistered, there is a handful per process
+struct QGeoTilePluginRegistry
+{
+    QGeoTilePluginRegistry() { names.append(QString()); }
+
+    QReadWriteLock lock;
+    QHash<QString, quint16> ids;
+    QList<QString> names; // indexed by id, 0 is the empty name
+};
+
+}
+
+Q_GLOBAL_STATIC(QGeoTilePluginRegistry, pluginRegistry)
+
+quint16 QGeoTileKey::pluginId(const QString &plugin)
+{
+    if (plugin.isEmpty())
+        return 0;
+
+    QGeoTilePluginRegistry *registry = pluginRegistry();
+    {
+        QReadLocker locker(&registry->lock);
+        const auto it = registry->ids.constFind(plugin);
+        if (it != registry->ids.constEnd())
+            return it.value();
+    }
+
+    QWriteLocker locker(&registry->lock);
+    const auto it = registry->ids.constFind(plugin);
+    if (it != registry->ids.constEnd())
+        return it.value();
+    if (registry->names.size() > 0xffff) {
+        qWarning("QGeoTileKey: too many tile plugin names");
+        return 0;
+    }
+    const quint16 id = quint16(registry->names.size());
+    registry->names.append(plugin);
+    registry->ids.insert(plugin, id);
+    return id;
+}
+
+QString QGeoTileKey::pluginName(quint16 pluginId)
+{
+    QGeoTilePluginRegistry *registry = pluginRegistry();
+    QReadLocker locker(&registry->lock);
+    return registry->names.value(pluginId);
+}
+
+QDebug operator<<(QDebug dbg, const QGeoTileKey &key)
+{
+    dbg << key.plugin() << key.mapId() << key.zoom() << key.x() << key.y() << key.version();
+    return dbg;
+}
+
+QT_END_NAMESPACE
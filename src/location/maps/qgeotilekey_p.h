@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILEKEY_P_H
+#define QGEOTILEKEY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QHashFunctions>
+#include <QtCore/QString>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+/* Value type identifying a tile inside the tile pipeline, with the same
+ * fields as QGeoTileSpec packed in 128 bits and the plugin name replaced by
+ * an id from a process wide registry. Copying, hashing and comparing a key
+ * never touches the heap or a string, which makes it the key of choice for
+ * the containers rebuilt on every frame. QGeoTileSpec remains the type used
+ * at API boundaries, see QGeoTileSpec::key().
+ *
+ * mapId and version are stored on 16 bits, zoom on 8 bits. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileKey
+{
+public:
+    constexpr QGeoTileKey() noexcept
+        : QGeoTileKey(0, 0, -1, -1, -1, -1) {}
+    constexpr QGeoTileKey(quint16 pluginId, int mapId, int zoom, int x, int y, int version = -1) noexcept
+        : hi_((quint64(pluginId) << 48) | (quint64(quint16(mapId)) << 32)
+              | (quint64(quint16(version)) << 16) | (quint64(quint8(zoom)) << 8)),
+          lo_((quint64(quint32(x)) << 32) | quint32(y)) {}
+
+    static quint16 pluginId(const QString &plugin);
+    static QString pluginName(quint16 pluginId);
+
+    constexpr quint16 pluginId() const noexcept { return quint16(hi_ >> 48); }
+    QString plugin() const { return pluginName(pluginId()); }
+    constexpr int mapId() const noexcept { return qint16(quint16(hi_ >> 32)); }
+    constexpr int version() const noexcept { return qint16(quint16(hi_ >> 16)); }
+    constexpr int zoom() const noexcept { return qint8(quint8(hi_ >> 8)); }
+    constexpr int x() const noexcept { return qint32(quint32(lo_ >> 32)); }
+    constexpr int y() const noexcept { return qint32(quint32(lo_)); }
+
+    void setZoom(int zoom) noexcept
+    { hi_ = (hi_ & ~(quint64(0xff) << 8)) | (quint64(quint8(zoom)) << 8); }
+    void setX(int x) noexcept
+    { lo_ = (lo_ & 0xffffffffULL) | (quint64(quint32(x)) << 32); }
+    void setY(int y) noexcept
+    { lo_ = (lo_ & ~0xffffffffULL) | quint32(y); }
+
+    friend constexpr bool operator==(const QGeoTileKey &lhs, const QGeoTileKey &rhs) noexcept
+    { return lhs.hi_ == rhs.hi_ && lhs.lo_ == rhs.lo_; }
+    friend constexpr bool operator!=(const QGeoTileKey &lhs, const QGeoTileKey &rhs) noexcept
+    { return !(lhs == rhs); }
+    // Not the QGeoTileSpec order: plugins compare by registration order
+    friend constexpr bool operator<(const QGeoTileKey &lhs, const QGeoTileKey &rhs) noexcept
+    { return lhs.hi_ < rhs.hi_ || (lhs.hi_ == rhs.hi_ && lhs.lo_ < rhs.lo_); }
+
+    friend size_t qHash(const QGeoTileKey &key, size_t seed = 0) noexcept
+    { return qHashMulti(seed, key.hi_, key.lo_); }
+
+private:
+    quint64 hi_; // plugin | mapId | version | zoom | unused
+    quint64 lo_; // x | y
+};
+
+Q_DECLARE_TYPEINFO(QGeoTileKey, Q_PRIMITIVE_TYPE);
+
+Q_LOCATION_PRIVATE_EXPORT QDebug operator<<(QDebug, const QGeoTileKey &);
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEKEY_P_H
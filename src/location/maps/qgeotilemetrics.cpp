@@ -0,0 +1,183 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotilemetrics_p.h"
+
+#include <QtCore/qalgorithms.h>
+
+QT_BEGIN_NAMESPACE
+
+static int bucketOf(qint64 usecs)
+{
+    if (usecs < 1)
+        return 0;
+    const int bucket = 64 - int(qCountLeadingZeroBits(quint64(usecs)));
+    return qMin(bucket, QGeoTileMetrics::Histogram::BucketCount - 1);
+}
+
+void QGeoTileMetrics::Histogram::record(qint64 usecs)
+{
+    buckets_[bucketOf(usecs)].fetchAndAddRelaxed(1);
+}
+
+void QGeoTileMetrics::Histogram::reset()
+{
+    for (QAtomicInteger<quint64> &bucket : buckets_)
+        bucket.storeRelaxed(0);
+}
+
+quint64 QGeoTileMetrics::Histogram::count() const
+{
+    quint64 total = 0;
+    for (const QAtomicInteger<quint64> &bucket : buckets_)
+        total += bucket.loadRelaxed();
+    return total;
+}
+
+/*
+    Returns the latency below which a fraction p of the samples fall,
+    interpolated linearly inside the bucket it lands in. The result is within
+    a factor of two of the exact value.
+*/
+qint64 QGeoTileMetrics::Histogram::percentile(double p) const
+{
+    quint64 counts[BucketCount];
+    quint64 total = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        counts[i] = buckets_[i].loadRelaxed();
+        total += counts[i];
+    }
+    if (!total)
+        return 0;
+
+    const double rank = qBound(0.0, p, 1.0) * total;
+    quint64 below = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        if (!counts[i])
+            continue;
+        if (below + counts[i] >= rank) {
+            const double low = i ? double(quint64(1) << (i - 1)) : 0.0;
+            const double high = double(quint64(1) << i);
+            const double fraction = (rank - below) / counts[i];
+            return qint64(low + fraction * (high - low) + 0.5);
+        }
+        below += counts[i];
+    }
+    return qint64(quint64(1) << (BucketCount - 1));
+}
+
+QGeoTileMetrics::QGeoTileMetrics()
+{
+    clock_.start();
+}
+
+void QGeoTileMetrics::setEnabled(bool enabled)
+{
+    enabled_.storeRelaxed(enabled);
+}
+
+// Clears the latencies and the counters. The cache counters are not affected
+void QGeoTileMetrics::reset()
+{
+    for (Histogram &histogram : histograms_)
+        histogram.reset();
+    for (QAtomicInteger<quint64> &counter : counters_)
+        counter.storeRelaxed(0);
+}
+
+void QGeoTileMetrics::snapshot(Snapshot *snapshot) const
+{
+    snapshot->enabled = isEnabled();
+    for (int i = 0; i < StageCount; ++i) {
+        StageStats &stats = snapshot->stages[i];
+        stats.count = qint64(histograms_[i].count());
+        stats.p50 = histograms_[i].percentile(0.50);
+        stats.p90 = histograms_[i].percentile(0.90);
+        stats.p99 = histograms_[i].percentile(0.99);
+    }
+    for (int i = 0; i < CounterCount; ++i)
+        snapshot->counters[i] = qint64(counters_[i].loadRelaxed());
+}
+
+QVariantMap QGeoTileMetrics::Snapshot::toVariantMap() const
+{
+    static const char *const tierNames[TierCount] = { "texture", "memory", "disk" };
+    static const char *const stageNames[StageCount] = { "fetch", "diskRead", "decode", "upload" };
+
+    QVariantMap caches;
+    for (int i = 0; i < TierCount; ++i) {
+        const TierStats &stats = tiers[i];
+        QVariantMap tier;
+        tier.insert(QStringLiteral("hits"), stats.hits);
+        tier.insert(QStringLiteral("misses"), stats.misses);
+        tier.insert(QStringLiteral("evictions"), stats.evictions);
+        tier.insert(QStringLiteral("tiles"), stats.tiles);
+        tier.insert(QStringLiteral("bytes"), stats.bytes);
+        tier.insert(QStringLiteral("maxBytes"), stats.maxBytes);
+        caches.insert(QLatin1String(tierNames[i]), tier);
+    }
+
+    QVariantMap latencies;
+    for (int i = 0; i < StageCount; ++i) {
+        const StageStats &stats = stages[i];
+        QVariantMap stage;
+        stage.insert(QStringLiteral("count"), stats.count);
+        stage.insert(QStringLiteral("p50"), stats.p50);
+        stage.insert(QStringLiteral("p90"), stats.p90);
+        stage.insert(QStringLiteral("p99"), stats.p99);
+        latencies.insert(QLatin1String(stageNames[i]), stage);
+    }
+
+    QVariantMap requests;
+    requests.insert(QStringLiteral("inFlight"), requestsInFlight);
+    requests.insert(QStringLiteral("queued"), requestsQueued);
+    requests.insert(QStringLiteral("total"), counters[FetchRequests]);
+    requests.insert(QStringLiteral("cancelled"), counters[FetchCancels]);
+    requests.insert(QStringLiteral("errors"), counters[FetchErrors]);
+
+    QVariantMap map;
+    map.insert(QStringLiteral("enabled"), enabled);
+    map.insert(QStringLiteral("caches"), caches);
+    map.insert(QStringLiteral("latencies"), latencies);
+    map.insert(QStringLiteral("requests"), requests);
+    return map;
+}
+
+QT_END_NAMESPACE
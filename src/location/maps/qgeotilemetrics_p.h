@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILEMETRICS_P_H
+#define QGEOTILEMETRICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QVariantMap>
+
+QT_BEGIN_NAMESPACE
+
+/* Counters and latency histograms of the tile pipeline of one mapping
+ * engine. Recording is thread safe and lock free; while disabled it costs a
+ * relaxed load and a branch. The per tier cache counters are kept by the
+ * caches themselves and pulled into the snapshot */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileMetrics
+{
+public:
+    enum Tier {
+        TextureTier,
+        MemoryTier,
+        DiskTier,
+        TierCount
+    };
+
+    enum Stage {
+        FetchStage,     // network request to reply
+        DiskReadStage,  // reading the tile from the disk storage
+        DecodeStage,    // decoding and converting the image
+        UploadStage,    // staging the texture into the atlas
+        StageCount
+    };
+
+    enum Counter {
+        FetchRequests,
+        FetchCancels,
+        FetchErrors,
+        CounterCount
+    };
+
+    /* Latencies in microseconds, counted in power of two buckets. Bucket 0
+     * holds [0, 1), bucket i holds [2^(i-1), 2^i) */
+    class Q_LOCATION_PRIVATE_EXPORT Histogram
+    {
+    public:
+        void record(qint64 usecs);
+        void reset();
+        quint64 count() const;
+        qint64 percentile(double p) const;
+
+        static constexpr int BucketCount = 40;
+
+    private:
+        QAtomicInteger<quint64> buckets_[BucketCount];
+    };
+
+    struct TierStats
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+        qint64 tiles = 0;
+        qint64 bytes = -1;      // -1 when the tier is not costed in bytes
+        qint64 maxBytes = -1;
+    };
+
+    struct StageStats
+    {
+        qint64 count = 0;
+        qint64 p50 = 0;         // microseconds
+        qint64 p90 = 0;
+        qint64 p99 = 0;
+    };
+
+    struct Snapshot
+    {
+        bool enabled = false;
+        TierStats tiers[TierCount];
+        StageStats stages[StageCount];
+        qint64 counters[CounterCount] = {};
+        int requestsInFlight = 0;
+        int requestsQueued = 0;
+
+        QVariantMap toVariantMap() const;
+    };
+
+    QGeoTileMetrics();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_.loadRelaxed(); }
+    void reset();
+
+    // Microseconds since the metrics were created, for timing across threads
+    qint64 now() const { return clock_.nsecsElapsed() / 1000; }
+
+    void record(Stage stage, qint64 usecs)
+    {
+        if (isEnabled())
+            histograms_[stage].record(usecs);
+    }
+    void recordSince(Stage stage, qint64 start) { record(stage, now() - start); }
+    void increment(Counter counter, int count = 1)
+    {
+        if (isEnabled())
+            counters_[counter].fetchAndAddRelaxed(count);
+    }
+
+    const Histogram &histogram(Stage stage) const { return histograms_[stage]; }
+    quint64 counter(Counter counter) const { return counters_[counter].loadRelaxed(); }
+
+    // Fills in the stages and counters, the rest is up to the caller
+    void snapshot(Snapshot *snapshot) const;
+
+private:
+    QAtomicInt enabled_;
+    QElapsedTimer clock_;
+    Histogram histograms_[StageCount];
+    QAtomicInteger<quint64> counters_[CounterCount];
+
+    Q_DISABLE_COPY(QGeoTileMetrics)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEMETRICS_P_H
@@ -0,0 +1,521 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeotilepackstorage_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+#include <QtCore/QDebug>
+
+QT_BEGIN_NAMESPACE
+
+static const quint32 PackMagic = 0x50544751;   // "QGTP"
+static const quint32 RecordMagic = 0x52544751; // "QGTR"
+static const quint32 IndexMagic = 0x49544751;  // "QGTI"
+static const quint32 FormatVersion = 1;
+
+/* Pack header: magic, version, generation, reserved.
+ * Record header: magic, type, reserved, name length, data length,
+ * checksum, timestamp; followed by the UTF-8 name and the tile data. */
+static const qint64 PackHeaderSize = 16;
+static const quint32 RecordHeaderSize = 24;
+
+static const quint8 TileRecord = 1;
+static const quint8 TombstoneRecord = 2;
+
+// Don't bother compacting until at least this much space is wasted
+static const qint64 MinimumCompactionGain = 1024 * 1024;
+// Records appended past the mapping are read with plain file reads until the
+// unmapped tail reaches this size, so that interleaved writes and reads don't
+// remap the whole pack each time.
+static const qint64 MappingGrowthStep = 16 * 1024 * 1024;
+
+static quint32 recordChecksum(const char *name, qsizetype nameLength, const char *data, qsizetype dataLength)
+{
+    const quint16 nameChecksum = qChecksum(QByteArrayView(name, nameLength));
+    const quint16 dataChecksum = qChecksum(QByteArrayView(data, dataLength));
+    return (quint32(nameChecksum) << 16) | dataChecksum;
+}
+
+static bool writePackHeader(QIODevice *device, quint32 generation)
+{
+    uchar header[PackHeaderSize] = {};
+    qToLittleEndian<quint32>(PackMagic, header);
+    qToLittleEndian<quint32>(FormatVersion, header + 4);
+    qToLittleEndian<quint32>(generation, header + 8);
+    return device->write(reinterpret_cast<const char *>(header), PackHeaderSize) == PackHeaderSize;
+}
+
+QGeoTilePackStorage::QGeoTilePackStorage()
+{
+}
+
+QGeoTilePackStorage::~QGeoTilePackStorage()
+{
+    QMutexLocker locker(&mutex_);
+    if (pack_.isOpen() && indexDirty_)
+        saveIndex();
+    unmapPack();
+    pack_.close();
+}
+
+QString QGeoTilePackStorage::kind() const
+{
+    return QStringLiteral("pack");
+}
+
+bool QGeoTilePackStorage::open(const QString &directory)
+{
+    QMutexLocker locker(&mutex_);
+
+    const QDir dir(directory);
+    packPath_ = dir.filePath(QStringLiteral("tiles.pack"));
+    indexPath_ = dir.filePath(QStringLiteral("tiles.idx"));
+
+    pack_.setFileName(packPath_);
+    if (!pack_.open(QIODevice::ReadWrite)) {
+        qWarning() << "Unable to open tile pack" << packPath_ << pack_.errorString();
+        return false;
+    }
+
+    bool validPack = false;
+    if (pack_.size() >= PackHeaderSize) {
+        uchar header[PackHeaderSize];
+        validPack = pack_.read(reinterpret_cast<char *>(header), PackHeaderSize) == PackHeaderSize
+                && qFromLittleEndian<quint32>(header) == PackMagic
+                && qFromLittleEndian<quint32>(header + 4) == FormatVersion;
+        if (validPack)
+            generation_ = qFromLittleEndian<quint32>(header + 8);
+    }
+    if (!validPack) {
+        if (pack_.size() > 0)
+            qWarning() << "Discarding unreadable tile pack" << packPath_;
+        QFile::remove(indexPath_);
+        if (!createPack(generation_ + 1)) {
+            pack_.close();
+            return false;
+        }
+    }
+
+    index_.clear();
+    deadBytes_ = 0;
+    qint64 indexedSize = PackHeaderSize;
+    if (loadIndex()) {
+        indexedSize = packSize_;
+    } else {
+        index_.clear();
+        deadBytes_ = 0;
+    }
+
+    // Recover what was appended after the index was last saved, and drop a
+    // record torn by a crash or a full disk
+    const qint64 end = scanRecords(indexedSize);
+    if (end < pack_.size()) {
+        qWarning() << "Truncating tile pack" << packPath_ << "at" << end << "of" << pack_.size() << "bytes";
+        unmapPack();
+        pack_.resize(end);
+    }
+    packSize_ = end;
+    if (end != indexedSize)
+        indexDirty_ = true;
+
+    const bool worthCompacting = deadBytes_ > MinimumCompactionGain && deadBytes_ * 3 > packSize_;
+    locker.unlock();
+
+    if (worthCompacting)
+        compact();
+    return true;
+}
+
+QList<QGeoTileDiskStorage::Entry> QGeoTilePackStorage::entries() const
+{
+    QMutexLocker locker(&mutex_);
+
+    QList<Entry> result;
+    result.reserve(index_.size());
+    for (auto it = index_.cbegin(); it != index_.cend(); ++it)
+        result.append({ it.key(), it->size, QDateTime::fromMSecsSinceEpoch(it->lastModified) });
+    return result;
+}
+
+bool QGeoTilePackStorage::write(const QString &name, const QByteArray &bytes)
+{
+    QMutexLocker locker(&mutex_);
+    if (!pack_.isOpen())
+        return false;
+
+    Slot slot;
+    if (!appendRecord(TileRecord, name.toUtf8(), bytes, &slot))
+        return false;
+
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+        deadBytes_ += it->headerSize + it->size;
+        *it = slot;
+    } else {
+        index_.insert(name, slot);
+    }
+    return true;
+}
+
+QByteArray QGeoTilePackStorage::read(const QString &name) const
+{
+    QMutexLocker locker(&mutex_);
+
+    const auto it = index_.constFind(name);
+    if (it == index_.cend())
+        return QByteArray();
+
+    const qint64 dataOffset = it->offset + it->headerSize;
+    if (dataOffset + it->size <= mapSize_)
+        return QByteArray(reinterpret_cast<const char *>(map_ + dataOffset), it->size);
+
+    const bool remap = !map_ || packSize_ - mapSize_ >= MappingGrowthStep;
+    if (remap && mapPack(packSize_))
+        return QByteArray(reinterpret_cast<const char *>(map_ + dataOffset), it->size);
+
+    // Unmapped tail, or no mapping available, e.g. on address space exhaustion
+    if (!pack_.seek(dataOffset))
+        return QByteArray();
+    return pack_.read(it->size);
+}
+
+void QGeoTilePackStorage::remove(const QString &name)
+{
+    QMutexLocker locker(&mutex_);
+
+    auto it = index_.find(name);
+    if (it == index_.end())
+        return;
+
+    Slot tombstone;
+    if (!appendRecord(TombstoneRecord, name.toUtf8(), QByteArray(), &tombstone))
+        return;
+    deadBytes_ += it->headerSize + it->size + tombstone.headerSize;
+    index_.erase(it);
+}
+
+void QGeoTilePackStorage::clear()
+{
+    QMutexLocker locker(&mutex_);
+    if (!pack_.isOpen())
+        return;
+
+    index_.clear();
+    deadBytes_ = 0;
+    if (createPack(generation_ + 1))
+        saveIndex();
+}
+
+bool QGeoTilePackStorage::sync()
+{
+    QMutexLocker locker(&mutex_);
+    return !pack_.isOpen() || syncFile(pack_);
+}
+
+/* Rewrites the pack with the live records only. Records are copied as they
+ * are, checksums and timestamps included. The new pack gets a new generation
+ * so that an index saved for the old one is never applied to it. */
+bool QGeoTilePackStorage::compact()
+{
+    QMutexLocker locker(&mutex_);
+    if (!pack_.isOpen())
+        return false;
+    if (deadBytes_ == 0)
+        return true;
+    if (!mapPack(packSize_))
+        return false;
+
+    QSaveFile out(packPath_);
+    const quint32 generation = generation_ + 1;
+    if (!out.open(QIODevice::WriteOnly) || !writePackHeader(&out, generation))
+        return false;
+
+    QHash<QString, Slot> compacted;
+    compacted.reserve(index_.size());
+    qint64 pos = PackHeaderSize;
+    for (auto it = index_.cbegin(); it != index_.cend(); ++it) {
+        const qint64 recordSize = it->headerSize + it->size;
+        if (out.write(reinterpret_cast<const char *>(map_ + it->offset), recordSize) != recordSize)
+            return false;
+        Slot slot = *it;
+        slot.offset = pos;
+        compacted.insert(it.key(), slot);
+        pos += recordSize;
+    }
+
+    // The old pack can't be replaced while it is open on every platform
+    unmapPack();
+    pack_.close();
+    const bool committed = out.commit();
+    if (!pack_.open(QIODevice::ReadWrite)) {
+        qWarning() << "Unable to reopen tile pack" << packPath_ << pack_.errorString();
+        index_.clear();
+        return false;
+    }
+    if (!committed)
+        return false;
+
+    index_ = compacted;
+    generation_ = generation;
+    packSize_ = pos;
+    deadBytes_ = 0;
+    saveIndex();
+    return true;
+}
+
+qint64 QGeoTilePackStorage::packSize() const
+{
+    QMutexLocker locker(&mutex_);
+    return packSize_;
+}
+
+qint64 QGeoTilePackStorage::wastedBytes() const
+{
+    QMutexLocker locker(&mutex_);
+    return deadBytes_;
+}
+
+bool QGeoTilePackStorage::createPack(quint32 generation)
+{
+    unmapPack();
+    if (!pack_.resize(0) || !pack_.seek(0) || !writePackHeader(&pack_, generation)) {
+        qWarning() << "Unable to initialize tile pack" << packPath_ << pack_.errorString();
+        return false;
+    }
+    pack_.flush();
+    generation_ = generation;
+    packSize_ = PackHeaderSize;
+    indexDirty_ = true;
+    return true;
+}
+
+bool QGeoTilePackStorage::loadIndex()
+{
+    QFile file(indexPath_);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();
+    file.close();
+
+    if (data.size() < qsizetype(sizeof(quint16)))
+        return false;
+    const qsizetype payloadSize = data.size() - sizeof(quint16);
+    if (qChecksum(QByteArrayView(data.constData(), payloadSize))
+            != qFromLittleEndian<quint16>(data.constData() + payloadSize)) {
+        return false;
+    }
+
+    QDataStream in(data.left(payloadSize));
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 generation = 0;
+    qint64 packSize = 0;
+    qint64 deadBytes = 0;
+    quint32 count = 0;
+    in >> magic >> version >> generation >> packSize >> deadBytes >> count;
+    if (in.status() != QDataStream::Ok || magic != IndexMagic || version != FormatVersion
+            || generation != generation_ || packSize < PackHeaderSize || packSize > pack_.size()) {
+        return false;
+    }
+
+    index_.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        QString name;
+        Slot slot;
+        in >> name >> slot.offset >> slot.headerSize >> slot.size >> slot.lastModified;
+        if (in.status() != QDataStream::Ok || slot.offset < PackHeaderSize
+                || slot.offset + slot.headerSize + slot.size > packSize) {
+            return false;
+        }
+        index_.insert(name, slot);
+    }
+
+    packSize_ = packSize;
+    deadBytes_ = deadBytes;
+    return true;
+}
+
+bool QGeoTilePackStorage::saveIndex()
+{
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << IndexMagic << FormatVersion << generation_ << packSize_ << deadBytes_
+            << quint32(index_.size());
+        for (auto it = index_.cbegin(); it != index_.cend(); ++it)
+            out << it.key() << it->offset << it->headerSize << it->size << it->lastModified;
+    }
+    uchar checksum[sizeof(quint16)];
+    qToLittleEndian<quint16>(qChecksum(data), checksum);
+    data.append(reinterpret_cast<const char *>(checksum), sizeof(checksum));
+
+    // The pack has to hit the disk before an index pointing into it
+    pack_.flush();
+
+    QSaveFile file(indexPath_);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Unable to write tile pack index" << indexPath_;
+        return false;
+    }
+    indexDirty_ = false;
+    return true;
+}
+
+/* Replays the records found from offset 'from' on into the index and
+ * returns the end of the last valid one */
+qint64 QGeoTilePackStorage::scanRecords(qint64 from)
+{
+    const qint64 size = pack_.size();
+    if (from >= size)
+        return from;
+
+    QByteArray buffer;
+    const uchar *data = nullptr;
+    if (mapPack(size)) {
+        data = map_;
+    } else {
+        pack_.seek(0);
+        buffer = pack_.readAll();
+        data = reinterpret_cast<const uchar *>(buffer.constData());
+    }
+
+    qint64 pos = from;
+    while (pos + RecordHeaderSize <= size) {
+        const uchar *header = data + pos;
+        if (qFromLittleEndian<quint32>(header) != RecordMagic)
+            break;
+
+        const quint8 type = header[4];
+        const quint16 nameLength = qFromLittleEndian<quint16>(header + 6);
+        const quint32 dataLength = qFromLittleEndian<quint32>(header + 8);
+        const quint32 checksum = qFromLittleEndian<quint32>(header + 12);
+        const qint64 timestamp = qFromLittleEndian<qint64>(header + 16);
+        const qint64 recordSize = qint64(RecordHeaderSize) + nameLength + dataLength;
+        if ((type != TileRecord && type != TombstoneRecord) || pos + recordSize > size)
+            break;
+
+        const char *name = reinterpret_cast<const char *>(header + RecordHeaderSize);
+        if (recordChecksum(name, nameLength, name + nameLength, dataLength) != checksum)
+            break;
+
+        const QString key = QString::fromUtf8(name, nameLength);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            deadBytes_ += it->headerSize + it->size;
+            index_.erase(it);
+        }
+
+        if (type == TileRecord) {
+            Slot slot;
+            slot.offset = pos;
+            slot.headerSize = RecordHeaderSize + nameLength;
+            slot.size = dataLength;
+            slot.lastModified = timestamp;
+            index_.insert(key, slot);
+        } else {
+            deadBytes_ += recordSize;
+        }
+        pos += recordSize;
+    }
+    return pos;
+}
+
+bool QGeoTilePackStorage::appendRecord(quint8 type, const QByteArray &name, const QByteArray &bytes, Slot *slot)
+{
+    if (name.size() > 0xffff || quint64(bytes.size()) > 0xffffffffu)
+        return false;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    uchar header[RecordHeaderSize] = {};
+    qToLittleEndian<quint32>(RecordMagic, header);
+    header[4] = type;
+    qToLittleEndian<quint16>(quint16(name.size()), header + 6);
+    qToLittleEndian<quint32>(quint32(bytes.size()), header + 8);
+    qToLittleEndian<quint32>(recordChecksum(name.constData(), name.size(),
+                                            bytes.constData(), bytes.size()), header + 12);
+    qToLittleEndian<qint64>(now, header + 16);
+
+    if (!pack_.seek(packSize_)
+            || pack_.write(reinterpret_cast<const char *>(header), RecordHeaderSize) != RecordHeaderSize
+            || pack_.write(name) != name.size()
+            || pack_.write(bytes) != bytes.size()
+            || !pack_.flush()) {
+        qWarning() << "Unable to append to tile pack" << packPath_ << pack_.errorString();
+        unmapPack();
+        pack_.resize(packSize_);
+        return false;
+    }
+
+    slot->offset = packSize_;
+    slot->headerSize = RecordHeaderSize + name.size();
+    slot->size = bytes.size();
+    slot->lastModified = now;
+    packSize_ += slot->headerSize + slot->size;
+    indexDirty_ = true;
+    return true;
+}
+
+bool QGeoTilePackStorage::mapPack(qint64 size) const
+{
+    if (map_ && mapSize_ >= size)
+        return true;
+    unmapPack();
+    if (size <= 0)
+        return false;
+    map_ = pack_.map(0, size);
+    if (!map_)
+        return false;
+    mapSize_ = size;
+    return true;
+}
+
+void QGeoTilePackStorage::unmapPack() const
+{
+    if (map_)
+        pack_.unmap(map_);
+    map_ = nullptr;
+    mapSize_ = 0;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOTILEPACKSTORAGE_P_H
+#define QGEOTILEPACKSTORAGE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotilediskstorage_p.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+QT_BEGIN_NAMESPACE
+
+/* Keeps all the tiles of a cache directory in a single append-only pack
+ * file (tiles.pack), with an index (tiles.idx) mapping tile names to their
+ * position in the pack.
+ *
+ * Each record in the pack is self describing and checksummed, removals
+ * append a tombstone record. The index is only a snapshot: records appended
+ * after it was saved are recovered by scanning the tail of the pack, and a
+ * missing or corrupt index is rebuilt from the pack alone. A torn record at
+ * the end of the pack, left by a crash, is truncated away.
+ *
+ * Space taken by overwritten and removed tiles is reclaimed by compact(),
+ * which is run on open() once enough of the pack is wasted. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTilePackStorage : public QGeoTileDiskStorage
+{
+public:
+    QGeoTilePackStorage();
+    ~QGeoTilePackStorage();
+
+    QString kind() const override;
+    bool open(const QString &directory) override;
+    QList<Entry> entries() const override;
+
+    bool write(const QString &name, const QByteArray &bytes) override;
+    QByteArray read(const QString &name) const override;
+    void remove(const QString &name) override;
+    void clear() override;
+    bool sync() override;
+
+    bool compact();
+    qint64 packSize() const;
+    qint64 wastedBytes() const;
+
+private:
+    struct Slot
+    {
+        qint64 offset = 0;       // start of the record
+        quint32 headerSize = 0;  // record header plus name
+        quint32 size = 0;        // tile data
+        qint64 lastModified = 0; // msecs since epoch
+    };
+
+    bool createPack(quint32 generation);
+    bool loadIndex();
+    bool saveIndex();
+    qint64 scanRecords(qint64 from);
+    bool appendRecord(quint8 type, const QByteArray &name, const QByteArray &bytes, Slot *slot);
+    bool mapPack(qint64 size) const;
+    void unmapPack() const;
+
+    QString packPath_;
+    QString indexPath_;
+    mutable QFile pack_;
+    mutable uchar *map_ = nullptr;
+    mutable qint64 mapSize_ = 0;
+    mutable QMutex mutex_;
+
+    QHash<QString, Slot> index_;
+    quint32 generation_ = 0;
+    qint64 packSize_ = 0;
+    qint64 deadBytes_ = 0;
+    bool indexDirty_ = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEPACKSTORAGE_P_H
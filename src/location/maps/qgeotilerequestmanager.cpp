@@ -58,14 +58,24 @@ public:
     QGeoTiledMap *m_map;
     QPointer<QGeoTiledMappingManagerEngine> m_engine;
 
-    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileKey> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTileChanges(const QSet<QGeoTileKey> &added,
+                                                                            const QSet<QGeoTileKey> &removed);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > updateRequests(QSet<QGeoTileKey> requestTiles,
+                                                                        const QSet<QGeoTileKey> &cancelTiles,
+                                                                        const QSet<QGeoTileKey> &cancelLoads);
+    void prefetchTiles(const QSet<QGeoTileKey> &tiles);
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
 
-    QHash<QGeoTileSpec, int> m_retries;
-    QHash<QGeoTileSpec, QSharedPointer<RetryFuture> > m_futures;
-    QSet<QGeoTileSpec> m_requested;
+    QHash<QGeoTileKey, int> m_retries;
+    QHash<QGeoTileKey, QSharedPointer<RetryFuture> > m_futures;
+    QSet<QGeoTileKey> m_requested;
+    QSet<QGeoTileKey> m_loading;
+    QSet<QGeoTileKey> m_prefetched; // requested or loading for prefetchTiles() only
 
     void tileFetched(const QGeoTileSpec &spec);
+    void tileLoaded(const QGeoTileSpec &spec);
+    void tileLoadFailed(const QGeoTileSpec &spec);
 };
 
 QGeoTileRequestManager::QGeoTileRequestManager(QGeoTiledMap *map, QGeoTiledMappingManagerEngine *engine)
@@ -79,16 +89,47 @@ QGeoTileRequestManager::~QGeoTileRequestManager()
 
 }
 
-QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileSpec> &tiles)
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileKey> &tiles)
 {
     return d_ptr->requestTiles(tiles);
 }
 
+/*
+    Same as requestTiles() for the previously requested set plus the added and
+    minus the removed tiles, without going through the whole set. Only valid if
+    the previous request was for the set the changes apply to.
+*/
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTileChanges(const QSet<QGeoTileKey> &added,
+                                                                                                const QSet<QGeoTileKey> &removed)
+{
+    return d_ptr->requestTileChanges(added, removed);
+}
+
+/*
+    Requests tiles expected to become visible soon. They are kept apart from
+    the visible ones: the requests only get cancelled by the next call, when
+    the tiles aren't expected anymore, unless they became visible meanwhile.
+*/
+void QGeoTileRequestManager::prefetchTiles(const QSet<QGeoTileKey> &tiles)
+{
+    d_ptr->prefetchTiles(tiles);
+}
+
 void QGeoTileRequestManager::tileFetched(const QGeoTileSpec &spec)
 {
     d_ptr->tileFetched(spec);
 }
 
+void QGeoTileRequestManager::tileLoaded(const QGeoTileSpec &spec)
+{
+    d_ptr->tileLoaded(spec);
+}
+
+void QGeoTileRequestManager::tileLoadFailed(const QGeoTileSpec &spec)
+{
+    d_ptr->tileLoadFailed(spec);
+}
+
 QSharedPointer<QGeoTileTexture> QGeoTileRequestManager::tileTexture(const QGeoTileSpec &spec)
 {
     if (d_ptr->m_engine)
@@ -112,30 +153,86 @@ QGeoTileRequestManagerPrivate::~QGeoTileRequestManagerPrivate()
 {
 }
 
-QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &tiles)
+static QSet<QGeoTileSpec> toSpecs(const QSet<QGeoTileKey> &keys)
 {
-    QSet<QGeoTileSpec> cancelTiles = m_requested - tiles;
-    QSet<QGeoTileSpec> requestTiles = tiles - m_requested;
-    QSet<QGeoTileSpec> cached;
-//    int tileSize = tiles.size();
-//    int newTiles = requestTiles.size();
+    QSet<QGeoTileSpec> specs;
+    specs.reserve(keys.size());
+    for (const QGeoTileKey &key : keys)
+        specs.insert(QGeoTileSpec(key));
+    return specs;
+}
+
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileKey> &tiles)
+{
+    // Prefetched tiles that became visible are no longer up to prefetchTiles() to cancel
+    m_prefetched -= tiles;
+    return updateRequests(tiles - m_requested - m_loading,
+                          m_requested - tiles - m_prefetched, m_loading - tiles - m_prefetched);
+}
+
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTileChanges(const QSet<QGeoTileKey> &added,
+                                                                                                       const QSet<QGeoTileKey> &removed)
+{
+    QSet<QGeoTileKey> requestTiles;
+    QSet<QGeoTileKey> cancelTiles;
+    QSet<QGeoTileKey> cancelLoads;
+    for (const QGeoTileKey &key : added) {
+        if (m_prefetched.remove(key))
+            continue;
+        if (!m_requested.contains(key) && !m_loading.contains(key))
+            requestTiles.insert(key);
+    }
+    for (const QGeoTileKey &key : removed) {
+        if (m_requested.contains(key))
+            cancelTiles.insert(key);
+        if (m_loading.contains(key))
+            cancelLoads.insert(key);
+    }
+    return updateRequests(requestTiles, cancelTiles, cancelLoads);
+}
+
+void QGeoTileRequestManagerPrivate::prefetchTiles(const QSet<QGeoTileKey> &tiles)
+{
+    const QSet<QGeoTileKey> cancelled = m_prefetched - tiles;
+    const QSet<QGeoTileKey> requestTiles = tiles - m_requested - m_loading;
+    m_prefetched -= cancelled;
+
+    // Tiles already in the memory cache don't need to be prefetched
+    updateRequests(requestTiles, cancelled & m_requested, cancelled & m_loading);
+    for (const QGeoTileKey &key : requestTiles) {
+        if (m_requested.contains(key) || m_loading.contains(key))
+            m_prefetched.insert(key);
+    }
+}
 
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::updateRequests(QSet<QGeoTileKey> requestTiles,
+                                                                                                   const QSet<QGeoTileKey> &cancelTiles,
+                                                                                                   const QSet<QGeoTileKey> &cancelLoads)
+{
+    QSet<QGeoTileKey> cached;
+    QSet<QGeoTileKey> loading;
+    QSet<QGeoTileSpec> requestSpecs;
+//    int newTiles = requestTiles.size();
 
     QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > cachedTex;
 
-    // remove tiles in cache from request tiles
-    if (!m_engine.isNull()) {
-        iter i = requestTiles.constBegin();
-        iter end = requestTiles.constEnd();
-        for (; i != end; ++i) {
-            QGeoTileSpec tile = *i;
-            QSharedPointer<QGeoTileTexture> tex = m_engine->getTileTexture(tile);
+    // remove tiles in cache from request tiles, specs are only built for the engine
+    if (!m_engine.isNull() && !requestTiles.isEmpty()) {
+        for (const QGeoTileKey &key : qAsConst(requestTiles)) {
+            const QGeoTileSpec tile(key);
+            QSharedPointer<QGeoTileTexture> tex = m_engine->getLoadedTileTexture(tile);
             if (tex) {
-                if (!tex->image.isNull())
+                if (!tex->isNull())
                     cachedTex.insert(tile, tex);
-                cached.insert(tile);
+                cached.insert(key);
             } else {
+                // Tiles in the disk or memory cache are read and decoded off this thread,
+                // tileLoaded() hands them over to the map once ready
+                if (m_engine->loadTileTexture(m_map, tile))
+                    loading.insert(key);
+                else
+                    requestSpecs.insert(tile);
+
                 // Try to use textures from lower zoom levels, but still request the proper tile
                 QGeoTileSpec spec = tile;
                 const int endRange = qMax(0, tile.zoom() - 4); // Using up to 4 zoom levels up. 4 is arbitrary.
@@ -144,8 +241,8 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
                     spec.setZoom(z);
                     spec.setX(tile.x() / denominator);
                     spec.setY(tile.y() / denominator);
-                    QSharedPointer<QGeoTileTexture> t = m_engine->getTileTexture(spec);
-                    if (t && !t->image.isNull()) {
+                    QSharedPointer<QGeoTileTexture> t = m_engine->getLoadedTileTexture(spec);
+                    if (t && !t->isNull()) {
                         cachedTex.insert(tile, t);
                         break;
                     }
@@ -155,24 +252,25 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
     }
 
     requestTiles -= cached;
+    requestTiles -= loading;
 
     m_requested -= cancelTiles;
     m_requested += requestTiles;
+    m_loading -= cancelLoads;
+    m_loading += loading;
 
-//    qDebug() << "required # tiles: " << tileSize << ", new tiles: " << newTiles << ", total server requests: " << requested_.size();
+    if (!cancelLoads.isEmpty() && !m_engine.isNull())
+        m_engine->cancelTileTextureLoads(m_map, toSpecs(cancelLoads));
 
     if (!requestTiles.isEmpty() || !cancelTiles.isEmpty()) {
         if (!m_engine.isNull()) {
-//            qDebug() << "new server requests: " << requestTiles.size() << ", server cancels: " << cancelTiles.size();
-            m_engine->updateTileRequests(m_map, requestTiles, cancelTiles);
+            m_engine->updateTileRequests(m_map, requestSpecs, toSpecs(cancelTiles));
 
             // Remove any cancelled tiles from the error retry hash to avoid
             // re-using the numbers for a totally different request cycle.
-            iter i = cancelTiles.constBegin();
-            iter end = cancelTiles.constEnd();
-            for (; i != end; ++i) {
-                m_retries.remove(*i);
-                m_futures.remove(*i);
+            for (const QGeoTileKey &key : qAsConst(cancelTiles)) {
+                m_retries.remove(key);
+                m_futures.remove(key);
             }
         }
     }
@@ -182,10 +280,37 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
 
 void QGeoTileRequestManagerPrivate::tileFetched(const QGeoTileSpec &spec)
 {
+    const QGeoTileKey key = spec.key();
+    m_requested.remove(key);
+    m_retries.remove(key);
+    m_futures.remove(key);
+
+    // Visible tiles are decoded off this thread like the cached ones,
+    // tileLoaded() then hands them over to the map
+    if (!m_prefetched.remove(key) && !m_engine.isNull()
+            && !m_engine->getLoadedTileTexture(spec) && m_engine->loadTileTexture(m_map, spec)) {
+        m_loading.insert(key);
+        return;
+    }
+    m_map->updateTile(spec);
+}
+
+void QGeoTileRequestManagerPrivate::tileLoaded(const QGeoTileSpec &spec)
+{
+    if (!m_loading.remove(spec.key()))
+        return;
+    m_prefetched.remove(spec.key());
     m_map->updateTile(spec);
-    m_requested.remove(spec);
-    m_retries.remove(spec);
-    m_futures.remove(spec);
+}
+
+void QGeoTileRequestManagerPrivate::tileLoadFailed(const QGeoTileSpec &spec)
+{
+    // The cached copy is gone or unreadable, fall back to the fetcher
+    if (!m_loading.remove(spec.key()) || m_engine.isNull())
+        return;
+
+    m_requested.insert(spec.key());
+    m_engine->updateTileRequests(m_map, QSet<QGeoTileSpec>{spec}, QSet<QGeoTileSpec>());
 }
 
 // Represents a tile that needs to be retried after a certain period of time
@@ -219,24 +344,26 @@ void RetryFuture::retry()
 
 void QGeoTileRequestManagerPrivate::tileError(const QGeoTileSpec &tile, const QString &errorString)
 {
-    if (m_requested.contains(tile)) {
-        int count = m_retries.value(tile, 0);
-        m_retries.insert(tile, count + 1);
+    const QGeoTileKey key = tile.key();
+    if (m_requested.contains(key)) {
+        int count = m_retries.value(key, 0);
+        m_retries.insert(key, count + 1);
 
         if (count >= 5) {
             qWarning("QGeoTileRequestManager: Failed to fetch tile (%d,%d,%d) 5 times, giving up. "
                      "Last error message was: '%s'",
                      tile.x(), tile.y(), tile.zoom(), qPrintable(errorString));
-            m_requested.remove(tile);
-            m_retries.remove(tile);
-            m_futures.remove(tile);
+            m_requested.remove(key);
+            m_prefetched.remove(key);
+            m_retries.remove(key);
+            m_futures.remove(key);
 
         } else {
             // Exponential time backoff when retrying
             int delay = (1 << count) * 500;
 
             QSharedPointer<RetryFuture> future(new RetryFuture(tile,m_map,m_engine));
-            m_futures.insert(tile, future);
+            m_futures.insert(key, future);
 
             QTimer::singleShot(delay, future.data(), &RetryFuture::retry);
             // Passing .data() to singleShot is ok -- Qt will clean up the
@@ -58,6 +58,7 @@ QT_BEGIN_NAMESPACE
 class QGeoTiledMap;
 class QGeoTiledMappingManagerEngine;
 class QGeoTileSpec;
+class QGeoTileKey;
 struct QGeoTileTexture;
 
 class QGeoTileRequestManagerPrivate;
@@ -68,10 +69,15 @@ public:
     explicit QGeoTileRequestManager(QGeoTiledMap *map, QGeoTiledMappingManagerEngine *engine);
     ~QGeoTileRequestManager();
 
-    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileKey> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTileChanges(const QSet<QGeoTileKey> &added,
+                                                                            const QSet<QGeoTileKey> &removed);
+    void prefetchTiles(const QSet<QGeoTileKey> &tiles);
 
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
     void tileFetched(const QGeoTileSpec &spec);
+    void tileLoaded(const QGeoTileSpec &spec);
+    void tileLoadFailed(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> tileTexture(const QGeoTileSpec &spec);
 
 private:
@@ -0,0 +1,643 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotileseedjob_p.h"
+#include "qgeotiledmappingmanagerengine_p.h"
+#include "qgeocameracapabilities_p.h"
+#include "qgeotilekey_p.h"
+#include "qabstractgeotilecache_p.h"
+
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QFile>
+#include <QtCore/QTimerEvent>
+#include <QtCore/QDebug>
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE
+
+static const quint32 ProgressMagic = 0x53544751; // "QGTS"
+static const quint32 ProgressVersion = 2;
+static const qint64 DefaultTileBytes = 16 * 1024;
+static const int ProgressSaveInterval = 2000; // ms
+static const int MaxSkippedTiles = 512; // tiles found on disk per call, before yielding
+
+/*
+    The outline of region in mercator units, unwrapped across the dateline
+    so that consecutive points are never more than half the map apart.
+*/
+static PolygonVector regionOutline(const QGeoShape &region)
+{
+    PolygonVector outline;
+
+    if (region.type() == QGeoShape::PolygonType) {
+        const QList<QGeoCoordinate> perimeter = QGeoPolygon(region).perimeter();
+        double offset = 0.0;
+        double previous = 0.0;
+        for (qsizetype i = 0; i < perimeter.size(); ++i) {
+            const QDoubleVector2D p = QWebMercator::coordToMercator(perimeter.at(i));
+            if (i > 0) {
+                if (p.x() + offset - previous > 0.5)
+                    offset -= 1.0;
+                else if (p.x() + offset - previous < -0.5)
+                    offset += 1.0;
+            }
+            previous = p.x() + offset;
+            outline.append(QDoubleVector3D(previous, p.y(), 0.0));
+        }
+        return outline;
+    }
+
+    const QGeoRectangle box = region.boundingGeoRectangle();
+    if (!box.isValid())
+        return outline;
+    const QDoubleVector2D topLeft = QWebMercator::coordToMercator(box.topLeft());
+    const QDoubleVector2D bottomRight = QWebMercator::coordToMercator(box.bottomRight());
+    double right = bottomRight.x();
+    if (right <= topLeft.x())
+        right += 1.0; // crosses the dateline, or spans the whole map
+    outline << QDoubleVector3D(topLeft.x(), topLeft.y(), 0.0)
+            << QDoubleVector3D(right, topLeft.y(), 0.0)
+            << QDoubleVector3D(right, bottomRight.y(), 0.0)
+            << QDoubleVector3D(topLeft.x(), bottomRight.y(), 0.0);
+    return outline;
+}
+
+/*!
+    \internal
+    Creates a job seeding the tiles of mapType covering region, from
+    minimumZoomLevel to maximumZoomLevel included. The zoom levels are those of
+    the tiles of the provider, clamped to the camera capabilities of the map type.
+    Use QGeoTiledMappingManagerEngine::createSeedJob().
+*/
+QGeoTileSeedJob::QGeoTileSeedJob(QGeoTiledMappingManagerEngine *engine, const QGeoShape &region,
+                                 int minimumZoomLevel, int maximumZoomLevel,
+                                 const QGeoMapType &mapType, QObject *parent)
+    : QObject(parent), m_engine(engine), m_region(region), m_mapType(mapType)
+{
+    const QGeoCameraCapabilities capabilities = engine->cameraCapabilities(mapType.mapId());
+    m_minimumZoomLevel = qMax(minimumZoomLevel, qCeil(capabilities.minimumZoomLevel()));
+    m_maximumZoomLevel = qMin(maximumZoomLevel, qFloor(capabilities.maximumZoomLevel()));
+
+    m_pluginString = engine->managerName() + QLatin1Char('_') + QString::number(engine->managerVersion());
+    m_pluginId = QGeoTileKey::pluginId(m_pluginString);
+    m_tileVersion = engine->tileVersion();
+
+    buildLevels();
+    seek(0);
+}
+
+/*!
+    \internal
+    Cancels the requests still in flight, saving the progress first.
+*/
+QGeoTileSeedJob::~QGeoTileSeedJob()
+{
+    if (m_state == Running)
+        saveProgress();
+    cancelRequests();
+}
+
+/*
+    Merges the rows of tiles covered by the region at each zoom level,
+    the same way QGeoCameraTiles does for the footprint of the camera.
+*/
+void QGeoTileSeedJob::buildLevels()
+{
+    const PolygonVector outline = regionOutline(m_region);
+    if (outline.size() < 3)
+        return;
+
+    QGeoCameraTilesPrivate tiles;
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (int zoom = m_minimumZoomLevel; zoom <= m_maximumZoomLevel; ++zoom) {
+        tiles.m_intZoomLevel = zoom;
+        tiles.m_sideLength = 1 << zoom;
+
+        PolygonVector polygon = outline;
+        for (QDoubleVector3D &p : polygon)
+            p = QDoubleVector3D(p.x() * tiles.m_sideLength, p.y() * tiles.m_sideLength, 0.0);
+
+        const QGeoCameraTilesPrivate::ClippedFootprint parts = tiles.clipFootprintToMap(polygon);
+        Level level{zoom, {}, 0};
+        for (const PolygonVector *part : { &parts.left, &parts.mid, &parts.right }) {
+            if (!part->isEmpty())
+                QGeoCameraTilesPrivate::addSpans(level.spans, tiles.tilesFromPolygon(*part));
+        }
+        for (const QList<QPair<int, int> > &row : qAsConst(level.spans)) {
+            for (const QPair<int, int> &span : row)
+                level.count += span.second - span.first + 1;
+        }
+        if (level.count == 0)
+            continue;
+        m_tileCount += level.count;
+        m_levels.append(level);
+
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << qint32(zoom);
+        for (auto row = level.spans.cbegin(); row != level.spans.cend(); ++row) {
+            out << qint32(row.key());
+            for (const QPair<int, int> &span : row.value())
+                out << qint32(span.first) << qint32(span.second);
+        }
+        hash.addData(data);
+    }
+    m_regionHash = hash.result();
+}
+
+/*
+    Moves the cursor to the tile at index, in the order of enumeration:
+    by zoom level, row and column.
+*/
+void QGeoTileSeedJob::seek(qint64 index)
+{
+    m_level = 0;
+    m_next = 0;
+    while (m_level < m_levels.size() && index - m_next >= m_levels.at(m_level).count)
+        m_next += m_levels.at(m_level++).count;
+    m_span = 0;
+    if (m_level == m_levels.size())
+        return;
+
+    const Level &level = m_levels.at(m_level);
+    for (m_row = level.spans.cbegin(); m_row != level.spans.cend(); ++m_row) {
+        const QList<QPair<int, int> > &row = m_row.value();
+        for (m_span = 0; m_span < row.size(); ++m_span) {
+            const qint64 width = row.at(m_span).second - row.at(m_span).first + 1;
+            if (index - m_next < width) {
+                m_x = row.at(m_span).first + int(index - m_next);
+                m_next = index;
+                return;
+            }
+            m_next += width;
+        }
+    }
+}
+
+bool QGeoTileSeedJob::nextTile(QGeoTileSpec &spec)
+{
+    while (m_level < m_levels.size()) {
+        const Level &level = m_levels.at(m_level);
+        if (m_row == level.spans.cend()) {
+            if (++m_level < m_levels.size()) {
+                m_row = m_levels.at(m_level).spans.cbegin();
+                m_span = 0;
+                m_x = m_row.value().first().first;
+            }
+            continue;
+        }
+        const QList<QPair<int, int> > &row = m_row.value();
+        if (m_span == row.size()) {
+            if (++m_row != level.spans.cend()) {
+                m_span = 0;
+                m_x = m_row.value().first().first;
+            }
+            continue;
+        }
+        if (m_x > row.at(m_span).second) {
+            if (++m_span < row.size())
+                m_x = row.at(m_span).first;
+            continue;
+        }
+
+        spec = QGeoTileSpec(QGeoTileKey(m_pluginId, m_mapType.mapId(), level.zoom,
+                                        m_x++, m_row.key(), m_tileVersion));
+        ++m_next;
+        return true;
+    }
+    return false;
+}
+
+/*
+    Hands the next tiles to the engine, as long as the concurrency and
+    rate limits allow it.
+*/
+void QGeoTileSeedJob::requestTiles()
+{
+    if (m_state != Running || !m_engine)
+        return;
+
+    const QAbstractGeoTileCache *cache = m_engine->tileCache();
+    QSet<QGeoTileSpec> tiles;
+    int skipped = 0;
+    while (m_inFlight.size() < m_maxConcurrentRequests && m_next < m_tileCount) {
+        if (m_maxRequestsPerSecond > 0) {
+            // Token bucket, allowing bursts of up to one second of requests
+            m_tokens = qMin<double>(m_maxRequestsPerSecond,
+                                    m_tokens + m_rateClock.restart() * m_maxRequestsPerSecond / 1000.0);
+            if (m_tokens < 1.0) {
+                if (!m_timer.isActive())
+                    m_timer.start(qCeil((1.0 - m_tokens) * 1000.0 / m_maxRequestsPerSecond), this);
+                break;
+            }
+        }
+
+        const qint64 index = m_next;
+        QGeoTileSpec spec;
+        if (!nextTile(spec))
+            break;
+
+        // Already on disk, browsed or seeded before: done without a download
+        const qint64 stored = cache ? cache->diskTileSize(spec) : -1;
+        if (stored >= 0) {
+            Result &result = m_window[index];
+            result.finished = true;
+            result.bytes = stored;
+            ++m_completed;
+            m_bytes += stored;
+            if (++skipped == MaxSkippedTiles) {
+                // The rest is looked up from the event loop, a large seeded region
+                // would otherwise block it
+                if (!m_timer.isActive())
+                    m_timer.start(0, this);
+                break;
+            }
+            continue;
+        }
+
+        if (m_maxRequestsPerSecond > 0)
+            m_tokens -= 1.0;
+        m_inFlight.insert(spec, index);
+        m_window.insert(index, Result());
+        tiles.insert(spec);
+    }
+
+    if (!tiles.isEmpty())
+        m_engine->updateSeedRequests(this, tiles, QSet<QGeoTileSpec>());
+    if (skipped > 0) {
+        commitResults();
+        emit progress(m_completed + m_failed, m_tileCount);
+    }
+
+    if (m_inFlight.isEmpty() && m_next >= m_tileCount) {
+        setState(Finished);
+        saveProgress();
+        emit finished();
+    }
+}
+
+void QGeoTileSeedJob::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+    m_timer.stop();
+    requestTiles();
+}
+
+/*!
+    \internal
+    Called by the engine once spec has been fetched and written to the disk cache.
+*/
+void QGeoTileSeedJob::tileFetched(const QGeoTileSpec &spec, qint64 size)
+{
+    finishTile(spec, false, size);
+}
+
+/*!
+    \internal
+    Called by the engine when fetching spec failed. The tile is not retried.
+*/
+void QGeoTileSeedJob::tileError(const QGeoTileSpec &spec, const QString &errorString)
+{
+    if (!m_inFlight.contains(spec))
+        return;
+    emit tileFailed(spec, errorString);
+    finishTile(spec, true, 0);
+}
+
+void QGeoTileSeedJob::finishTile(const QGeoTileSpec &spec, bool failed, qint64 bytes)
+{
+    const auto it = m_inFlight.constFind(spec);
+    if (it == m_inFlight.cend())
+        return;
+    Result &result = m_window[it.value()];
+    m_inFlight.erase(it);
+    result.finished = true;
+    result.failed = failed;
+    result.bytes = bytes;
+    if (failed) {
+        ++m_failed;
+    } else {
+        ++m_completed;
+        m_bytes += bytes;
+    }
+
+    commitResults();
+    emit progress(m_completed + m_failed, m_tileCount);
+    requestTiles();
+}
+
+// Commits the finished results up to the first unfinished one
+void QGeoTileSeedJob::commitResults()
+{
+    while (!m_window.isEmpty() && m_window.first().finished) {
+        const Result first = m_window.take(m_window.firstKey());
+        if (first.failed) {
+            ++m_committedFailed;
+        } else {
+            ++m_committedCompleted;
+            m_committedBytes += first.bytes;
+        }
+    }
+    if (!m_progressFile.isEmpty() && m_saveClock.hasExpired(ProgressSaveInterval))
+        saveProgress();
+}
+
+void QGeoTileSeedJob::cancelRequests()
+{
+    m_timer.stop();
+    if (m_engine && !m_inFlight.isEmpty()) {
+        QSet<QGeoTileSpec> tiles;
+        for (auto it = m_inFlight.cbegin(); it != m_inFlight.cend(); ++it)
+            tiles.insert(it.key());
+        m_engine->updateSeedRequests(this, QSet<QGeoTileSpec>(), tiles);
+    }
+    m_inFlight.clear();
+}
+
+/*!
+    \internal
+    Starts the job, or resumes it after pause(). The first time, the progress
+    file is read, if set, and the tiles it records as done are skipped.
+*/
+void QGeoTileSeedJob::start()
+{
+    if (m_state == Running || m_state == Finished || m_state == Canceled)
+        return;
+    if (m_state == Idle)
+        loadProgress();
+
+    m_tokens = 1.0;
+    m_rateClock.start();
+    m_saveClock.start();
+    setState(Running);
+    requestTiles();
+}
+
+/*!
+    \internal
+    Pauses the job. The requests in flight are canceled and the cursor goes
+    back to the first of them, so that they are requested again on start().
+*/
+void QGeoTileSeedJob::pause()
+{
+    if (m_state != Running)
+        return;
+
+    cancelRequests();
+    if (!m_window.isEmpty())
+        seek(m_window.firstKey());
+    m_window.clear();
+    m_completed = m_committedCompleted;
+    m_failed = m_committedFailed;
+    m_bytes = m_committedBytes;
+    saveProgress();
+    setState(Paused);
+}
+
+/*!
+    \internal
+    Stops the job for good, saving the progress so far.
+*/
+void QGeoTileSeedJob::cancel()
+{
+    if (m_state == Finished || m_state == Canceled)
+        return;
+    if (m_state == Running)
+        saveProgress();
+    cancelRequests();
+    setState(Canceled);
+}
+
+void QGeoTileSeedJob::setState(State state)
+{
+    if (m_state == state)
+        return;
+    m_state = state;
+    emit stateChanged(state);
+}
+
+/*
+    The progress file stores the index up to which all tiles are done and the
+    counters up to it, along with what identifies the tiles of this job: a
+    hash of the tile spans of all its levels stands for the region.
+*/
+bool QGeoTileSeedJob::saveProgress()
+{
+    if (m_progressFile.isEmpty())
+        return false;
+    m_saveClock.restart();
+
+    const qint64 committed = m_window.isEmpty() ? m_next : m_window.firstKey();
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << ProgressMagic << ProgressVersion << m_pluginString << qint32(m_mapType.mapId())
+            << qint32(m_tileVersion) << qint32(m_minimumZoomLevel) << qint32(m_maximumZoomLevel)
+            << m_tileCount << m_regionHash << committed << m_committedCompleted << m_committedFailed
+            << m_committedBytes;
+    }
+
+    QSaveFile file(m_progressFile);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Unable to write tile seeding progress " << m_progressFile;
+        return false;
+    }
+    return true;
+}
+
+bool QGeoTileSeedJob::loadProgress()
+{
+    if (m_progressFile.isEmpty())
+        return false;
+    QFile file(m_progressFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString pluginString;
+    qint32 mapId = 0;
+    qint32 tileVersion = 0;
+    qint32 minimumZoomLevel = 0;
+    qint32 maximumZoomLevel = 0;
+    qint64 tileCount = 0;
+    QByteArray regionHash;
+    qint64 committed = 0;
+    qint64 completed = 0;
+    qint64 failed = 0;
+    qint64 bytes = 0;
+    in >> magic >> version >> pluginString >> mapId >> tileVersion >> minimumZoomLevel
+       >> maximumZoomLevel >> tileCount >> regionHash >> committed >> completed >> failed >> bytes;
+    if (in.status() != QDataStream::Ok || magic != ProgressMagic || version != ProgressVersion
+            || pluginString != m_pluginString || mapId != m_mapType.mapId()
+            || tileVersion != m_tileVersion || minimumZoomLevel != m_minimumZoomLevel
+            || maximumZoomLevel != m_maximumZoomLevel || tileCount != m_tileCount
+            || regionHash != m_regionHash || committed < 0 || committed > m_tileCount) {
+        qWarning() << "Ignoring tile seeding progress of another region " << m_progressFile;
+        return false;
+    }
+
+    seek(committed);
+    m_completed = m_committedCompleted = completed;
+    m_failed = m_committedFailed = failed;
+    m_bytes = m_committedBytes = bytes;
+    return true;
+}
+
+QGeoShape QGeoTileSeedJob::region() const
+{
+    return m_region;
+}
+
+int QGeoTileSeedJob::minimumZoomLevel() const
+{
+    return m_minimumZoomLevel;
+}
+
+int QGeoTileSeedJob::maximumZoomLevel() const
+{
+    return m_maximumZoomLevel;
+}
+
+QGeoMapType QGeoTileSeedJob::mapType() const
+{
+    return m_mapType;
+}
+
+QGeoTileSeedJob::State QGeoTileSeedJob::state() const
+{
+    return m_state;
+}
+
+/*!
+    \internal
+    Returns the number of tiles covering the region over the zoom range.
+*/
+qint64 QGeoTileSeedJob::tileCount() const
+{
+    return m_tileCount;
+}
+
+qint64 QGeoTileSeedJob::completedTiles() const
+{
+    return m_completed;
+}
+
+qint64 QGeoTileSeedJob::failedTiles() const
+{
+    return m_failed;
+}
+
+qint64 QGeoTileSeedJob::downloadedBytes() const
+{
+    return m_bytes;
+}
+
+/*!
+    \internal
+    Returns an estimate of the size of all the tiles of the job: the bytes
+    downloaded so far plus the remaining tiles at the average size of the
+    downloaded ones, or of a typical raster tile before any was downloaded.
+*/
+qint64 QGeoTileSeedJob::estimatedBytes() const
+{
+    const qint64 average = m_completed > 0 ? m_bytes / m_completed : DefaultTileBytes;
+    return m_bytes + (m_tileCount - m_completed - m_failed) * average;
+}
+
+/*!
+    \internal
+    Sets the number of tiles the job has requested at once to count.
+    Defaults to 4, leaving room for the tiles of the maps using the same engine.
+*/
+void QGeoTileSeedJob::setMaxConcurrentRequests(int count)
+{
+    m_maxConcurrentRequests = qMax(1, count);
+    requestTiles();
+}
+
+int QGeoTileSeedJob::maxConcurrentRequests() const
+{
+    return m_maxConcurrentRequests;
+}
+
+/*!
+    \internal
+    Limits the rate of requests to count per second, as required by the usage
+    policy of many tile servers. Defaults to 0, no limit.
+*/
+void QGeoTileSeedJob::setMaxRequestsPerSecond(int count)
+{
+    m_maxRequestsPerSecond = qMax(0, count);
+    requestTiles();
+}
+
+int QGeoTileSeedJob::maxRequestsPerSecond() const
+{
+    return m_maxRequestsPerSecond;
+}
+
+/*!
+    \internal
+    Sets the file the progress of the job is saved to, and resumed from on start().
+*/
+void QGeoTileSeedJob::setProgressFile(const QString &fileName)
+{
+    m_progressFile = fileName;
+}
+
+QString QGeoTileSeedJob::progressFile() const
+{
+    return m_progressFile;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILESEEDJOB_P_H
+#define QGEOTILESEEDJOB_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeocameratiles_p_p.h>
+#include <QtLocation/private/qgeomaptype_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+#include <QtPositioning/QGeoShape>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QBasicTimer>
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoTiledMappingManagerEngine;
+
+/*
+    Downloads all the tiles of a region over a range of zoom levels into the
+    disk cache of the engine, for offline use. Tiles are enumerated from
+    per-row spans and requested a few at a time, so that the region can be
+    large without all its tile specs being held in memory. The progress can
+    be saved to a file, and a later job over the same region resumes from it.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileSeedJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Idle,
+        Running,
+        Paused,
+        Finished,
+        Canceled
+    };
+    Q_ENUM(State)
+
+    ~QGeoTileSeedJob();
+
+    QGeoShape region() const;
+    int minimumZoomLevel() const;
+    int maximumZoomLevel() const;
+    QGeoMapType mapType() const;
+    State state() const;
+
+    qint64 tileCount() const;
+    qint64 completedTiles() const;
+    qint64 failedTiles() const;
+    qint64 downloadedBytes() const;
+    qint64 estimatedBytes() const;
+
+    void setMaxConcurrentRequests(int count);
+    int maxConcurrentRequests() const;
+    void setMaxRequestsPerSecond(int count);
+    int maxRequestsPerSecond() const;
+    void setProgressFile(const QString &fileName);
+    QString progressFile() const;
+
+    // Called by the engine
+    void tileFetched(const QGeoTileSpec &spec, qint64 size);
+    void tileError(const QGeoTileSpec &spec, const QString &errorString);
+
+public Q_SLOTS:
+    void start();
+    void pause();
+    void cancel();
+
+Q_SIGNALS:
+    void progress(qint64 processed, qint64 total);
+    void tileFailed(const QGeoTileSpec &spec, const QString &errorString);
+    void stateChanged(QGeoTileSeedJob::State state);
+    void finished();
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    QGeoTileSeedJob(QGeoTiledMappingManagerEngine *engine, const QGeoShape &region,
+                    int minimumZoomLevel, int maximumZoomLevel, const QGeoMapType &mapType,
+                    QObject *parent);
+
+    struct Level
+    {
+        int zoom;
+        QGeoCameraTilesPrivate::TileSpans spans;
+        qint64 count;
+    };
+
+    struct Result
+    {
+        bool finished = false;
+        bool failed = false;
+        qint64 bytes = 0;
+    };
+
+    void buildLevels();
+    void seek(qint64 index);
+    bool nextTile(QGeoTileSpec &spec);
+    void requestTiles();
+    void finishTile(const QGeoTileSpec &spec, bool failed, qint64 bytes);
+    void commitResults();
+    void cancelRequests();
+    void setState(State state);
+    bool loadProgress();
+    bool saveProgress();
+
+    QPointer<QGeoTiledMappingManagerEngine> m_engine;
+    QGeoShape m_region;
+    int m_minimumZoomLevel = 0;
+    int m_maximumZoomLevel = 0;
+    QGeoMapType m_mapType;
+    QString m_pluginString;
+    quint16 m_pluginId = 0;
+    int m_tileVersion = -1;
+    State m_state = Idle;
+
+    QList<Level> m_levels;
+    qint64 m_tileCount = 0;
+    QByteArray m_regionHash; // of the spans of all the levels, identifies the tiles in the progress file
+
+    // Enumeration cursor, m_next being the index of the tile it points to
+    qsizetype m_level = 0;
+    QGeoCameraTilesPrivate::TileSpans::const_iterator m_row;
+    qsizetype m_span = 0;
+    int m_x = 0;
+    qint64 m_next = 0;
+
+    // Requests in flight, and the results past the first of them. Progress
+    // is only committed, and saved, up to the first unfinished index.
+    QHash<QGeoTileSpec, qint64> m_inFlight;
+    QMap<qint64, Result> m_window;
+    qint64 m_completed = 0;
+    qint64 m_failed = 0;
+    qint64 m_bytes = 0;
+    qint64 m_committedCompleted = 0;
+    qint64 m_committedFailed = 0;
+    qint64 m_committedBytes = 0;
+
+    int m_maxConcurrentRequests = 4;
+    int m_maxRequestsPerSecond = 0;
+    double m_tokens = 0.0;
+    QElapsedTimer m_rateClock;
+    QBasicTimer m_timer;
+
+    QString m_progressFile;
+    QElapsedTimer m_saveClock;
+
+    friend class QGeoTiledMappingManagerEngine;
+    Q_DISABLE_COPY(QGeoTileSeedJob)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILESEEDJOB_P_H
@@ -56,6 +56,12 @@ QGeoTileSpec::QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, in
 {
 }
 
+QGeoTileSpec::QGeoTileSpec(const QGeoTileKey &key)
+    : d(new QGeoTileSpecPrivate(key.plugin(), key.pluginId(), key.mapId(), key.zoom(),
+                                key.x(), key.y(), key.version()))
+{
+}
+
 QGeoTileSpec::QGeoTileSpec(const QGeoTileSpec &other) noexcept = default;
 
 QGeoTileSpec::~QGeoTileSpec() = default;
@@ -124,6 +130,11 @@ int QGeoTileSpec::version() const
     return d->version_;
 }
 
+QGeoTileKey QGeoTileSpec::key() const
+{
+    return QGeoTileKey(d->pluginId_, d->mapId_, d->zoom_, d->x_, d->y_, d->version_);
+}
+
 bool QGeoTileSpec::isEqual(const QGeoTileSpec &rhs) const noexcept
 {
     return (*(d.constData()) == *(rhs.d.constData()));
@@ -136,13 +147,8 @@ bool QGeoTileSpec::isLess(const QGeoTileSpec &rhs) const noexcept
 
 unsigned int qHash(const QGeoTileSpec &spec)
 {
-    unsigned int result = (qHash(spec.plugin()) * 13) % 31;
-    result += ((spec.mapId() * 17) % 31) << 5;
-    result += ((spec.zoom() * 19) % 31) << 10;
-    result += ((spec.x() * 23) % 31) << 15;
-    result += ((spec.y() * 29) % 31) << 20;
-    result += (spec.version() % 3) << 25;
-    return result;
+    // Hashes the interned plugin id, not the plugin name
+    return uint(qHash(spec.key()));
 }
 
 QDebug operator<< (QDebug dbg, const QGeoTileSpec &spec)
@@ -52,6 +52,7 @@
 //
 
 #include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotilekey_p.h>
 #include <QtCore/QMetaType>
 #include <QString>
 
@@ -69,6 +70,7 @@ public:
     QGeoTileSpec(const QGeoTileSpec &other) noexcept;
     QGeoTileSpec(QGeoTileSpec &&other) noexcept = default;
     QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version = -1);
+    explicit QGeoTileSpec(const QGeoTileKey &key);
     ~QGeoTileSpec();
 
     QGeoTileSpec &operator=(const QGeoTileSpec &other) noexcept;
@@ -93,6 +95,8 @@ public:
     void setVersion(int version);
     int version() const;
 
+    QGeoTileKey key() const;
+
     friend inline bool operator==(const QGeoTileSpec &lhs, const QGeoTileSpec &rhs) noexcept
     { return lhs.isEqual(rhs); }
     friend inline bool operator!=(const QGeoTileSpec &lhs, const QGeoTileSpec &rhs) noexcept
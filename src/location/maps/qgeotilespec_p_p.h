@@ -53,6 +53,8 @@
 #include <QString>
 #include <QSharedData>
 
+#include "qgeotilekey_p.h"
+
 QT_BEGIN_NAMESPACE
 
 class QGeoTileSpecPrivate : public QSharedData
@@ -60,7 +62,12 @@ class QGeoTileSpecPrivate : public QSharedData
 public:
     QGeoTileSpecPrivate(const QString &plugin = {}, int mapId = 0,
                                   int zoom = -1, int x = -1, int y = -1, int version = -1)
-        : plugin_(plugin), mapId_(mapId), zoom_(zoom),
+        : plugin_(plugin), pluginId_(QGeoTileKey::pluginId(plugin)), mapId_(mapId), zoom_(zoom),
+          x_(x), y_(y), version_(version)
+    {}
+    QGeoTileSpecPrivate(const QString &plugin, quint16 pluginId, int mapId,
+                        int zoom, int x, int y, int version)
+        : plugin_(plugin), pluginId_(pluginId), mapId_(mapId), zoom_(zoom),
           x_(x), y_(y), version_(version)
     {}
 
@@ -71,11 +78,12 @@ public:
             && x_ == rhs.x_
             && y_ == rhs.y_
             && version_ == rhs.version_
-            && plugin_ == rhs.plugin_;
+            && pluginId_ == rhs.pluginId_;
     }
     bool operator<(const QGeoTileSpecPrivate &rhs) const;
 
     QString plugin_;
+    quint16 pluginId_ = 0; // interned plugin_, see QGeoTileKey
     int mapId_ = 0;
     int zoom_ = -1;
     int x_ = -1;
@@ -0,0 +1,421 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotiletextureatlas_p.h"
+
+#include <QtGui/private/qrhi_p.h>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/QDebug>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+// Texels repeating the edge of a slot on each side, enough for the first mipmap levels
+static const int SlotGutter = 4;
+// Slots of a new page, the texture doubles from there
+static const int InitialPageSlots = 4;
+
+// image is square, in a 32 bit format
+static QImage qgeotileatlas_withGutter(const QImage &image, int gutter)
+{
+    const int size = image.width();
+    QImage padded(size + 2 * gutter, size + 2 * gutter, image.format());
+    for (int y = 0; y < padded.height(); ++y) {
+        const quint32 *src = reinterpret_cast<const quint32 *>(
+                    image.constScanLine(qBound(0, y - gutter, size - 1)));
+        quint32 *dst = reinterpret_cast<quint32 *>(padded.scanLine(y));
+        std::fill(dst, dst + gutter, src[0]);
+        std::copy(src, src + size, dst + gutter);
+        std::fill(dst + gutter + size, dst + padded.width(), src[size - 1]);
+    }
+    return padded;
+}
+
+QGeoTileAtlasPage::QGeoTileAtlasPage(int slotSize, int maxPageSize,
+                                     QGeoCompressedTileImage::Format compression)
+    : m_slotSize(slotSize), m_compression(compression)
+{
+    const bool gutter = compression == QGeoCompressedTileImage::NoCompression
+            && slotSize + 2 * SlotGutter <= maxPageSize;
+    m_gutter = gutter ? SlotGutter : 0;
+    m_cellSize = slotSize + 2 * m_gutter;
+    m_columns = qMax(1, maxPageSize / m_cellSize);
+    m_capacity = m_columns * m_columns;
+}
+
+QGeoTileAtlasPage::~QGeoTileAtlasPage()
+{
+    if (m_texture)
+        m_texture->deleteLater();
+}
+
+qint64 QGeoTileAtlasPage::comparisonKey() const
+{
+    return qint64(qintptr(this));
+}
+
+QRhiTexture *QGeoTileAtlasPage::rhiTexture() const
+{
+    return m_texture;
+}
+
+QSize QGeoTileAtlasPage::textureSize() const
+{
+    return m_size;
+}
+
+bool QGeoTileAtlasPage::hasAlphaChannel() const
+{
+    return m_hasAlphaChannel;
+}
+
+bool QGeoTileAtlasPage::hasMipmaps() const
+{
+    return m_gutter > 0;
+}
+
+void QGeoTileAtlasPage::commitTextureOperations(QRhi *rhi, QRhiResourceUpdateBatch *resourceUpdates)
+{
+    bool grown = false;
+    if (!m_texture || m_texture->pixelSize() != m_size) {
+        QRhiTexture *previous = m_texture;
+        QRhiTexture::Format format = QRhiTexture::RGBA8;
+        if (previous) {
+            format = previous->format();
+        } else if (m_compression != QGeoCompressedTileImage::NoCompression) {
+            const QRhiTexture::Format compressed = m_compression == QGeoCompressedTileImage::BC1
+                    ? QRhiTexture::BC1 : QRhiTexture::ETC2_RGB8;
+            if (rhi->isTextureFormatSupported(compressed))
+                format = compressed;
+        }
+        m_uploadCompressed = format != QRhiTexture::RGBA8;
+
+        QRhiTexture::Flags flags;
+        if (hasMipmaps())
+            flags |= QRhiTexture::MipMapped | QRhiTexture::UsedWithGenerateMips;
+        m_texture = rhi->newTexture(format, m_size, 1, flags);
+        if (!m_texture->create()) {
+            qWarning("QGeoTileAtlasPage: failed to create a %dx%d texture",
+                     m_size.width(), m_size.height());
+            delete m_texture;
+            m_texture = previous;
+            return;
+        }
+
+        if (previous) {
+            if (m_uploadCompressed) {
+                // Not every backend copies compressed textures, upload the slots again
+                for (int slot = 0; slot < m_compressedSlots.size(); ++slot) {
+                    if (!m_compressedSlots.at(slot).isNull())
+                        queueUpload({ slot, QImage(), m_compressedSlots.at(slot) });
+                }
+            } else {
+                resourceUpdates->copyTexture(m_texture, previous);
+            }
+            previous->deleteLater();
+            grown = true;
+        }
+    }
+
+    if (m_pendingUploads.isEmpty()) {
+        if (grown && hasMipmaps())
+            resourceUpdates->generateMips(m_texture);
+        return;
+    }
+
+    QVarLengthArray<QRhiTextureUploadEntry, 16> entries;
+    entries.reserve(m_pendingUploads.size());
+    for (const PendingUpload &upload : qAsConst(m_pendingUploads)) {
+        QRhiTextureSubresourceUploadDescription description;
+        if (upload.compressed.isNull()) {
+            description.setImage(upload.image);
+        } else if (m_uploadCompressed) {
+            description.setData(upload.compressed.data());
+            description.setSourceSize(upload.compressed.size());
+        } else {
+            description.setImage(uploadImage(upload.compressed.toImage()));
+        }
+        // The uploaded images include the gutter
+        description.setDestinationTopLeft(slotPosition(upload.slot) - QPoint(m_gutter, m_gutter));
+        entries.append(QRhiTextureUploadEntry(0, 0, description));
+    }
+    QRhiTextureUploadDescription description;
+    description.setEntries(entries.cbegin(), entries.cend());
+    resourceUpdates->uploadTexture(m_texture, description);
+    if (hasMipmaps())
+        resourceUpdates->generateMips(m_texture);
+    m_pendingUploads.clear();
+}
+
+int QGeoTileAtlasPage::allocate(const QImage &image)
+{
+    const int slot = takeSlot();
+    if (slot < 0)
+        return -1;
+
+    m_hasAlphaChannel = m_hasAlphaChannel || image.hasAlphaChannel();
+    queueUpload({ slot, uploadImage(image), QGeoCompressedTileImage() });
+    ++m_used;
+    return slot;
+}
+
+// The tile has to be exactly of the slot size, in the format of the page
+int QGeoTileAtlasPage::allocate(const QGeoCompressedTileImage &image)
+{
+    Q_ASSERT(image.format() == m_compression && image.size() == QSize(m_slotSize, m_slotSize));
+    const int slot = takeSlot();
+    if (slot < 0)
+        return -1;
+
+    if (m_compressedSlots.size() <= slot)
+        m_compressedSlots.resize(slot + 1);
+    m_compressedSlots[slot] = image; // shared with the tile texture
+    queueUpload({ slot, QImage(), image });
+    ++m_used;
+    return slot;
+}
+
+int QGeoTileAtlasPage::takeSlot()
+{
+    if (!m_freeSlots.isEmpty())
+        return m_freeSlots.takeLast();
+    if (m_nextSlot >= m_capacity)
+        return -1;
+    if (m_nextSlot >= m_textureCapacity)
+        grow();
+    return m_nextSlot++;
+}
+
+/*
+    Doubles the number of slots the texture has room for, a row at a time
+    once the width of the page is reached. The slots keep their position,
+    commitTextureOperations() copies them into the larger texture.
+*/
+void QGeoTileAtlasPage::grow()
+{
+    int capacity = qMax(InitialPageSlots, m_textureCapacity * 2);
+    if (capacity > m_columns)
+        capacity = (capacity + m_columns - 1) / m_columns * m_columns;
+    m_textureCapacity = qMin(capacity, m_capacity);
+
+    const int columns = qMin(m_textureCapacity, m_columns);
+    const int rows = (m_textureCapacity + m_columns - 1) / m_columns;
+    m_size = QSize(columns * m_cellSize, rows * m_cellSize);
+}
+
+void QGeoTileAtlasPage::queueUpload(const PendingUpload &upload)
+{
+    // A slot freed and reused before the previous upload happened only needs the latest image
+    for (auto it = m_pendingUploads.begin(); it != m_pendingUploads.end(); ++it) {
+        if (it->slot == upload.slot) {
+            m_pendingUploads.erase(it);
+            break;
+        }
+    }
+    m_pendingUploads.append(upload);
+}
+
+QImage QGeoTileAtlasPage::uploadImage(const QImage &image) const
+{
+    QImage upload = image;
+    if (upload.size() != QSize(m_slotSize, m_slotSize))
+        upload = upload.scaled(m_slotSize, m_slotSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    upload = std::move(upload).convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+    if (m_gutter > 0)
+        upload = qgeotileatlas_withGutter(upload, m_gutter);
+    return upload;
+}
+
+void QGeoTileAtlasPage::release(int slot)
+{
+    if (slot < 0 || slot >= m_nextSlot)
+        return;
+    if (slot < m_compressedSlots.size())
+        m_compressedSlots[slot] = QGeoCompressedTileImage();
+    m_freeSlots.append(slot);
+    --m_used;
+}
+
+/*!
+    \internal
+    Maps \a subRect, in normalized coordinates of the tile image, to texture
+    coordinates of \a slot in the current texture size, which changes when the
+    page grows. Pages without a gutter clamp the rect to the texel centers at
+    the border of the slot, so that linear filtering never samples the
+    neighbouring slot; the rect is not scaled, overzoomed tiles keep matching
+    their neighbours.
+*/
+QRectF QGeoTileAtlasPage::textureRect(int slot, const QRectF &subRect) const
+{
+    const QPoint pos = slotPosition(slot);
+    const qreal w = m_size.width();
+    const qreal h = m_size.height();
+    QRectF rect(pos.x() + subRect.x() * m_slotSize,
+                pos.y() + subRect.y() * m_slotSize,
+                subRect.width() * m_slotSize,
+                subRect.height() * m_slotSize);
+    if (m_gutter == 0) {
+        const qreal left = pos.x() + 0.5;
+        const qreal right = pos.x() + m_slotSize - 0.5;
+        const qreal top = pos.y() + 0.5;
+        const qreal bottom = pos.y() + m_slotSize - 0.5;
+        rect.setCoords(qBound(left, rect.left(), right), qBound(top, rect.top(), bottom),
+                       qBound(left, rect.right(), right), qBound(top, rect.bottom(), bottom));
+    }
+    return QRectF(rect.x() / w, rect.y() / h, rect.width() / w, rect.height() / h);
+}
+
+// Top left texel of the slot, inside its gutter
+QPoint QGeoTileAtlasPage::slotPosition(int slot) const
+{
+    return QPoint((slot % m_columns) * m_cellSize + m_gutter,
+                  (slot / m_columns) * m_cellSize + m_gutter);
+}
+
+QGeoTileTextureAtlas::QGeoTileTextureAtlas(int maxPageSize)
+    : m_maxPageSize(maxPageSize)
+{
+}
+
+QGeoTileTextureAtlas::~QGeoTileTextureAtlas()
+{
+    clear();
+}
+
+/*!
+    \internal
+    Queues \a image for upload into a free slot and returns it. Images of
+    different sizes go to different pages; a new page is created when all
+    pages of the right size are full.
+*/
+QGeoTileTextureAtlas::Slot QGeoTileTextureAtlas::allocate(const QImage &image)
+{
+    Slot slot;
+    if (image.isNull())
+        return slot;
+
+    QGeoTileAtlasPage *page = pageFor(qMax(image.width(), image.height()),
+                                      QGeoCompressedTileImage::NoCompression, &slot.page);
+    slot.index = page->allocate(image);
+    return slot;
+}
+
+/*!
+    \internal
+    Same as above for a block compressed tile, which goes to a page of its
+    compression format.
+*/
+QGeoTileTextureAtlas::Slot QGeoTileTextureAtlas::allocate(const QGeoCompressedTileImage &image)
+{
+    Slot slot;
+    if (image.isNull())
+        return slot;
+
+    QGeoTileAtlasPage *page = pageFor(image.size().width(), image.format(), &slot.page);
+    slot.index = page->allocate(image);
+    return slot;
+}
+
+QGeoTileAtlasPage *QGeoTileTextureAtlas::pageFor(int slotSize,
+                                                 QGeoCompressedTileImage::Format compression,
+                                                 int *index)
+{
+    int freePage = -1;
+    for (int i = 0; i < m_pages.size(); ++i) {
+        QGeoTileAtlasPage *page = m_pages.at(i);
+        if (!page) {
+            if (freePage < 0)
+                freePage = i;
+            continue;
+        }
+        if (page->slotSize() != slotSize || page->compression() != compression || page->isFull())
+            continue;
+        *index = i;
+        return page;
+    }
+
+    QGeoTileAtlasPage *page = new QGeoTileAtlasPage(slotSize, m_maxPageSize, compression);
+    if (freePage < 0) {
+        freePage = m_pages.size();
+        m_pages.append(page);
+    } else {
+        m_pages[freePage] = page;
+    }
+    *index = freePage;
+    return page;
+}
+
+void QGeoTileTextureAtlas::release(const Slot &slot)
+{
+    if (QGeoTileAtlasPage *page = m_pages.value(slot.page))
+        page->release(slot.index);
+}
+
+void QGeoTileTextureAtlas::clear()
+{
+    qDeleteAll(m_pages);
+    m_pages.clear();
+}
+
+/*!
+    \internal
+    Deletes the pages no slot is allocated from anymore, keeping the first one
+    around to avoid reallocating the texture while panning. Must only be called
+    once no node draws from the released slots.
+*/
+void QGeoTileTextureAtlas::collectGarbage()
+{
+    bool keep = true;
+    for (int i = 0; i < m_pages.size(); ++i) {
+        QGeoTileAtlasPage *page = m_pages.at(i);
+        if (!page)
+            continue;
+        if (page->usedSlots() == 0 && !keep) {
+            delete page;
+            m_pages[i] = nullptr;
+        }
+        keep = false;
+    }
+    while (!m_pages.isEmpty() && !m_pages.last())
+        m_pages.removeLast();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILETEXTUREATLAS_P_H
+#define QGEOTILETEXTUREATLAS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotilecompression_p.h>
+
+#include <QtQuick/QSGTexture>
+#include <QtGui/QImage>
+#include <QtCore/QList>
+
+QT_BEGIN_NAMESPACE
+
+class QRhiTexture;
+
+/*
+    One texture of the atlas, divided into a grid of equally sized tile slots.
+    Tile images are queued on allocation and uploaded into their slot the next
+    time a material using the page commits its texture operations. The texture
+    starts with room for a few slots and grows as they get allocated, up to
+    the maximum page size.
+
+    A page holds either images or block compressed tiles of one format. Image
+    pages are mipmapped, every slot being surrounded by a gutter repeating its
+    edge texels so that the smaller levels don't mix neighbouring tiles. The
+    compressed blocks are uploaded as they are, or decoded on upload when the
+    graphics backend doesn't support the format; these pages have no mipmaps.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileAtlasPage : public QSGTexture
+{
+    Q_OBJECT
+public:
+    QGeoTileAtlasPage(int slotSize, int maxPageSize,
+                      QGeoCompressedTileImage::Format compression = QGeoCompressedTileImage::NoCompression);
+    ~QGeoTileAtlasPage() override;
+
+    qint64 comparisonKey() const override;
+    QRhiTexture *rhiTexture() const override;
+    QSize textureSize() const override;
+    bool hasAlphaChannel() const override;
+    bool hasMipmaps() const override;
+    void commitTextureOperations(QRhi *rhi, QRhiResourceUpdateBatch *resourceUpdates) override;
+
+    int slotSize() const { return m_slotSize; }
+    QGeoCompressedTileImage::Format compression() const { return m_compression; }
+    int usedSlots() const { return m_used; }
+    bool isFull() const { return m_freeSlots.isEmpty() && m_nextSlot >= m_capacity; }
+    int gutter() const { return m_gutter; }
+
+    int allocate(const QImage &image);
+    int allocate(const QGeoCompressedTileImage &image);
+    void release(int slot);
+    QRectF textureRect(int slot, const QRectF &subRect) const;
+
+private:
+    struct PendingUpload
+    {
+        int slot;
+        QImage image;
+        QGeoCompressedTileImage compressed;
+    };
+
+    QPoint slotPosition(int slot) const;
+    QImage uploadImage(const QImage &image) const;
+    int takeSlot();
+    void grow();
+    void queueUpload(const PendingUpload &upload);
+
+    QSize m_size; // of the texture, grows with m_textureCapacity
+    int m_slotSize;
+    int m_gutter;
+    int m_cellSize; // slot and gutters
+    int m_columns;
+    int m_capacity;
+    int m_textureCapacity = 0;
+    int m_nextSlot = 0;
+    int m_used = 0;
+    QList<int> m_freeSlots;
+    QList<PendingUpload> m_pendingUploads;
+    QList<QGeoCompressedTileImage> m_compressedSlots; // to upload again when the texture grows
+    QRhiTexture *m_texture = nullptr;
+    QGeoCompressedTileImage::Format m_compression;
+    bool m_uploadCompressed = false;
+    bool m_hasAlphaChannel = false;
+};
+
+/*
+    Pool of QGeoTileAtlasPage objects shared by all the tiles of a map scene.
+    Lives on the render thread, next to the nodes drawing from it.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileTextureAtlas
+{
+public:
+    struct Slot
+    {
+        int page = -1;
+        int index = -1;
+        bool isValid() const { return page >= 0; }
+    };
+
+    explicit QGeoTileTextureAtlas(int maxPageSize = 4096);
+    ~QGeoTileTextureAtlas();
+
+    Slot allocate(const QImage &image);
+    Slot allocate(const QGeoCompressedTileImage &image);
+    void release(const Slot &slot);
+    void clear();
+    void collectGarbage();
+
+    QGeoTileAtlasPage *page(int page) const { return m_pages.value(page); }
+
+private:
+    Q_DISABLE_COPY(QGeoTileTextureAtlas)
+
+    QGeoTileAtlasPage *pageFor(int slotSize, QGeoCompressedTileImage::Format compression,
+                               int *index);
+
+    QList<QGeoTileAtlasPage *> m_pages; // nullptr entries are reused
+    int m_maxPageSize;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILETEXTUREATLAS_P_H
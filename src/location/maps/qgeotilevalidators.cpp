@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qgeotilevalidators_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QLocale>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Builds the validators from the raw values of the ETag, Last-Modified,
+    Cache-Control and Expires headers of a response received at \a received.
+    Cache-Control takes precedence over Expires. "no-cache" and "no-store",
+    like an unparsable Expires, make the tile stale right away.
+*/
+QGeoTileValidators QGeoTileValidators::fromHeaders(const QByteArray &etag, const QByteArray &lastModified,
+                                                   const QByteArray &cacheControl, const QByteArray &expires,
+                                                   const QDateTime &received)
+{
+    QGeoTileValidators validators;
+    validators.etag = etag.trimmed();
+    validators.lastModified = lastModified.trimmed();
+
+    bool hasLifetime = false;
+    const QList<QByteArray> directives = cacheControl.split(',');
+    for (const QByteArray &d : directives) {
+        const QByteArray directive = d.trimmed().toLower();
+        if (directive == "no-cache" || directive == "no-store") {
+            validators.expires = received;
+            return validators;
+        }
+        if (directive.startsWith("max-age=")) {
+            bool ok = false;
+            const qint64 maxAge = directive.mid(8).toLongLong(&ok);
+            if (ok) {
+                validators.expires = received.addSecs(qMax<qint64>(0, maxAge));
+                hasLifetime = true;
+            }
+        }
+    }
+
+    if (!hasLifetime && !expires.isEmpty()) {
+        // HTTP dates are in GMT. Invalid ones mean expired
+        const QString date = QString::fromLatin1(expires.trimmed());
+        validators.expires = QLocale::c().toDateTime(date, QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'"));
+        if (validators.expires.isValid())
+            validators.expires.setTimeSpec(Qt::UTC);
+        else
+            validators.expires = QDateTime::fromString(date, Qt::RFC2822Date);
+        if (!validators.expires.isValid())
+            validators.expires = received;
+    }
+    return validators;
+}
+
+QDataStream &operator<<(QDataStream &out, const QGeoTileValidators &validators)
+{
+    return out << validators.etag << validators.lastModified << validators.expires;
+}
+
+QDataStream &operator>>(QDataStream &in, QGeoTileValidators &validators)
+{
+    return in >> validators.etag >> validators.lastModified >> validators.expires;
+}
+
+QT_END_NAMESPACE
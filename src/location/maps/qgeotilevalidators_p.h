@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILEVALIDATORS_P_H
+#define QGEOTILEVALIDATORS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QMetaType>
+
+QT_BEGIN_NAMESPACE
+
+class QDataStream;
+
+/* What the tile server said about the freshness of a tile: the validators to
+ * send back in a conditional request once the tile is stale, and until when
+ * it can be used without asking. Tiles without an expiry never go stale */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileValidators
+{
+public:
+    bool isNull() const { return etag.isEmpty() && lastModified.isEmpty() && !expires.isValid(); }
+    bool canRevalidate() const { return !etag.isEmpty() || !lastModified.isEmpty(); }
+    bool isStale(const QDateTime &now = QDateTime::currentDateTimeUtc()) const
+    {
+        return expires.isValid() && now >= expires;
+    }
+
+    static QGeoTileValidators fromHeaders(const QByteArray &etag, const QByteArray &lastModified,
+                                          const QByteArray &cacheControl, const QByteArray &expires,
+                                          const QDateTime &received = QDateTime::currentDateTimeUtc());
+
+    QByteArray etag;
+    QByteArray lastModified; // as sent by the server, for If-Modified-Since
+    QDateTime expires;
+};
+
+Q_LOCATION_PRIVATE_EXPORT QDataStream &operator<<(QDataStream &out, const QGeoTileValidators &validators);
+Q_LOCATION_PRIVATE_EXPORT QDataStream &operator>>(QDataStream &in, QGeoTileValidators &validators);
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoTileValidators)
+
+#endif // QGEOTILEVALIDATORS_P_H
@@ -284,6 +284,10 @@ QDeclarativeCircleMapItem::QDeclarativeCircleMapItem(QQuickItem *parent)
     // ToDo: handle envvar, and switch implementation.
     m_itemType = QGeoMap::MapCircle;
     setFlag(ItemHasContents, true);
+    QObject::connect(this, &QDeclarativeCircleMapItem::centerChanged,
+                     this, &QDeclarativeGeoMapItemBase::geoShapeChanged);
+    QObject::connect(this, &QDeclarativeCircleMapItem::radiusChanged,
+                     this, &QDeclarativeGeoMapItemBase::geoShapeChanged);
     QObject::connect(&m_border, &QDeclarativeMapLineProperties::colorChanged,
                      this, &QDeclarativeCircleMapItem::onLinePropertiesChanged);
     QObject::connect(&m_border, &QDeclarativeMapLineProperties::widthChanged,
@@ -49,10 +49,12 @@
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPath>
 #include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qlocationutils_p.h>
 #include <QtQuick/QQuickWindow>
 #include <QtQuick/QSGRectangleNode>
 #include <QtQml/qqmlinfo.h>
 #include <QtQuick/private/qquickitem_p.h>
+#include <algorithm>
 #include <cmath>
 
 #ifndef M_PI
@@ -570,6 +572,9 @@ void QDeclarativeGeoMap::mappingManagerInitialized()
     if (!m_map)
         return;
 
+    if (m_metricsEnabled)
+        m_map->setMetricsEnabled(true);
+
     // Any map items that were added before the plugin was ready
     // need to have setMap called again
     for (const QPointer<QDeclarativeGeoMapItemBase> &item : qAsConst(m_mapItems)) {
@@ -1322,6 +1327,36 @@ bool QDeclarativeGeoMap::copyrightsVisible() const
     return m_copyrightsVisible;
 }
 
+/*!
+    \qmlproperty bool QtLocation::Map::metricsEnabled
+
+    This property holds whether the map collects performance metrics about
+    loading its data, returned by \l metrics(). Collecting them has a small
+    cost, so by default this property is set to \c false.
+
+    With the tiled map plugins the metrics are shared by all the maps using the
+    same plugin instance.
+
+    \sa metrics()
+    \since QtLocation 6.4
+*/
+void QDeclarativeGeoMap::setMetricsEnabled(bool enabled)
+{
+    if (m_metricsEnabled == enabled)
+        return;
+
+    if (m_map)
+        m_map->setMetricsEnabled(enabled);
+
+    m_metricsEnabled = enabled;
+    emit metricsEnabledChanged(enabled);
+}
+
+bool QDeclarativeGeoMap::metricsEnabled() const
+{
+    return m_metricsEnabled;
+}
+
 
 
 /*!
@@ -1380,6 +1415,8 @@ void QDeclarativeGeoMap::setVisibleArea(const QRectF &visibleArea)
                 if (i)
                     i->visibleAreaChanged();
             }
+            // all of them may be on screen now
+            m_viewportMapItems = m_mapItems;
         }
     } else {
         m_visibleArea = visibleArea;
@@ -1540,6 +1577,37 @@ void QDeclarativeGeoMap::clearData()
         m_map->clearData();
 }
 
+/*!
+    \qmlmethod object QtLocation::Map::metrics()
+
+    Returns the performance metrics of the map data, to tell where the time
+    goes when tiles show up late. For tiled maps the object holds:
+
+    \list
+    \li \c caches: for each of \c texture, \c memory and \c disk, the
+        \c hits, \c misses and \c evictions since the plugin was loaded, the
+        number of \c tiles held and their size in \c bytes out of
+        \c maxBytes. The sizes are -1 for caches that do not count bytes.
+    \li \c latencies: for each of \c fetch, \c diskRead, \c decode and
+        \c upload, the \c count of samples and the \c p50, \c p90 and
+        \c p99 percentiles, in microseconds.
+    \li \c requests: the tile requests \c inFlight and \c queued, and the
+        \c total, \c cancelled and failed (\c errors) requests.
+    \endlist
+
+    Latencies and request counts are only collected while \l metricsEnabled
+    is \c true. The object is empty if the plugin does not provide metrics.
+
+    \sa metricsEnabled
+    \since QtLocation 6.4
+*/
+QVariantMap QDeclarativeGeoMap::metrics() const
+{
+    if (!m_map)
+        return QVariantMap();
+    return m_map->metrics();
+}
+
 /*!
     \qmlmethod void QtLocation::Map::fitViewportToGeoShape(geoShape, margins)
 
@@ -1713,10 +1781,7 @@ void QDeclarativeGeoMap::onCameraDataChanged(const QGeoCameraData &cameraData)
 
     m_cameraData = cameraData;
     // polish map items
-    for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_mapItems)) {
-        if (i)
-            i->baseCameraDataChanged(m_cameraData); // Consider optimizing this further, removing the contained duplicate if conditions.
-    }
+    updateMapItemsInViewport();
 
     if (centerHasChanged)
         emit centerChanged(m_cameraData.center());
@@ -1754,6 +1819,56 @@ QList<QObject *> QDeclarativeGeoMap::mapItems()
     return ret;
 }
 
+/*!
+    \qmlmethod list<MapItem> QtLocation::Map::mapItemsAt(point position)
+
+    Returns the visible map items containing \a position, in the coordinate
+    system of the map, topmost first.
+
+    Only the items whose bounding box is near \a position are tested, so the
+    cost of this method does not grow with the number of items elsewhere on
+    the map.
+
+    \sa mapItems
+    \since QtLocation 6.4
+*/
+QList<QObject *> QDeclarativeGeoMap::mapItemsAt(const QPointF &position) const
+{
+    QList<QObject *> res;
+    if (!m_map)
+        return res;
+
+    // Candidates: items whose bounding box is within a few pixels of position,
+    // to account for borders and line widths.
+    const qreal tolerance = 16.0;
+    QGeoPath area;
+    for (const QPointF &offset : { QPointF(-tolerance, -tolerance), QPointF(tolerance, -tolerance),
+                                   QPointF(tolerance, tolerance), QPointF(-tolerance, tolerance) }) {
+        const QGeoCoordinate c = toCoordinate(position + offset, false);
+        if (c.isValid())
+            area.addCoordinate(c);
+    }
+    QList<QDeclarativeGeoMapItemBase *> candidates;
+    if (area.size())
+        candidates = m_mapItemIndex.intersecting(area.boundingGeoRectangle());
+    for (const QPointer<QDeclarativeGeoMapItemBase> &i : m_unindexedMapItems) {
+        if (i)
+            candidates.append(i.data());
+    }
+
+    // topmost first: highest z, then last added
+    std::reverse(candidates.begin(), candidates.end());
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const QDeclarativeGeoMapItemBase *a, const QDeclarativeGeoMapItemBase *b) {
+        return a->z() > b->z();
+    });
+    for (QDeclarativeGeoMapItemBase *item : qAsConst(candidates)) {
+        if (item->isVisible() && item->contains(item->mapFromItem(this, position)))
+            res.append(item);
+    }
+    return res;
+}
+
 /*!
     \qmlmethod void QtLocation::Map::addMapItem(MapItem item)
 
@@ -1786,6 +1901,19 @@ bool QDeclarativeGeoMap::addMapItem_real(QDeclarativeGeoMapItemBase *item)
     if (!qobject_cast<QDeclarativeGeoMapItemGroup *>(item->parentItem()))
         item->setParentItem(this);
     m_mapItems.append(item);
+    switch (item->itemType()) {
+    case QGeoMap::MapRectangle:
+    case QGeoMap::MapCircle:
+    case QGeoMap::MapPolyline:
+    case QGeoMap::MapPolygon:
+        m_mapItemIndex.insert(item, item->geoShape().boundingGeoRectangle());
+        connect(item, &QDeclarativeGeoMapItemBase::geoShapeChanged,
+                this, &QDeclarativeGeoMap::onMapItemGeoShapeChanged);
+        break;
+    default:
+        m_unindexedMapItems.append(item);
+        break;
+    }
     if (m_map) {
         item->setMap(this, m_map);
         m_map->addMapItem(item);
@@ -1820,11 +1948,87 @@ bool QDeclarativeGeoMap::removeMapItem_real(QDeclarativeGeoMapItemBase *ptr)
     if (item->parentItem() == this)
         item->setParentItem(0);
     item->setMap(0, 0);
+    if (m_mapItemIndex.remove(ptr)) {
+        disconnect(ptr, &QDeclarativeGeoMapItemBase::geoShapeChanged,
+                   this, &QDeclarativeGeoMap::onMapItemGeoShapeChanged);
+        m_viewportMapItems.removeOne(item);
+    } else {
+        m_unindexedMapItems.removeOne(item);
+    }
     // these can be optimized for perf, as we already check the 'contains' above
     m_mapItems.removeOne(item);
     return true;
 }
 
+void QDeclarativeGeoMap::onMapItemGeoShapeChanged()
+{
+    QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
+    if (m_mapItemIndex.contains(item))
+        m_mapItemIndex.insert(item, item->geoShape().boundingGeoRectangle());
+}
+
+/*
+    Sends the camera change to the map items that may be on screen: the
+    indexed items intersecting the viewport, the ones that were in it at the
+    previous change, so that they move out of it, and the unindexed items.
+    The other items keep the screen geometry they had when they left the
+    viewport, which is off screen, until they are back in it.
+*/
+void QDeclarativeGeoMap::updateMapItemsInViewport()
+{
+    const QGeoRectangle region = mapItemsQueryRegion();
+    if (!region.isValid()) {
+        for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_mapItems)) {
+            if (i)
+                i->baseCameraDataChanged(m_cameraData);
+        }
+        m_viewportMapItems = m_mapItems;
+        return;
+    }
+
+    const QList<QDeclarativeGeoMapItemBase *> visibleItems = m_mapItemIndex.intersecting(region);
+    const QSet<QDeclarativeGeoMapItemBase *> visibleSet(visibleItems.cbegin(), visibleItems.cend());
+    for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_viewportMapItems)) {
+        if (i && m_mapItemIndex.contains(i.data()) && !visibleSet.contains(i.data()))
+            i->baseCameraDataChanged(m_cameraData);
+    }
+    m_viewportMapItems.clear();
+    for (QDeclarativeGeoMapItemBase *i : visibleItems) {
+        i->baseCameraDataChanged(m_cameraData);
+        m_viewportMapItems.append(i);
+    }
+    for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_unindexedMapItems)) {
+        if (i)
+            i->baseCameraDataChanged(m_cameraData);
+    }
+}
+
+/*
+    The bounding box of the visible region, grown by a quarter on each side
+    for borders and lines drawn in pixels. Invalid when it cannot be used to
+    cull map items, that is when a visible area smaller than the map is set.
+*/
+QGeoRectangle QDeclarativeGeoMap::mapItemsQueryRegion() const
+{
+    if (!m_map || !m_map->visibleArea().isEmpty())
+        return QGeoRectangle();
+
+    const QGeoRectangle visible = m_map->visibleRegion().boundingGeoRectangle();
+    if (!visible.isValid())
+        return QGeoRectangle();
+
+    const double width = visible.width();
+    const double height = visible.height();
+    const double top = qMin(90.0, visible.topLeft().latitude() + height * 0.25);
+    const double bottom = qMax(-90.0, visible.bottomRight().latitude() - height * 0.25);
+    if (width * 1.5 >= 360.0)
+        return QGeoRectangle(QGeoCoordinate(top, -180.0), QGeoCoordinate(bottom, 180.0));
+
+    const double left = QLocationUtils::wrapLong(visible.topLeft().longitude() - width * 0.25);
+    const double right = QLocationUtils::wrapLong(visible.bottomRight().longitude() + width * 0.25);
+    return QGeoRectangle(QGeoCoordinate(top, left), QGeoCoordinate(bottom, right));
+}
+
 /*!
     \qmlmethod void QtLocation::Map::clearMapItems()
 
@@ -2086,6 +2290,7 @@ void QDeclarativeGeoMap::geometryChange(const QRectF &newGeometry, const QRectF
                 if (i)
                     i->polishAndUpdate();
             }
+            m_viewportMapItems = m_mapItems;
         }
     }
 
@@ -55,6 +55,7 @@
 #include <QtLocation/private/qdeclarativegeomapitemview_p.h>
 #include <QtLocation/private/qquickgeomapgesturearea_p.h>
 #include <QtLocation/private/qdeclarativegeomapitemgroup_p.h>
+#include <QtLocation/private/qgeomapitemindex_p.h>
 #include <QtLocation/qgeoserviceprovider.h>
 #include <QtLocation/private/qgeocameradata_p.h>
 #include <QtLocation/private/qgeocameracapabilities_p.h>
@@ -107,6 +108,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
     Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
     Q_PROPERTY(bool mapReady READ mapReady NOTIFY mapReadyChanged)
     Q_PROPERTY(QRectF visibleArea READ visibleArea WRITE setVisibleArea NOTIFY visibleAreaChanged  REVISION(5, 12))
+    Q_PROPERTY(bool metricsEnabled READ metricsEnabled WRITE setMetricsEnabled NOTIFY metricsEnabledChanged REVISION(6, 4))
     Q_INTERFACES(QQmlParserStatus)
 
 public:
@@ -165,6 +167,9 @@ public:
 
     bool mapReady() const;
 
+    void setMetricsEnabled(bool enabled);
+    bool metricsEnabled() const;
+
     QList<QGeoMapType> supportedMapTypes();
 
     Q_INVOKABLE void setBearing(qreal bearing, const QGeoCoordinate &coordinate);
@@ -193,6 +198,8 @@ public:
     Q_INVOKABLE void prefetchData(); // optional hint for prefetch
     Q_INVOKABLE void clearData();
     Q_REVISION(13) Q_INVOKABLE void fitViewportToGeoShape(const QGeoShape &shape, QVariant margins);
+    Q_REVISION(6, 4) Q_INVOKABLE QList<QObject *> mapItemsAt(const QPointF &position) const;
+    Q_REVISION(6, 4) Q_INVOKABLE QVariantMap metrics() const;
     void fitViewportToGeoShape(const QGeoShape &shape, const QMargins &borders = QMargins(10, 10, 10, 10));
 
     QString errorString() const;
@@ -227,6 +234,7 @@ Q_SIGNALS:
     void mapReadyChanged(bool ready);
     void visibleAreaChanged();
     Q_REVISION(14) void visibleRegionChanged();
+    Q_REVISION(6, 4) void metricsEnabledChanged(bool enabled);
 
 protected:
     void mousePressEvent(QMouseEvent *event) override ;
@@ -269,6 +277,7 @@ private Q_SLOTS:
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
     void onAttachedCopyrightNoticeVisibilityChanged();
     void onCameraDataChanged(const QGeoCameraData &cameraData);
+    void onMapItemGeoShapeChanged();
 
 private:
     void setupMapView(QDeclarativeGeoMapItemView *view);
@@ -278,6 +287,8 @@ private:
     void attachCopyrightNotice(bool initialVisibility);
     void detachCopyrightNotice(bool currentVisibility);
     QMargins mapMargins() const;
+    void updateMapItemsInViewport();
+    QGeoRectangle mapItemsQueryRegion() const;
 
 private:
     QQuickWindow *m_window = nullptr;
@@ -291,6 +302,11 @@ private:
     QPointer<QDeclarativeGeoMapCopyrightNotice> m_copyrights;
     QList<QPointer<QDeclarativeGeoMapItemBase> > m_mapItems;
     QList<QPointer<QDeclarativeGeoMapItemGroup> > m_mapItemGroups;
+    // Items with a geographic extent, updated on camera changes only when in the viewport
+    QGeoMapItemIndex<QDeclarativeGeoMapItemBase *> m_mapItemIndex;
+    QList<QPointer<QDeclarativeGeoMapItemBase> > m_viewportMapItems;
+    // Items drawn in screen space, updated on every camera change
+    QList<QPointer<QDeclarativeGeoMapItemBase> > m_unindexedMapItems;
     QString m_errorString;
     QGeoServiceProvider::Error m_error = QGeoServiceProvider::NoError;
     QGeoRectangle m_visibleRegion;
@@ -299,6 +315,7 @@ private:
     bool m_componentCompleted = false;
     bool m_pendingFitViewport = false;
     bool m_copyrightsVisible = true;
+    bool m_metricsEnabled = false;
     double m_maximumViewportLatitude = 0.0;
     double m_minimumViewportLatitude = 0.0;
     bool m_initialized = false;
@@ -84,7 +84,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemBase : public QQuickItem
     QML_ADDED_IN_VERSION(5, 0)
     QML_UNCREATABLE("GeoMapItemBase is not intended instantiable by developer.")
 
-    Q_PROPERTY(QGeoShape geoShape READ geoShape WRITE setGeoShape STORED false )
+    Q_PROPERTY(QGeoShape geoShape READ geoShape WRITE setGeoShape NOTIFY geoShapeChanged STORED false )
     Q_PROPERTY(bool autoFadeIn READ autoFadeIn WRITE setAutoFadeIn REVISION(5, 14))
     Q_PROPERTY(int lodThreshold READ lodThreshold WRITE setLodThreshold NOTIFY lodThresholdChanged REVISION(5, 15))
 
@@ -135,6 +135,7 @@ Q_SIGNALS:
     Q_REVISION(12) void addTransitionFinished();
     Q_REVISION(12) void removeTransitionFinished();
     void lodThresholdChanged();
+    void geoShapeChanged();
 
 protected Q_SLOTS:
     virtual void afterChildrenChanged();
@@ -0,0 +1,738 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdeclarativegeomaplinelayer_p.h"
+#include "qdeclarativegeomapitemutils_p.h"
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/qmath.h>
+#include <QtQml/QJSValue>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype MapLineLayer
+    \instantiates QDeclarativeGeoMapLineLayer
+    \inqmlmodule QtLocation
+    \ingroup qml-QtLocation5-maps
+    \since QtLocation 6.4
+
+    \brief The MapLineLayer type displays the paths of a model as lines on a map.
+
+    The MapLineLayer type draws one line for each row of \l model, using the
+    path, color and width found in the \l pathRole, \l colorRole and \l widthRole
+    roles of the row. Rows that do not provide a color or a width use
+    \l {line.color} and \l {line.width}.
+
+    Unlike a MapItemView with a MapPolyline delegate, the layer does not create
+    an item per row: all the lines are drawn by a single scene graph node, and
+    changing a row only rebuilds the vertices of that row. This makes it
+    suitable for thousands of routes or geofences.
+
+    The path role may contain a \l geopath, a \l geopolygon, whose perimeter
+    is drawn as a closed line, a list of \l {coordinate}{coordinates}, or a
+    list of elements with \c latitude and \c longitude roles.
+
+    \section2 Performance
+
+    Camera changes do not touch the vertices of the layer, only the uniforms
+    of its node. Lines are drawn with the extruded polyline shader and are not
+    simplified with the zoom level, unlike MapPolyline.
+
+    \section2 Example Usage
+
+    \code
+    Map {
+        MapLineLayer {
+            line.width: 3
+            line.color: "green"
+            model: ListModel {
+                ListElement {
+                    path: [
+                        ListElement { latitude: -27; longitude: 153.0 },
+                        ListElement { latitude: -27; longitude: 154.1 },
+                        ListElement { latitude: -28; longitude: 153.5 }
+                    ]
+                }
+                ListElement {
+                    color: "red"
+                    path: [
+                        ListElement { latitude: -29; longitude: 153.5 },
+                        ListElement { latitude: -30; longitude: 153.5 }
+                    ]
+                }
+            }
+        }
+    }
+    \endcode
+*/
+
+namespace {
+
+QList<QGeoCoordinate> pathFromVariant(QVariant value, bool *closed)
+{
+    *closed = false;
+    if (value.metaType() == QMetaType::fromType<QJSValue>())
+        value = value.value<QJSValue>().toVariant();
+
+    if (value.metaType() == QMetaType::fromType<QGeoPath>())
+        return value.value<QGeoPath>().path();
+    if (value.metaType() == QMetaType::fromType<QGeoPolygon>()) {
+        *closed = true;
+        return value.value<QGeoPolygon>().perimeter();
+    }
+    if (value.metaType() == QMetaType::fromType<QGeoShape>()) {
+        const QGeoShape shape = value.value<QGeoShape>();
+        if (shape.type() == QGeoShape::PathType)
+            return QGeoPath(shape).path();
+        if (shape.type() == QGeoShape::PolygonType) {
+            *closed = true;
+            return QGeoPolygon(shape).perimeter();
+        }
+        return {};
+    }
+    if (value.metaType() == QMetaType::fromType<QList<QGeoCoordinate>>())
+        return value.value<QList<QGeoCoordinate>>();
+
+    QList<QGeoCoordinate> path;
+    if (const auto *model = qobject_cast<const QAbstractItemModel *>(value.value<QObject *>())) {
+        // Nested ListElements, as in path: [ ListElement { latitude: 1; longitude: 2 } ]
+        const QHash<int, QByteArray> roleNames = model->roleNames();
+        const int latitudeRole = roleNames.key(QByteArrayLiteral("latitude"), -1);
+        const int longitudeRole = roleNames.key(QByteArrayLiteral("longitude"), -1);
+        if (latitudeRole < 0 || longitudeRole < 0)
+            return path;
+        const int rows = model->rowCount();
+        path.reserve(rows);
+        for (int i = 0; i < rows; ++i) {
+            const QModelIndex index = model->index(i, 0);
+            const QGeoCoordinate c(index.data(latitudeRole).toDouble(),
+                                   index.data(longitudeRole).toDouble());
+            if (c.isValid())
+                path.append(c);
+        }
+        return path;
+    }
+
+    const QVariantList list = value.toList();
+    path.reserve(list.size());
+    for (const QVariant &v : list) {
+        const QGeoCoordinate c = v.value<QGeoCoordinate>();
+        if (c.isValid())
+            path.append(c);
+    }
+    return path;
+}
+
+void fillEntries(QList<MapLineLayerNode::Entry> &entries,
+                 const QList<QDoubleVector2D> &v,
+                 bool closed,
+                 const MapLineLayerNode::Entry &style)
+{
+    // Same layout as QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries:
+    // two triangles per segment, six vertices
+    const qsizetype numSegments = v.size() - 1;
+    entries.resize(numSegments * 6);
+    MapLineLayerNode::Entry *vertices = entries.data();
+
+    for (qsizetype i = 0; i < numSegments; ++i) {
+        MapLineLayerNode::Entry e = style;
+        const QDeclarativeGeoMapItemUtils::vec2 cur = v[i];
+        const QDeclarativeGeoMapItemUtils::vec2 next = v[i + 1];
+        e.triangletype = 1.0;
+        e.next = next;
+        e.prev = cur;
+        e.pos = cur;
+        e.direction = 1.0;
+        e.vertextype = -1.0;
+        vertices[i*6] = e;
+        e.direction = -1.0;
+        vertices[i*6+1] = e;
+        e.pos = next;
+        e.vertextype = 1.0;
+        vertices[i*6+2] = e;
+
+        // Second tri
+        e.triangletype = -1.0;
+        e.direction = -1.0;
+        vertices[i*6+3] = e;
+        e.direction = 1.0;
+        vertices[i*6+4] = e;
+        e.pos = cur;
+        e.vertextype = -1.0;
+        vertices[i*6+5] = e;
+
+        if (i != 0) {
+            vertices[i*6].prev = vertices[i*6+1].prev = vertices[i*6+5].prev = v[i - 1];
+        } else {
+            if (closed) {
+                vertices[i*6].prev = vertices[i*6+1].prev = vertices[i*6+5].prev = v[numSegments - 1];
+            } else {
+                vertices[i*6].triangletype = vertices[i*6+1].triangletype = vertices[i*6+5].triangletype = 2.0;
+            }
+        }
+        if (i != numSegments - 1) {
+            vertices[i*6+2].next = vertices[i*6+3].next = vertices[i*6+4].next = v[i + 2];
+        } else {
+            if (closed) {
+                vertices[i*6+2].next = vertices[i*6+3].next = vertices[i*6+4].next = v[1];
+            } else {
+                vertices[i*6+2].triangletype = vertices[i*6+3].triangletype = vertices[i*6+4].triangletype = 3.0;
+            }
+        }
+    }
+}
+
+double distanceToSegment(const QPointF &p, const QDoubleVector2D &a, const QDoubleVector2D &b)
+{
+    const double dx = b.x() - a.x();
+    const double dy = b.y() - a.y();
+    const double lengthSquared = dx * dx + dy * dy;
+    double t = 0.0;
+    if (lengthSquared > 0.0)
+        t = qBound(0.0, ((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / lengthSquared, 1.0);
+    const double px = a.x() + t * dx - p.x();
+    const double py = a.y() + t * dy - p.y();
+    return qSqrt(px * px + py * py);
+}
+
+void unite(QGeoRectangle &bounds, const QGeoRectangle &other)
+{
+    if (other.isValid())
+        bounds = bounds.isValid() ? bounds.united(other) : other;
+}
+
+} // anonymous namespace
+
+QDeclarativeGeoMapLineLayer::QDeclarativeGeoMapLineLayer(QQuickItem *parent)
+    : QDeclarativeGeoMapItemBase(parent), m_line(this)
+{
+    setFlag(ItemHasContents, true);
+    QObject::connect(&m_line, &QDeclarativeMapLineProperties::colorChanged,
+                     this, &QDeclarativeGeoMapLineLayer::markAllDirty);
+    QObject::connect(&m_line, &QDeclarativeMapLineProperties::widthChanged,
+                     this, &QDeclarativeGeoMapLineLayer::markAllDirty);
+}
+
+QDeclarativeGeoMapLineLayer::~QDeclarativeGeoMapLineLayer()
+{
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapLineLayer::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
+{
+    QDeclarativeGeoMapItemBase::setMap(quickMap, map);
+    if (!map)
+        return;
+    // The layer covers the whole map, its vertices are in mercator space
+    setPosition(QPointF(0, 0));
+    setSize(QSizeF(quickMap->width(), quickMap->height()));
+    polishAndUpdate();
+}
+
+/*!
+    \qmlproperty model QtLocation::MapLineLayer::model
+
+    This property holds the model that provides the lines of the layer, one
+    line per row. Only QAbstractItemModel based models are supported.
+*/
+QAbstractItemModel *QDeclarativeGeoMapLineLayer::model() const
+{
+    return m_model;
+}
+
+void QDeclarativeGeoMapLineLayer::setModel(QAbstractItemModel *model)
+{
+    if (model == m_model)
+        return;
+
+    if (m_model)
+        m_model->disconnect(this);
+
+    m_model = model;
+
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::rowsInserted,
+                this, &QDeclarativeGeoMapLineLayer::onRowsInserted);
+        connect(m_model, &QAbstractItemModel::rowsRemoved,
+                this, &QDeclarativeGeoMapLineLayer::onRowsRemoved);
+        connect(m_model, &QAbstractItemModel::dataChanged,
+                this, &QDeclarativeGeoMapLineLayer::onDataChanged);
+        connect(m_model, &QAbstractItemModel::modelReset,
+                this, &QDeclarativeGeoMapLineLayer::onModelReset);
+        connect(m_model, &QAbstractItemModel::rowsMoved,
+                this, &QDeclarativeGeoMapLineLayer::onModelReset);
+        connect(m_model, &QAbstractItemModel::layoutChanged,
+                this, &QDeclarativeGeoMapLineLayer::onModelReset);
+    }
+
+    onModelReset();
+    emit modelChanged();
+}
+
+/*!
+    \qmlproperty string QtLocation::MapLineLayer::pathRole
+
+    This property holds the name of the model role providing the path of
+    each line. The default is \c "path".
+*/
+QString QDeclarativeGeoMapLineLayer::pathRole() const
+{
+    return m_pathRole;
+}
+
+void QDeclarativeGeoMapLineLayer::setPathRole(const QString &role)
+{
+    if (role == m_pathRole)
+        return;
+    m_pathRole = role;
+    resolveRoles();
+    markAllDirty();
+    emit pathRoleChanged();
+}
+
+/*!
+    \qmlproperty string QtLocation::MapLineLayer::colorRole
+
+    This property holds the name of the model role providing the color of
+    each line. The default is \c "color".
+*/
+QString QDeclarativeGeoMapLineLayer::colorRole() const
+{
+    return m_colorRole;
+}
+
+void QDeclarativeGeoMapLineLayer::setColorRole(const QString &role)
+{
+    if (role == m_colorRole)
+        return;
+    m_colorRole = role;
+    resolveRoles();
+    markAllDirty();
+    emit colorRoleChanged();
+}
+
+/*!
+    \qmlproperty string QtLocation::MapLineLayer::widthRole
+
+    This property holds the name of the model role providing the width, in
+    pixels, of each line. The default is \c "width".
+*/
+QString QDeclarativeGeoMapLineLayer::widthRole() const
+{
+    return m_widthRole;
+}
+
+void QDeclarativeGeoMapLineLayer::setWidthRole(const QString &role)
+{
+    if (role == m_widthRole)
+        return;
+    m_widthRole = role;
+    resolveRoles();
+    markAllDirty();
+    emit widthRoleChanged();
+}
+
+/*!
+    \qmlpropertygroup Location::MapLineLayer::line
+    \qmlproperty int MapLineLayer::line.width
+    \qmlproperty color MapLineLayer::line.color
+
+    This property is part of the line property group. The line
+    property group holds the width and color used to draw the lines
+    whose row does not provide them.
+
+    The width is in pixels and is independent of the zoom level of the map.
+    The default values correspond to a black border with a width of 1 pixel.
+*/
+QDeclarativeMapLineProperties *QDeclarativeGeoMapLineLayer::line()
+{
+    return &m_line;
+}
+
+/*!
+    \qmlproperty int QtLocation::MapLineLayer::count
+
+    This property holds the number of lines in the layer.
+*/
+int QDeclarativeGeoMapLineLayer::count() const
+{
+    return int(m_features.size());
+}
+
+/*!
+    \qmlmethod int QtLocation::MapLineLayer::featureAt(point position)
+
+    Returns the row of the topmost line passing under \a position, in the
+    coordinate system of the map, or -1 if there is none.
+*/
+int QDeclarativeGeoMapLineLayer::featureAt(const QPointF &position) const
+{
+    if (!map())
+        return -1;
+
+    const QGeoProjectionWebMercator &p =
+            static_cast<const QGeoProjectionWebMercator &>(map()->geoProjection());
+    for (qsizetype row = m_features.size() - 1; row >= 0; --row) {
+        const QList<MapLineLayerNode::Entry> &entries = m_features.at(row).entries;
+        if (entries.isEmpty())
+            continue;
+
+        // Same world copy as the one picked by the shader
+        const double wrap = p.projectionWrapFactor(QDoubleVector2D(entries.first().leftBound, 0.0));
+        const double halfWidth = entries.first().lineWidth * 0.5;
+        for (qsizetype i = 0; i < entries.size(); i += 6) {
+            const MapLineLayerNode::Entry &e = entries.at(i);
+            const QDoubleVector2D a(e.pos.x + wrap, e.pos.y);
+            const QDoubleVector2D b(e.next.x + wrap, e.next.y);
+            if (!p.isProjectable(a) || !p.isProjectable(b))
+                continue;
+            if (distanceToSegment(position,
+                                  p.wrappedMapProjectionToItemPosition(a),
+                                  p.wrappedMapProjectionToItemPosition(b)) <= halfWidth) {
+                return int(row);
+            }
+        }
+    }
+    return -1;
+}
+
+/*!
+    \internal
+*/
+const QGeoShape &QDeclarativeGeoMapLineLayer::geoShape() const
+{
+    return m_bounds;
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapLineLayer::setGeoShape(const QGeoShape &shape)
+{
+    // The shape of the layer is the bounding box of its lines
+    Q_UNUSED(shape);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapLineLayer::afterViewportChanged(const QGeoMapViewportChangeEvent &event)
+{
+    if (event.mapSize.isEmpty())
+        return;
+
+    if (event.mapSizeChanged)
+        setSize(event.mapSize);
+    // Only the uniforms of the node depend on the camera
+    update();
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapLineLayer::updatePolish()
+{
+    if (m_dirtyRows.isEmpty())
+        return;
+
+    QGeoRectangle added;
+    for (int row : qAsConst(m_dirtyRows)) {
+        Feature &feature = m_features[row];
+        const qsizetype oldSize = feature.entries.size();
+        removeBounds(feature.bounds);
+        buildFeature(feature, row);
+        unite(added, feature.bounds);
+        feature.dirty = false;
+        if (feature.entries.size() != oldSize)
+            m_layoutChanged = true;
+        else if (!m_layoutChanged)
+            m_uploadRows.append(row);
+    }
+    m_dirtyRows.clear();
+    updateBounds(added);
+}
+
+/*!
+    \internal
+*/
+QSGNode *QDeclarativeGeoMapLineLayer::updateMapItemPaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    if (!m_node || !oldNode) {
+        if (oldNode)
+            delete oldNode;
+        m_node = new MapLineLayerNode();
+        m_layoutChanged = true;
+    } else {
+        m_node = static_cast<MapLineLayerNode *>(oldNode);
+    }
+
+    QSGGeometry *geometry = m_node->lineGeometry();
+    if (m_layoutChanged) {
+        qsizetype vertexCount = 0;
+        for (Feature &feature : m_features) {
+            feature.firstVertex = vertexCount;
+            vertexCount += feature.entries.size();
+        }
+        geometry->allocate(int(vertexCount));
+        auto *vertices = static_cast<MapLineLayerNode::Entry *>(geometry->vertexData());
+        for (const Feature &feature : qAsConst(m_features))
+            std::copy(feature.entries.cbegin(), feature.entries.cend(), vertices + feature.firstVertex);
+        m_node->markDirty(QSGNode::DirtyGeometry);
+    } else if (!m_uploadRows.isEmpty()) {
+        // Same number of vertices, patch the features in place
+        auto *vertices = static_cast<MapLineLayerNode::Entry *>(geometry->vertexData());
+        for (int row : qAsConst(m_uploadRows)) {
+            const Feature &feature = m_features.at(row);
+            std::copy(feature.entries.cbegin(), feature.entries.cend(), vertices + feature.firstVertex);
+        }
+        m_node->markDirty(QSGNode::DirtyGeometry);
+    }
+    m_uploadRows.clear();
+    m_layoutChanged = false;
+
+    m_node->setSubtreeBlocked(geometry->vertexCount() == 0);
+    const QGeoProjectionWebMercator &p =
+            static_cast<const QGeoProjectionWebMercator &>(map()->geoProjection());
+    m_node->updateMaterial(p.qsgTransform(), p.centerMercator());
+    return m_node;
+}
+
+void QDeclarativeGeoMapLineLayer::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    const int inserted = last - first + 1;
+    for (int &row : m_dirtyRows) {
+        if (row >= first)
+            row += inserted;
+    }
+    m_features.insert(first, inserted, Feature());
+    markDirty(first, last);
+    m_layoutChanged = true;
+    polishAndUpdate();
+    emit countChanged();
+}
+
+void QDeclarativeGeoMapLineLayer::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    const int removed = last - first + 1;
+    m_dirtyRows.removeIf([first, last](int row) { return row >= first && row <= last; });
+    for (int &row : m_dirtyRows) {
+        if (row > last)
+            row -= removed;
+    }
+    for (int row = first; row <= last; ++row)
+        removeBounds(m_features.at(row).bounds);
+    m_features.remove(first, removed);
+    m_layoutChanged = true;
+    updateBounds(QGeoRectangle());
+    update();
+    emit countChanged();
+}
+
+void QDeclarativeGeoMapLineLayer::onDataChanged(const QModelIndex &topLeft,
+                                                const QModelIndex &bottomRight,
+                                                const QList<int> &roles)
+{
+    if (topLeft.parent().isValid())
+        return;
+    if (!roles.isEmpty()
+            && !roles.contains(m_pathRoleId)
+            && !roles.contains(m_colorRoleId)
+            && !roles.contains(m_widthRoleId)) {
+        return;
+    }
+
+    markDirty(topLeft.row(), qMin(bottomRight.row(), int(m_features.size()) - 1));
+    polishAndUpdate();
+}
+
+void QDeclarativeGeoMapLineLayer::onModelReset()
+{
+    const int oldCount = count();
+    m_features = QList<Feature>(m_model ? m_model->rowCount() : 0);
+    m_dirtyRows.clear();
+    m_uploadRows.clear();
+    m_layoutChanged = true;
+    markDirty(0, int(m_features.size()) - 1);
+    resolveRoles();
+    m_boundsStale = true;
+    updateBounds(QGeoRectangle());
+    polishAndUpdate();
+    if (count() != oldCount)
+        emit countChanged();
+}
+
+void QDeclarativeGeoMapLineLayer::resolveRoles()
+{
+    m_pathRoleId = m_colorRoleId = m_widthRoleId = -1;
+    if (!m_model)
+        return;
+
+    const QHash<int, QByteArray> roleNames = m_model->roleNames();
+    m_pathRoleId = roleNames.key(m_pathRole.toUtf8(), -1);
+    m_colorRoleId = roleNames.key(m_colorRole.toUtf8(), -1);
+    m_widthRoleId = roleNames.key(m_widthRole.toUtf8(), -1);
+}
+
+void QDeclarativeGeoMapLineLayer::markAllDirty()
+{
+    markDirty(0, int(m_features.size()) - 1);
+    polishAndUpdate();
+}
+
+// Lists the rows for the next polish, which rebuilds only those
+void QDeclarativeGeoMapLineLayer::markDirty(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        Feature &feature = m_features[row];
+        if (feature.dirty)
+            continue;
+        feature.dirty = true;
+        m_dirtyRows.append(row);
+    }
+}
+
+void QDeclarativeGeoMapLineLayer::buildFeature(Feature &feature, int row) const
+{
+    feature.entries.clear();
+    feature.bounds = QGeoRectangle();
+    if (!m_model || m_pathRoleId < 0)
+        return;
+
+    const QModelIndex index = m_model->index(row, 0);
+    bool closed = false;
+    const QList<QGeoCoordinate> path = pathFromVariant(index.data(m_pathRoleId), &closed);
+    if (path.size() < 2)
+        return;
+
+    QColor color = m_line.color();
+    if (m_colorRoleId >= 0) {
+        const QColor c = index.data(m_colorRoleId).value<QColor>();
+        if (c.isValid())
+            color = c;
+    }
+    qreal width = m_line.width();
+    if (m_widthRoleId >= 0) {
+        bool ok = false;
+        const qreal w = index.data(m_widthRoleId).toReal(&ok);
+        if (ok)
+            width = w;
+    }
+    if (width < 0.5 || color.alpha() == 0)
+        return;
+
+    feature.bounds = QGeoPath(path).boundingGeoRectangle();
+    const QDoubleVector2D leftBound = QWebMercator::coordToMercator(feature.bounds.topLeft());
+
+    QList<QDoubleVector2D> projected;
+    projected.reserve(path.size() + 1);
+    for (const QGeoCoordinate &c : path)
+        projected.append(QWebMercator::coordToMercator(c));
+    QList<QDoubleVector2D> wrapped;
+    QDeclarativeGeoMapItemUtils::wrapPath(projected, leftBound, wrapped);
+    if (wrapped.size() != projected.size())
+        return; // non finite coordinates
+    if (closed) {
+        const QDoubleVector2D &first = wrapped.first();
+        if (first.x() != wrapped.last().x() || first.y() != wrapped.last().y())
+            wrapped.append(first);
+        if (wrapped.size() < 3)
+            closed = false;
+    }
+
+    MapLineLayerNode::Entry style;
+    style.lineWidth = float(width);
+    style.leftBound = float(leftBound.x());
+    const QRgb rgba = qPremultiply(color.rgba());
+    style.color[0] = uchar(qRed(rgba));
+    style.color[1] = uchar(qGreen(rgba));
+    style.color[2] = uchar(qBlue(rgba));
+    style.color[3] = uchar(qAlpha(rgba));
+    fillEntries(feature.entries, wrapped, closed, style);
+}
+
+// The bounds of a line are taken out of the layer, which can only shrink if they lie on its edge
+void QDeclarativeGeoMapLineLayer::removeBounds(const QGeoRectangle &bounds)
+{
+    if (m_boundsStale || !bounds.isValid() || !m_bounds.isValid())
+        return;
+    if (bounds.topLeft().latitude() == m_bounds.topLeft().latitude()
+            || bounds.bottomRight().latitude() == m_bounds.bottomRight().latitude()
+            || bounds.topLeft().longitude() == m_bounds.topLeft().longitude()
+            || bounds.bottomRight().longitude() == m_bounds.bottomRight().longitude()) {
+        m_boundsStale = true;
+    }
+}
+
+// Grows the bounds by the lines just built, all lines are scanned only when the bounds may shrink
+void QDeclarativeGeoMapLineLayer::updateBounds(const QGeoRectangle &added)
+{
+    QGeoRectangle bounds;
+    if (m_boundsStale) {
+        m_boundsStale = false;
+        for (const Feature &feature : qAsConst(m_features))
+            unite(bounds, feature.bounds);
+    } else {
+        bounds = m_bounds;
+        unite(bounds, added);
+    }
+    if (bounds == m_bounds)
+        return;
+    m_bounds = bounds;
+    emit geoShapeChanged();
+}
+
+QT_END_NAMESPACE
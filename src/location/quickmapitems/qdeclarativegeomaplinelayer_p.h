@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDECLARATIVEGEOMAPLINELAYER_P_H
+#define QDECLARATIVEGEOMAPLINELAYER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qdeclarativegeomapitembase_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+#include <QtLocation/private/qdeclarativegeomaplinelayer_rhi_p.h>
+
+#include <QtCore/QPointer>
+#include <QtPositioning/QGeoRectangle>
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractItemModel;
+
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapLineLayer : public QDeclarativeGeoMapItemBase
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(MapLineLayer)
+    QML_ADDED_IN_VERSION(6, 4)
+
+    Q_PROPERTY(QAbstractItemModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QString pathRole READ pathRole WRITE setPathRole NOTIFY pathRoleChanged)
+    Q_PROPERTY(QString colorRole READ colorRole WRITE setColorRole NOTIFY colorRoleChanged)
+    Q_PROPERTY(QString widthRole READ widthRole WRITE setWidthRole NOTIFY widthRoleChanged)
+    Q_PROPERTY(QDeclarativeMapLineProperties *line READ line CONSTANT)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    explicit QDeclarativeGeoMapLineLayer(QQuickItem *parent = nullptr);
+    ~QDeclarativeGeoMapLineLayer() override;
+
+    void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) override;
+
+    QAbstractItemModel *model() const;
+    void setModel(QAbstractItemModel *model);
+
+    QString pathRole() const;
+    void setPathRole(const QString &role);
+    QString colorRole() const;
+    void setColorRole(const QString &role);
+    QString widthRole() const;
+    void setWidthRole(const QString &role);
+
+    QDeclarativeMapLineProperties *line();
+
+    int count() const;
+
+    Q_INVOKABLE int featureAt(const QPointF &position) const;
+
+    const QGeoShape &geoShape() const override;
+    void setGeoShape(const QGeoShape &shape) override;
+
+    QSGNode *updateMapItemPaintNode(QSGNode *, UpdatePaintNodeData *) override;
+
+Q_SIGNALS:
+    void modelChanged();
+    void pathRoleChanged();
+    void colorRoleChanged();
+    void widthRoleChanged();
+    void countChanged();
+
+protected:
+    void updatePolish() override;
+
+protected Q_SLOTS:
+    void afterViewportChanged(const QGeoMapViewportChangeEvent &event) override;
+
+private Q_SLOTS:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onModelReset();
+    void markAllDirty();
+
+private:
+    struct Feature {
+        QList<MapLineLayerNode::Entry> entries;
+        QGeoRectangle bounds;
+        qsizetype firstVertex = 0;
+        bool dirty = false; // listed in m_dirtyRows
+    };
+
+    void resolveRoles();
+    void markDirty(int first, int last);
+    void buildFeature(Feature &feature, int row) const;
+    void removeBounds(const QGeoRectangle &bounds);
+    void updateBounds(const QGeoRectangle &added);
+
+    QPointer<QAbstractItemModel> m_model;
+    QString m_pathRole = QStringLiteral("path");
+    QString m_colorRole = QStringLiteral("color");
+    QString m_widthRole = QStringLiteral("width");
+    int m_pathRoleId = -1;
+    int m_colorRoleId = -1;
+    int m_widthRoleId = -1;
+    QDeclarativeMapLineProperties m_line;
+
+    QList<Feature> m_features;
+    QList<int> m_dirtyRows; // features to rebuild at the next polish
+    QList<int> m_uploadRows; // features rebuilt in place since the last sync
+    bool m_layoutChanged = true; // features added, removed or resized
+    QGeoRectangle m_bounds;
+    bool m_boundsStale = false; // a line on the edge of m_bounds shrank or went away
+
+    MapLineLayerNode *m_node = nullptr;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDECLARATIVEGEOMAPLINELAYER_P_H
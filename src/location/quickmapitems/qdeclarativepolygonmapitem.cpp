@@ -446,6 +446,8 @@ QDeclarativePolygonMapItem::QDeclarativePolygonMapItem(QQuickItem *parent)
     m_itemType = QGeoMap::MapPolygon;
     m_geopoly = QGeoPolygonEager();
     setFlag(ItemHasContents, true);
+    QObject::connect(this, &QDeclarativePolygonMapItem::pathChanged,
+                     this, &QDeclarativeGeoMapItemBase::geoShapeChanged);
     // ToDo: fix this, only flag material?
     QObject::connect(&m_border, &QDeclarativeMapLineProperties::colorChanged,
                      this, &QDeclarativePolygonMapItem::onLinePropertiesChanged);
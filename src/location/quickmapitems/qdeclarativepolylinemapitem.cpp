@@ -730,9 +730,8 @@ void QDeclarativePolylineMapItemPrivateCPU::regenerateCache()
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_poly.map()->geoProjection());
     m_geopathProjected.clear();
-    m_geopathProjected.reserve(m_poly.m_geopath.size());
-    for (const QGeoCoordinate &c : m_poly.m_geopath.path())
-        m_geopathProjected << p.geoToMapProjection(c);
+    m_geopathProjected.reserve(m_poly.pathSize());
+    m_poly.projectPath(p, m_geopathProjected);
 }
 
 void QDeclarativePolylineMapItemPrivateCPU::updateCache()
@@ -740,12 +739,12 @@ void QDeclarativePolylineMapItemPrivateCPU::updateCache()
     if (!m_poly.map() || m_poly.map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(m_poly.map()->geoProjection());
-    m_geopathProjected << p.geoToMapProjection(m_poly.m_geopath.path().last());
+    m_geopathProjected << p.geoToMapProjection(m_poly.geoPath().path().last());
 }
 
 void QDeclarativePolylineMapItemPrivateCPU::updatePolish()
 {
-    if (m_poly.m_geopath.path().length() < 2) { // Possibly cleared
+    if (m_poly.pathSize() < 2) { // Possibly cleared
         m_geometry.clear();
         m_poly.setWidth(0);
         m_poly.setHeight(0);
@@ -757,7 +756,7 @@ void QDeclarativePolylineMapItemPrivateCPU::updatePolish()
     const QGeoMap *map = m_poly.map();
     const qreal borderWidth = m_poly.m_line.width();
 
-    m_geometry.updateSourcePoints(*map, m_geopathProjected, m_poly.m_geopath.boundingGeoRectangle().topLeft());
+    m_geometry.updateSourcePoints(*map, m_geopathProjected, m_poly.pathBounds().topLeft());
     m_geometry.updateScreenPoints(*map, borderWidth);
 
     m_poly.setWidth(m_geometry.sourceBoundingBox().width() + borderWidth);
@@ -817,6 +816,8 @@ QDeclarativePolylineMapItem::QDeclarativePolylineMapItem(QQuickItem *parent)
     m_itemType = QGeoMap::MapPolyline;
     m_geopath = QGeoPathEager();
     setFlag(ItemHasContents, true);
+    QObject::connect(this, &QDeclarativePolylineMapItem::pathChanged,
+                     this, &QDeclarativeGeoMapItemBase::geoShapeChanged);
     QObject::connect(&m_line, &QDeclarativeMapLineProperties::colorChanged,
                      this, &QDeclarativePolylineMapItem::updateAfterLinePropertiesChanged);
     QObject::connect(&m_line, &QDeclarativeMapLineProperties::widthChanged,
@@ -855,7 +856,7 @@ void QDeclarativePolylineMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *
 
 QList<QGeoCoordinate> QDeclarativePolylineMapItem::path() const
 {
-    return m_geopath.path();
+    return geoPath().path();
 }
 
 void QDeclarativePolylineMapItem::setPath(const QList<QGeoCoordinate> &value)
@@ -874,23 +875,68 @@ void QDeclarativePolylineMapItem::setPath(const QList<QGeoCoordinate> &value)
 */
 void QDeclarativePolylineMapItem::setPath(const QGeoPath &path)
 {
-    if (m_geopath.path() == path.path())
+    if (geoPath().path() == path.path())
         return;
 
     m_geopath = QGeoPathEager(path);
+    pathEdited();
     m_d->onGeoGeometryChanged();
     emit pathChanged();
 }
 
+/*
+    Appends the web mercator projection of the path to projected.
+*/
+void QDeclarativePolylineMapItem::projectPath(const QGeoProjectionWebMercator &p,
+                                              QList<QDoubleVector2D> &projected) const
+{
+    for (const QGeoCoordinate &c : geoPath().path())
+        projected << p.geoToMapProjection(c);
+}
+
+/*
+    Returns the path, built first if the subclass defers it.
+*/
+const QGeoPath &QDeclarativePolylineMapItem::geoPath() const
+{
+    preparePath();
+    return m_geopath;
+}
+
+/*
+    Builds m_geopath if it was deferred, called before it is read or edited.
+*/
+void QDeclarativePolylineMapItem::preparePath() const
+{
+}
+
+/*
+    Called after m_geopath was edited in place.
+*/
+void QDeclarativePolylineMapItem::pathEdited()
+{
+}
+
+qsizetype QDeclarativePolylineMapItem::pathSize() const
+{
+    return m_geopath.size();
+}
+
+QGeoRectangle QDeclarativePolylineMapItem::pathBounds() const
+{
+    return m_geopath.boundingGeoRectangle();
+}
+
 /*!
     \internal
 */
 void QDeclarativePolylineMapItem::setPathFromGeoList(const QList<QGeoCoordinate> &path)
 {
-    if (m_geopath.path() == path)
+    if (geoPath().path() == path)
         return;
 
     m_geopath.setPath(path);
+    pathEdited();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -907,7 +953,7 @@ void QDeclarativePolylineMapItem::setPathFromGeoList(const QList<QGeoCoordinate>
 */
 int QDeclarativePolylineMapItem::pathLength() const
 {
-    return m_geopath.path().length();
+    return int(pathSize());
 }
 
 /*!
@@ -922,7 +968,9 @@ void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate
     if (!coordinate.isValid())
         return;
 
+    preparePath();
     m_geopath.addCoordinate(coordinate);
+    pathEdited();
 
     m_d->onGeoGeometryUpdated();
     emit pathChanged();
@@ -939,10 +987,12 @@ void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate
 */
 void QDeclarativePolylineMapItem::insertCoordinate(int index, const QGeoCoordinate &coordinate)
 {
-    if (index < 0 || index > m_geopath.path().length())
+    if (index < 0 || index > pathSize())
         return;
 
+    preparePath();
     m_geopath.insertCoordinate(index, coordinate);
+    pathEdited();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -960,10 +1010,12 @@ void QDeclarativePolylineMapItem::insertCoordinate(int index, const QGeoCoordina
 */
 void QDeclarativePolylineMapItem::replaceCoordinate(int index, const QGeoCoordinate &coordinate)
 {
-    if (index < 0 || index >= m_geopath.path().length())
+    if (index < 0 || index >= pathSize())
         return;
 
+    preparePath();
     m_geopath.replaceCoordinate(index, coordinate);
+    pathEdited();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -980,10 +1032,10 @@ void QDeclarativePolylineMapItem::replaceCoordinate(int index, const QGeoCoordin
 */
 QGeoCoordinate QDeclarativePolylineMapItem::coordinateAt(int index) const
 {
-    if (index < 0 || index >= m_geopath.path().length())
+    if (index < 0 || index >= pathSize())
         return QGeoCoordinate();
 
-    return m_geopath.coordinateAt(index);
+    return geoPath().coordinateAt(index);
 }
 
 /*!
@@ -995,7 +1047,7 @@ QGeoCoordinate QDeclarativePolylineMapItem::coordinateAt(int index) const
 */
 bool QDeclarativePolylineMapItem::containsCoordinate(const QGeoCoordinate &coordinate)
 {
-    return m_geopath.containsCoordinate(coordinate);
+    return geoPath().containsCoordinate(coordinate);
 }
 
 /*!
@@ -1010,10 +1062,12 @@ bool QDeclarativePolylineMapItem::containsCoordinate(const QGeoCoordinate &coord
 */
 void QDeclarativePolylineMapItem::removeCoordinate(const QGeoCoordinate &coordinate)
 {
+    preparePath();
     int length = m_geopath.path().length();
     m_geopath.removeCoordinate(coordinate);
     if (m_geopath.path().length() == length)
         return;
+    pathEdited();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -1032,10 +1086,12 @@ void QDeclarativePolylineMapItem::removeCoordinate(const QGeoCoordinate &coordin
 */
 void QDeclarativePolylineMapItem::removeCoordinate(int index)
 {
-    if (index < 0 || index >= m_geopath.path().length())
+    if (index < 0 || index >= pathSize())
         return;
 
+    preparePath();
     m_geopath.removeCoordinate(index);
+    pathEdited();
 
     m_d->onGeoGeometryChanged();
     emit pathChanged();
@@ -1111,7 +1167,7 @@ void QDeclarativePolylineMapItem::setBackend(QDeclarativePolylineMapItem::Backen
 */
 void QDeclarativePolylineMapItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
 {
-    if (newGeometry.topLeft() == oldGeometry.topLeft() || !map() || !m_geopath.isValid() || m_updatingGeometry) {
+    if (newGeometry.topLeft() == oldGeometry.topLeft() || !map() || !geoPath().isValid() || m_updatingGeometry) {
         QDeclarativeGeoMapItemBase::geometryChange(newGeometry, oldGeometry);
         return;
     }
@@ -1126,6 +1182,7 @@ void QDeclarativePolylineMapItem::geometryChange(const QRectF &newGeometry, cons
         return;
 
     m_geopath.translate(offsetLati, offsetLongi);
+    pathEdited();
     m_d->onGeoGeometryChanged();
     emit pathChanged();
 
@@ -1169,7 +1226,7 @@ bool QDeclarativePolylineMapItem::contains(const QPointF &point) const
 
 const QGeoShape &QDeclarativePolylineMapItem::geoShape() const
 {
-    return m_geopath;
+    return geoPath();
 }
 
 void QDeclarativePolylineMapItem::setGeoShape(const QGeoShape &shape)
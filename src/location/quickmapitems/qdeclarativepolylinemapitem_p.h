@@ -54,6 +54,7 @@
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
 #include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoRectangle>
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
@@ -63,6 +64,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QGeoProjectionWebMercator;
+
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeMapLineProperties : public QObject
 {
     Q_OBJECT
@@ -150,11 +153,19 @@ protected:
     void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void setPathFromGeoList(const QList<QGeoCoordinate> &path);
     void updatePolish() override;
+    virtual void projectPath(const QGeoProjectionWebMercator &p, QList<QDoubleVector2D> &projected) const;
+
+    // For subclasses building m_geopath only once it is read or edited
+    const QGeoPath &geoPath() const;
+    virtual void preparePath() const;
+    virtual void pathEdited();
+    virtual qsizetype pathSize() const;
+    virtual QGeoRectangle pathBounds() const;
 
 #ifdef QT_LOCATION_DEBUG
 public:
 #endif
-    QGeoPath m_geopath;
+    mutable QGeoPath m_geopath; // read through geoPath(), preparePath() before editing
     QDeclarativeMapLineProperties m_line;
 
     Backend m_backend = Software;
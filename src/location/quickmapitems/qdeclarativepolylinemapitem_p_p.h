@@ -187,7 +187,7 @@ public:
     void updateCache();
     void preserveGeometry()
     {
-        m_geometry.setPreserveGeometry(true, m_poly.m_geopath.boundingGeoRectangle().topLeft());
+        m_geometry.setPreserveGeometry(true, m_poly.pathBounds().topLeft());
     }
     void afterViewportChanged() override
     {
@@ -150,6 +150,10 @@ QDeclarativeRectangleMapItem::QDeclarativeRectangleMapItem(QQuickItem *parent)
     // ToDo: handle envvar, and switch implementation.
     m_itemType = QGeoMap::MapRectangle;
     setFlag(ItemHasContents, true);
+    QObject::connect(this, &QDeclarativeRectangleMapItem::topLeftChanged,
+                     this, &QDeclarativeGeoMapItemBase::geoShapeChanged);
+    QObject::connect(this, &QDeclarativeRectangleMapItem::bottomRightChanged,
+                     this, &QDeclarativeGeoMapItemBase::geoShapeChanged);
     QObject::connect(&m_border, &QDeclarativeMapLineProperties::colorChanged,
                      this, &QDeclarativeRectangleMapItem::onLinePropertiesChanged);
     QObject::connect(&m_border, &QDeclarativeMapLineProperties::widthChanged,
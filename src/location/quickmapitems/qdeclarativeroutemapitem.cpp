@@ -40,6 +40,9 @@
 
 #include "qdeclarativeroutemapitem_p.h"
 #include "qdeclarativepolylinemapitem_p.h"
+#include "qdeclarativepolylinemapitem_p_p.h"
+#include <QtLocation/private/qgeoroute_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
 
 #include <QtQml/QQmlInfo>
 #include <QtGui/QPainter>
@@ -122,14 +125,79 @@ void QDeclarativeRouteMapItem::setRoute(const QGeoRoute &route)
 
     route_ = route;
 
-    setPathFromGeoList(route_.path());
+    resetPath();
 
     emit routeChanged(route_);
 }
 
 void QDeclarativeRouteMapItem::updateRoutePath()
 {
-    setPathFromGeoList(route_.path());
+    resetPath();
+}
+
+/*
+    Makes the packed path of the route the path of the item. The list of
+    coordinates of m_geopath is only built if the path is read or edited,
+    drawing the route doesn't need it.
+*/
+void QDeclarativeRouteMapItem::resetPath()
+{
+    packedBounds_ = QGeoRoutePrivate::get(route_)->packedPath().boundingGeoRectangle();
+    packedPathValid_ = true;
+    pathDeferred_ = true;
+
+    m_d->onGeoGeometryChanged();
+    emit pathChanged();
+}
+
+void QDeclarativeRouteMapItem::preparePath() const
+{
+    if (!pathDeferred_)
+        return;
+    pathDeferred_ = false;
+    m_geopath.setPath(route_.path());
+}
+
+// Edited through the path methods of MapPolyline, the packed path is stale
+void QDeclarativeRouteMapItem::pathEdited()
+{
+    packedPathValid_ = false;
+    pathDeferred_ = false;
+}
+
+qsizetype QDeclarativeRouteMapItem::pathSize() const
+{
+    if (packedPathValid_)
+        return QGeoRoutePrivate::get(route_)->packedPath().size();
+    return QDeclarativePolylineMapItem::pathSize();
+}
+
+QGeoRectangle QDeclarativeRouteMapItem::pathBounds() const
+{
+    if (packedPathValid_)
+        return packedBounds_;
+    return QDeclarativePolylineMapItem::pathBounds();
+}
+
+/*
+    Projects the route straight from its packed path, instead of going
+    through a QGeoCoordinate per point.
+*/
+void QDeclarativeRouteMapItem::projectPath(const QGeoProjectionWebMercator &p,
+                                           QList<QDoubleVector2D> &projected) const
+{
+    if (!packedPathValid_) {
+        QDeclarativePolylineMapItem::projectPath(p, projected);
+        return;
+    }
+
+    const QGeoPackedPath &path = QGeoRoutePrivate::get(route_)->packedPath();
+    QGeoCoordinate coordinate(0.0, 0.0);
+    for (qsizetype i = 0; i < path.size(); ++i) {
+        coordinate.setLatitude(path.latitude(i));
+        coordinate.setLongitude(path.longitude(i));
+        projected << p.geoToMapProjection(coordinate);
+    }
 }
 
 /*!
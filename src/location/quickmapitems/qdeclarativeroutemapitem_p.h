@@ -84,9 +84,19 @@ private slots:
 
 protected:
     void setPath(const QList<QGeoCoordinate> &value) override;
+    void projectPath(const QGeoProjectionWebMercator &p, QList<QDoubleVector2D> &projected) const override;
+    void preparePath() const override;
+    void pathEdited() override;
+    qsizetype pathSize() const override;
+    QGeoRectangle pathBounds() const override;
 
 private:
+    void resetPath();
+
     QGeoRoute route_;
+    QGeoRectangle packedBounds_;
+    bool packedPathValid_ = false; // the path is still the packed path of route_
+    mutable bool pathDeferred_ = false; // m_geopath not built from it yet
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,309 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOMAPITEMINDEX_P_H
+#define QGEOMAPITEMINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QVarLengthArray>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoRectangle>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Spatial index over the geographic bounding boxes of map items.
+
+    This is a loose quadtree on longitude/latitude: a box is stored in the
+    deepest node whose cell is at least as large as the box and contains
+    its center, and every node is queried with its cell grown by half a
+    cell on each side. Boxes crossing the dateline are stored as two boxes.
+    Queries return the values in insertion order; updating the box of a
+    value keeps its position in that order.
+*/
+template <typename T>
+class QGeoMapItemIndex
+{
+public:
+    QGeoMapItemIndex()
+    {
+        clear();
+    }
+
+    void insert(const T &value, const QGeoRectangle &bounds)
+    {
+        quint64 sequence = m_nextSequence;
+        auto it = m_entries.find(value);
+        if (it != m_entries.end()) {
+            sequence = it->sequence;
+            removeBoxes(value, *it);
+        } else {
+            ++m_nextSequence;
+            it = m_entries.insert(value, Entry());
+        }
+        it->sequence = sequence;
+        it->nodes.clear();
+
+        QVarLengthArray<Box, 2> boxes;
+        toBoxes(bounds, &boxes);
+        for (const Box &box : qAsConst(boxes)) {
+            const int node = nodeFor(box);
+            m_nodes[node].values.append(Slot{value, box, sequence});
+            it->nodes.append(node);
+        }
+    }
+
+    bool remove(const T &value)
+    {
+        auto it = m_entries.find(value);
+        if (it == m_entries.end())
+            return false;
+        removeBoxes(value, *it);
+        m_entries.erase(it);
+        return true;
+    }
+
+    bool contains(const T &value) const
+    {
+        return m_entries.contains(value);
+    }
+
+    qsizetype size() const
+    {
+        return m_entries.size();
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+        m_nodes.clear();
+        m_nodes.append(Node());
+        m_nextSequence = 0;
+    }
+
+    QList<T> intersecting(const QGeoRectangle &rect) const
+    {
+        QVarLengthArray<Box, 2> boxes;
+        toBoxes(rect, &boxes);
+        return query(boxes);
+    }
+
+    QList<T> containing(const QGeoCoordinate &coordinate) const
+    {
+        QVarLengthArray<Box, 2> boxes;
+        if (coordinate.isValid()) {
+            const double x = coordinate.longitude();
+            const double y = coordinate.latitude();
+            boxes.append(Box{x, y, x, y});
+        }
+        return query(boxes);
+    }
+
+private:
+    enum { MaxDepth = 16 };
+
+    struct Box {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+
+        bool intersects(const Box &other) const
+        {
+            return minX <= other.maxX && other.minX <= maxX
+                    && minY <= other.maxY && other.minY <= maxY;
+        }
+    };
+
+    struct Slot {
+        T value;
+        Box box;
+        quint64 sequence;
+    };
+
+    struct Node {
+        int children[4] = { -1, -1, -1, -1 };
+        QList<Slot> values;
+    };
+
+    struct Entry {
+        quint64 sequence = 0;
+        QVarLengthArray<int, 2> nodes;
+    };
+
+    static void toBoxes(const QGeoRectangle &rect, QVarLengthArray<Box, 2> *boxes)
+    {
+        if (!rect.isValid())
+            return;
+        const double top = rect.topLeft().latitude();
+        const double bottom = rect.bottomRight().latitude();
+        const double left = rect.topLeft().longitude();
+        const double right = rect.bottomRight().longitude();
+        if (left <= right) {
+            boxes->append(Box{left, bottom, right, top});
+        } else {
+            // crossing the dateline
+            boxes->append(Box{left, bottom, 180.0, top});
+            boxes->append(Box{-180.0, bottom, right, top});
+        }
+    }
+
+    int nodeFor(const Box &box)
+    {
+        const double centerX = (box.minX + box.maxX) * 0.5;
+        const double centerY = (box.minY + box.maxY) * 0.5;
+        const double width = box.maxX - box.minX;
+        const double height = box.maxY - box.minY;
+
+        int node = 0;
+        double cellX = -180.0;
+        double cellY = -90.0;
+        double cellWidth = 360.0;
+        double cellHeight = 180.0;
+        for (int depth = 0; depth < MaxDepth; ++depth) {
+            cellWidth *= 0.5;
+            cellHeight *= 0.5;
+            if (width > cellWidth || height > cellHeight)
+                break;
+            const int column = centerX >= cellX + cellWidth ? 1 : 0;
+            const int row = centerY >= cellY + cellHeight ? 1 : 0;
+            cellX += column * cellWidth;
+            cellY += row * cellHeight;
+
+            const int quadrant = row * 2 + column;
+            int child = m_nodes.at(node).children[quadrant];
+            if (child < 0) {
+                child = int(m_nodes.size());
+                m_nodes.append(Node());
+                m_nodes[node].children[quadrant] = child;
+            }
+            node = child;
+        }
+        return node;
+    }
+
+    void removeBoxes(const T &value, const Entry &entry)
+    {
+        for (int node : entry.nodes) {
+            QList<Slot> &values = m_nodes[node].values;
+            for (qsizetype i = 0; i < values.size(); ++i) {
+                if (values.at(i).value == value) {
+                    values.remove(i);
+                    break;
+                }
+            }
+        }
+    }
+
+    QList<T> query(const QVarLengthArray<Box, 2> &boxes) const
+    {
+        QList<const Slot *> found;
+        struct Cell {
+            int node;
+            double x;
+            double y;
+            double width;
+            double height;
+        };
+        QVarLengthArray<Cell, 64> stack;
+        for (const Box &box : boxes) {
+            stack.append(Cell{0, -180.0, -90.0, 360.0, 180.0});
+            while (!stack.isEmpty()) {
+                const Cell cell = stack.takeLast();
+                const Node &node = m_nodes.at(cell.node);
+                for (const Slot &slot : node.values) {
+                    if (slot.box.intersects(box))
+                        found.append(&slot);
+                }
+                const double childWidth = cell.width * 0.5;
+                const double childHeight = cell.height * 0.5;
+                for (int quadrant = 0; quadrant < 4; ++quadrant) {
+                    const int child = node.children[quadrant];
+                    if (child < 0)
+                        continue;
+                    const double x = cell.x + (quadrant % 2) * childWidth;
+                    const double y = cell.y + (quadrant / 2) * childHeight;
+                    // loose bounds: the cell grown by half a cell on each side
+                    const Box loose{x - childWidth * 0.5, y - childHeight * 0.5,
+                                    x + childWidth * 1.5, y + childHeight * 1.5};
+                    if (loose.intersects(box))
+                        stack.append(Cell{child, x, y, childWidth, childHeight});
+                }
+            }
+        }
+
+        std::sort(found.begin(), found.end(), [](const Slot *a, const Slot *b) {
+            return a->sequence < b->sequence;
+        });
+        QList<T> res;
+        res.reserve(found.size());
+        const Slot *previous = nullptr;
+        for (const Slot *slot : qAsConst(found)) {
+            // values crossing the dateline may be found twice
+            if (!previous || previous->sequence != slot->sequence)
+                res.append(slot->value);
+            previous = slot;
+        }
+        return res;
+    }
+
+    QHash<T, Entry> m_entries;
+    QList<Node> m_nodes;
+    quint64 m_nextSequence = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPITEMINDEX_P_H
@@ -1832,6 +1832,11 @@ void QQuickGeoMapGestureArea::startFlick(int dx, int dy, int timeMs)
     m_flick.m_animation->setFrom(animationStartCoordinate);
     m_flick.m_animation->setTo(animationEndCoordinate);
     m_flick.m_animation->start();
+
+    // Let the map fetch what will be on screen at the end of the flick
+    QGeoCameraData target = m_map->cameraData();
+    target.setCenter(animationEndCoordinate);
+    m_map->prefetchCameraTarget(target, timeMs);
 }
 
 void QQuickGeoMapGestureArea::stopPan()
@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qdeclarativegeomaplinelayer_rhi_p.h"
+
+#include <QtQuick/private/qsgmaterialshader_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+
+QT_BEGIN_NAMESPACE
+
+MapLineLayerShader::MapLineLayerShader() : QSGMaterialShader(*new QSGMaterialShaderPrivate(this))
+{
+    // Same extrusion as MapPolylineShaderExtruded, with per-vertex style and wrapping
+    setShaderFileName(VertexStage, QLatin1String(":/location/quickmapitems/rhi/shaders/linelayer.vert.qsb"));
+    setShaderFileName(FragmentStage, QLatin1String(":/location/quickmapitems/rhi/shaders/linelayer.frag.qsb"));
+}
+
+bool MapLineLayerShader::updateUniformData(QSGMaterialShader::RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect)
+{
+    Q_ASSERT(oldEffect == nullptr || newEffect->type() == oldEffect->type());
+    MapLineLayerMaterial *newMaterial = static_cast<MapLineLayerMaterial *>(newEffect);
+
+    const QMatrix4x4 &geoProjection = newMaterial->geoProjection();
+    const QDoubleVector3D &center = newMaterial->center();
+
+    QVector4D vecCenter, vecCenter_lowpart;
+    for (int i = 0; i < 3; i++)
+        QLocationUtils::split_double(center.get(i), &vecCenter[i], &vecCenter_lowpart[i]);
+    vecCenter[3] = 0;
+    vecCenter_lowpart[3] = 0;
+
+    int offset = 0;
+    char *buf_p = state.uniformData()->data();
+
+    if (state.isMatrixDirty()) {
+        const QMatrix4x4 m = state.projectionMatrix();
+        memcpy(buf_p + offset, m.constData(), 4*4*4);
+    }
+    offset += 4*4*4;
+
+    memcpy(buf_p + offset, geoProjection.constData(), 4*4*4); offset+=4*4*4;
+
+    memcpy(buf_p + offset, &vecCenter, 4*4); offset += 4*4;
+
+    memcpy(buf_p + offset, &vecCenter_lowpart, 4*4); offset+=4*4;
+
+    if (state.isOpacityDirty()) {
+        const float opacity = state.opacity();
+        memcpy(buf_p + offset, &opacity, 4);
+    }
+    offset += 4;
+
+    const QRectF viewportRect = state.viewportRect();
+    const float aspect = float(viewportRect.width() / viewportRect.height());
+    memcpy(buf_p + offset, &aspect, 4); offset+=4;
+
+    return true;
+}
+
+QSGMaterialShader *MapLineLayerMaterial::createShader(QSGRendererInterface::RenderMode renderMode) const
+{
+    Q_UNUSED(renderMode);
+    return new MapLineLayerShader();
+}
+
+QSGMaterialType *MapLineLayerMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+int MapLineLayerMaterial::compare(const QSGMaterial *other) const
+{
+    const MapLineLayerMaterial &o = *static_cast<const MapLineLayerMaterial *>(other);
+    if (o.m_center == m_center && o.m_geoProjection == m_geoProjection)
+        return 0;
+    return -1;
+}
+
+MapLineLayerNode::MapLineLayerNode()
+: m_geometry(MapLineLayerNode::Entry::attributes(), 0)
+{
+    m_geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+    // Features are patched in place while the layout of the layer is unchanged
+    m_geometry.setVertexDataPattern(QSGGeometry::DynamicPattern);
+    QSGGeometryNode::setMaterial(&m_material);
+    QSGGeometryNode::setGeometry(&m_geometry);
+}
+
+MapLineLayerNode::~MapLineLayerNode()
+{
+
+}
+
+void MapLineLayerNode::updateMaterial(const QMatrix4x4 &geoProjection, const QDoubleVector3D &center)
+{
+    m_material.setGeoProjection(geoProjection);
+    m_material.setCenter(center);
+    markDirty(DirtyMaterial);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,183 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QDECLARATIVEGEOMAPLINELAYER_RHI_P_H
+#define QDECLARATIVEGEOMAPLINELAYER_RHI_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QSGMaterialShader>
+#include <QtQuick/QSGMaterial>
+#include <QtGui/QMatrix4x4>
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p_p.h>
+#include <QtLocation/private/qdeclarativegeomapitemutils_p.h>
+
+#include <QtPositioning/private/qdoublevector3d_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_LOCATION_PRIVATE_EXPORT MapLineLayerShader : public QSGMaterialShader
+{
+public:
+    MapLineLayerShader();
+
+    bool updateUniformData(RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect) override;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT MapLineLayerMaterial : public QSGMaterial
+{
+public:
+    MapLineLayerMaterial()
+    {
+        // Same as MapPolylineMaterial: the shader expects the vertex data
+        // to be in mercator space, so it must not be touched by the batch renderer.
+        setFlag(Blending | RequiresFullMatrix);
+    }
+
+    QSGMaterialShader *createShader(QSGRendererInterface::RenderMode renderMode) const override;
+    QSGMaterialType *type() const override;
+    int compare(const QSGMaterial *other) const override;
+
+    void setGeoProjection(const QMatrix4x4 &p)
+    {
+        m_geoProjection = p;
+    }
+
+    QMatrix4x4 geoProjection() const
+    {
+        return m_geoProjection;
+    }
+
+    void setCenter(const QDoubleVector3D &c)
+    {
+        m_center = c;
+    }
+
+    QDoubleVector3D center() const
+    {
+        return m_center;
+    }
+
+protected:
+    QMatrix4x4 m_geoProjection;
+    QDoubleVector3D m_center;
+};
+
+/*
+    All the features of a MapLineLayer are drawn by this single node.
+    The vertices are the extruded segments of MapPolylineNodeOpenGLExtruded,
+    with the style of the feature and the left bound of its path attached,
+    so that one draw call covers features of different color and width, and
+    the shader can pick the world copy of each feature on its own.
+*/
+class Q_LOCATION_PRIVATE_EXPORT MapLineLayerNode : public MapItemGeometryNode
+{
+public:
+    struct Entry {
+        QDeclarativeGeoMapItemUtils::vec2 pos;
+        QDeclarativeGeoMapItemUtils::vec2 prev;
+        QDeclarativeGeoMapItemUtils::vec2 next;
+        float direction;
+        float triangletype; // es2 does not support int attribs
+        float vertextype;
+        float lineWidth;
+        float leftBound; // mercator x of the left bound of the feature
+        uchar color[4]; // premultiplied rgba
+
+        static const QSGGeometry::AttributeSet &attributes()
+        {
+            static const QSGGeometry::Attribute data[] = {
+                QSGGeometry::Attribute::createWithAttributeType(0, 2,
+                   QSGGeometry::FloatType, QSGGeometry::PositionAttribute) // pos
+                ,QSGGeometry::Attribute::createWithAttributeType(1, 2,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute) // previous
+                ,QSGGeometry::Attribute::createWithAttributeType(2, 2,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute) // next
+                ,QSGGeometry::Attribute::createWithAttributeType(3, 1,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // direction
+                ,QSGGeometry::Attribute::createWithAttributeType(4, 1,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // triangletype
+                ,QSGGeometry::Attribute::createWithAttributeType(5, 1,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // vertextype
+                ,QSGGeometry::Attribute::createWithAttributeType(6, 1,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // lineWidth
+                ,QSGGeometry::Attribute::createWithAttributeType(7, 1,
+                   QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)  // leftBound
+                ,QSGGeometry::Attribute::createWithAttributeType(8, 4,
+                   QSGGeometry::UnsignedByteType, QSGGeometry::ColorAttribute) // color
+            };
+            static const QSGGeometry::AttributeSet attrs = {
+                9,
+                sizeof(Entry),
+                data
+            };
+            return attrs;
+        }
+    };
+
+    MapLineLayerNode();
+    ~MapLineLayerNode() override;
+
+    QSGGeometry *lineGeometry()
+    {
+        return &m_geometry;
+    }
+
+    void updateMaterial(const QMatrix4x4 &geoProjection, const QDoubleVector3D &center);
+
+protected:
+    MapLineLayerMaterial m_material;
+    QSGGeometry m_geometry;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDECLARATIVEGEOMAPLINELAYER_RHI_P_H
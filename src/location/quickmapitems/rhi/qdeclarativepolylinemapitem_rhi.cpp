@@ -64,7 +64,7 @@ void MapPolylineNodeOpenGLLineStrip::update(const QColor &fillColor,
                                    const QDoubleVector3D &center,
                                    const Qt::PenCapStyle /*capStyle*/)
 {
-    if (shape->m_screenVertices->size() < 2) {
+    if (shape->vertexCount() < 2) {
         setSubtreeBlocked(true);
         return;
     } else {
@@ -196,35 +196,42 @@ bool QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries(QSGGeometry *geom,
                                                            bool closed,
                                                            unsigned int zoom) const
 {
-    // Select LOD. Generate if not present. Assign it to m_screenVertices;
+    // Select LOD. Rank the vertices in the background if not done yet.
     if (m_dataChanged) {
         // it means that the data really changed.
-        // So synchronously produce LOD 1, and enqueue the requested one if != 0 or 1.
-        // Select 0 if 0 is requested, or 1 in all other cases.
+        // So select 0, and enqueue the ranking if another LOD is requested.
         selectLODOnDataChanged(zoom, m_bboxLeftBoundWrapped.x());
     } else {
         // Data has not changed, but active LOD != requested LOD.
-        // So, if there are no active tasks, try to change to the correct one.
+        // So, if the vertices are ranked, change to the correct one.
         if (!selectLODOnLODMismatch(zoom, m_bboxLeftBoundWrapped.x(), closed))
             return false;
     }
 
-    const QList<QDeclarativeGeoMapItemUtils::vec2> &v = *m_screenVertices;
-    if (v.size() < 2) {
+    // Walk the vertices of the active LOD, keeping the indices of the one
+    // before the segment, the segment ends and the one after it
+    const QList<QDeclarativeGeoMapItemUtils::vec2> &v = *m_vertices;
+    const qsizetype count = vertexCount();
+    if (count < 2) {
         geom->allocate(0, 0);
         return true;
     }
-    const int numSegments = (v.size() - 1);
+    const int numSegments = (count - 1);
 
     const int numIndices = numSegments * 6; // six vertices per line segment
     geom->allocate(numIndices);
     MapPolylineNodeOpenGLExtruded::MapPolylineEntry *vertices =
             static_cast<MapPolylineNodeOpenGLExtruded::MapPolylineEntry *>(geom->vertexData());
 
+    const qsizetype last = v.size() - 1;
+    qsizetype iPrev = -1;
+    qsizetype iCur = 0;
+    qsizetype iNext = nextVertex(iCur);
+    qsizetype iAfter = nextVertex(iNext);
     for (int i = 0; i < numSegments; ++i) {
         MapPolylineNodeOpenGLExtruded::MapPolylineEntry e;
-        const QDeclarativeGeoMapItemUtils::vec2 &cur = v[i];
-        const QDeclarativeGeoMapItemUtils::vec2 &next = v[i+1];
+        const QDeclarativeGeoMapItemUtils::vec2 &cur = v[iCur];
+        const QDeclarativeGeoMapItemUtils::vec2 &next = v[iNext];
         e.triangletype = 1.0;
         e.next = next;
         e.prev = cur;
@@ -249,23 +256,28 @@ bool QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries(QSGGeometry *geom,
         vertices[i*6+5] = e;
 
         if (i != 0) {
-           vertices[i*6].prev = vertices[i*6+1].prev = vertices[i*6+5].prev = v[i-1];
+           vertices[i*6].prev = vertices[i*6+1].prev = vertices[i*6+5].prev = v[iPrev];
         } else {
             if (closed) {
-                vertices[i*6].prev = vertices[i*6+1].prev = vertices[i*6+5].prev = v[numSegments - 1];
+                vertices[i*6].prev = vertices[i*6+1].prev = vertices[i*6+5].prev = v[previousVertex(last)];
             } else {
                 vertices[i*6].triangletype = vertices[i*6+1].triangletype = vertices[i*6+5].triangletype = 2.0;
             }
         }
         if (i != numSegments - 1) {
-            vertices[i*6+2].next = vertices[i*6+3].next = vertices[i*6+4].next = v[i+2];
+            vertices[i*6+2].next = vertices[i*6+3].next = vertices[i*6+4].next = v[iAfter];
         } else {
             if (closed) {
-                vertices[i*6+2].next = vertices[i*6+3].next = vertices[i*6+4].next = v[1];
+                vertices[i*6+2].next = vertices[i*6+3].next = vertices[i*6+4].next = v[nextVertex(0)];
             } else {
                 vertices[i*6+2].triangletype = vertices[i*6+3].triangletype = vertices[i*6+4].triangletype = 3.0;
             }
         }
+
+        iPrev = iCur;
+        iCur = iNext;
+        iNext = iAfter;
+        iAfter = nextVertex(iAfter);
     }
     return true;
 }
@@ -273,15 +285,15 @@ bool QGeoMapPolylineGeometryOpenGL::allocateAndFillEntries(QSGGeometry *geom,
 void QGeoMapPolylineGeometryOpenGL::allocateAndFillLineStrip(QSGGeometry *geom,
                                                              int lod) const
 {
-    // Select LOD. Generate if not present. Assign it to m_screenVertices;
+    // Uses the LOD selected by allocateAndFillEntries, if any
     Q_UNUSED(lod);
 
-    const QList<QDeclarativeGeoMapItemUtils::vec2> &vx = *m_screenVertices;
-    geom->allocate(vx.size());
+    const QList<QDeclarativeGeoMapItemUtils::vec2> &vx = *m_vertices;
+    geom->allocate(vertexCount());
 
     QSGGeometry::Point2D *pts = geom->vertexDataAsPoint2D();
-    for (qsizetype i = 0; i < vx.size(); ++i)
-        pts[i].set(vx[i].x, vx[i].y);
+    for (qsizetype i = 0; i < vx.size(); i = nextVertex(i))
+        (pts++)->set(vx[i].x, vx[i].y);
 }
 
 void MapPolylineNodeOpenGLExtruded::update(const QColor &fillColor,
@@ -294,7 +306,7 @@ void MapPolylineNodeOpenGLExtruded::update(const QColor &fillColor,
                                    unsigned int zoom)
 {
     // shape->size() == number of triangles
-    if (shape->m_screenVertices->size() < 2
+    if (shape->vertexCount() < 2
             || lineWidth < 0.5 || fillColor.alpha() == 0) { // number of points
         setSubtreeBlocked(true);
         return;
@@ -424,7 +436,7 @@ bool QDeclarativePolylineMapItemPrivateOpenGLLineStrip::contains(const QPointF &
 
 void QDeclarativePolylineMapItemPrivateOpenGLLineStrip::updatePolish()
 {
-    if (m_poly.m_geopath.path().length() == 0) { // Possibly cleared
+    if (m_poly.pathSize() == 0) { // Possibly cleared
         m_geometry.clear();
         m_geometry.clear();
         m_poly.setWidth(0);
@@ -435,7 +447,7 @@ void QDeclarativePolylineMapItemPrivateOpenGLLineStrip::updatePolish()
     QScopedValueRollback<bool> rollback(m_poly.m_updatingGeometry);
     m_poly.m_updatingGeometry = true;
     const qreal lineWidth = m_poly.m_line.width();
-    m_geometry.updateSourcePoints(*m_poly.map(), m_poly.m_geopath);
+    m_geometry.updateSourcePoints(*m_poly.map(), m_poly.geoPath());
     m_geometry.markScreenDirty();
     m_geometry.updateScreenPoints(*m_poly.map(), lineWidth);
 
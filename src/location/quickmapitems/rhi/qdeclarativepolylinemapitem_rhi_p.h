@@ -256,6 +256,10 @@ public:
     QDeclarativePolylineMapItemPrivateOpenGLLineStrip(QDeclarativePolylineMapItem &poly)
         : QDeclarativePolylineMapItemPrivate(poly)
     {
+        // LODs are simplified in the background, repolish when one arrives
+        m_geometry.setLODReadyCallback([this]() {
+            m_poly.polishAndUpdate();
+        });
     }
 
     ~QDeclarativePolylineMapItemPrivateOpenGLLineStrip() override;
@@ -270,7 +274,7 @@ public:
     }
     void preserveGeometry()
     {
-        m_geometry.setPreserveGeometry(true, m_poly.m_geopath.boundingGeoRectangle().topLeft());
+        m_geometry.setPreserveGeometry(true, m_poly.pathBounds().topLeft());
     }
     void onMapSet() override
     {
@@ -41,6 +41,9 @@
 
 #include <QThreadPool>
 #include <QRunnable>
+#include <QThread>
+#include <QMutex>
+#include <QCoreApplication>
 
 #include <QtQuick/QSGGeometry>
 #include <QtPositioning/private/qwebmercator_p.h>
@@ -57,6 +60,7 @@
 /* poly2tri triangulator includes */
 #include <earcut.hpp>
 #include <array>
+#include <numeric>
 
 QT_BEGIN_NAMESPACE
 
@@ -65,176 +69,238 @@ QT_BEGIN_NAMESPACE
     Implementation of QGeoMapItemLODGeometry
 */
 
-struct ThreadPool // to have a thread pool with max 1 thread for geometry processing
+/* Simplification state shared between a geometry and the tasks working for
+   it. The request fields are protected by the mutex, the rest is only used in
+   the GUI thread. */
+struct QGeoMapItemLODState
 {
-    ThreadPool ()
-    {
-        m_threadPool.setMaxThreadCount(1);
-    }
+    QMutex mutex;
+    QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> input;
+    double leftBound = 0;
+    int generation = 0; // bumped whenever the source vertices change
+    bool queued = false;
+    int working = 0;
+
+    QGeoMapItemLODGeometry *geometry = nullptr;
+    std::function<void()> lodReady;
+};
 
-    void start(QRunnable *runnable, int priority = 0)
+struct LODThreadPool
+{
+    LODThreadPool()
     {
-        m_threadPool.start(runnable, priority);
+        m_threadPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
     }
 
     QThreadPool m_threadPool;
 };
 
-Q_GLOBAL_STATIC(ThreadPool, threadPool)
+Q_GLOBAL_STATIC(LODThreadPool, lodThreadPool)
 
+/* Ranks the vertices of a geometry by the zoom level from which they are kept.
+   At most one task per geometry waits in the pool, and it works on the latest
+   vertices by the time it starts. */
 class PolylineSimplifyTask : public QRunnable
 {
 public:
-    PolylineSimplifyTask(const QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>
-                                 &input, // reference as it gets copied in the nested call
-                         const QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> &output,
-                         double leftBound, unsigned int zoom, QSharedPointer<unsigned int> &working)
-        : m_zoom(zoom), m_leftBound(leftBound), m_input(input), m_output(output), m_working(working)
+    explicit PolylineSimplifyTask(const QSharedPointer<QGeoMapItemLODState> &state)
+        : m_state(state)
     {
-        Q_ASSERT(!input.isNull());
-        Q_ASSERT(!output.isNull());
     }
 
     void run() override
     {
-        // Skip sending notifications for now. Updated data will be picked up eventually.
-        // ToDo: figure out how to connect a signal from here to a slot in the item.
-        *m_working = QGeoMapItemLODGeometry::zoomToLOD(m_zoom);
-        const QList<QDeclarativeGeoMapItemUtils::vec2> res =
-                QGeoMapItemLODGeometry::getSimplified(
-                        *m_input, m_leftBound, QGeoMapItemLODGeometry::zoomForLOD(m_zoom));
-        *m_output = res;
-        *m_working = 0;
+        QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> input;
+        double leftBound;
+        int generation;
+        {
+            QMutexLocker locker(&m_state->mutex);
+            m_state->queued = false;
+            ++m_state->working;
+            input = m_state->input;
+            leftBound = m_state->leftBound;
+            generation = m_state->generation;
+        }
+
+        const QList<quint8> zoomLevels = QGeoSimplify::geoSimplifyZoomLevels(
+                *input, leftBound, QGeoMapItemLODGeometry::zoomForLOD(20));
+
+        // The geometry may be gone by the time this arrives, the state is not
+        const QSharedPointer<QGeoMapItemLODState> state = m_state;
+        QMetaObject::invokeMethod(QCoreApplication::instance(),
+                                  [state, generation, zoomLevels]() {
+            {
+                QMutexLocker locker(&state->mutex);
+                --state->working;
+                if (generation != state->generation)
+                    return;
+            }
+            QGeoMapItemLODGeometry *geometry = state->geometry;
+            if (!geometry)
+                return;
+            geometry->setVertexZoomLevels(zoomLevels);
+            if (state->lodReady)
+                state->lodReady();
+        }, Qt::QueuedConnection);
     }
 
-    unsigned int m_zoom;
-    double m_leftBound;
-    QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> m_input, m_output;
-    QSharedPointer<unsigned int> m_working;
+    QSharedPointer<QGeoMapItemLODState> m_state;
 };
 
 
 QGeoMapItemLODGeometry::QGeoMapItemLODGeometry()
+    : m_lodState(new QGeoMapItemLODState)
 {
+    m_lodState->geometry = this;
     resetLOD();
 }
 
+QGeoMapItemLODGeometry::~QGeoMapItemLODGeometry()
+{
+    m_lodState->geometry = nullptr;
+    m_lodState->lodReady = nullptr;
+}
+
 void QGeoMapItemLODGeometry::resetLOD()
 {
-    // New pointer, some old LOD task might still be running and operating on the old pointers.
-    m_verticesLOD[0] = QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>(
+    // New pointer, some old LOD task might still be running and operating on the old pointer.
+    m_vertices = QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>(
             new QList<QDeclarativeGeoMapItemUtils::vec2>);
-    for (unsigned int i = 1; i < m_verticesLOD.size(); ++i)
-        m_verticesLOD[i] = nullptr; // allocate on first use
-    m_screenVertices = m_verticesLOD.front().data(); // resetting pointer to data to be LOD 0
+    m_vertexZoomLevels.clear();
+    m_lodVertexCount.fill(0);
+    m_lod = 0;
+
+    // Results of tasks still running for the old vertices are dropped
+    QMutexLocker locker(&m_lodState->mutex);
+    ++m_lodState->generation;
 }
 
-QList<QDeclarativeGeoMapItemUtils::vec2> QGeoMapItemLODGeometry::getSimplified(
-        QList<QDeclarativeGeoMapItemUtils::vec2>
-                &wrappedPath, // reference as it gets copied in the nested call
-        double leftBoundWrapped, unsigned int zoom)
+/*!
+    \internal
+    Sets the \a callback invoked in the GUI thread whenever the LODs computed in
+    the background become available, so that the item can polish and pick them up.
+*/
+void QGeoMapItemLODGeometry::setLODReadyCallback(const std::function<void()> &callback)
 {
-    // Try a simplify step
-    QList<QDoubleVector2D> data;
-    for (auto e: wrappedPath)
-        data << e.toDoubleVector2D();
-    const QList<QDoubleVector2D> simplified = QGeoSimplify::geoSimplifyZL(data,
-                                                                leftBoundWrapped,
-                                                                zoom);
+    m_lodState->lodReady = callback;
+}
 
-    data.clear();
-    QList<QDeclarativeGeoMapItemUtils::vec2> simple;
-    for (auto e: simplified)
-        simple << e;
-    return simple;
+void QGeoMapItemLODGeometry::setSimplificationThreadCount(int count)
+{
+    lodThreadPool->m_threadPool.setMaxThreadCount(qMax(1, count));
 }
 
-bool QGeoMapItemLODGeometry::isLODActive(unsigned int lod) const
+int QGeoMapItemLODGeometry::simplificationThreadCount()
 {
-    return m_screenVertices == m_verticesLOD[zoomToLOD(lod)].data();
+    return lodThreadPool->m_threadPool.maxThreadCount();
+}
+
+void QGeoMapItemLODGeometry::setVertexZoomLevels(const QList<quint8> &zoomLevels)
+{
+    Q_ASSERT(zoomLevels.size() == m_vertices->size());
+    m_vertexZoomLevels = zoomLevels;
+
+    // Vertex count of every LOD, from how many vertices appear at each zoom level
+    std::array<qsizetype, 32> perZoomLevel;
+    perZoomLevel.fill(0);
+    for (quint8 zoomLevel : zoomLevels)
+        ++perZoomLevel[qMin<size_t>(zoomLevel, perZoomLevel.size() - 1)];
+    m_lodVertexCount[0] = zoomLevels.size();
+    for (unsigned int lod = 1; lod < m_lodVertexCount.size(); ++lod) {
+        const unsigned int zoom = lodZoomLevel(lod);
+        m_lodVertexCount[lod] = std::accumulate(perZoomLevel.begin(),
+                                                perZoomLevel.begin() + zoom + 1, qsizetype(0));
+    }
+}
+
+unsigned int QGeoMapItemLODGeometry::lodZoomLevel(unsigned int lod)
+{
+    return zoomForLOD(lod * 3);
+}
+
+qsizetype QGeoMapItemLODGeometry::vertexCount() const
+{
+    return m_lod ? m_lodVertexCount[m_lod] : m_vertices->size();
+}
+
+qsizetype QGeoMapItemLODGeometry::nextVertex(qsizetype index) const
+{
+    const qsizetype size = m_vertices->size();
+    if (!m_lod)
+        return qMin(index + 1, size);
+    const unsigned int zoom = lodZoomLevel(m_lod);
+    do {
+        ++index;
+    } while (index < size && m_vertexZoomLevels.at(index) > zoom);
+    return index;
+}
+
+qsizetype QGeoMapItemLODGeometry::previousVertex(qsizetype index) const
+{
+    if (!m_lod)
+        return qMax<qsizetype>(index - 1, -1);
+    const unsigned int zoom = lodZoomLevel(m_lod);
+    do {
+        --index;
+    } while (index >= 0 && m_vertexZoomLevels.at(index) > zoom);
+    return index;
+}
+
+bool QGeoMapItemLODGeometry::isLODActive(unsigned int zoom) const
+{
+    return m_lod == zoomToLOD(zoom);
+}
+
+bool QGeoMapItemLODGeometry::isLODPending() const
+{
+    QMutexLocker locker(&m_lodState->mutex);
+    return m_lodState->queued || m_lodState->working > 0;
 }
 
 bool QGeoMapItemLODGeometry::selectLODOnLODMismatch(unsigned int zoom, double leftBound,
                                                     bool closed) const
 {
-    if (*m_working > 0)
+    // Keep what is shown until the vertex ranks arrive and polish the item
+    if (zoomToLOD(zoom) > 0 && m_vertexZoomLevels.isEmpty()) {
+        if (!isLODPending())
+            enqueueSimplificationTask(leftBound);
         return false;
+    }
     const_cast<QGeoMapItemLODGeometry *>(this)->selectLOD(zoom, leftBound, closed);
     return true;
 }
 
-void QGeoMapItemLODGeometry::enqueueSimplificationTask(
-        const QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> &input,
-        const QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> &output, double leftBound,
-        unsigned int zoom, QSharedPointer<unsigned int> &working)
+void QGeoMapItemLODGeometry::enqueueSimplificationTask(double leftBound) const
 {
-    Q_ASSERT(!input.isNull());
-    Q_ASSERT(!output.isNull());
-    PolylineSimplifyTask *task = new PolylineSimplifyTask(input,
-                                                          output,
-                                                          leftBound,
-                                                          zoom,
-                                                          working);
-    threadPool->start(task);
+    if (m_vertices->size() <= 2)
+        return; // nothing to simplify, never more than LOD 0
+    {
+        QMutexLocker locker(&m_lodState->mutex);
+        m_lodState->input = m_vertices;
+        m_lodState->leftBound = leftBound;
+        if (m_lodState->queued)
+            return; // the waiting task picks up this request instead
+        m_lodState->queued = true;
+    }
+    lodThreadPool->m_threadPool.start(new PolylineSimplifyTask(m_lodState));
 }
 
 void QGeoMapItemLODGeometry::selectLOD(unsigned int zoom, double leftBound, bool /* closed */) // closed to tell if this is a polygon or a polyline.
 {
-    unsigned int requestedLod = zoomToLOD(zoom);
-    if (!m_verticesLOD[requestedLod].isNull()) {
-        m_screenVertices = m_verticesLOD[requestedLod].data();
-    } else if (!m_verticesLOD.at(0)->isEmpty()) {
-        // if here, zoomToLOD != 0 and no current working task.
-        // So select the last filled LOD != m_working (lower-bounded by 1,
-        // guaranteed to exist), and enqueue the right one
-        m_verticesLOD[requestedLod] = QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>(
-                new QList<QDeclarativeGeoMapItemUtils::vec2>);
-
-        for (unsigned int i = requestedLod - 1; i >= 1; i--) {
-            if (*m_working != i && !m_verticesLOD[i].isNull()) {
-                m_screenVertices = m_verticesLOD[i].data();
-                break;
-            } else if (i == 1) {
-                // get 1 synchronously if not computed already
-                m_verticesLOD[1] = QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>(
-                        new QList<QDeclarativeGeoMapItemUtils::vec2>);
-                *m_verticesLOD[1] = getSimplified(*m_verticesLOD[0], leftBound, zoomForLOD(0));
-                if (requestedLod == 1)
-                    return;
-            }
-        }
-
-        enqueueSimplificationTask(m_verticesLOD.at(0),
-                                  m_verticesLOD[requestedLod],
-                                  leftBound,
-                                  zoom,
-                                  m_working);
-
-    }
+    const unsigned int requestedLod = zoomToLOD(zoom);
+    if (requestedLod == 0 || !m_vertexZoomLevels.isEmpty())
+        m_lod = requestedLod;
+    else
+        enqueueSimplificationTask(leftBound);
 }
 
 void QGeoMapItemLODGeometry::selectLODOnDataChanged(unsigned int zoom, double leftBound) const
 {
-    unsigned int lod = zoomToLOD(zoom);
-    if (lod > 0) {
-        // Generate ZL 1 as fallback for all cases != 0. Do not do if 0 is requested
-        // (= old behavior, LOD disabled)
-        m_verticesLOD[1] = QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>(
-                new QList<QDeclarativeGeoMapItemUtils::vec2>);
-        *m_verticesLOD[1] = getSimplified( *m_verticesLOD[0], leftBound, zoomForLOD(0));
-    }
-    if (lod > 1) {
-        if (!m_verticesLOD[lod]) {
-            m_verticesLOD[lod] = QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>(
-                    new QList<QDeclarativeGeoMapItemUtils::vec2>);
-        }
-        enqueueSimplificationTask(m_verticesLOD.at(0),
-                                  m_verticesLOD[lod],
-                                  leftBound,
-                                  zoom,
-                                  m_working);
-    }
-    m_screenVertices = m_verticesLOD[qMin<unsigned int>(lod, 1)].data(); // return only 0,1 synchronously
+    // The full path is shown until the vertex ranks are available. Do not compute
+    // them if 0 is requested (= old behavior, LOD disabled)
+    m_lod = 0;
+    if (zoomToLOD(zoom) > 0 && m_vertexZoomLevels.isEmpty())
+        enqueueSimplificationTask(leftBound);
 }
 
 unsigned int QGeoMapItemLODGeometry::zoomToLOD(unsigned int zoom)
@@ -595,7 +661,7 @@ void QGeoMapPolylineGeometryOpenGL::updateSourcePoints(const QGeoProjectionWebMe
     // New pointers, some old LOD task might still be running and operating on the old pointers.
     resetLOD();
 
-    for (const auto &v: qAsConst(wrappedPath)) m_screenVertices->append(v);
+    for (const auto &v: qAsConst(wrappedPath)) m_vertices->append(v);
 
     m_wrappedPolygons.resize(3);
     m_wrappedPolygons[0].wrappedBboxes = wrappedBboxMinus1;
@@ -696,12 +762,13 @@ bool QGeoMapPolylineGeometryOpenGL::contains(const QPointF &point, qreal lineWid
 {
     const double lineHalfWidth = lineWidth * 0.5;
     const QDoubleVector2D pt(point);
+    const QList<QDeclarativeGeoMapItemUtils::vec2> &vertices = *m_vertices;
     QDoubleVector2D a;
-    if (m_screenVertices->size())
-        a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(m_screenVertices->first().toDoubleVector2D()));
+    if (vertices.size())
+        a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(vertices.first().toDoubleVector2D()));
     QDoubleVector2D b;
-    for (qsizetype i = 1; i < m_screenVertices->size(); ++i) {
-        const auto &screenVertice = m_screenVertices->at(i);
+    for (qsizetype i = nextVertex(0); i < vertices.size(); i = nextVertex(i)) {
+        const auto &screenVertice = vertices.at(i);
         if (!a.isFinite()) {
             a = p.wrappedMapProjectionToItemPosition(p.wrapMapProjection(screenVertice.toDoubleVector2D()));
             continue;
@@ -54,6 +54,7 @@
 #include <QtCore/QList>
 #include <QtCore/QSharedPointer>
 #include <QtGui/QColor>
+#include <functional>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtLocation/private/qdeclarativegeomapitemutils_p.h>
 #include <QtLocation/private/qgeomapitemgeometry_p.h>
@@ -68,39 +69,50 @@ class QGeoPath;
 class QGeoPolygon;
 class QGeoProjectionWebMercator;
 class QGeoRectangle;
+struct QGeoMapItemLODState;
 
-class QGeoMapItemLODGeometry
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemLODGeometry
 {
     Q_DISABLE_COPY(QGeoMapItemLODGeometry);
 public:
-    mutable std::array<QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>, 7>
-            m_verticesLOD; // fix it to 7,
-                           // do not allow simplifications beyond ZL 20. This could actually be
-                           // limited even further
-    mutable QList<QDeclarativeGeoMapItemUtils::vec2> *m_screenVertices;
-    mutable QSharedPointer<unsigned int> m_working;
+    // All vertices in path order. A LOD is not a copy of them, but the subset
+    // whose entry in m_vertexZoomLevels does not exceed the zoom level of the LOD.
+    QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> m_vertices;
+    QList<quint8> m_vertexZoomLevels; // empty until computed in the background
+    std::array<qsizetype, 7> m_lodVertexCount; // fix it to 7,
+                                               // do not allow simplifications beyond ZL 20.
+                                               // This could actually be limited even further
+    mutable unsigned int m_lod = 0;
+    QSharedPointer<QGeoMapItemLODState> m_lodState;
 
     QGeoMapItemLODGeometry();
+    ~QGeoMapItemLODGeometry();
 
     void resetLOD();
+    void setLODReadyCallback(const std::function<void()> &callback);
+    void setVertexZoomLevels(const QList<quint8> &zoomLevels);
+
+    static void setSimplificationThreadCount(int count);
+    static int simplificationThreadCount();
 
     static unsigned int zoomToLOD(unsigned int zoom);
 
     static unsigned int zoomForLOD(unsigned int zoom);
 
-    bool isLODActive(unsigned int lod) const;
+    static unsigned int lodZoomLevel(unsigned int lod);
 
-    void selectLOD(unsigned int zoom, double leftBound, bool /*closed*/);
+    // Vertices of the active LOD: their count, and walking through them
+    // by index into m_vertices. Past the ends these return size() and -1.
+    qsizetype vertexCount() const;
+    qsizetype nextVertex(qsizetype index) const;
+    qsizetype previousVertex(qsizetype index) const;
+
+    bool isLODActive(unsigned int zoom) const;
+    bool isLODPending() const;
 
-    static QList<QDeclarativeGeoMapItemUtils::vec2>
-    getSimplified(QList<QDeclarativeGeoMapItemUtils::vec2> &wrappedPath, double leftBoundWrapped,
-                  unsigned int zoom);
+    void selectLOD(unsigned int zoom, double leftBound, bool /*closed*/);
 
-    static void enqueueSimplificationTask(
-            const QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>>
-                    &input, // reference as it gets copied in the nested call
-            const QSharedPointer<QList<QDeclarativeGeoMapItemUtils::vec2>> &output,
-            double leftBound, unsigned int zoom, QSharedPointer<unsigned int> &working);
+    void enqueueSimplificationTask(double leftBound) const;
 
     void selectLODOnDataChanged(unsigned int zoom, double leftBound) const;
     bool selectLODOnLODMismatch(unsigned int zoom, double leftBound, bool closed) const;
@@ -114,10 +126,7 @@ public:
         QList<QDoubleVector2D> wrappedBboxes;
     } WrappedPolyline;
 
-    QGeoMapPolylineGeometryOpenGL()
-    {
-        m_working = QSharedPointer<unsigned int>(new unsigned int(0));
-    }
+    QGeoMapPolylineGeometryOpenGL() = default;
 
     void updateSourcePoints(const QGeoMap &map,
                             const QGeoPolygon &poly);
@@ -46,6 +46,7 @@
 #include <QtPositioning/private/qlocationutils_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QVarLengthArray>
 
 QT_BEGIN_NAMESPACE
 
@@ -105,61 +106,78 @@ double pixelDistanceAtZoomAndLatitude(int zoom, double latitude)
     return pixelDist;
 }
 
-// simplification using Ramer-Douglas-Peucker algorithm
-void simplifyDouglasPeuckerStepZL(const QList<QDoubleVector2D> &points, double leftBound,
-                                  qsizetype first, qsizetype last, int zoomLevel,
-                                  QList<QDoubleVector2D> &simplified)
+double toleranceAtZoom(int zoom, const QGeoCoordinate &first, const QGeoCoordinate &last)
 {
-    const QGeoCoordinate firstC = unwrappedToGeo(points.at(first), leftBound);
-    const QGeoCoordinate lastC = unwrappedToGeo(points.at(last), leftBound);
-    double maxDistanceFound = (pixelDistanceAtZoomAndLatitude(zoomLevel, firstC.latitude())
-                             + pixelDistanceAtZoomAndLatitude(zoomLevel, lastC.latitude())) * 0.5;
-    qsizetype index = -1;
-
-    const auto &firstPoint = points.at(first);
-    const auto &lastPoint = points.at(last);
-    for (qsizetype i = first + 1; i < last; i++) {
-        const double distance = getSegDist(points.at(i),
-                                           firstPoint,
-                                           lastPoint,
-                                           leftBound);
-
-        if (distance > maxDistanceFound) {
-            index = i;
-            maxDistanceFound = distance;
-        }
-    }
-
-    if (index > 0) {
-        if (index - first > 1) {
-            simplifyDouglasPeuckerStepZL(points, leftBound,
-                                         first, index, zoomLevel,
-                                         simplified);
-        }
-        simplified.append(points.at(index));
-        if (last - index > 1) {
-            simplifyDouglasPeuckerStepZL(points, leftBound,
-                                         index, last, zoomLevel,
-                                         simplified);
-        }
-    }
+    return (pixelDistanceAtZoomAndLatitude(zoom, first.latitude())
+          + pixelDistanceAtZoomAndLatitude(zoom, last.latitude())) * 0.5;
 }
 
 } // anonymous namespace
 
 namespace  QGeoSimplify {
 
-QList<QDoubleVector2D> geoSimplifyZL(const QList<QDoubleVector2D> &points,
-                                     double leftBound, int zoomLevel)
+/*
+    The point splitting a range is the one farthest from the segment between
+    its ends, whatever the zoom level. Only whether it is far enough depends on
+    the zoom level, and it has to be kept at the zoom level of the split above
+    it too. So the recursion of the Ramer-Douglas-Peucker algorithm is done once,
+    recording the zoom level from which each point is kept.
+*/
+QList<quint8> geoSimplifyZoomLevels(const QList<QDeclarativeGeoMapItemUtils::vec2> &points,
+                                    double leftBound, int maxZoomLevel)
 {
     if (points.size() <= 2)
-        return points;
+        return QList<quint8>(points.size(), 0);
 
+    QList<quint8> zoomLevels(points.size(), quint8(maxZoomLevel + 1));
     const qsizetype last = points.size() - 1;
-    QList<QDoubleVector2D> simplified { points.first() };
-    simplifyDouglasPeuckerStepZL(points, leftBound, 0, last, zoomLevel, simplified);
-    simplified.append(points.at(last));
-    return simplified;
+    zoomLevels[0] = 0;
+    zoomLevels[last] = 0;
+
+    struct Range {
+        qsizetype first;
+        qsizetype last;
+        int zoomLevel;
+    };
+    QVarLengthArray<Range, 64> ranges;
+    ranges.append({ 0, last, 0 });
+    while (!ranges.isEmpty()) {
+        const Range range = ranges.takeLast();
+        const QDoubleVector2D firstPoint = points.at(range.first).toDoubleVector2D();
+        const QDoubleVector2D lastPoint = points.at(range.last).toDoubleVector2D();
+
+        double maxDistanceFound = 0.0;
+        qsizetype index = -1;
+        for (qsizetype i = range.first + 1; i < range.last; i++) {
+            const double distance = getSegDist(points.at(i).toDoubleVector2D(),
+                                               firstPoint,
+                                               lastPoint,
+                                               leftBound);
+            if (distance > maxDistanceFound) {
+                index = i;
+                maxDistanceFound = distance;
+            }
+        }
+        if (index < 0)
+            continue;
+
+        const QGeoCoordinate firstC = unwrappedToGeo(firstPoint, leftBound);
+        const QGeoCoordinate lastC = unwrappedToGeo(lastPoint, leftBound);
+        int zoomLevel = range.zoomLevel;
+        while (zoomLevel <= maxZoomLevel
+               && maxDistanceFound <= toleranceAtZoom(zoomLevel, firstC, lastC)) {
+            ++zoomLevel;
+        }
+        if (zoomLevel > maxZoomLevel)
+            continue; // Neither this point nor the ones it would split for are ever kept
+
+        zoomLevels[index] = quint8(zoomLevel);
+        if (index - range.first > 1)
+            ranges.append({ range.first, index, zoomLevel });
+        if (range.last - index > 1)
+            ranges.append({ index, range.last, zoomLevel });
+    }
+    return zoomLevels;
 }
 
 }
@@ -55,19 +55,20 @@
 //
 
 #include <QtCore/QList>
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qdeclarativegeomapitemutils_p.h>
 
 QT_BEGIN_NAMESPACE
 
-class QDoubleVector2D;
-
 namespace QGeoSimplify
 {
-    // offsetTolerance - how far outside the straight line a point
-    //                   needs to be for it to be "kept"
-    // This function tries to be adaptive in the offsetTolerance across latitudes,
-    // and return a simplification adequate for the given zoomLevel.
-    QList<QDoubleVector2D> geoSimplifyZL(const QList<QDoubleVector2D> &points,
-                                         double leftBound, int zoomLevel); // in meters
+    // Ramer-Douglas-Peucker simplification for every zoom level at once.
+    // The tolerance at a zoom level is one pixel, adapted to the latitude.
+    // Returns, for each point, the lowest zoom level up to maxZoomLevel at
+    // which the point is kept, or maxZoomLevel + 1 if it never is. The points
+    // kept at a zoom level are those whose entry is not larger than it.
+    Q_LOCATION_PRIVATE_EXPORT QList<quint8> geoSimplifyZoomLevels(const QList<QDeclarativeGeoMapItemUtils::vec2> &points,
+                                                                  double leftBound, int maxZoomLevel = 20);
 }
 
 QT_END_NAMESPACE
@@ -45,6 +45,7 @@
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtLocation/private/qgeotiledmap_p.h>
 #include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotilepackstorage_p.h>
 
 #include <QFileInfo>
 #include <QDir>
@@ -128,6 +129,13 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
     if (parameters.contains(kParamToken))
         tileFetcher->setToken(parameters.value(kParamToken).toString());
 
+    if (parameters.contains(QStringLiteral("esri.mapping.max_concurrent_requests"))) {
+        bool ok = false;
+        const int count = parameters.value(QStringLiteral("esri.mapping.max_concurrent_requests")).toInt(&ok);
+        if (ok && count > 0)
+            tileFetcher->setMaxConcurrentRequests(count);
+    }
+
     setTileFetcher(tileFetcher);
 
     /* TILE CACHE */
@@ -159,6 +167,12 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
             tileCache->setMaxDiskUsage(cacheSize);
     }
 
+    if (parameters.contains(QStringLiteral("esri.mapping.cache.disk.storage"))) {
+        QString storage = parameters.value(QStringLiteral("esri.mapping.cache.disk.storage")).toString().toLower();
+        if (storage == QLatin1String("pack"))
+            tileCache->setDiskStorage(new QGeoTilePackStorage);
+    }
+
     /*
      * Memory cache setup -- defaults to ByteSize (old behavior)
      */
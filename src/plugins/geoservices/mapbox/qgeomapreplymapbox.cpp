@@ -68,6 +68,16 @@ void QGeoMapReplyMapbox::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError)
         return;
 
+    setValidators(QGeoTileValidators::fromHeaders(reply->rawHeader("ETag"),
+                                                  reply->rawHeader("Last-Modified"),
+                                                  reply->rawHeader("Cache-Control"),
+                                                  reply->rawHeader("Expires")));
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        setNotModified(true);
+        setFinished(true);
+        return;
+    }
+
     setMapImageData(reply->readAll());
     setMapImageFormat(m_format);
     setFinished(true);
@@ -81,11 +81,16 @@ void QGeoRouteReplyMapbox::networkReplyFinished()
     QGeoRoutingManagerEngineMapbox *engine = qobject_cast<QGeoRoutingManagerEngineMapbox *>(parent());
     const QGeoRouteParser *parser = engine->routeParser();
 
-    QList<QGeoRoute> routes;
-    QString errorString;
+    m_routeReply = reply->readAll();
+    QGeoRouteParserJob *job = parser->parseReplyAsync(m_routeReply);
+    connect(job, &QGeoRouteParserJob::finished, this, &QGeoRouteReplyMapbox::parserFinished);
+    connect(this, &QGeoRouteReply::aborted, job, [this, job]() { job->disconnect(this); });
+}
 
-    QByteArray routeReply = reply->readAll();
-    QGeoRouteReply::Error error = parser->parseReply(routes, errorString, routeReply);
+void QGeoRouteReplyMapbox::parserFinished(QGeoRouteReply::Error error, const QString &errorString,
+                                          const QList<QGeoRoute> &parsedRoutes)
+{
+    QList<QGeoRoute> routes = parsedRoutes;
     // Setting the request into the result
     for (QGeoRoute &route : routes) {
         route.setRequest(request());
@@ -95,7 +100,7 @@ void QGeoRouteReplyMapbox::networkReplyFinished()
     }
 
     QVariantMap metadata;
-    metadata["osrm.reply-json"] = routeReply;
+    metadata["osrm.reply-json"] = m_routeReply;
 
     QVariantMap extAttr;
     extAttr["engine"] = "mapbox";
@@ -57,6 +57,10 @@ public:
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
+    void parserFinished(QGeoRouteReply::Error error, const QString &errorString, const QList<QGeoRoute> &routes);
+
+private:
+    QByteArray m_routeReply;
 };
 
 QT_END_NAMESPACE
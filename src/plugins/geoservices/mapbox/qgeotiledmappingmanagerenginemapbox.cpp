@@ -43,6 +43,7 @@
 #include <QtLocation/private/qgeocameracapabilities_p.h>
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtLocation/private/qgeotiledmap_p.h>
+#include <QtLocation/private/qgeotilepackstorage_p.h>
 #include "qgeofiletilecachemapbox.h"
 typedef QGeoTiledMap Map;
 
@@ -148,6 +149,14 @@ QGeoTiledMappingManagerEngineMapbox::QGeoTiledMappingManagerEngineMapbox(const Q
         const QString token = parameters.value(QStringLiteral("mapbox.access_token")).toString();
         tileFetcher->setAccessToken(token);
     }
+    if (parameters.contains(QStringLiteral("mapbox.mapping.max_concurrent_requests"))) {
+        bool ok = false;
+        const int count = parameters.value(QStringLiteral("mapbox.mapping.max_concurrent_requests")).toInt(&ok);
+        if (ok && count > 0)
+            tileFetcher->setMaxConcurrentRequests(count);
+    }
+    if (parameters.contains(QStringLiteral("mapbox.mapping.http2")))
+        tileFetcher->setHttp2Enabled(parameters.value(QStringLiteral("mapbox.mapping.http2")).toBool());
 
     setTileFetcher(tileFetcher);
 
@@ -189,6 +198,12 @@ QGeoTiledMappingManagerEngineMapbox::QGeoTiledMappingManagerEngineMapbox(const Q
             tileCache->setMaxDiskUsage(6000); // The maximum allowed with the free tier
     }
 
+    if (parameters.contains(QStringLiteral("mapbox.mapping.cache.disk.storage"))) {
+        QString storage = parameters.value(QStringLiteral("mapbox.mapping.cache.disk.storage")).toString().toLower();
+        if (storage == QLatin1String("pack"))
+            tileCache->setDiskStorage(new QGeoTilePackStorage);
+    }
+
     /*
      * Memory cache setup -- defaults to ByteSize (old behavior)
      */
@@ -87,10 +87,24 @@ void QGeoTileFetcherMapbox::setAccessToken(const QString &accessToken)
     m_accessToken = accessToken;
 }
 
+// With HTTP/2 the tile requests share a single connection
+void QGeoTileFetcherMapbox::setHttp2Enabled(bool enabled)
+{
+    m_http2 = enabled;
+}
+
 QGeoTiledMapReply *QGeoTileFetcherMapbox::getTileImage(const QGeoTileSpec &spec)
 {
     QNetworkRequest request;
     request.setRawHeader("User-Agent", m_userAgent);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, m_http2);
+
+    // Refreshing a stale tile: the server answers 304 if it did not change
+    const QGeoTileValidators validators = tileValidators(spec);
+    if (!validators.etag.isEmpty())
+        request.setRawHeader("If-None-Match", validators.etag);
+    if (!validators.lastModified.isEmpty())
+        request.setRawHeader("If-Modified-Since", validators.lastModified);
 
     request.setUrl(QUrl(mapboxTilesApiPath +
                         ((spec.mapId() >= m_mapIds.size()) ? QStringLiteral("mapbox.streets") : m_mapIds[spec.mapId() - 1]) + QLatin1Char('/') +
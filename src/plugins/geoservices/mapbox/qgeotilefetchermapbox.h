@@ -59,6 +59,7 @@ public:
     void setMapIds(const QList<QString> &mapIds);
     void setFormat(const QString &format);
     void setAccessToken(const QString &accessToken);
+    void setHttp2Enabled(bool enabled);
 
 private:
     QGeoTiledMapReply *getTileImage(const QGeoTileSpec &spec) override;
@@ -70,6 +71,7 @@ private:
     QString m_accessToken;
     QList<QString> m_mapIds;
     int m_scaleFactor;
+    bool m_http2 = true;
 };
 
 QT_END_NAMESPACE
@@ -230,8 +230,9 @@ void QGeoMapMaplibreGLPrivate::addMapItem(QDeclarativeGeoMapItemBase *item)
     }
 
     QObject::connect(item, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged, q, &QGeoMapMaplibreGL::onMapItemPropertyChanged);
+    QObject::connect(item, &QQuickItem::zChanged, q, &QGeoMapMaplibreGL::onMapItemPropertyChanged);
 
-    m_styleChanges << QMaplibreGLStyleChange::addMapItem(item, m_mapItemsBefore);
+    m_managedItems.insert(item);
 
     emit q->sgNodeChanged();
 }
@@ -261,7 +262,7 @@ void QGeoMapMaplibreGLPrivate::removeMapItem(QDeclarativeGeoMapItemBase *item)
 
     q->disconnect(item);
 
-    m_styleChanges << QMaplibreGLStyleChange::removeMapItem(item);
+    m_managedItems.remove(item);
 
     emit q->sgNodeChanged();
 }
@@ -311,6 +312,9 @@ QRectF QGeoMapMaplibreGLPrivate::visibleArea() const
 
 void QGeoMapMaplibreGLPrivate::syncStyleChanges(QMapLibreGL::Map *map)
 {
+    // Map items are flushed after the queued map parameter changes
+    m_styleChanges << m_managedItems.takeChanges(m_mapItemsBefore);
+
     for (const auto& change : m_styleChanges) {
         change->apply(map);
     }
@@ -408,8 +412,7 @@ void QGeoMapMaplibreGL::onMapChanged(QMapLibreGL::Map::MapChange change)
         d->m_styleLoaded = false;
         d->m_styleChanges.clear();
 
-        for (QDeclarativeGeoMapItemBase *item : d->m_mapItems)
-            d->m_styleChanges << QMaplibreGLStyleChange::addMapItem(item, d->m_mapItemsBefore);
+        d->m_managedItems.resetStyle();
     }
 }
 
@@ -418,8 +421,7 @@ void QGeoMapMaplibreGL::onMapItemPropertyChanged()
     Q_D(QGeoMapMaplibreGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
-    d->m_styleChanges << QMaplibreGLStyleSetPaintProperty::fromMapItem(item);
-    d->m_styleChanges << QMaplibreGLStyleSetLayoutProperty::fromMapItem(item);
+    d->m_managedItems.updateProperties(item);
 
     emit sgNodeChanged();
 }
@@ -429,7 +431,7 @@ void QGeoMapMaplibreGL::onMapItemSubPropertyChanged()
     Q_D(QGeoMapMaplibreGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender()->parent());
-    d->m_styleChanges << QMaplibreGLStyleSetPaintProperty::fromMapItem(item);
+    d->m_managedItems.updateProperties(item);
 
     emit sgNodeChanged();
 }
@@ -445,7 +447,7 @@ void QGeoMapMaplibreGL::onMapItemGeometryChanged()
     Q_D(QGeoMapMaplibreGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
-    d->m_styleChanges << QMaplibreGLStyleAddSource::fromMapItem(item);
+    d->m_managedItems.updateGeometry(item);
 
     emit sgNodeChanged();
 }
@@ -49,10 +49,11 @@
 #include <QtCore/QRectF>
 #include <QtLocation/private/qgeomap_p_p.h>
 
+#include "qmaplibreglstylechange_p.h"
+
 namespace QMapLibreGL {
 class Map;
 }
-class QMaplibreGLStyleChange;
 
 class QGeoMapMaplibreGLPrivate : public QGeoMapPrivate
 {
@@ -93,6 +94,7 @@ public:
     SyncStates m_syncState = NoSync;
 
     QList<QSharedPointer<QMaplibreGLStyleChange>> m_styleChanges;
+    QMaplibreGLItemPool m_managedItems;
 
 protected:
     void changeViewportSize(const QSize &size) override;
@@ -147,6 +147,14 @@ QGeoMappingManagerEngineMaplibreGL::QGeoMappingManagerEngineMaplibreGL(const QVa
             m_settings.setCacheDatabaseMaximumSize(cacheSize);
     }
 
+    if (parameters.contains(QStringLiteral("maplibregl.mapping.cache.tiles.memory_size"))) {
+        bool ok = false;
+        int tileCacheSize = parameters.value(QStringLiteral("maplibregl.mapping.cache.tiles.memory_size")).toString().toInt(&ok);
+
+        if (ok && tileCacheSize >= 0)
+            m_settings.setTileCacheMaximumSize(tileCacheSize);
+    }
+
     if (parameters.contains(QStringLiteral("maplibregl.mapping.use_fbo"))) {
         m_useFBO = parameters.value(QStringLiteral("maplibregl.mapping.use_fbo")).toBool();
     }
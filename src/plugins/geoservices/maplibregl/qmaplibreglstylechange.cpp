@@ -43,11 +43,14 @@
 #include <QtCore/QMetaProperty>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStringList>
+#include <QtGui/QColor>
 #include <QtPositioning/QGeoPath>
 #include <QtPositioning/QGeoPolygon>
 #include <QtQml/QJSValue>
 #include <QtLocation/private/qdeclarativecirclemapitem_p_p.h>
 
+#include <algorithm>
+
 namespace {
 
 QString getId(QDeclarativeGeoMapItemBase *mapItem)
@@ -174,187 +177,405 @@ QMapLibreGL::Feature featureFromMapItem(QDeclarativeGeoMapItemBase *item)
 } // namespace
 
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleChange::addMapItem(QDeclarativeGeoMapItemBase *item, const QString &before)
-{
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
+// QMaplibreGLItemPool
+
+// Items re-sent together when one of them changes, at most
+static const qsizetype MaxGroupItems = 64;
 
+bool QMaplibreGLItemPool::isManaged(QDeclarativeGeoMapItemBase *item)
+{
     switch (item->itemType()) {
     case QGeoMap::MapRectangle:
     case QGeoMap::MapCircle:
     case QGeoMap::MapPolygon:
     case QGeoMap::MapPolyline:
-        break;
+        return true;
     default:
-        qWarning() << "Unsupported QGeoMap item type: " << item->itemType();
-        return changes;
+        return false;
     }
+}
 
-    QMapLibreGL::Feature feature = featureFromMapItem(item);
+QMaplibreGLItemPool::Kind QMaplibreGLItemPool::kindOf(QDeclarativeGeoMapItemBase *item)
+{
+    return item->itemType() == QGeoMap::MapPolyline ? Lines : Fills;
+}
 
-    changes << QMaplibreGLStyleAddLayer::fromFeature(feature, before);
-    changes << QMaplibreGLStyleAddSource::fromFeature(feature);
-    changes << QMaplibreGLStyleSetPaintProperty::fromMapItem(item);
-    changes << QMaplibreGLStyleSetLayoutProperty::fromMapItem(item);
+void QMaplibreGLItemPool::insert(QDeclarativeGeoMapItemBase *item)
+{
+    if (m_keys.contains(item))
+        return;
 
-    return changes;
+    const quint64 key = m_nextKey++;
+    Entry &entry = m_entries[key];
+    entry.feature = featureFromMapItem(item);
+    entry.kind = kindOf(item);
+    updateEntry(entry, item);
+    m_keys.insert(item, key);
+    place(key);
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleChange::removeMapItem(QDeclarativeGeoMapItemBase *item)
+void QMaplibreGLItemPool::remove(QDeclarativeGeoMapItemBase *item)
 {
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
+    const auto it = m_keys.constFind(item);
+    if (it == m_keys.constEnd())
+        return;
 
-    const QString id = getId(item);
+    unplace(*it);
+    m_entries.remove(*it);
+    m_keys.erase(it);
+}
 
-    changes << QSharedPointer<QMaplibreGLStyleChange>(new QMaplibreGLStyleRemoveLayer(id));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(new QMaplibreGLStyleRemoveSource(id));
+void QMaplibreGLItemPool::updateGeometry(QDeclarativeGeoMapItemBase *item)
+{
+    const auto it = m_keys.constFind(item);
+    if (it == m_keys.constEnd())
+        return;
 
-    return changes;
+    Entry &entry = m_entries[*it];
+    const QMapLibreGL::Feature feature = featureFromMapItem(item);
+    entry.feature.type = feature.type;
+    entry.feature.geometry = feature.geometry;
+    m_groups[groupOf(*it)].dirty = true;
+    m_dirty = true;
 }
 
-// QMaplibreGLStyleSetLayoutProperty
-
-void QMaplibreGLStyleSetLayoutProperty::apply(QMapLibreGL::Map *map)
+void QMaplibreGLItemPool::updateProperties(QDeclarativeGeoMapItemBase *item)
 {
-    map->setLayoutProperty(m_layer, m_property, m_value);
+    const auto it = m_keys.constFind(item);
+    if (it == m_keys.constEnd())
+        return;
+
+    Entry &entry = m_entries[*it];
+    const qreal z = entry.z;
+    updateEntry(entry, item);
+    if (entry.z != z) {
+        // Taken out of the group of its old z, then placed by its new one
+        const qreal newZ = entry.z;
+        entry.z = z;
+        unplace(*it);
+        m_entries[*it].z = newZ;
+        place(*it);
+        return;
+    }
+    m_groups[groupOf(*it)].dirty = true;
+    m_dirty = true;
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetLayoutProperty::fromMapItem(QDeclarativeGeoMapItemBase *item)
+// Whether the item lhs is drawn below the item rhs
+bool QMaplibreGLItemPool::precedes(quint64 lhs, quint64 rhs) const
 {
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
+    const qreal lhsZ = m_entries.constFind(lhs)->z;
+    const qreal rhsZ = m_entries.constFind(rhs)->z;
+    return lhsZ < rhsZ || (lhsZ == rhsZ && lhs < rhs);
+}
 
-    switch (item->itemType()) {
-    case QGeoMap::MapPolyline:
-        changes = fromMapItem(static_cast<QDeclarativePolylineMapItem *>(item));
-    default:
-        break;
+// Adds the item to the group it belongs to, splitting a group if it falls inside one of another run
+void QMaplibreGLItemPool::place(quint64 key)
+{
+    const Entry &entry = *m_entries.constFind(key);
+    const auto byDrawingOrder = [this](quint64 lhs, quint64 rhs) { return precedes(lhs, rhs); };
+    m_dirty = true;
+
+    // The last group starting below the item
+    qsizetype index = m_groups.size() - 1;
+    while (index >= 0 && !precedes(m_groups.at(index).keys.first(), key))
+        --index;
+
+    if (index >= 0) {
+        Group &group = m_groups[index];
+        const auto position = std::upper_bound(group.keys.begin(), group.keys.end(), key, byDrawingOrder);
+        if (group.kind == entry.kind && group.z == entry.z) {
+            group.keys.insert(position, key);
+            group.dirty = true;
+            m_keyGroups.insert(key, group.id);
+            if (group.keys.size() > MaxGroupItems)
+                splitGroup(index, group.keys.size() / 2);
+            return;
+        }
+        if (position != group.keys.end())
+            splitGroup(index, position - group.keys.begin());
     }
 
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetLayoutProperty(getId(item), QStringLiteral("visibility"),
-            item->isVisible() ? QStringLiteral("visible") : QStringLiteral("none")));
+    const qsizetype next = index + 1;
+    if (next < m_groups.size()) {
+        Group &group = m_groups[next];
+        if (group.kind == entry.kind && group.z == entry.z && group.keys.size() < MaxGroupItems) {
+            group.keys.prepend(key);
+            group.dirty = true;
+            m_keyGroups.insert(key, group.id);
+            return;
+        }
+    }
 
-    return changes;
+    Group group;
+    group.id = newGroupId();
+    group.kind = entry.kind;
+    group.z = entry.z;
+    group.keys.append(key);
+    insertGroup(next, group);
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetLayoutProperty::fromMapItem(QDeclarativePolylineMapItem *item)
+// Removes the item from its group, merging the groups around it if they become one run
+void QMaplibreGLItemPool::unplace(quint64 key)
 {
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
-    changes.reserve(2);
-
-    const QString id = getId(item);
-
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetLayoutProperty(id, QStringLiteral("line-cap"), QStringLiteral("square")));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetLayoutProperty(id, QStringLiteral("line-join"), QStringLiteral("bevel")));
-
-    return changes;
+    const qsizetype index = groupOf(key);
+    m_keyGroups.remove(key);
+    Group &group = m_groups[index];
+    group.keys.removeOne(key);
+    group.dirty = true;
+    m_dirty = true;
+    if (!group.keys.isEmpty())
+        return;
+
+    removeGroup(index);
+    if (index == 0 || index == m_groups.size())
+        return;
+    Group &below = m_groups[index - 1];
+    const Group &above = m_groups.at(index);
+    if (below.kind != above.kind || below.z != above.z
+            || below.keys.size() + above.keys.size() > MaxGroupItems) {
+        return;
+    }
+    for (quint64 aboveKey : above.keys)
+        m_keyGroups.insert(aboveKey, below.id);
+    below.keys.append(above.keys);
+    below.dirty = true;
+    removeGroup(index);
 }
 
-QMaplibreGLStyleSetLayoutProperty::QMaplibreGLStyleSetLayoutProperty(const QString& layer, const QString& property, const QVariant &value)
-    : m_layer(layer), m_property(property), m_value(value)
+qsizetype QMaplibreGLItemPool::groupOf(quint64 key) const
 {
+    const qsizetype index = m_groupIndexes.value(m_keyGroups.value(key), -1);
+    Q_ASSERT(index >= 0 && m_groups.at(index).keys.contains(key));
+    return index;
 }
 
-// QMaplibreGLStyleSetPaintProperty
-
-QMaplibreGLStyleSetPaintProperty::QMaplibreGLStyleSetPaintProperty(const QString& layer, const QString& property, const QVariant &value)
-    : m_layer(layer), m_property(property), m_value(value)
+// Moves the items from at on to a new group right above
+void QMaplibreGLItemPool::splitGroup(qsizetype index, qsizetype at)
 {
+    Group &group = m_groups[index];
+    Group upper;
+    upper.id = newGroupId();
+    upper.kind = group.kind;
+    upper.z = group.z;
+    upper.keys = group.keys.mid(at);
+    group.keys.resize(at);
+    group.dirty = true;
+    for (quint64 key : qAsConst(upper.keys))
+        m_keyGroups.insert(key, upper.id);
+    insertGroup(index + 1, upper);
+}
+
+// The indexes of the groups above the one inserted or removed change too
+void QMaplibreGLItemPool::insertGroup(qsizetype index, const Group &group)
+{
+    m_groups.insert(index, group);
+    for (qsizetype i = index; i < m_groups.size(); ++i)
+        m_groupIndexes.insert(m_groups.at(i).id, i);
 }
 
-void QMaplibreGLStyleSetPaintProperty::apply(QMapLibreGL::Map *map)
+void QMaplibreGLItemPool::removeGroup(qsizetype index)
 {
-    map->setPaintProperty(m_layer, m_property, m_value);
+    m_groupIndexes.remove(m_groups.at(index).id);
+    m_groups.removeAt(index);
+    for (qsizetype i = index; i < m_groups.size(); ++i)
+        m_groupIndexes.insert(m_groups.at(i).id, i);
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetPaintProperty::fromMapItem(QDeclarativeGeoMapItemBase *item)
+QString QMaplibreGLItemPool::newGroupId()
 {
-    switch (item->itemType()) {
-    case QGeoMap::MapRectangle:
-        return fromMapItem(static_cast<QDeclarativeRectangleMapItem *>(item));
-    case QGeoMap::MapCircle:
-        return fromMapItem(static_cast<QDeclarativeCircleMapItem *>(item));
-    case QGeoMap::MapPolygon:
-        return fromMapItem(static_cast<QDeclarativePolygonMapItem *>(item));
-    case QGeoMap::MapPolyline:
-        return fromMapItem(static_cast<QDeclarativePolylineMapItem *>(item));
-    default:
-        qWarning() << "Unsupported QGeoMap item type: " << item->itemType();
-        return QList<QSharedPointer<QMaplibreGLStyleChange>>();
-    }
+    return QStringLiteral("QtLocation-items-") + QString::number(m_nextGroup++);
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetPaintProperty::fromMapItem(QDeclarativeRectangleMapItem *item)
+QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLItemPool::takeChanges(const QString &before)
 {
     QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
-    changes.reserve(3);
-
-    const QString id = getId(item);
+    if (!m_dirty)
+        return changes;
 
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-opacity"), item->color().alphaF() * item->mapItemOpacity()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-color"), item->color()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-outline-color"), item->border()->color()));
+    QSet<QString> groups;
+    groups.reserve(m_groups.size());
+    for (const Group &group : qAsConst(m_groups))
+        groups.insert(group.id);
+
+    // Groups emptied, or merged into the one below
+    for (const QString &id : qAsConst(m_styleGroups)) {
+        if (groups.contains(id))
+            continue;
+        changes << QSharedPointer<QMaplibreGLStyleChange>(new QMaplibreGLStyleRemoveLayer(id));
+        changes << QSharedPointer<QMaplibreGLStyleChange>(new QMaplibreGLStyleRemoveSource(id));
+    }
+    m_styleGroups.intersect(groups);
+
+    // From the top, so that a new layer goes below the one of the group above it
+    QString above = before;
+    for (auto group = m_groups.rbegin(), end = m_groups.rend(); group != end; ++group) {
+        const bool added = m_styleGroups.contains(group->id);
+        if (group->dirty || !added) {
+            QList<QMapLibreGL::Feature> features;
+            features.reserve(group->keys.size());
+            for (quint64 key : qAsConst(group->keys)) {
+                const Entry &entry = *m_entries.constFind(key);
+                if (entry.visible)
+                    features.append(entry.feature);
+            }
+            // The source goes first, the layer refers to it
+            changes << QMaplibreGLStyleAddSource::fromFeatures(group->id, features);
+        }
+        if (!added) {
+            changes << QSharedPointer<QMaplibreGLStyleChange>(new QMaplibreGLStyleAddLayer(layerParams(*group), above));
+            m_styleGroups.insert(group->id);
+        }
+        group->dirty = false;
+        above = group->id;
+    }
 
+    m_dirty = false;
     return changes;
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetPaintProperty::fromMapItem(QDeclarativeCircleMapItem *item)
+void QMaplibreGLItemPool::resetStyle()
 {
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
-    changes.reserve(3);
+    m_styleGroups.clear();
+    m_dirty = !m_groups.isEmpty();
+}
 
-    const QString id = getId(item);
+QList<QList<QDeclarativeGeoMapItemBase *>> QMaplibreGLItemPool::groupItems() const
+{
+    QHash<quint64, QDeclarativeGeoMapItemBase *> items;
+    items.reserve(m_keys.size());
+    for (auto it = m_keys.cbegin(), end = m_keys.cend(); it != end; ++it)
+        items.insert(it.value(), it.key());
+
+    QList<QList<QDeclarativeGeoMapItemBase *>> groups;
+    groups.reserve(m_groups.size());
+    for (const Group &group : m_groups) {
+        QList<QDeclarativeGeoMapItemBase *> groupItems;
+        groupItems.reserve(group.keys.size());
+        for (quint64 key : group.keys)
+            groupItems.append(items.value(key));
+        groups.append(groupItems);
+    }
+    return groups;
+}
 
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-opacity"), item->color().alphaF() * item->mapItemOpacity()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-color"), item->color()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-outline-color"), item->border()->color()));
+static QVariantList featureProperty(const char *name)
+{
+    return QVariantList { QStringLiteral("get"), QString::fromLatin1(name) };
+}
 
-    return changes;
+static QVariantList featureColor(const char *name)
+{
+    return QVariantList { QStringLiteral("to-color"), featureProperty(name) };
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetPaintProperty::fromMapItem(QDeclarativePolygonMapItem *item)
+QVariantMap QMaplibreGLItemPool::layerParams(const Group &group)
 {
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
-    changes.reserve(3);
+    QVariantMap params;
+    params[QStringLiteral("id")] = group.id;
+    params[QStringLiteral("source")] = group.id;
+
+    QVariantMap layout;
+    QVariantMap paint;
+    if (group.kind == Lines) {
+        params[QStringLiteral("type")] = QStringLiteral("line");
+        layout[QStringLiteral("line-cap")] = QStringLiteral("square");
+        layout[QStringLiteral("line-join")] = QStringLiteral("bevel");
+        paint[QStringLiteral("line-color")] = featureColor("color");
+        paint[QStringLiteral("line-opacity")] = featureProperty("opacity");
+        paint[QStringLiteral("line-width")] = featureProperty("width");
+    } else {
+        params[QStringLiteral("type")] = QStringLiteral("fill");
+        paint[QStringLiteral("fill-color")] = featureColor("color");
+        paint[QStringLiteral("fill-opacity")] = featureProperty("opacity");
+        paint[QStringLiteral("fill-outline-color")] = featureColor("outline-color");
+    }
+    params[QStringLiteral("layout")] = layout;
+    params[QStringLiteral("paint")] = paint;
+
+    return params;
+}
 
-    const QString id = getId(item);
+// Same format the style conversions use for a QColor
+static QString colorString(const QColor &color)
+{
+    return QString::asprintf("rgba(%d,%d,%d,%lf)", color.red(), color.green(), color.blue(), color.alphaF());
+}
 
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-opacity"), item->color().alphaF() * item->mapItemOpacity()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-color"), item->color()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("fill-outline-color"), item->border()->color()));
+// The feature properties are the ones the layer of the pool reads
+void QMaplibreGLItemPool::updateEntry(Entry &entry, QDeclarativeGeoMapItemBase *item)
+{
+    QVariantMap properties;
 
-    return changes;
+    switch (item->itemType()) {
+    case QGeoMap::MapRectangle: {
+        QDeclarativeRectangleMapItem *rectangle = static_cast<QDeclarativeRectangleMapItem *>(item);
+        properties[QStringLiteral("color")] = colorString(rectangle->color());
+        properties[QStringLiteral("opacity")] = rectangle->color().alphaF() * item->mapItemOpacity();
+        properties[QStringLiteral("outline-color")] = colorString(rectangle->border()->color());
+        break;
+    }
+    case QGeoMap::MapCircle: {
+        QDeclarativeCircleMapItem *circle = static_cast<QDeclarativeCircleMapItem *>(item);
+        properties[QStringLiteral("color")] = colorString(circle->color());
+        properties[QStringLiteral("opacity")] = circle->color().alphaF() * item->mapItemOpacity();
+        properties[QStringLiteral("outline-color")] = colorString(circle->border()->color());
+        break;
+    }
+    case QGeoMap::MapPolygon: {
+        QDeclarativePolygonMapItem *polygon = static_cast<QDeclarativePolygonMapItem *>(item);
+        properties[QStringLiteral("color")] = colorString(polygon->color());
+        properties[QStringLiteral("opacity")] = polygon->color().alphaF() * item->mapItemOpacity();
+        properties[QStringLiteral("outline-color")] = colorString(polygon->border()->color());
+        break;
+    }
+    case QGeoMap::MapPolyline: {
+        QDeclarativePolylineMapItem *polyline = static_cast<QDeclarativePolylineMapItem *>(item);
+        properties[QStringLiteral("color")] = colorString(polyline->line()->color());
+        properties[QStringLiteral("opacity")] = polyline->line()->color().alphaF() * item->mapItemOpacity();
+        properties[QStringLiteral("width")] = double(polyline->line()->width());
+        break;
+    }
+    default:
+        break;
+    }
+
+    entry.feature.properties = properties;
+    entry.z = item->z();
+    entry.visible = item->isVisible();
 }
 
-QList<QSharedPointer<QMaplibreGLStyleChange>> QMaplibreGLStyleSetPaintProperty::fromMapItem(QDeclarativePolylineMapItem *item)
+// QMaplibreGLStyleSetLayoutProperty
+
+void QMaplibreGLStyleSetLayoutProperty::apply(QMapLibreGL::Map *map)
 {
-    QList<QSharedPointer<QMaplibreGLStyleChange>> changes;
-    changes.reserve(3);
+    map->setLayoutProperty(m_layer, m_property, m_value);
+}
 
-    const QString id = getId(item);
+QMaplibreGLStyleSetLayoutProperty::QMaplibreGLStyleSetLayoutProperty(const QString& layer, const QString& property, const QVariant &value)
+    : m_layer(layer), m_property(property), m_value(value)
+{
+}
 
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("line-opacity"), item->line()->color().alphaF() * item->mapItemOpacity()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("line-color"), item->line()->color()));
-    changes << QSharedPointer<QMaplibreGLStyleChange>(
-        new QMaplibreGLStyleSetPaintProperty(id, QStringLiteral("line-width"), item->line()->width()));
+// QMaplibreGLStyleSetPaintProperty
 
-    return changes;
+QMaplibreGLStyleSetPaintProperty::QMaplibreGLStyleSetPaintProperty(const QString& layer, const QString& property, const QVariant &value)
+    : m_layer(layer), m_property(property), m_value(value)
+{
+}
+
+void QMaplibreGLStyleSetPaintProperty::apply(QMapLibreGL::Map *map)
+{
+    map->setPaintProperty(m_layer, m_property, m_value);
 }
 
 // QMaplibreGLStyleAddLayer
 
+QMaplibreGLStyleAddLayer::QMaplibreGLStyleAddLayer(const QVariantMap &params, const QString &before)
+    : m_params(params), m_before(before)
+{
+}
+
 void QMaplibreGLStyleAddLayer::apply(QMapLibreGL::Map *map)
 {
     map->addLayer(m_params, m_before);
@@ -414,9 +635,15 @@ QSharedPointer<QMaplibreGLStyleChange> QMaplibreGLStyleAddSource::fromFeature(co
     return QSharedPointer<QMaplibreGLStyleChange>(source);
 }
 
-QSharedPointer<QMaplibreGLStyleChange> QMaplibreGLStyleAddSource::fromMapItem(QDeclarativeGeoMapItemBase *item)
+QSharedPointer<QMaplibreGLStyleChange> QMaplibreGLStyleAddSource::fromFeatures(const QString &id, const QList<QMapLibreGL::Feature> &features)
 {
-    return fromFeature(featureFromMapItem(item));
+    auto source = new QMaplibreGLStyleAddSource();
+
+    source->m_id = id;
+    source->m_params[QStringLiteral("type")] = QStringLiteral("geojson");
+    source->m_params[QStringLiteral("data")] = QVariant::fromValue<QList<QMapLibreGL::Feature>>(features);
+
+    return QSharedPointer<QMaplibreGLStyleChange>(source);
 }
 
 
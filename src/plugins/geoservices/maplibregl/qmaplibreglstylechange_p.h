@@ -37,7 +37,9 @@
 #ifndef QQMAPLIBREGLSTYLECHANGE_P_H
 #define QQMAPLIBREGLSTYLECHANGE_P_H
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QSet>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QString>
 #include <QtCore/QVariant>
@@ -56,24 +58,88 @@ class QMaplibreGLStyleChange
 public:
     virtual ~QMaplibreGLStyleChange() = default;
 
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> addMapItem(QDeclarativeGeoMapItemBase *, const QString &before);
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> removeMapItem(QDeclarativeGeoMapItemBase *);
-
     virtual void apply(QMapLibreGL::Map *map) = 0;
 };
 
+/* The managed map items, drawn in the order of their z, then of their
+ * insertion. Consecutive items of the same kind, fill or line, and of the
+ * same z form a group, drawn by one GeoJSON source and one style layer: the
+ * paint properties of an item are properties of its feature, which the layer
+ * reads through expressions. Groups are capped in size, so a change of an
+ * item only re-sends the source of its group, once per frame at most. */
+class QMaplibreGLItemPool
+{
+public:
+    static bool isManaged(QDeclarativeGeoMapItemBase *item);
+
+    void insert(QDeclarativeGeoMapItemBase *item);
+    void remove(QDeclarativeGeoMapItemBase *item);
+    void updateGeometry(QDeclarativeGeoMapItemBase *item);
+    void updateProperties(QDeclarativeGeoMapItemBase *item);
+
+    // Changes that bring the style up to date since the last call
+    QList<QSharedPointer<QMaplibreGLStyleChange>> takeChanges(const QString &before);
+    // The style is being reloaded, the layers and sources are gone
+    void resetStyle();
+    // The items of each group, from the bottom
+    QList<QList<QDeclarativeGeoMapItemBase *>> groupItems() const;
+
+private:
+    enum Kind {
+        Fills,
+        Lines
+    };
+
+    struct Entry
+    {
+        QMapLibreGL::Feature feature;
+        Kind kind = Fills;
+        qreal z = 0;
+        bool visible = true;
+    };
+
+    struct Group
+    {
+        QString id;
+        Kind kind = Fills;
+        qreal z = 0;
+        QList<quint64> keys; // in drawing order
+        bool dirty = true;
+    };
+
+    static Kind kindOf(QDeclarativeGeoMapItemBase *item);
+    static QVariantMap layerParams(const Group &group);
+    static void updateEntry(Entry &entry, QDeclarativeGeoMapItemBase *item);
+
+    bool precedes(quint64 lhs, quint64 rhs) const;
+    void place(quint64 key);
+    void unplace(quint64 key);
+    qsizetype groupOf(quint64 key) const;
+    void splitGroup(qsizetype index, qsizetype at);
+    void insertGroup(qsizetype index, const Group &group);
+    void removeGroup(qsizetype index);
+    QString newGroupId();
+
+    quint64 m_nextKey = 0; // keys follow the insertion order
+    quint64 m_nextGroup = 0;
+    QHash<quint64, Entry> m_entries;
+    QHash<QDeclarativeGeoMapItemBase *, quint64> m_keys;
+    QList<Group> m_groups;
+    QHash<quint64, QString> m_keyGroups; // the group of each key
+    QHash<QString, qsizetype> m_groupIndexes; // the index of each group in m_groups
+    QSet<QString> m_styleGroups; // groups with a layer in the style
+    bool m_dirty = false;
+};
+
 class QMaplibreGLStyleSetLayoutProperty : public QMaplibreGLStyleChange
 {
 public:
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativeGeoMapItemBase *);
+    QMaplibreGLStyleSetLayoutProperty(const QString &layer, const QString &property, const QVariant &value);
 
     void apply(QMapLibreGL::Map *map) override;
 
 private:
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativePolylineMapItem *);
-
     QMaplibreGLStyleSetLayoutProperty() = default;
-    QMaplibreGLStyleSetLayoutProperty(const QString &layer, const QString &property, const QVariant &value);
 
     QString m_layer;
     QString m_property;
@@ -83,18 +149,12 @@ private:
 class QMaplibreGLStyleSetPaintProperty : public QMaplibreGLStyleChange
 {
 public:
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativeGeoMapItemBase *);
+    QMaplibreGLStyleSetPaintProperty(const QString &layer, const QString &property, const QVariant &value);
 
     void apply(QMapLibreGL::Map *map) override;
 
 private:
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativeRectangleMapItem *);
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativeCircleMapItem *);
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativePolygonMapItem *);
-    static QList<QSharedPointer<QMaplibreGLStyleChange>> fromMapItem(QDeclarativePolylineMapItem *);
-
     QMaplibreGLStyleSetPaintProperty() = default;
-    QMaplibreGLStyleSetPaintProperty(const QString &layer, const QString &property, const QVariant &value);
 
     QString m_layer;
     QString m_property;
@@ -104,6 +164,8 @@ private:
 class QMaplibreGLStyleAddLayer : public QMaplibreGLStyleChange
 {
 public:
+    QMaplibreGLStyleAddLayer(const QVariantMap &params, const QString &before);
+
     static QSharedPointer<QMaplibreGLStyleChange> fromFeature(const QMapLibreGL::Feature &feature, const QString &before);
 
     void apply(QMapLibreGL::Map *map) override;
@@ -132,7 +194,7 @@ class QMaplibreGLStyleAddSource : public QMaplibreGLStyleChange
 {
 public:
     static QSharedPointer<QMaplibreGLStyleChange> fromFeature(const QMapLibreGL::Feature &feature);
-    static QSharedPointer<QMaplibreGLStyleChange> fromMapItem(QDeclarativeGeoMapItemBase *);
+    static QSharedPointer<QMaplibreGLStyleChange> fromFeatures(const QString &id, const QList<QMapLibreGL::Feature> &features);
 
     void apply(QMapLibreGL::Map *map) override;
 
@@ -43,6 +43,7 @@
 #include "qgeotilefetcher_nokia.h"
 #include "qgeotilespec_p.h"
 #include "qgeofiletilecachenokia.h"
+#include "qgeotilepackstorage_p.h"
 
 #include <QDebug>
 #include <QDir>
@@ -122,6 +123,12 @@ QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
     setSupportedMapTypes(types);
 
     QGeoTileFetcherNokia *fetcher = new QGeoTileFetcherNokia(parameters, networkManager, this, tileSize(), ppi);
+    if (parameters.contains(QStringLiteral("here.mapping.max_concurrent_requests"))) {
+        bool ok = false;
+        const int count = parameters.value(QStringLiteral("here.mapping.max_concurrent_requests")).toInt(&ok);
+        if (ok && count > 0)
+            fetcher->setMaxConcurrentRequests(count);
+    }
     setTileFetcher(fetcher);
 
     /* TILE CACHE */
@@ -155,6 +162,12 @@ QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
           tileCache->setMaxDiskUsage(cacheSize);
     }
 
+    if (parameters.contains(QStringLiteral("here.mapping.cache.disk.storage"))) {
+        QString storage = parameters.value(QStringLiteral("here.mapping.cache.disk.storage")).toString().toLower();
+        if (storage == QLatin1String("pack"))
+            tileCache->setDiskStorage(new QGeoTilePackStorage);
+    }
+
     /*
      * Memory cache setup -- defaults to ByteSize (old behavior)
      */
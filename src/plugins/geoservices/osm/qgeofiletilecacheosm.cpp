@@ -58,7 +58,16 @@ QGeoFileTileCacheOsm::QGeoFileTileCacheOsm(const QList<QGeoTileProviderOsm *> &p
     if (!offlineDirectory.isEmpty()) {
         m_offlineDirectory = QDir(offlineDirectory);
         if (m_offlineDirectory.exists())
-            m_offlineData = true;
+            m_offlineData = m_offlineStorage.open(m_offlineDirectory.absolutePath());
+        // Indexed once, to not list the directory for each tile
+        if (m_offlineData) {
+            const QStringList files = m_offlineDirectory.entryList(QDir::Files);
+            for (const QString &file : files) {
+                const int dot = file.lastIndexOf(QLatin1Char('.'));
+                if (dot > 0 && !m_offlineTiles.contains(file.left(dot)))
+                    m_offlineTiles.insert(file.left(dot), file);
+            }
+        }
     }
     for (int i = 0; i < providers.size(); i++) {
         providers[i]->setParent(this);
@@ -79,9 +88,26 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::get(const QGeoTileSpec &sp
         return tt;
     if ((tt = getFromOfflineStorage(spec)))
         return tt;
+    if ((tt = getFromOfflineArchive(spec)))
+        return tt;
     return getFromDisk(spec);
 }
 
+bool QGeoFileTileCacheOsm::loadAsync(const QGeoTileSpec &spec)
+{
+    if (pendingLoads_.contains(spec))
+        return true;
+    if (memoryCache_.peek(spec))
+        return QGeoFileTileCache::loadAsync(spec);
+
+    const QString offlineFile = offlineTileFilename(spec);
+    if (offlineFile.isEmpty())
+        return QGeoFileTileCache::loadAsync(spec);
+
+    startLoad(spec, &m_offlineStorage, offlineFile);
+    return true;
+}
+
 void QGeoFileTileCacheOsm::onProviderResolutionFinished(const QGeoTileProviderOsm *provider)
 {
     clearObsoleteTiles(provider);
@@ -117,6 +143,9 @@ void QGeoFileTileCacheOsm::init()
         directory_ = baseLocationCacheDirectory();
     QDir::root().mkpath(directory_);
 
+    // Base class ::init()
+    QGeoFileTileCache::init();
+
     // find max mapId
     int max = 0;
     for (auto p: m_providers)
@@ -125,47 +154,41 @@ void QGeoFileTileCacheOsm::init()
     // Create a mapId to maxTimestamp LUT..
     m_maxMapIdTimestamps.resize(max+1); // initializes to invalid QDateTime
 
-    // .. by finding the newest file in each tileset (tileset = mapId).
-    QDir dir(directory_);
-    QStringList formats;
-    formats << QLatin1String("*.*");
-    QStringList files = dir.entryList(formats, QDir::Files);
-
-    for (const QString &tileFileName : files) {
-        QGeoTileSpec spec = filenameToTileSpec(tileFileName);
-        if (spec.zoom() == -1)
-            continue;
-        QFileInfo fi(dir.filePath(tileFileName));
-        if (fi.lastModified() > m_maxMapIdTimestamps[spec.mapId()])
-            m_maxMapIdTimestamps[spec.mapId()] = fi.lastModified();
+    // .. from the newest file in each tileset (tileset = mapId), as restored
+    // from the manifest or found by the base class scan.
+    for (auto it = newestTileTimestamps_.cbegin(); it != newestTileTimestamps_.cend(); ++it) {
+        if (it.key() >= 0 && it.key() <= max)
+            m_maxMapIdTimestamps[it.key()] = it.value();
     }
 
-    // Base class ::init()
-    QGeoFileTileCache::init();
-
     for (QGeoTileProviderOsm * p: m_providers)
         clearObsoleteTiles(p);
 }
 
-QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(const QGeoTileSpec &spec)
+// Returns the name of the offline tile file relative to the offline directory
+QString QGeoFileTileCacheOsm::offlineTileFilename(const QGeoTileSpec &spec) const
 {
     if (!m_offlineData)
-        return QSharedPointer<QGeoTileTexture>();
+        return QString();
 
     int providerId = spec.mapId() - 1;
     if (providerId < 0 || providerId >= m_providers.size())
-        return QSharedPointer<QGeoTileTexture>();
+        return QString();
+
+    QString baseName = tileSpecToFilename(spec, QString(), providerId);
+    baseName.chop(1); // the dot before the format
+    return m_offlineTiles.value(baseName);
+}
 
-    const QString fileName = tileSpecToFilename(spec, QStringLiteral("*"), providerId);
-    QStringList validTiles = m_offlineDirectory.entryList({fileName});
-    if (!validTiles.size())
+QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(const QGeoTileSpec &spec)
+{
+    const QString offlineFile = offlineTileFilename(spec);
+    if (offlineFile.isEmpty())
         return QSharedPointer<QGeoTileTexture>();
 
-    QFile file(m_offlineDirectory.absoluteFilePath(validTiles.first()));
-    if (!file.open(QIODevice::ReadOnly))
+    QByteArray bytes = m_offlineStorage.read(offlineFile);
+    if (bytes.isEmpty())
         return QSharedPointer<QGeoTileTexture>();
-    QByteArray bytes = file.readAll();
-    file.close();
 
     QImage image;
     if (!image.loadFromData(bytes)) {
@@ -173,8 +196,8 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(cons
         return QSharedPointer<QGeoTileTexture>();
     }
 
-    addToMemoryCache(spec, bytes, QString());
-    return addToTextureCache(spec, image);
+    addToMemoryCache(spec, bytes, QGeoTileFormat());
+    return addToTextureCache(spec, image, bytes, QGeoTileFormat());
 }
 
 void QGeoFileTileCacheOsm::dropTiles(int mapId)
@@ -198,18 +221,16 @@ void QGeoFileTileCacheOsm::dropTiles(int mapId)
 
 void QGeoFileTileCacheOsm::loadTiles(int mapId)
 {
-    QStringList formats;
-    formats << QLatin1String("*.*");
-
+    waitForDiskWrites();
     QDir dir(directory_);
-    QStringList files = dir.entryList(formats, QDir::Files);
+    const QList<QGeoTileDiskStorage::Entry> files = diskStorage_->entries();
 
-    for (int i = 0; i < files.size(); ++i) {
-        QGeoTileSpec spec = filenameToTileSpec(files.at(i));
+    for (const QGeoTileDiskStorage::Entry &file : files) {
+        QGeoTileSpec spec = filenameToTileSpec(file.name);
         if (spec.zoom() == -1 || spec.mapId() != mapId)
             continue;
-        QString filename = dir.filePath(files.at(i));
-        addToDiskCache(spec, filename);
+        QString filename = dir.filePath(file.name);
+        addToDiskCache(spec, filename, file.size);
     }
 }
 
@@ -304,8 +325,8 @@ void QGeoFileTileCacheOsm::clearObsoleteTiles(const QGeoTileProviderOsm *p)
             if (m_maxMapIdTimestamps[p->mapType().mapId()].isValid() &&  // there are tiles in the cache
                 p->timestamp() > m_maxMapIdTimestamps[p->mapType().mapId()]) { // and they are older than the provider
                 qInfo() << "provider for " << p->mapType().name() << " timestamp: " << p->timestamp()
-                        << " -- data last modified: " << m_maxMapIdTimestamps[p->mapType().mapId()] << ". Clearing.";
-                clearMapId(p->mapType().mapId());
+                        << " -- data last modified: " << m_maxMapIdTimestamps[p->mapType().mapId()] << ". Refreshing.";
+                expireMapId(p->mapType().mapId());
                 m_maxMapIdTimestamps[p->mapType().mapId()] = p->timestamp(); // don't do it again.
             }
         } else {
@@ -58,6 +58,7 @@ public:
     ~QGeoFileTileCacheOsm();
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    bool loadAsync(const QGeoTileSpec &spec) override;
 
 Q_SIGNALS:
     void mapDataUpdated(int mapId);
@@ -71,6 +72,7 @@ protected:
     inline QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, int providerId) const;
     QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const override;
     QGeoTileSpec filenameToTileSpec(const QString &filename) const override;
+    QString offlineTileFilename(const QGeoTileSpec &spec) const;
     QSharedPointer<QGeoTileTexture> getFromOfflineStorage(const QGeoTileSpec &spec);
     void dropTiles(int mapId);
     void loadTiles(int mapId);
@@ -78,7 +80,9 @@ protected:
     void clearObsoleteTiles(const QGeoTileProviderOsm *p);
 
     QDir m_offlineDirectory;
+    QGeoTileFileStorage m_offlineStorage;
     bool m_offlineData;
+    QHash<QString, QString> m_offlineTiles; // file name without the format, to file name
     QList<QGeoTileProviderOsm *> m_providers;
     QList<bool> m_highDpi;
     QList<QDateTime> m_maxMapIdTimestamps;
@@ -72,6 +72,16 @@ void QGeoMapReplyOsm::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError) // Already handled in networkReplyError
         return;
 
+    setValidators(QGeoTileValidators::fromHeaders(reply->rawHeader("ETag"),
+                                                  reply->rawHeader("Last-Modified"),
+                                                  reply->rawHeader("Cache-Control"),
+                                                  reply->rawHeader("Expires")));
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        setNotModified(true);
+        setFinished(true);
+        return;
+    }
+
     QByteArray a = reply->readAll();
 
     setMapImageData(a);
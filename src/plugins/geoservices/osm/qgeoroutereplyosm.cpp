@@ -39,6 +39,7 @@
 
 #include "qgeoroutereplyosm.h"
 #include "qgeoroutingmanagerengineosm.h"
+#include <QtLocation/private/qgeorouteparser_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -73,9 +74,17 @@ void QGeoRouteReplyOsm::networkReplyFinished()
     QGeoRoutingManagerEngineOsm *engine = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent());
     const QGeoRouteParser *parser = engine->routeParser();
 
-    QList<QGeoRoute> routes;
-    QString errorString;
-    QGeoRouteReply::Error error = parser->parseReply(routes, errorString, reply->readAll());
+    // Large replies with alternatives take a while to parse, this is done
+    // off the thread of the reply
+    QGeoRouteParserJob *job = parser->parseReplyAsync(reply->readAll());
+    connect(job, &QGeoRouteParserJob::finished, this, &QGeoRouteReplyOsm::parserFinished);
+    connect(this, &QGeoRouteReply::aborted, job, [this, job]() { job->disconnect(this); });
+}
+
+void QGeoRouteReplyOsm::parserFinished(QGeoRouteReply::Error error, const QString &errorString,
+                                       const QList<QGeoRoute> &parsedRoutes)
+{
+    QList<QGeoRoute> routes = parsedRoutes;
     // Setting the request into the result
     for (QGeoRoute &route : routes) {
         route.setRequest(request());
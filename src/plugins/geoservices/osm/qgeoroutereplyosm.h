@@ -57,6 +57,7 @@ public:
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
+    void parserFinished(QGeoRouteReply::Error error, const QString &errorString, const QList<QGeoRoute> &routes);
 };
 
 QT_END_NAMESPACE
@@ -46,6 +46,8 @@
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtLocation/private/qgeotiledmap_p.h>
 #include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotilepackstorage_p.h>
+#include <QtLocation/private/qgeotilearchive_p.h>
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkDiskCache>
@@ -252,6 +254,15 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         m_offlineDirectory = parameters.value(QStringLiteral("osm.mapping.offline.directory")).toString();
     QGeoFileTileCacheOsm *tileCache = new QGeoFileTileCacheOsm(m_providers, m_offlineDirectory, m_cacheDirectory);
 
+    if (parameters.contains(QStringLiteral("osm.mapping.offline.archive"))) {
+        const QString archiveFile = parameters.value(QStringLiteral("osm.mapping.offline.archive")).toString();
+        int archiveMapId = 0;
+        if (parameters.contains(QStringLiteral("osm.mapping.offline.archive.mapid")))
+            archiveMapId = parameters.value(QStringLiteral("osm.mapping.offline.archive.mapid")).toInt();
+        if (QGeoTileArchive *archive = QGeoTileArchive::create(archiveFile))
+            tileCache->setOfflineArchive(archive, archiveMapId);
+    }
+
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
      */
@@ -271,6 +282,20 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
             tileCache->setMaxDiskUsage(cacheSize);
     }
 
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.disk.storage"))) {
+        QString storage = parameters.value(QStringLiteral("osm.mapping.cache.disk.storage")).toString().toLower();
+        if (storage == QLatin1String("pack"))
+            tileCache->setDiskStorage(new QGeoTilePackStorage);
+    }
+
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.disk.sync"))) {
+        QString sync = parameters.value(QStringLiteral("osm.mapping.cache.disk.sync")).toString().toLower();
+        if (sync == QLatin1String("batch"))
+            tileCache->setDiskSyncPolicy(QGeoFileTileCache::SyncEachBatch);
+        else if (sync == QLatin1String("tile"))
+            tileCache->setDiskSyncPolicy(QGeoFileTileCache::SyncEachTile);
+    }
+
     /*
      * Memory cache setup -- defaults to ByteSize (old behavior)
      */
@@ -309,6 +334,16 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
             tileCache->setExtraTextureUsage(cacheSize);
     }
 
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.texture.format"))) {
+        QString format = parameters.value(QStringLiteral("osm.mapping.cache.texture.format")).toString().toLower();
+        if (format == QLatin1String("rgb565"))
+            tileCache->setTextureFormat(QGeoFileTileCache::TextureRgb565);
+        else if (format == QLatin1String("bc1"))
+            tileCache->setTextureFormat(QGeoFileTileCache::TextureBC1);
+        else if (format == QLatin1String("etc2"))
+            tileCache->setTextureFormat(QGeoFileTileCache::TextureETC2);
+    }
+
 
     setTileCache(tileCache);
 
@@ -319,6 +354,14 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         const QByteArray ua = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
         tileFetcher->setUserAgent(ua);
     }
+    if (parameters.contains(QStringLiteral("osm.mapping.max_concurrent_requests"))) {
+        bool ok = false;
+        const int count = parameters.value(QStringLiteral("osm.mapping.max_concurrent_requests")).toInt(&ok);
+        if (ok && count > 0)
+            tileFetcher->setMaxConcurrentRequests(count);
+    }
+    if (parameters.contains(QStringLiteral("osm.mapping.http2")))
+        tileFetcher->setHttp2Enabled(parameters.value(QStringLiteral("osm.mapping.http2")).toBool());
     setTileFetcher(tileFetcher);
 
     /* PREFETCHING */
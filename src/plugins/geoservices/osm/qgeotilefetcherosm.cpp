@@ -105,6 +105,12 @@ void QGeoTileFetcherOsm::setUserAgent(const QByteArray &userAgent)
     m_userAgent = userAgent;
 }
 
+// With HTTP/2 the tile requests to a host share a single connection
+void QGeoTileFetcherOsm::setHttp2Enabled(bool enabled)
+{
+    m_http2 = enabled;
+}
+
 bool QGeoTileFetcherOsm::initialized() const
 {
     if (!m_ready) {
@@ -159,7 +165,16 @@ QGeoTiledMapReply *QGeoTileFetcherOsm::getTileImage(const QGeoTileSpec &spec)
     const QUrl url = m_providers[id]->tileAddress(spec.x(), spec.y(), spec.zoom());
     QNetworkRequest request;
     request.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, m_http2);
     request.setUrl(url);
+
+    // Refreshing a stale tile: the server answers 304 if it did not change
+    const QGeoTileValidators validators = tileValidators(spec);
+    if (!validators.etag.isEmpty())
+        request.setRawHeader("If-None-Match", validators.etag);
+    if (!validators.lastModified.isEmpty())
+        request.setRawHeader("If-Modified-Since", validators.lastModified);
+
     QNetworkReply *reply = m_nm->get(request);
     return new QGeoMapReplyOsm(reply, spec, m_providers[id]->format());
 }
@@ -62,6 +62,7 @@ public:
                        QGeoMappingManagerEngine *parent);
 
     void setUserAgent(const QByteArray &userAgent);
+    void setHttp2Enabled(bool enabled);
 
 Q_SIGNALS:
     void providerDataUpdated(const QGeoTileProviderOsm *provider);
@@ -82,6 +83,7 @@ private:
     QList<QGeoTileProviderOsm *> m_providers;
     QNetworkAccessManager *m_nm;
     bool m_ready;
+    bool m_http2 = true;
 };
 
 QT_END_NAMESPACE
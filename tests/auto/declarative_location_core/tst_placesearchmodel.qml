@@ -234,6 +234,32 @@ TestCase {
         delete countChangedSpy;
     }
 
+    function test_places() {
+        var testModel = Qt.createQmlObject('import QtLocation 5.3; PlaceSearchModel {}', testCase, "PlaceSearchModel");
+        testModel.plugin = testPlugin;
+
+        testModel.searchTerm = "view";
+        testModel.update();
+        tryCompare(testModel, "status", PlaceSearchModel.Ready);
+        compare(testModel.count, 2);
+
+        // Created on the first request, the same object afterwards
+        var first = testModel.data(0, "place");
+        verify(first);
+        compare(testModel.data(0, "place"), first);
+        verify(testModel.data(1, "place") !== first);
+        verify(testModel.data(0, "place").placeId !== testModel.data(1, "place").placeId);
+
+        // The places of the previous results may be reused, with the new data
+        testModel.searchTerm = "park";
+        testModel.update();
+        tryCompare(testModel, "status", PlaceSearchModel.Ready);
+        compare(testModel.count, 1);
+        compare(testModel.data(0, "place").placeId, "4dcc74ce-fdeb-443e-827c-367438017cf1");
+
+        delete testModel;
+    }
+
     function test_cancel() {
         var testModel = Qt.createQmlObject('import QtLocation 5.3; PlaceSearchModel {}', testCase, "PlaceSearchModel");
         testModel.plugin = testPlugin;
@@ -73,6 +73,12 @@ Item {
             { latitude: 23, longitude: 17 }
         ]
     })
+    property route farRoute: ({
+        path: [
+            { latitude: 40, longitude: -30 },
+            { latitude: 35, longitude: -25 }
+        ]
+    })
     Item { id: someItem }
 
     ItemGroup {
@@ -593,6 +599,27 @@ Item {
             compare (preMapQuickItemSourceItemChanged.count, 1)
         }
 
+        function test_route_switch_opengl_linestrip()
+        {
+            // The geometry origin is taken from the bounds of the new route,
+            // not from the path of the previous one
+            preMapRoute.backend = MapPolyline.OpenGLLineStrip
+            preMapRoute.line.width = 1
+            preMapRoute.route = farRoute
+            verify(LocationTestHelper.waitForPolished(map))
+            map.center = QtPositioning.coordinate(22, 16)
+            preMapRoute.route = someRoute
+            verify(LocationTestHelper.waitForPolished(map))
+
+            var topLeft = map.fromCoordinate(QtPositioning.coordinate(23, 15), false)
+            var itemTopLeft = preMapRoute.mapToItem(map, 0, 0)
+            verify(fuzzy_compare(itemTopLeft.x, topLeft.x, 3))
+            verify(fuzzy_compare(itemTopLeft.y, topLeft.y, 3))
+            compare(preMapRoute.pathLength(), 3)
+
+            preMapRoute.backend = MapPolyline.Software
+        }
+
         function fuzzy_compare(val, ref, tol) {
             var tolerance = 2
             if (tol !== undefined)
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick
+import QtTest
+import QtLocation
+import QtPositioning
+
+Item {
+    id: masterItem
+    width: 200
+    height: 350
+
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    GeoJsonModel {
+        id: geoJsonModel
+        batchSize: 1
+        source: "tst_map_itemview_geojson.geojson"
+    }
+
+    Map {
+        id: map
+
+        property int mapItemsLength: mapItems.length
+
+        center: QtPositioning.coordinate(12, 32)
+        plugin: testPlugin
+        anchors.fill: parent
+        zoomLevel: 2
+
+        MapItemView {
+            id: itemView
+            incubateDelegates: false
+            add: null
+            remove: null
+            model: geoJsonModel
+            delegate: Component {
+                MapCircle {
+                    property string name: model.properties.name
+                    property int featureIndex: model.featureIndex
+                    radius: 100000
+                    center: model.geoShape.center
+                }
+            }
+        }
+    }
+
+    TestCase {
+        name: "MapItemViewGeoJson"
+        when: windowShown && map.mapReady
+
+        function itemNamed(name) {
+            for (var i = 0; i < map.mapItems.length; ++i) {
+                if (map.mapItems[i].name === name)
+                    return map.mapItems[i]
+            }
+            return null
+        }
+
+        function test_delegates() {
+            tryCompare(geoJsonModel, "status", GeoJsonModel.Ready)
+            compare(geoJsonModel.count, 4)
+            compare(geoJsonModel.progress, 1.0)
+            compare(geoJsonModel.errorString, "")
+            tryCompare(map, "mapItemsLength", 4)
+
+            compare(itemNamed("first").center, QtPositioning.coordinate(11, 31))
+            compare(itemNamed("second").center, QtPositioning.coordinate(12, 32))
+
+            // The parts of a multi geometry share the feature
+            var parts = []
+            for (var i = 0; i < map.mapItems.length; ++i) {
+                if (map.mapItems[i].name === "third")
+                    parts.push(map.mapItems[i])
+            }
+            compare(parts.length, 2)
+            compare(parts[0].featureIndex, 2)
+            compare(parts[1].featureIndex, 2)
+
+            var row = geoJsonModel.get(0)
+            compare(row.type, "Point")
+            compare(row.id, "first")
+            compare(row.properties.rank, 1)
+        }
+
+        function test_source_change() {
+            tryCompare(geoJsonModel, "status", GeoJsonModel.Ready)
+            tryCompare(map, "mapItemsLength", 4)
+
+            geoJsonModel.source = "tst_map_itemview_geojson_missing.geojson"
+            tryCompare(geoJsonModel, "status", GeoJsonModel.Error)
+            verify(geoJsonModel.errorString.length > 0)
+            compare(geoJsonModel.count, 0)
+            tryCompare(map, "mapItemsLength", 0)
+
+            geoJsonModel.source = "tst_map_itemview_geojson.geojson"
+            tryCompare(geoJsonModel, "status", GeoJsonModel.Ready)
+            tryCompare(map, "mapItemsLength", 4)
+        }
+    }
+}
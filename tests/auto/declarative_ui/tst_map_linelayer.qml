@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick
+import QtTest
+import QtLocation
+import QtPositioning
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 256
+    height: 256
+    Plugin { id: testPlugin; name : "qmlgeo.test.plugin"; allowExperimental: true }
+
+    Map {
+        id: map
+        plugin: testPlugin
+        center: QtPositioning.coordinate(20, 20)
+        zoomLevel: 3
+        anchors.fill: parent
+
+        MapLineLayer {
+            id: layer
+            line.width: 10
+            line.color: "green"
+            model: ListModel {
+                id: lines
+                ListElement {
+                    color: ""
+                    width: 10
+                    path: [
+                        ListElement { latitude: 20; longitude: 10 },
+                        ListElement { latitude: 20; longitude: 30 }
+                    ]
+                }
+                ListElement {
+                    color: "red"
+                    width: 6
+                    path: [
+                        ListElement { latitude: 10; longitude: 25 },
+                        ListElement { latitude: 30; longitude: 25 }
+                    ]
+                }
+            }
+        }
+    }
+
+    SignalSpy { id: countSpy; target: layer; signalName: "countChanged" }
+
+    TestCase {
+        name: "MapLineLayer"
+        when: windowShown && map.mapReady
+
+        function pointAt(latitude, longitude)
+        {
+            return map.fromCoordinate(QtPositioning.coordinate(latitude, longitude))
+        }
+
+        function boundsAre(top, left, bottom, right)
+        {
+            var bounds = layer.geoShape.boundingGeoRectangle()
+            return bounds.topLeft.latitude === top && bounds.topLeft.longitude === left
+                    && bounds.bottomRight.latitude === bottom && bounds.bottomRight.longitude === right
+        }
+
+        function test_bounds()
+        {
+            verify(boundsAre(30, 10, 10, 30))
+
+            // a new line grows the bounds, hiding it shrinks them back
+            lines.append({ color: "", width: 4,
+                           path: [ { latitude: 40, longitude: 0 },
+                                   { latitude: 35, longitude: 5 } ] })
+            tryVerify(function() { return boundsAre(40, 0, 10, 30) })
+            lines.setProperty(2, "color", "transparent")
+            tryVerify(function() { return boundsAre(30, 10, 10, 30) })
+            lines.remove(2)
+            verify(boundsAre(30, 10, 10, 30))
+
+            // the row changed is still the one rebuilt after an insertion above it
+            lines.insert(0, { color: "", width: 4,
+                              path: [ { latitude: 0, longitude: 40 },
+                                      { latitude: 5, longitude: 45 } ] })
+            lines.setProperty(1, "width", 0)
+            tryVerify(function() { return boundsAre(30, 25, 0, 45) })
+            compare(layer.featureAt(pointAt(20, 15)), -1)
+
+            lines.remove(0)
+            tryVerify(function() { return boundsAre(30, 25, 10, 25) })
+            lines.setProperty(0, "width", 10)
+            tryVerify(function() { return boundsAre(30, 10, 10, 30) })
+            compare(layer.featureAt(pointAt(20, 15)), 0)
+        }
+
+        function test_features()
+        {
+            compare(layer.count, 2)
+            compare(layer.width, map.width)
+            compare(layer.height, map.height)
+
+            var bounds = layer.geoShape.boundingGeoRectangle()
+            compare(bounds.topLeft.latitude, 30)
+            compare(bounds.topLeft.longitude, 10)
+            compare(bounds.bottomRight.latitude, 10)
+            compare(bounds.bottomRight.longitude, 30)
+        }
+
+        function test_featureAt()
+        {
+            compare(layer.featureAt(pointAt(20, 15)), 0)
+            compare(layer.featureAt(pointAt(15, 25)), 1)
+            // the last row is on top
+            compare(layer.featureAt(pointAt(20, 25)), 1)
+            compare(layer.featureAt(pointAt(0, 0)), -1)
+        }
+
+        function test_modelChanges()
+        {
+            countSpy.clear()
+            lines.append({ color: "", width: 4,
+                           path: [ { latitude: 0, longitude: -10 },
+                                   { latitude: 0, longitude: 10 } ] })
+            compare(countSpy.count, 1)
+            compare(layer.count, 3)
+            tryVerify(function() { return layer.featureAt(pointAt(0, 0)) === 2 })
+
+            // a transparent line is not drawn, nor picked
+            lines.setProperty(2, "color", "transparent")
+            tryVerify(function() { return layer.featureAt(pointAt(0, 0)) === -1 })
+
+            lines.remove(2)
+            compare(countSpy.count, 2)
+            compare(layer.count, 2)
+            compare(layer.featureAt(pointAt(20, 15)), 0)
+        }
+    }
+}
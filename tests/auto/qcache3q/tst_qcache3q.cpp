@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qcache3q_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QCache3Q<QString, int> Cache;
+
+class tst_QCache3Q : public QObject
+{
+    Q_OBJECT
+
+private:
+    struct Snapshot
+    {
+        QList<QString> keys;
+        QList<QSharedPointer<int> > values;
+        QList<int> costs;
+        QList<quint64> popularities;
+    };
+    static Snapshot snapshot(const Cache &cache, int queue);
+    static void fill(Cache &cache);
+
+private Q_SLOTS:
+    void serializeRoundTrip();
+    void deserializeSkipsKnownKeys();
+    void deserializeRebalances();
+    void counters();
+};
+
+tst_QCache3Q::Snapshot tst_QCache3Q::snapshot(const Cache &cache, int queue)
+{
+    Snapshot s;
+    cache.serializeQueue(queue, s.keys, s.values, s.costs, s.popularities);
+    return s;
+}
+
+void tst_QCache3Q::fill(Cache &cache)
+{
+    for (int i = 0; i < 6; ++i)
+        cache.insert(QString::number(i), QSharedPointer<int>(new int(i)), 1 + i);
+    // promote "1" and "2" to the regulars
+    for (int i = 0; i <= cache.promoteAt(); ++i) {
+        cache.object(QStringLiteral("1"));
+        cache.object(QStringLiteral("2"));
+    }
+    // then overflow, leaving ghosts of the oldest newbies
+    for (int i = 6; i < 8; ++i)
+        cache.insert(QString::number(i), QSharedPointer<int>(new int(i)), 1 + i);
+}
+
+void tst_QCache3Q::serializeRoundTrip()
+{
+    Cache cache(30);
+    fill(cache);
+
+    Cache restored(30);
+    for (int queue = 1; queue <= 4; ++queue) {
+        const Snapshot s = snapshot(cache, queue);
+        restored.deserializeQueue(queue, s.keys, s.values, s.costs, s.popularities);
+    }
+
+    QCOMPARE(restored.totalCost(), cache.totalCost());
+    for (int queue = 1; queue <= 4; ++queue) {
+        const Snapshot expected = snapshot(cache, queue);
+        const Snapshot actual = snapshot(restored, queue);
+        QCOMPARE(actual.keys, expected.keys);
+        QCOMPARE(actual.costs, expected.costs);
+        QCOMPARE(actual.popularities, expected.popularities);
+    }
+    QCOMPARE(snapshot(restored, 2).keys, QList<QString>({ QStringLiteral("2"), QStringLiteral("1") }));
+    QVERIFY(!snapshot(restored, 4).keys.isEmpty());
+}
+
+void tst_QCache3Q::deserializeSkipsKnownKeys()
+{
+    Cache cache(100);
+    cache.insert(QStringLiteral("a"), QSharedPointer<int>(new int(1)), 5);
+
+    cache.deserializeQueue(1, { QStringLiteral("a"), QStringLiteral("b") },
+                           { QSharedPointer<int>(new int(2)), QSharedPointer<int>(new int(3)) },
+                           { 7, 11 }, { 0, 0 });
+
+    QCOMPARE(cache.totalCost(), 16);
+    QCOMPARE(*cache.object(QStringLiteral("a")), 1);
+    QCOMPARE(*cache.object(QStringLiteral("b")), 3);
+}
+
+void tst_QCache3Q::deserializeRebalances()
+{
+    Cache cache(30);
+    fill(cache);
+    const Snapshot s = snapshot(cache, 1);
+
+    Cache smaller(10);
+    smaller.deserializeQueue(1, s.keys, s.values, s.costs, s.popularities);
+    QVERIFY(smaller.totalCost() <= 10);
+    // the least recently added newbies go first
+    QCOMPARE(smaller.object(s.keys.last()), QSharedPointer<int>());
+    QCOMPARE(*smaller.object(s.keys.first()), *s.values.first());
+}
+
+void tst_QCache3Q::counters()
+{
+    Cache cache(10);
+    cache.insert(QStringLiteral("a"), QSharedPointer<int>(new int(1)), 4);
+    cache.insert(QStringLiteral("b"), QSharedPointer<int>(new int(2)), 4);
+    cache.insert(QStringLiteral("c"), QSharedPointer<int>(new int(3)), 4);
+
+    // "a", the least recently added newbie, made room for "c"
+    QCOMPARE(cache.evictionCount(), 1);
+    QCOMPARE(cache.size(), 2);
+    QCOMPARE(cache.totalCost(), 8);
+
+    QVERIFY(cache.object(QStringLiteral("b")));
+    QVERIFY(!cache.object(QStringLiteral("a"))); // a ghost
+    QVERIFY(!cache.object(QStringLiteral("z")));
+    QCOMPARE(cache.hitCount(), 1);
+    QCOMPARE(cache.missCount(), 2);
+}
+
+QTEST_APPLESS_MAIN(tst_QCache3Q)
+
+#include "tst_qcache3q.moc"
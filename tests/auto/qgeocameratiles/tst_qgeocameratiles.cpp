@@ -37,6 +37,7 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
 #include <QtTest/QtTest>
 #include <QtCore/QList>
 #include <QtCore/QPair>
@@ -72,6 +73,7 @@ private slots:
     void tilesPositions();
     void tilesPositions_data();
     void test_tilted_frustum();
+    void incrementalTiles();
 };
 
 void tst_QGeoCameraTiles::row(const PositionTestInfo &pti, int xOffset, int yOffset, int tileX, int tileY, int tileW, int tileH)
@@ -142,6 +144,61 @@ void tst_QGeoCameraTiles::test_tilted_frustum()
     QCOMPARE(ct.createTiles(), ctFull.createTiles());
 }
 
+void tst_QGeoCameraTiles::incrementalTiles()
+{
+    QGeoCameraData camera;
+    camera.setZoomLevel(5.5);
+    camera.setTilt(20);
+    camera.setBearing(30);
+    camera.setCenter(QGeoCoordinate(10.0, 175.0));
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(64);
+    ct.setScreenSize(QSize(640, 480));
+    ct.setCameraData(camera);
+
+    QSet<QGeoTileKey> tiles = ct.createTiles();
+    QVERIFY(!ct.hasTileDelta());
+
+    // Pan across the dateline, the applied deltas must match the full tile sets
+    for (int i = 0; i < 40; ++i) {
+        QGeoCoordinate center = camera.center();
+        center.setLongitude(QLocationUtils::wrapLong(center.longitude() + 0.7));
+        center.setLatitude(center.latitude() + ((i % 2) ? 0.3 : -0.2));
+        camera.setCenter(center);
+        ct.setCameraData(camera);
+        const QSet<QGeoTileKey> &result = ct.createTiles();
+        QVERIFY(ct.hasTileDelta());
+        QVERIFY(!ct.addedTiles().intersects(tiles));
+        QVERIFY(tiles.contains(ct.removedTiles()));
+        tiles -= ct.removedTiles();
+        tiles += ct.addedTiles();
+        QCOMPARE(result, tiles);
+
+        QGeoCameraTiles control;
+        control.setTileSize(64);
+        control.setScreenSize(QSize(640, 480));
+        control.setCameraData(camera);
+        QCOMPARE(tiles, control.createTiles());
+    }
+
+    // Nothing to report when nothing changed
+    ct.createTiles();
+    QVERIFY(ct.hasTileDelta());
+    QVERIFY(ct.addedTiles().isEmpty());
+    QVERIFY(ct.removedTiles().isEmpty());
+
+    // Changing the integer zoom level or the metadata requires a full update
+    camera.setZoomLevel(6.5);
+    ct.setCameraData(camera);
+    ct.createTiles();
+    QVERIFY(!ct.hasTileDelta());
+
+    ct.setPluginString("pluginA");
+    ct.createTiles();
+    QVERIFY(!ct.hasTileDelta());
+}
+
 void tst_QGeoCameraTiles::tilesPlugin()
 {
     QGeoCameraData camera;
@@ -154,37 +211,37 @@ void tst_QGeoCameraTiles::tilesPlugin()
     ct.setScreenSize(QSize(32, 32));
     ct.setMapType(QGeoMapType(QGeoMapType::StreetMap, "street map", "street map", false, false, 1, QByteArrayLiteral(""), QGeoCameraCapabilities()));
 
-    QSet<QGeoTileSpec> tiles1 = ct.createTiles();
+    QSet<QGeoTileKey> tiles1 = ct.createTiles();
 
     ct.setPluginString("pluginA");
 
-    QSet<QGeoTileSpec> tiles2 = ct.createTiles();
+    QSet<QGeoTileKey> tiles2 = ct.createTiles();
 
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
+    typedef QSet<QGeoTileKey>::const_iterator iter;
     iter i1 = tiles1.constBegin();
     iter end1 = tiles1.constEnd();
 
-    QSet<QGeoTileSpec> tiles2_check;
+    QSet<QGeoTileKey> tiles2_check;
 
     for (; i1 != end1; ++i1) {
-        QGeoTileSpec tile = *i1;
-        tiles2_check.insert(QGeoTileSpec("pluginA", tile.mapId(), tile.zoom(), tile.x(), tile.y()));
+        QGeoTileKey tile = *i1;
+        tiles2_check.insert(QGeoTileSpec("pluginA", tile.mapId(), tile.zoom(), tile.x(), tile.y()).key());
     }
 
     QCOMPARE(tiles2, tiles2_check);
 
     ct.setPluginString("pluginB");
 
-    QSet<QGeoTileSpec> tiles3 = ct.createTiles();
+    QSet<QGeoTileKey> tiles3 = ct.createTiles();
 
     iter i2 = tiles2.constBegin();
     iter end2 = tiles2.constEnd();
 
-    QSet<QGeoTileSpec> tiles3_check;
+    QSet<QGeoTileKey> tiles3_check;
 
     for (; i2 != end2; ++i2) {
-        QGeoTileSpec tile = *i2;
-        tiles3_check.insert(QGeoTileSpec("pluginB", tile.mapId(), tile.zoom(), tile.x(), tile.y()));
+        QGeoTileKey tile = *i2;
+        tiles3_check.insert(QGeoTileSpec("pluginB", tile.mapId(), tile.zoom(), tile.x(), tile.y()).key());
     }
 
     QCOMPARE(tiles3, tiles3_check);
@@ -202,22 +259,22 @@ void tst_QGeoCameraTiles::tilesMapType()
     ct.setScreenSize(QSize(32, 32));
     ct.setPluginString("pluginA");
 
-    QSet<QGeoTileSpec> tiles1 = ct.createTiles();
+    QSet<QGeoTileKey> tiles1 = ct.createTiles();
 
     QGeoMapType mapType1 = QGeoMapType(QGeoMapType::StreetMap, "street map", "street map", false, false, 1, QByteArrayLiteral(""), QGeoCameraCapabilities());
     ct.setMapType(mapType1);
 
-    QSet<QGeoTileSpec> tiles2 = ct.createTiles();
+    QSet<QGeoTileKey> tiles2 = ct.createTiles();
 
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
+    typedef QSet<QGeoTileKey>::const_iterator iter;
     iter i1 = tiles1.constBegin();
     iter end1 = tiles1.constEnd();
 
-    QSet<QGeoTileSpec> tiles2_check;
+    QSet<QGeoTileKey> tiles2_check;
 
     for (; i1 != end1; ++i1) {
-        QGeoTileSpec tile = *i1;
-        tiles2_check.insert(QGeoTileSpec(tile.plugin(), mapType1.mapId(), tile.zoom(), tile.x(), tile.y()));
+        QGeoTileKey tile = *i1;
+        tiles2_check.insert(QGeoTileKey(tile.pluginId(), mapType1.mapId(), tile.zoom(), tile.x(), tile.y()));
     }
 
     QCOMPARE(tiles2, tiles2_check);
@@ -225,16 +282,16 @@ void tst_QGeoCameraTiles::tilesMapType()
     QGeoMapType mapType2 = QGeoMapType(QGeoMapType::StreetMap, "satellite map", "satellite map", false, false, 2, QByteArrayLiteral(""), QGeoCameraCapabilities());
     ct.setMapType(mapType2);
 
-    QSet<QGeoTileSpec> tiles3 = ct.createTiles();
+    QSet<QGeoTileKey> tiles3 = ct.createTiles();
 
     iter i2 = tiles2.constBegin();
     iter end2 = tiles2.constEnd();
 
-    QSet<QGeoTileSpec> tiles3_check;
+    QSet<QGeoTileKey> tiles3_check;
 
     for (; i2 != end2; ++i2) {
-        QGeoTileSpec tile = *i2;
-        tiles3_check.insert(QGeoTileSpec(tile.plugin(), mapType2.mapId(), tile.zoom(), tile.x(), tile.y()));
+        QGeoTileKey tile = *i2;
+        tiles3_check.insert(QGeoTileKey(tile.pluginId(), mapType2.mapId(), tile.zoom(), tile.x(), tile.y()));
     }
 
     QCOMPARE(tiles3, tiles3_check);
@@ -259,12 +316,12 @@ void tst_QGeoCameraTiles::tilesPositions()
     ct.setCameraData(camera);
     ct.setScreenSize(QSize(qCeil(width), qCeil(height)));
 
-    QSet<QGeoTileSpec> tiles;
+    QSet<QGeoTileKey> tiles;
 
     QVERIFY2(tilesX.size() == tilesY.size(), "tilesX and tilesY have different size");
 
     for (int i = 0; i < tilesX.size(); ++i)
-        tiles.insert(QGeoTileSpec("", 0, static_cast<int>(qFloor(zoom)), tilesX.at(i), tilesY.at(i)));
+        tiles.insert(QGeoTileSpec("", 0, static_cast<int>(qFloor(zoom)), tilesX.at(i), tilesY.at(i)).key());
 
     QCOMPARE(ct.createTiles(), tiles);
 }
@@ -0,0 +1,246 @@
+/****************************************************************************
+**
+** Copyright (C) 2023 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QBuffer>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotilediskstorage_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+// Holds the reads in the load pool until opened, counting how many run at once
+class GatedStorage : public QGeoTileFileStorage
+{
+public:
+    QByteArray read(const QString &name) const override
+    {
+        const int running = m_running.fetchAndAddOrdered(1) + 1;
+        int peak = m_peak.loadAcquire();
+        while (running > peak && !m_peak.testAndSetOrdered(peak, running))
+            peak = m_peak.loadAcquire();
+
+        m_mutex.lock();
+        while (m_closed)
+            m_opened.wait(&m_mutex);
+        m_mutex.unlock();
+
+        m_running.fetchAndSubOrdered(1);
+        return QGeoTileFileStorage::read(name);
+    }
+
+    void setClosed(bool closed)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = closed;
+        if (!closed)
+            m_opened.wakeAll();
+    }
+
+    int running() const { return m_running.loadAcquire(); }
+    int peak() const { return m_peak.loadAcquire(); }
+
+private:
+    mutable QMutex m_mutex;
+    mutable QWaitCondition m_opened;
+    mutable QAtomicInt m_running;
+    mutable QAtomicInt m_peak;
+    bool m_closed = false;
+};
+
+class TileCacheTest : public QGeoFileTileCache
+{
+public:
+    using QGeoFileTileCache::QGeoFileTileCache;
+    using QGeoFileTileCache::waitForDiskWrites;
+};
+
+class tst_QGeoFileTileCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray tileData(int i);
+    static QSet<QGeoTileSpec> loadedTiles(const QSignalSpy &spy);
+    void fillCache(TileCacheTest *cache, const QList<QGeoTileSpec> &tiles);
+
+private Q_SLOTS:
+    void initTestCase();
+    void loadAsync();
+    void boundedLoads();
+    void cancelLoads();
+
+private:
+    QList<QGeoTileSpec> m_tiles;
+};
+
+QByteArray tst_QGeoFileTileCache::tileData(int i)
+{
+    QImage image(8, 8, QImage::Format_ARGB32_Premultiplied);
+    image.fill(QColor::fromRgb(i, 255 - i, 0));
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return png;
+}
+
+QSet<QGeoTileSpec> tst_QGeoFileTileCache::loadedTiles(const QSignalSpy &spy)
+{
+    QSet<QGeoTileSpec> tiles;
+    for (const QList<QVariant> &arguments : spy)
+        tiles.insert(arguments.at(0).value<QGeoTileSpec>());
+    return tiles;
+}
+
+// Only on disk, so that loads go through the storage
+void tst_QGeoFileTileCache::fillCache(TileCacheTest *cache, const QList<QGeoTileSpec> &tiles)
+{
+    for (int i = 0; i < tiles.size(); ++i)
+        cache->insert(tiles.at(i), tileData(i), QGeoTileFormat::Png, QAbstractGeoTileCache::DiskCache);
+    cache->waitForDiskWrites();
+}
+
+void tst_QGeoFileTileCache::initTestCase()
+{
+    for (int x = 0; x < 8; ++x) {
+        for (int y = 0; y < 4; ++y)
+            m_tiles.append(QGeoTileSpec(QStringLiteral("test"), 1, 3, x, y));
+    }
+}
+
+void tst_QGeoFileTileCache::loadAsync()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TileCacheTest cache(dir.path());
+    static_cast<QAbstractGeoTileCache &>(cache).init();
+    fillCache(&cache, m_tiles);
+
+    QSignalSpy loadedSpy(&cache, &QAbstractGeoTileCache::tileLoaded);
+    QSignalSpy failedSpy(&cache, &QAbstractGeoTileCache::tileLoadFailed);
+    for (const QGeoTileSpec &spec : qAsConst(m_tiles)) {
+        QVERIFY(!cache.getLoaded(spec));
+        QVERIFY(cache.loadAsync(spec));
+    }
+    // Loading already
+    QVERIFY(cache.loadAsync(m_tiles.first()));
+    // Not cached, to be fetched
+    QVERIFY(!cache.loadAsync(QGeoTileSpec(QStringLiteral("test"), 1, 4, 0, 0)));
+
+    QTRY_COMPARE(loadedSpy.count(), m_tiles.size());
+    QCOMPARE(failedSpy.count(), 0);
+    QCOMPARE(loadedTiles(loadedSpy), QSet<QGeoTileSpec>(m_tiles.cbegin(), m_tiles.cend()));
+    for (const QGeoTileSpec &spec : qAsConst(m_tiles)) {
+        const QSharedPointer<QGeoTileTexture> texture = cache.getLoaded(spec);
+        QVERIFY(texture);
+        QCOMPARE(texture->image.size(), QSize(8, 8));
+    }
+
+    // A tile in the memory cache is only decoded
+    const QGeoTileSpec memory(QStringLiteral("test"), 1, 4, 1, 1);
+    cache.insert(memory, tileData(1), QGeoTileFormat::Png, QAbstractGeoTileCache::MemoryCache);
+    QVERIFY(cache.loadAsync(memory));
+    QTRY_COMPARE(loadedSpy.count(), m_tiles.size() + 1);
+    QVERIFY(cache.getLoaded(memory));
+}
+
+void tst_QGeoFileTileCache::boundedLoads()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TileCacheTest cache(dir.path());
+    GatedStorage *storage = new GatedStorage;
+    cache.setDiskStorage(storage);
+    static_cast<QAbstractGeoTileCache &>(cache).init();
+    fillCache(&cache, m_tiles);
+
+    // As many reads as there are pool threads, the others wait their turn
+    const int maxLoads = qBound(1, QThread::idealThreadCount() / 2, 4);
+    QSignalSpy loadedSpy(&cache, &QAbstractGeoTileCache::tileLoaded);
+    storage->setClosed(true);
+    for (const QGeoTileSpec &spec : qAsConst(m_tiles))
+        QVERIFY(cache.loadAsync(spec));
+    QTRY_COMPARE(storage->running(), maxLoads);
+    QTest::qWait(50);
+    QCOMPARE(storage->running(), maxLoads);
+    QCOMPARE(loadedSpy.count(), 0);
+
+    storage->setClosed(false);
+    QTRY_COMPARE(loadedSpy.count(), m_tiles.size());
+    QCOMPARE(storage->peak(), maxLoads);
+}
+
+void tst_QGeoFileTileCache::cancelLoads()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TileCacheTest cache(dir.path());
+    GatedStorage *storage = new GatedStorage;
+    cache.setDiskStorage(storage);
+    static_cast<QAbstractGeoTileCache &>(cache).init();
+    fillCache(&cache, m_tiles);
+
+    QSignalSpy loadedSpy(&cache, &QAbstractGeoTileCache::tileLoaded);
+    QSignalSpy failedSpy(&cache, &QAbstractGeoTileCache::tileLoadFailed);
+    storage->setClosed(true);
+    for (const QGeoTileSpec &spec : qAsConst(m_tiles))
+        QVERIFY(cache.loadAsync(spec));
+    QTRY_VERIFY(storage->running() > 0);
+
+    // Those that left the visible set, some reading already, the others queued
+    const QSet<QGeoTileSpec> kept(m_tiles.cbegin(), m_tiles.cbegin() + m_tiles.size() / 2);
+    const QSet<QGeoTileSpec> cancelled(m_tiles.cbegin() + m_tiles.size() / 2, m_tiles.cend());
+    cache.cancelLoads(cancelled);
+    storage->setClosed(false);
+
+    QTRY_COMPARE(loadedSpy.count(), kept.size());
+    QTest::qWait(50);
+    QCOMPARE(loadedSpy.count(), kept.size());
+    QCOMPARE(failedSpy.count(), 0);
+    QCOMPARE(loadedTiles(loadedSpy), kept);
+    for (const QGeoTileSpec &spec : cancelled)
+        QVERIFY(!cache.getLoaded(spec));
+
+    // A cancelled tile can be loaded again
+    QVERIFY(cache.loadAsync(*cancelled.cbegin()));
+    QTRY_COMPARE(loadedSpy.count(), kept.size() + 1);
+    QVERIFY(cache.getLoaded(*cancelled.cbegin()));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoFileTileCache)
+
+#include "tst_qgeofiletilecache.moc"
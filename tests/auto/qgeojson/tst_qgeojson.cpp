@@ -32,6 +32,10 @@
 #include <QtCore/QVariant>
 #include <QtCore/QList>
 #include <QtLocation/private/qgeojson_p.h>
+#include <QtLocation/private/qgeojsonimporter_p.h>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
 
 QT_USE_NAMESPACE
 
@@ -41,11 +45,36 @@ class tst_QGeoJson : public QObject
 
 private Q_SLOTS:
     void testGeojson();
+    void streamingImport_data();
+    void streamingImport();
+    void streamingImportErrors();
+    void importerBatches();
 
 private:
     QString testDataDir;
 };
 
+static QByteArray readTestFile(const QString &name)
+{
+    QFile file(QFINDTESTDATA(name));
+    file.open(QFile::ReadOnly);
+    return file.readAll();
+}
+
+// Collects the simple geometries of an importGeoJson result in document order
+static void flatten(const QVariantMap &map, QVariantList *parts)
+{
+    const QString type = map.value(QStringLiteral("type")).toString();
+    if (type == QLatin1String("FeatureCollection") || type == QLatin1String("GeometryCollection")
+            || type.startsWith(QLatin1String("Multi"))) {
+        const QVariantList children = map.value(QStringLiteral("data")).toList();
+        for (const QVariant &child : children)
+            flatten(child.toMap(), parts);
+    } else {
+        parts->append(map);
+    }
+}
+
 void tst_QGeoJson::testGeojson()
 {
     QJsonDocument originalDocument;
@@ -85,5 +114,130 @@ void tst_QGeoJson::testGeojson()
     }
 }
 
+void tst_QGeoJson::streamingImport_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("point") << QStringLiteral("01-point.json");
+    QTest::newRow("linestring") << QStringLiteral("02-linestring.json");
+    QTest::newRow("multipoint") << QStringLiteral("03-multipoint.json");
+    QTest::newRow("polygon") << QStringLiteral("04-polygon.json");
+    QTest::newRow("multilinestring") << QStringLiteral("05-multilinestring.json");
+    QTest::newRow("multipolygon") << QStringLiteral("06-multipolygon.json");
+    QTest::newRow("geometrycollection") << QStringLiteral("07-geometrycollection.json");
+    QTest::newRow("feature") << QStringLiteral("08-feature.json");
+    QTest::newRow("featurecollection") << QStringLiteral("09-featurecollection.json");
+    QTest::newRow("countries") << QStringLiteral("10-countries.json");
+    QTest::newRow("full") << QStringLiteral("11-full.json");
+}
+
+void tst_QGeoJson::streamingImport()
+{
+    QFETCH(QString, fileName);
+
+    const QByteArray json = readTestFile(fileName);
+    QVariantList expected;
+    for (const QVariant &item : QGeoJson::importGeoJson(QJsonDocument::fromJson(json)))
+        flatten(item.toMap(), &expected);
+
+    QString errorString;
+    const QList<QGeoJsonFeature> features = QGeoJsonImporter::readAll(json, &errorString);
+    QVERIFY2(errorString.isEmpty(), qPrintable(errorString));
+    QCOMPARE(features.size(), expected.size());
+
+    for (qsizetype i = 0; i < features.size(); ++i) {
+        const QGeoJsonFeature &feature = features.at(i);
+        const QVariantMap map = expected.at(i).toMap();
+        QCOMPARE(feature.type, map.value(QStringLiteral("type")).toString());
+        const QVariant data = map.value(QStringLiteral("data"));
+        if (feature.type == QLatin1String("Point")) {
+            QCOMPARE(QGeoCircle(feature.geometry), data.value<QGeoCircle>());
+        } else if (feature.type == QLatin1String("LineString")) {
+            QCOMPARE(QGeoPath(feature.geometry), data.value<QGeoPath>());
+        } else {
+            // importGeoJson carries the holes over between the polygons of a
+            // MultiPolygon, so only the perimeters are compared
+            QCOMPARE(QGeoPolygon(feature.geometry).perimeter(),
+                     data.value<QGeoPolygon>().perimeter());
+        }
+        if (map.contains(QStringLiteral("properties")))
+            QCOMPARE(feature.properties(), map.value(QStringLiteral("properties")).toMap());
+        if (map.contains(QStringLiteral("id")))
+            QCOMPARE(feature.id, map.value(QStringLiteral("id")));
+    }
+}
+
+void tst_QGeoJson::streamingImportErrors()
+{
+    QString errorString;
+    QGeoJsonImporter::readAll("{\"type\": \"Point\", \"coordinates\": [1, ", &errorString);
+    QVERIFY(!errorString.isEmpty());
+
+    QGeoJsonImporter::readAll("[]", &errorString);
+    QVERIFY(!errorString.isEmpty());
+
+    // Members in any order, escapes in strings
+    const QList<QGeoJsonFeature> features = QGeoJsonImporter::readAll(
+                "{\"features\": [{\"geometry\": {\"coordinates\": [[1, 2], [3, 4]],"
+                " \"type\": \"MultiPoint\"}, \"id\": \"a\\u00e9\\\"\", \"type\": \"Feature\","
+                " \"properties\": {\"n\": 1}}], \"type\": \"FeatureCollection\"}", &errorString);
+    QVERIFY2(errorString.isEmpty(), qPrintable(errorString));
+    QCOMPARE(features.size(), 2);
+    QCOMPARE(features.at(1).featureIndex, 0);
+    QCOMPARE(features.at(1).type, QStringLiteral("Point"));
+    QCOMPARE(QGeoCircle(features.at(1).geometry).center(), QGeoCoordinate(4, 3));
+    QCOMPARE(features.at(0).id.toString(), QString(u"a\u00e9\""));
+    QCOMPARE(features.at(0).properties().value(QStringLiteral("n")).toInt(), 1);
+
+    // A sink returning false stops the reader without an error
+    int count = 0;
+    QVERIFY(!QGeoJsonImporter::read(readTestFile(QStringLiteral("10-countries.json")),
+                                    [&count](QGeoJsonFeature &&, qint64) { return ++count < 3; },
+                                    &errorString));
+    QCOMPARE(count, 3);
+    QVERIFY(errorString.isEmpty());
+}
+
+void tst_QGeoJson::importerBatches()
+{
+    const QByteArray json = readTestFile(QStringLiteral("10-countries.json"));
+    const qsizetype total = QGeoJsonImporter::readAll(json).size();
+    QVERIFY(total > 10);
+
+    QGeoJsonImporter importer;
+    importer.setBatchSize(10);
+    QSignalSpy batchSpy(&importer, &QGeoJsonImporter::featuresImported);
+    QSignalSpy progressSpy(&importer, &QGeoJsonImporter::progressChanged);
+    QSignalSpy finishedSpy(&importer, &QGeoJsonImporter::finished);
+
+    importer.importFile(QFINDTESTDATA("10-countries.json"));
+    QVERIFY(importer.isRunning());
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QVERIFY(!importer.isRunning());
+
+    qsizetype imported = 0;
+    for (const QList<QVariant> &arguments : qAsConst(batchSpy)) {
+        const auto batch = arguments.at(0).value<QList<QGeoJsonFeature>>();
+        QVERIFY(batch.size() <= 10);
+        imported += batch.size();
+    }
+    QCOMPARE(imported, total);
+    QCOMPARE(progressSpy.last().at(0).toLongLong(), qint64(json.size()));
+
+    // A cancelled import reports nothing
+    batchSpy.clear();
+    finishedSpy.clear();
+    importer.importData(json);
+    importer.cancel();
+    QTest::qWait(100);
+    QCOMPARE(batchSpy.count(), 0);
+    QCOMPARE(finishedSpy.count(), 0);
+
+    QSignalSpy errorSpy(&importer, &QGeoJsonImporter::errorOccurred);
+    importer.importData(json.left(json.size() / 2));
+    QTRY_COMPARE(errorSpy.count(), 1);
+    QCOMPARE(finishedSpy.count(), 0);
+}
+
 QTEST_MAIN(tst_QGeoJson)
 #include "tst_qgeojson.moc"
@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QRandomGenerator>
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qgeomapitemindex_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapItemIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoRectangle rect(double top, double left, double bottom, double right);
+
+private Q_SLOTS:
+    void intersecting();
+    void containing();
+    void insertionOrder();
+    void update();
+    void remove();
+    void dateline();
+    void invalidBounds();
+    void matchesLinearScan();
+};
+
+QGeoRectangle tst_QGeoMapItemIndex::rect(double top, double left, double bottom, double right)
+{
+    return QGeoRectangle(QGeoCoordinate(top, left), QGeoCoordinate(bottom, right));
+}
+
+void tst_QGeoMapItemIndex::intersecting()
+{
+    QGeoMapItemIndex<int> index;
+    index.insert(1, rect(10, 10, 0, 20));
+    index.insert(2, rect(50, -100, 40, -90));
+    index.insert(3, rect(80, -170, -80, 170)); // large, stays near the root
+    QCOMPARE(index.size(), 3);
+
+    QCOMPARE(index.intersecting(rect(15, 15, 5, 25)), QList<int>({ 1, 3 }));
+    QCOMPARE(index.intersecting(rect(45, -95, 44, -94)), QList<int>({ 2, 3 }));
+    QCOMPARE(index.intersecting(rect(-85, -10, -89, 10)), QList<int>());
+    // touching boxes intersect
+    QCOMPARE(index.intersecting(rect(0, 20, -1, 21)), QList<int>({ 1, 3 }));
+}
+
+void tst_QGeoMapItemIndex::containing()
+{
+    QGeoMapItemIndex<int> index;
+    index.insert(1, rect(10, 10, 0, 20));
+    index.insert(2, rect(5, 15, 0, 16));
+    index.insert(3, rect(10, 30, 0, 40));
+
+    QCOMPARE(index.containing(QGeoCoordinate(5, 15)), QList<int>({ 1, 2 }));
+    QCOMPARE(index.containing(QGeoCoordinate(5, 35)), QList<int>({ 3 }));
+    QCOMPARE(index.containing(QGeoCoordinate(5, 25)), QList<int>());
+    QCOMPARE(index.containing(QGeoCoordinate()), QList<int>());
+}
+
+void tst_QGeoMapItemIndex::insertionOrder()
+{
+    QGeoMapItemIndex<int> index;
+    // Different sizes end up in different nodes
+    index.insert(5, rect(2, 1, 0, 2));
+    index.insert(4, rect(60, -60, -60, 60));
+    index.insert(3, rect(2, 1, 0, 3));
+    index.insert(2, rect(30, -30, -30, 30));
+    index.insert(1, rect(1.5, 1.5, 1.4, 1.6));
+
+    QCOMPARE(index.containing(QGeoCoordinate(1, 1.5)), QList<int>({ 5, 4, 3, 2 }));
+    QCOMPARE(index.containing(QGeoCoordinate(1.45, 1.55)), QList<int>({ 5, 4, 3, 2, 1 }));
+}
+
+void tst_QGeoMapItemIndex::update()
+{
+    QGeoMapItemIndex<int> index;
+    index.insert(1, rect(10, 10, 0, 20));
+    index.insert(2, rect(10, 10, 0, 20));
+
+    // moving keeps the insertion order
+    index.insert(1, rect(-10, -20, -20, -10));
+    QCOMPARE(index.size(), 2);
+    QCOMPARE(index.containing(QGeoCoordinate(5, 15)), QList<int>({ 2 }));
+    QCOMPARE(index.containing(QGeoCoordinate(-15, -15)), QList<int>({ 1 }));
+
+    index.insert(1, rect(10, 10, 0, 20));
+    QCOMPARE(index.containing(QGeoCoordinate(5, 15)), QList<int>({ 1, 2 }));
+}
+
+void tst_QGeoMapItemIndex::remove()
+{
+    QGeoMapItemIndex<int> index;
+    index.insert(1, rect(10, 10, 0, 20));
+    index.insert(2, rect(10, 10, 0, 20));
+
+    QVERIFY(index.remove(1));
+    QVERIFY(!index.remove(1));
+    QVERIFY(!index.contains(1));
+    QVERIFY(index.contains(2));
+    QCOMPARE(index.size(), 1);
+    QCOMPARE(index.containing(QGeoCoordinate(5, 15)), QList<int>({ 2 }));
+
+    index.clear();
+    QCOMPARE(index.size(), 0);
+    QCOMPARE(index.containing(QGeoCoordinate(5, 15)), QList<int>());
+}
+
+void tst_QGeoMapItemIndex::dateline()
+{
+    QGeoMapItemIndex<int> index;
+    index.insert(1, rect(10, 170, 0, -170));
+    index.insert(2, rect(10, 160, 0, 165));
+
+    QCOMPARE(index.containing(QGeoCoordinate(5, 175)), QList<int>({ 1 }));
+    QCOMPARE(index.containing(QGeoCoordinate(5, -175)), QList<int>({ 1 }));
+    QCOMPARE(index.containing(QGeoCoordinate(5, 0)), QList<int>());
+
+    // a query crossing the dateline, reported once
+    QCOMPARE(index.intersecting(rect(20, 150, -20, -150)), QList<int>({ 1, 2 }));
+    QCOMPARE(index.intersecting(rect(20, 179, -20, -179)), QList<int>({ 1 }));
+
+    QVERIFY(index.remove(1));
+    QCOMPARE(index.containing(QGeoCoordinate(5, -175)), QList<int>());
+}
+
+void tst_QGeoMapItemIndex::invalidBounds()
+{
+    QGeoMapItemIndex<int> index;
+    index.insert(1, QGeoRectangle());
+    QVERIFY(index.contains(1));
+    QCOMPARE(index.intersecting(rect(90, -180, -90, 180)), QList<int>());
+    QCOMPARE(index.intersecting(QGeoRectangle()), QList<int>());
+
+    index.insert(1, rect(10, 10, 0, 20));
+    QCOMPARE(index.intersecting(rect(90, -180, -90, 180)), QList<int>({ 1 }));
+}
+
+void tst_QGeoMapItemIndex::matchesLinearScan()
+{
+    QRandomGenerator rng(42);
+    auto randomRect = [&rng](double maxSize) {
+        const double width = rng.bounded(maxSize);
+        const double height = rng.bounded(maxSize);
+        const double left = -180.0 + rng.bounded(360.0 - width);
+        const double bottom = -90.0 + rng.bounded(180.0 - height);
+        return rect(bottom + height, left, bottom, left + width);
+    };
+
+    QGeoMapItemIndex<int> index;
+    QList<QGeoRectangle> boxes;
+    for (int i = 0; i < 2000; ++i) {
+        boxes.append(randomRect(i % 10 ? 2.0 : 60.0));
+        index.insert(i, boxes.last());
+    }
+    for (int i = 0; i < 2000; i += 3) {
+        boxes[i] = randomRect(5.0);
+        index.insert(i, boxes[i]);
+    }
+
+    for (int q = 0; q < 200; ++q) {
+        const QGeoRectangle query = randomRect(q % 2 ? 1.0 : 40.0);
+        QList<int> expected;
+        for (int i = 0; i < boxes.size(); ++i) {
+            if (boxes.at(i).intersects(query))
+                expected.append(i);
+        }
+        QCOMPARE(index.intersecting(query), expected);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoMapItemIndex)
+
+#include "tst_qgeomapitemindex.moc"
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2023 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qmath.h>
+#include <QtTest/QtTest>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <QtLocation/private/qgeomapitemgeometry_rhi_p.h>
+#include <QtLocation/private/qgeosimplify_p.h>
+
+#include <algorithm>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapItemLOD : public QObject
+{
+    Q_OBJECT
+
+private:
+    static void fillVertices(QGeoMapItemLODGeometry *geometry, int count, double amplitude);
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void threadCount();
+    void lastRequestStored();
+    void geometryDestroyed();
+
+private:
+    int m_threadCount = 0;
+};
+
+// A wavy line across a quarter of the world, in mercator coordinates
+void tst_QGeoMapItemLOD::fillVertices(QGeoMapItemLODGeometry *geometry, int count, double amplitude)
+{
+    geometry->m_vertices->clear();
+    for (int i = 0; i < count; ++i) {
+        const double t = double(i) / count;
+        geometry->m_vertices->append(QDoubleVector2D(0.4 + 0.25 * t,
+                                                     0.4 + amplitude * std::sin(t * 200)
+                                                         + amplitude * 0.1 * std::sin(t * 5000)));
+    }
+}
+
+void tst_QGeoMapItemLOD::initTestCase()
+{
+    m_threadCount = QGeoMapItemLODGeometry::simplificationThreadCount();
+}
+
+void tst_QGeoMapItemLOD::cleanupTestCase()
+{
+    QGeoMapItemLODGeometry::setSimplificationThreadCount(m_threadCount);
+}
+
+void tst_QGeoMapItemLOD::threadCount()
+{
+    QGeoMapItemLODGeometry::setSimplificationThreadCount(3);
+    QCOMPARE(QGeoMapItemLODGeometry::simplificationThreadCount(), 3);
+    QGeoMapItemLODGeometry::setSimplificationThreadCount(0);
+    QCOMPARE(QGeoMapItemLODGeometry::simplificationThreadCount(), 1);
+}
+
+void tst_QGeoMapItemLOD::lastRequestStored()
+{
+    QGeoMapItemLODGeometry::setSimplificationThreadCount(1);
+
+    QGeoMapItemLODGeometry geometry;
+    int ready = 0;
+    geometry.setLODReadyCallback([&ready]() { ++ready; });
+
+    // Data changes and zoom changes in a row, as while the item is being edited
+    // and the map zoomed: only the latest vertices get ranked, once
+    fillVertices(&geometry, 20000, 0.01);
+    geometry.selectLODOnDataChanged(14, 0.0);
+    QVERIFY(geometry.isLODPending());
+    geometry.resetLOD();
+    fillVertices(&geometry, 5000, 0.02);
+    geometry.selectLODOnDataChanged(5, 0.0);
+    QVERIFY(!geometry.selectLODOnLODMismatch(9, 0.0, false));
+    QVERIFY(!geometry.selectLODOnLODMismatch(14, 0.0, false));
+    QCOMPARE(geometry.m_lod, 0u);
+    QCOMPARE(geometry.vertexCount(), qsizetype(5000));
+
+    QTRY_COMPARE(ready, 1);
+    QTest::qWait(100);
+    QCOMPARE(ready, 1);
+    QVERIFY(!geometry.isLODPending());
+    const QList<quint8> expected = QGeoSimplify::geoSimplifyZoomLevels(
+            *geometry.m_vertices, 0.0, QGeoMapItemLODGeometry::zoomForLOD(20));
+    QCOMPARE(geometry.m_vertexZoomLevels, expected);
+
+    // The item picks up the LOD of the last zoom level once called back
+    QVERIFY(geometry.selectLODOnLODMismatch(14, 0.0, false));
+    QVERIFY(geometry.isLODActive(14));
+    const unsigned int zoom = QGeoMapItemLODGeometry::lodZoomLevel(QGeoMapItemLODGeometry::zoomToLOD(14));
+    const qsizetype kept = std::count_if(expected.cbegin(), expected.cend(),
+                                         [zoom](quint8 zoomLevel) { return zoomLevel <= zoom; });
+    QCOMPARE(geometry.vertexCount(), kept);
+    QVERIFY(kept < 5000);
+
+    qsizetype walked = 0;
+    for (qsizetype i = geometry.nextVertex(-1); i < geometry.m_vertices->size(); i = geometry.nextVertex(i))
+        ++walked;
+    QCOMPARE(walked, kept);
+
+    // Other zoom levels don't need the background again
+    QVERIFY(geometry.selectLODOnLODMismatch(5, 0.0, false));
+    QVERIFY(geometry.isLODActive(5));
+    QVERIFY(!geometry.isLODPending());
+    QTest::qWait(50);
+    QCOMPARE(ready, 1);
+}
+
+void tst_QGeoMapItemLOD::geometryDestroyed()
+{
+    QGeoMapItemLODGeometry::setSimplificationThreadCount(1);
+
+    int ready = 0;
+    {
+        QGeoMapItemLODGeometry geometry;
+        geometry.setLODReadyCallback([&ready]() { ++ready; });
+        fillVertices(&geometry, 20000, 0.01);
+        geometry.selectLODOnDataChanged(14, 0.0);
+        QVERIFY(geometry.isLODPending());
+    }
+
+    // The result arrives for a geometry that is gone and is dropped
+    QTest::qWait(500);
+    QCOMPARE(ready, 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoMapItemLOD)
+
+#include "tst_qgeomapitemlod.moc"
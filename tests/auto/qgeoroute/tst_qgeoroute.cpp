@@ -259,6 +259,76 @@ void tst_QGeoRoute::operators()
     QCOMPARE(r.travelTime(), 123456);
 }
 
+void tst_QGeoRoute::packedPath()
+{
+    QList<QGeoCoordinate> path;
+    path << QGeoCoordinate(1.0, 2.0) << QGeoCoordinate(3.0, 4.0, 100.0) << QGeoCoordinate(5.0, 6.0);
+    QGeoCoordinate latitudeOnly;
+    latitudeOnly.setLatitude(7.0);
+    path << latitudeOnly;
+
+    const QGeoPackedPath packed(path);
+    QCOMPARE(packed.size(), path.size());
+    QCOMPARE(packed.toList(), path);
+    QVERIFY(qIsNaN(packed.altitude(0)));
+    QCOMPARE(packed.altitude(1), 100.0);
+    QVERIFY(qIsNaN(packed.longitude(3)));
+
+    QGeoRoute route;
+    QGeoRoutePrivate::get(route)->setPackedPath(packed);
+    QCOMPARE(route.path(), path);
+
+    QGeoRoute other;
+    other.setPath(path);
+    QVERIFY(QGeoRoutePrivate::get(route)->packedPath() == QGeoRoutePrivate::get(other)->packedPath());
+    path.last().setLatitude(8.0);
+    other.setPath(path);
+    QVERIFY(QGeoRoutePrivate::get(route)->packedPath() != QGeoRoutePrivate::get(other)->packedPath());
+}
+
+void tst_QGeoRoute::packedPathRanges()
+{
+    QGeoPackedPath path;
+    for (int i = 0; i < 10; ++i)
+        path.append(i, i * 2);
+
+    // Ranges share the buffer, until appended to
+    QGeoPackedPath head = path.mid(0, 4);
+    const QGeoPackedPath tail = path.mid(4);
+    QVERIFY(head.sharesBuffer(path));
+    QVERIFY(tail.sharesBuffer(path));
+    QCOMPARE(head.size(), 4);
+    QCOMPARE(tail.size(), 6);
+    QCOMPARE(tail.latitude(0), 4.0);
+    QCOMPARE(tail.longitude(5), 18.0);
+    QCOMPARE(head.constData() + 8, tail.constData());
+
+    head.append(42.0, 43.0);
+    QVERIFY(!head.sharesBuffer(path));
+    QCOMPARE(head.size(), 5);
+    QCOMPARE(head.latitude(4), 42.0);
+    QCOMPARE(path.latitude(4), 4.0);
+    QCOMPARE(tail.latitude(0), 4.0);
+
+    QGeoPackedPath joined = path.mid(0, 4);
+    joined.append(tail);
+    QCOMPARE(joined, path);
+
+    QVERIFY(path.mid(10).isEmpty());
+    QCOMPARE(path.mid(8, 5).size(), 2);
+}
+
+void tst_QGeoRoute::packedPathBounds()
+{
+    QList<QGeoCoordinate> path;
+    path << QGeoCoordinate(10.0, 170.0) << QGeoCoordinate(-5.0, -175.0) << QGeoCoordinate(20.0, 179.0);
+    QCOMPARE(QGeoPackedPath(path).boundingGeoRectangle(), QGeoPath(path).boundingGeoRectangle());
+
+    path.clear();
+    path << QGeoCoordinate(1.0, 1.0) << QGeoCoordinate(-2.0, 3.0) << QGeoCoordinate(4.0, -5.0);
+    QCOMPARE(QGeoPackedPath(path).boundingGeoRectangle(), QGeoPath(path).boundingGeoRectangle());
+}
+
 
 
 QTEST_APPLESS_MAIN(tst_QGeoRoute);
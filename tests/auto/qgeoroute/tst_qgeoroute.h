@@ -38,6 +38,9 @@
 #include <qgeocoordinate.h>
 #include <qgeorouterequest.h>
 #include <qgeoroutesegment.h>
+#include <QtPositioning/QGeoPath>
+#include <QtLocation/private/qgeoroute_p.h>
+#include <QtLocation/private/qgeopackedpath_p.h>
 
 
 QT_USE_NAMESPACE
@@ -64,6 +67,9 @@ private Q_SLOTS:
     void travelMode_data();
     void travelTime();
     void operators();
+    void packedPath();
+    void packedPathRanges();
+    void packedPathBounds();
     //End Unit Test for QGeoRoute
 };
 
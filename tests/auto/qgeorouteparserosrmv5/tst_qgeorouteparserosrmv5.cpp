@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteRequest>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoRouteParserOsrmV5 : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void parseReply();
+    void parseReplyAsync();
+    void polyline5();
+    void errors_data();
+    void errors();
+};
+
+static QByteArray step(const char *geometry, double lat, double lon, const char *type)
+{
+    return QByteArray(R"({"geometry": ")") + geometry + R"(", "duration": 10, "distance": 100,
+                         "name": "Street", "intersections": [],
+                         "maneuver": {"type": ")" + type + R"(", "location": [)"
+            + QByteArray::number(lon, 'f', 6) + ", " + QByteArray::number(lat, 'f', 6) + "]}}";
+}
+
+static QByteArray route(const QList<QByteArray> &steps)
+{
+    QByteArray reply = R"({"distance": 500, "duration": 50, "legs": [{"distance": 500, "duration": 50, "steps": [)";
+    reply += steps.join(',');
+    return reply + "]}]}";
+}
+
+// Two alternatives, the first of two steps, both ending at the same point
+static QByteArray twoRoutes()
+{
+    return R"({"code": "Ok", "routes": [)"
+            + route({ step("ocqdcBspdqX_}@k`Aw|AskC", 52.520008, 13.404954, "depart"),
+                      step("g_vdcBs~jqXg^klB", 52.5225, 13.40825, "arrive") }) + ","
+            + route({ step("ocqdcBspdqX~}@{{F_yFo}@", 52.520008, 13.404954, "depart") })
+            + "]}";
+}
+
+static void compareFirstRoutes(const QList<QGeoRoute> &routes)
+{
+    QCOMPARE(routes.size(), 2);
+
+    const QList<QGeoCoordinate> path = routes.at(0).path();
+    QCOMPARE(path.size(), 5);
+    QCOMPARE(path.at(0), QGeoCoordinate(52.520008, 13.404954));
+    QCOMPARE(path.at(2), QGeoCoordinate(52.5225, 13.40825));
+    QCOMPARE(path.at(4), QGeoCoordinate(52.523, 13.41));
+
+    const QGeoRouteSegment first = routes.at(0).firstRouteSegment();
+    QCOMPARE(first.path().size(), 3);
+    QCOMPARE(first.nextRouteSegment().path().size(), 2);
+    QCOMPARE(first.nextRouteSegment().path().first(), path.at(3));
+    QCOMPARE(routes.at(0).routeLegs().size(), 1);
+    QCOMPARE(routes.at(0).routeLegs().first().path(), path);
+
+    QCOMPARE(routes.at(1).path().size(), 3);
+    QCOMPARE(routes.at(1).path().at(1), QGeoCoordinate(52.519, 13.409));
+}
+
+void tst_QGeoRouteParserOsrmV5::parseReply()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoRoute> routes;
+    QString errorString;
+    QCOMPARE(parser.parseReply(routes, errorString, twoRoutes()), QGeoRouteReply::NoError);
+    compareFirstRoutes(routes);
+}
+
+void tst_QGeoRouteParserOsrmV5::parseReplyAsync()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoRoute> expected;
+    QString errorString;
+    parser.parseReply(expected, errorString, twoRoutes());
+
+    QGeoRouteParserJob *job = parser.parseReplyAsync(twoRoutes());
+    QPointer<QGeoRouteParserJob> guard(job);
+    bool finished = false;
+    QList<QGeoRoute> routes;
+    connect(job, &QGeoRouteParserJob::finished, this,
+            [&](QGeoRouteReply::Error error, const QString &, const QList<QGeoRoute> &result) {
+        QCOMPARE(error, QGeoRouteReply::NoError);
+        routes = result;
+        finished = true;
+    });
+    QTRY_VERIFY(finished);
+    // In the order of the reply, whichever thread finished first
+    compareFirstRoutes(routes);
+    QCOMPARE(routes, expected);
+    QTRY_VERIFY(guard.isNull());
+}
+
+void tst_QGeoRouteParserOsrmV5::polyline5()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QCOMPARE(parser.polylinePrecision(), 6);
+    parser.setPolylinePrecision(4);
+    QCOMPARE(parser.polylinePrecision(), 6);
+    parser.setPolylinePrecision(5);
+    QCOMPARE(parser.polylinePrecision(), 5);
+
+    const QGeoRouteRequest request(QGeoCoordinate(52.52, 13.40), QGeoCoordinate(52.53, 13.41));
+    const QUrlQuery query(parser.requestUrl(request, QStringLiteral("http://localhost/")));
+    QCOMPARE(query.queryItemValue(QStringLiteral("geometries")), QStringLiteral("polyline"));
+
+    const QByteArray reply = R"({"code": "Ok", "routes": [)"
+            + route({ step("ayp_I}cypAeEqEkHaM", 52.52001, 13.40495, "depart") }) + "]}";
+    QList<QGeoRoute> routes;
+    QString errorString;
+    QCOMPARE(parser.parseReply(routes, errorString, reply), QGeoRouteReply::NoError);
+    QCOMPARE(routes.size(), 1);
+    const QList<QGeoCoordinate> path = routes.first().path();
+    QCOMPARE(path.size(), 3);
+    QCOMPARE(path.at(0), QGeoCoordinate(52.52001, 13.40495));
+    QCOMPARE(path.at(2), QGeoCoordinate(52.52250, 13.40825));
+}
+
+void tst_QGeoRouteParserOsrmV5::errors_data()
+{
+    QTest::addColumn<QByteArray>("reply");
+    QTest::addColumn<QGeoRouteReply::Error>("error");
+    QTest::addColumn<QString>("errorString");
+
+    QTest::newRow("invalid json") << QByteArray("{\"code\": ") << QGeoRouteReply::ParseError
+                                  << QStringLiteral("Couldn't parse json.");
+    QTest::newRow("status") << QByteArray(R"({"code": "NoRoute"})") << QGeoRouteReply::UnknownError
+                            << QStringLiteral("NoRoute");
+    QTest::newRow("no routes") << QByteArray(R"({"code": "Ok"})") << QGeoRouteReply::ParseError
+                               << QStringLiteral("No routes found");
+}
+
+void tst_QGeoRouteParserOsrmV5::errors()
+{
+    QFETCH(QByteArray, reply);
+    QFETCH(QGeoRouteReply::Error, error);
+    QFETCH(QString, errorString);
+
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoRoute> routes;
+    QString syncErrorString;
+    QCOMPARE(parser.parseReply(routes, syncErrorString, reply), error);
+    QCOMPARE(syncErrorString, errorString);
+
+    QGeoRouteParserJob *job = parser.parseReplyAsync(reply);
+    bool finished = false;
+    connect(job, &QGeoRouteParserJob::finished, this,
+            [&](QGeoRouteReply::Error e, const QString &s, const QList<QGeoRoute> &result) {
+        QCOMPARE(e, error);
+        QCOMPARE(s, errorString);
+        QVERIFY(result.isEmpty());
+        finished = true;
+    });
+    QTRY_VERIFY(finished);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteParserOsrmV5)
+
+#include "tst_qgeorouteparserosrmv5.moc"
@@ -0,0 +1,246 @@
+/****************************************************************************
+**
+** Copyright (C) 2023 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QRandomGenerator>
+#include <QtCore/qmath.h>
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+
+#include <QtLocation/private/qgeosimplify_p.h>
+
+QT_USE_NAMESPACE
+
+using Vertices = QList<QDeclarativeGeoMapItemUtils::vec2>;
+Q_DECLARE_METATYPE(Vertices)
+
+// The Ramer-Douglas-Peucker simplification run separately for each zoom
+// level, as done before geoSimplifyZoomLevels(), returning the kept indices
+namespace Reference {
+
+QDoubleVector2D closestPoint(const QDoubleVector2D &p, const QDoubleVector2D &a,
+                             const QDoubleVector2D &b)
+{
+    if (a == b)
+        return a;
+
+    const double u = ((p.x() - a.x()) * (b.x() - a.x()) + (p.y() - a.y()) * (b.y() - a.y()))
+                   / (b - a).lengthSquared();
+    const QDoubleVector2D intersection(a.x() + u * (b.x() - a.x()) , a.y() + u * (b.y() - a.y()));
+    QDoubleVector2D candidate = ((p - a).length() < (p - b).length()) ? a : b;
+    if (u > 0 && u < 1 && (p - intersection).length() < (p - candidate).length())
+        candidate = intersection;
+    return candidate;
+}
+
+QGeoCoordinate unwrappedToGeo(QDoubleVector2D p, double leftBound)
+{
+    if (p.x() > 1.0)
+        p.setX(p.x() - leftBound);
+    return QWebMercator::mercatorToCoord(p);
+}
+
+double getSegDist(const QDoubleVector2D &p, const QDoubleVector2D &a, const QDoubleVector2D &b,
+                  double leftBound)
+{
+    return unwrappedToGeo(closestPoint(p, a, b), leftBound).distanceTo(unwrappedToGeo(p, leftBound));
+}
+
+double pixelDistanceAtZoomAndLatitude(int zoom, double latitude)
+{
+    return QLocationUtils::earthMeanCircumference() * std::cos(QLocationUtils::radians(latitude))
+         / double(1 << (zoom + 8));
+}
+
+void simplifyStep(const QList<QDoubleVector2D> &points, double leftBound, qsizetype first,
+                  qsizetype last, int zoomLevel, QList<qsizetype> &simplified)
+{
+    const QGeoCoordinate firstC = unwrappedToGeo(points.at(first), leftBound);
+    const QGeoCoordinate lastC = unwrappedToGeo(points.at(last), leftBound);
+    double maxDistanceFound = (pixelDistanceAtZoomAndLatitude(zoomLevel, firstC.latitude())
+                             + pixelDistanceAtZoomAndLatitude(zoomLevel, lastC.latitude())) * 0.5;
+    qsizetype index = -1;
+    for (qsizetype i = first + 1; i < last; i++) {
+        const double distance = getSegDist(points.at(i), points.at(first), points.at(last), leftBound);
+        if (distance > maxDistanceFound) {
+            index = i;
+            maxDistanceFound = distance;
+        }
+    }
+
+    if (index > 0) {
+        if (index - first > 1)
+            simplifyStep(points, leftBound, first, index, zoomLevel, simplified);
+        simplified.append(index);
+        if (last - index > 1)
+            simplifyStep(points, leftBound, index, last, zoomLevel, simplified);
+    }
+}
+
+QList<qsizetype> geoSimplifyZL(const QList<QDoubleVector2D> &points, double leftBound, int zoomLevel)
+{
+    QList<qsizetype> simplified;
+    for (qsizetype i = 0; i < points.size(); ++i)
+        simplified.append(i);
+    if (points.size() <= 2)
+        return simplified;
+
+    const qsizetype last = points.size() - 1;
+    simplified = { 0 };
+    simplifyStep(points, leftBound, 0, last, zoomLevel, simplified);
+    simplified.append(last);
+    return simplified;
+}
+
+} // namespace Reference
+
+class tst_QGeoSimplify : public QObject
+{
+    Q_OBJECT
+
+private:
+    static Vertices vertices(const QList<QGeoCoordinate> &path, double leftBoundLongitude);
+
+private Q_SLOTS:
+    void matchesPerZoomSimplification_data();
+    void matchesPerZoomSimplification();
+};
+
+// Projected and unwrapped around the left bound like the map item geometries do
+Vertices tst_QGeoSimplify::vertices(const QList<QGeoCoordinate> &path, double leftBoundLongitude)
+{
+    const double leftBound = QWebMercator::coordToMercator(QGeoCoordinate(0, leftBoundLongitude)).x();
+    Vertices result;
+    for (const QGeoCoordinate &coordinate : path) {
+        QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
+        if (p.x() < leftBound)
+            p.setX(p.x() + 1.0);
+        result.append(p);
+    }
+    return result;
+}
+
+void tst_QGeoSimplify::matchesPerZoomSimplification_data()
+{
+    QTest::addColumn<Vertices>("points");
+    QTest::addColumn<double>("leftBound");
+
+    QRandomGenerator random(42);
+    auto jitter = [&random](double amplitude) {
+        return (random.generateDouble() - 0.5) * amplitude;
+    };
+
+    QTest::newRow("empty") << Vertices() << 0.0;
+    QTest::newRow("two points")
+            << vertices({ QGeoCoordinate(10, 10), QGeoCoordinate(20, 20) }, 10) << 0.0;
+    QTest::newRow("three points")
+            << vertices({ QGeoCoordinate(10, 10), QGeoCoordinate(15, 16), QGeoCoordinate(20, 20) }, 10)
+            << 0.0;
+
+    // Noise at every scale, from a few meters to a few degrees
+    QList<QGeoCoordinate> track;
+    for (int i = 0; i < 400; ++i) {
+        const double t = i / 400.0;
+        track.append(QGeoCoordinate(45 + 5 * std::sin(t * 7) + jitter(std::pow(10.0, -(i % 6))),
+                                    -30 + 60 * t + jitter(std::pow(10.0, -(i % 5)))));
+    }
+    QTest::newRow("noisy track") << vertices(track, -30) << 0.0;
+
+    // High latitudes, where the tolerance shrinks
+    QList<QGeoCoordinate> northern;
+    for (int i = 0; i < 200; ++i)
+        northern.append(QGeoCoordinate(75 + jitter(0.5), 10 + i * 0.1 + jitter(0.01)));
+    QTest::newRow("high latitude") << vertices(northern, 10) << 0.0;
+
+    // Closed paths: the first point comes back last
+    QList<QGeoCoordinate> circle;
+    for (int i = 0; i < 180; ++i) {
+        const double angle = 2 * M_PI * i / 180;
+        circle.append(QGeoCoordinate(20 + 3 * std::sin(angle) + jitter(0.001),
+                                     40 + 4 * std::cos(angle) + jitter(0.001)));
+    }
+    circle.append(circle.first());
+    QTest::newRow("closed circle") << vertices(circle, 36) << 0.0;
+
+    QList<QGeoCoordinate> square { QGeoCoordinate(-10, -10), QGeoCoordinate(-10, 10),
+                                   QGeoCoordinate(10, 10), QGeoCoordinate(10, -10),
+                                   QGeoCoordinate(-10, -10) };
+    QTest::newRow("closed square") << vertices(square, -10) << 0.0;
+
+    // Across the dateline, unwrapped past 1.0
+    QList<QGeoCoordinate> pacific;
+    for (int i = 0; i < 300; ++i) {
+        double longitude = 160 + i * 0.15 + jitter(0.05);
+        if (longitude > 180)
+            longitude -= 360;
+        pacific.append(QGeoCoordinate(-20 + 10 * std::sin(i / 30.0) + jitter(0.01), longitude));
+    }
+    const double pacificLeft = QWebMercator::coordToMercator(QGeoCoordinate(0, 160)).x();
+    QTest::newRow("dateline") << vertices(pacific, 160) << pacificLeft;
+
+    QList<QGeoCoordinate> fiji;
+    for (int i = 0; i < 120; ++i) {
+        const double angle = 2 * M_PI * i / 120;
+        double longitude = 179 + 3 * std::cos(angle) + jitter(0.01);
+        if (longitude > 180)
+            longitude -= 360;
+        fiji.append(QGeoCoordinate(-17 + 2 * std::sin(angle) + jitter(0.01), longitude));
+    }
+    fiji.append(fiji.first());
+    const double fijiLeft = QWebMercator::coordToMercator(QGeoCoordinate(0, 175)).x();
+    QTest::newRow("closed across the dateline") << vertices(fiji, 175) << fijiLeft;
+}
+
+void tst_QGeoSimplify::matchesPerZoomSimplification()
+{
+    QFETCH(Vertices, points);
+    QFETCH(double, leftBound);
+    const int maxZoomLevel = 20;
+
+    const QList<quint8> zoomLevels = QGeoSimplify::geoSimplifyZoomLevels(points, leftBound, maxZoomLevel);
+    QCOMPARE(zoomLevels.size(), points.size());
+
+    QList<QDoubleVector2D> input;
+    for (const QDeclarativeGeoMapItemUtils::vec2 &point : points)
+        input.append(point.toDoubleVector2D());
+
+    for (int zoom = 0; zoom <= maxZoomLevel; ++zoom) {
+        QList<qsizetype> kept;
+        for (qsizetype i = 0; i < zoomLevels.size(); ++i) {
+            if (zoomLevels.at(i) <= zoom)
+                kept.append(i);
+        }
+        QCOMPARE(kept, Reference::geoSimplifyZL(input, leftBound, zoom));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoSimplify)
+
+#include "tst_qgeosimplify.moc"
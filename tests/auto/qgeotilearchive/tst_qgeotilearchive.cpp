@@ -0,0 +1,271 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+
+#include <QtLocation/private/qgeotilearchive_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+#ifdef QT_LOCATION_MBTILES
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#endif
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileArchive : public QObject
+{
+    Q_OBJECT
+
+private:
+    struct Entry
+    {
+        quint64 tileId;
+        quint64 offset;
+        quint32 length;
+        quint32 runLength;
+    };
+    static QByteArray encodeDirectory(const QList<Entry> &entries);
+    QString writePMTiles();
+
+private Q_SLOTS:
+    void tileId();
+    void pmtiles();
+    void readByName();
+    void unknownFile();
+#ifdef QT_LOCATION_MBTILES
+    void mbtiles();
+#endif
+
+private:
+    QTemporaryDir m_dir;
+};
+
+static void appendVarint(QByteArray &data, quint64 value)
+{
+    while (value >= 0x80) {
+        data.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    data.append(char(value));
+}
+
+QByteArray tst_QGeoTileArchive::encodeDirectory(const QList<Entry> &entries)
+{
+    QByteArray data;
+    appendVarint(data, entries.size());
+    quint64 lastId = 0;
+    for (const Entry &entry : entries) {
+        appendVarint(data, entry.tileId - lastId);
+        lastId = entry.tileId;
+    }
+    for (const Entry &entry : entries)
+        appendVarint(data, entry.runLength);
+    for (const Entry &entry : entries)
+        appendVarint(data, entry.length);
+    for (qsizetype i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries.at(i);
+        if (i > 0 && entry.offset == entries.at(i - 1).offset + entries.at(i - 1).length)
+            appendVarint(data, 0);
+        else
+            appendVarint(data, entry.offset + 1);
+    }
+    return data;
+}
+
+/*
+    Zoom levels 0 to 2, uncompressed: tile ids 0 to 3 in the root directory,
+    the first two tiles of zoom level 1 sharing their data, and ids 5 to 11
+    in a leaf directory. Ids 4 and 6 to 9 are missing.
+*/
+QString tst_QGeoTileArchive::writePMTiles()
+{
+    const QByteArray tileData("t0t1t3t5t10");
+    const QByteArray leaf = encodeDirectory({ { 5, 6, 2, 1 }, { 10, 8, 3, 2 } });
+    const QByteArray root = encodeDirectory({ { 0, 0, 2, 1 }, { 1, 2, 2, 2 }, { 3, 4, 2, 1 },
+                                              { 5, 0, quint32(leaf.size()), 0 } });
+
+    const quint64 rootOffset = 127;
+    const quint64 leafOffset = rootOffset + root.size();
+    const quint64 tileDataOffset = leafOffset + leaf.size();
+
+    QByteArray header(127, 0);
+    uchar *h = reinterpret_cast<uchar *>(header.data());
+    memcpy(h, "PMTiles", 7);
+    h[7] = 3;
+    qToLittleEndian<quint64>(rootOffset, h + 8);
+    qToLittleEndian<quint64>(root.size(), h + 16);
+    qToLittleEndian<quint64>(leafOffset, h + 40);
+    qToLittleEndian<quint64>(leaf.size(), h + 48);
+    qToLittleEndian<quint64>(tileDataOffset, h + 56);
+    qToLittleEndian<quint64>(tileData.size(), h + 64);
+    h[96] = 1; // clustered
+    h[97] = 1; // no compression
+    h[98] = 1;
+    h[99] = 2; // png
+    h[100] = 0;
+    h[101] = 2;
+
+    const QString fileName = m_dir.filePath(QStringLiteral("tiles.pmtiles"));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return QString();
+    file.write(header + root + leaf + tileData);
+    return fileName;
+}
+
+void tst_QGeoTileArchive::tileId()
+{
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(0, 0, 0), quint64(0));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(1, 0, 0), quint64(1));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(1, 0, 1), quint64(2));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(1, 1, 1), quint64(3));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(1, 1, 0), quint64(4));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(2, 0, 0), quint64(5));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(12, 3423, 1763), quint64(19078479));
+    QCOMPARE(QGeoTilePMTilesArchive::tileId(20, 0, 0), quint64(366503875925));
+}
+
+void tst_QGeoTileArchive::pmtiles()
+{
+    const QString fileName = writePMTiles();
+    QVERIFY(!fileName.isEmpty());
+
+    std::unique_ptr<QGeoTileArchive> archive(QGeoTileArchive::create(fileName));
+    QVERIFY(archive);
+    QCOMPARE(archive->kind(), QStringLiteral("pmtiles"));
+    QCOMPARE(archive->format(), QStringLiteral("png"));
+    QCOMPARE(archive->minimumZoomLevel(), 0);
+    QCOMPARE(archive->maximumZoomLevel(), 2);
+    QVERIFY(archive->entries().isEmpty());
+
+    QCOMPARE(archive->tile(0, 0, 0), QByteArray("t0"));
+    QCOMPARE(archive->tile(1, 0, 0), QByteArray("t1"));
+    QCOMPARE(archive->tile(1, 0, 1), QByteArray("t1"));
+    QCOMPARE(archive->tile(1, 1, 1), QByteArray("t3"));
+    QVERIFY(archive->tile(1, 1, 0).isEmpty());
+    QVERIFY(!archive->contains(1, 1, 0));
+    QVERIFY(archive->contains(1, 1, 1));
+
+    // From the leaf directory, twice to go through the decoded leaves
+    for (int i = 0; i < 2; ++i) {
+        QCOMPARE(archive->tile(2, 0, 0), QByteArray("t5"));
+        QCOMPARE(archive->tile(2, 0, 3), QByteArray("t10"));
+        QCOMPARE(archive->tile(2, 1, 3), QByteArray("t10"));
+        QVERIFY(archive->tile(2, 1, 0).isEmpty());
+        QVERIFY(!archive->contains(2, 1, 2));
+    }
+
+    // Out of the archive
+    QVERIFY(!archive->contains(3, 0, 0));
+    QVERIFY(!archive->contains(2, 4, 0));
+    QVERIFY(archive->tile(-1, 0, 0).isEmpty());
+
+    // Read-only
+    QVERIFY(!archive->write(QStringLiteral("0/0/0.png"), QByteArray("new")));
+    QCOMPARE(archive->tile(0, 0, 0), QByteArray("t0"));
+}
+
+void tst_QGeoTileArchive::readByName()
+{
+    std::unique_ptr<QGeoTileArchive> archive(QGeoTileArchive::create(writePMTiles()));
+    QVERIFY(archive);
+
+    const QGeoTileSpec spec(QStringLiteral("osm"), 1, 2, 1, 3);
+    const QString name = QGeoTileArchive::tileName(spec, archive->format());
+    QCOMPARE(name, QStringLiteral("2/1/3.png"));
+    QCOMPARE(archive->read(name), QByteArray("t10"));
+    QVERIFY(archive->read(QStringLiteral("2/1.png")).isEmpty());
+    QVERIFY(archive->read(QStringLiteral("a/b/c.png")).isEmpty());
+}
+
+void tst_QGeoTileArchive::unknownFile()
+{
+    const QString fileName = m_dir.filePath(QStringLiteral("tiles.txt"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a tile archive");
+    file.close();
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Not an MBTiles or PMTiles archive"));
+    QVERIFY(!QGeoTileArchive::create(fileName));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Unable to open tile archive"));
+    QVERIFY(!QGeoTileArchive::create(m_dir.filePath(QStringLiteral("missing.pmtiles"))));
+}
+
+#ifdef QT_LOCATION_MBTILES
+void tst_QGeoTileArchive::mbtiles()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The SQLite driver is not available");
+
+    const QString fileName = m_dir.filePath(QStringLiteral("tiles.mbtiles"));
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("writer"));
+        db.setDatabaseName(fileName);
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec(QStringLiteral("CREATE TABLE metadata (name TEXT, value TEXT)")));
+        QVERIFY(query.exec(QStringLiteral("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, "
+                                          "tile_row INTEGER, tile_data BLOB)")));
+        QVERIFY(query.exec(QStringLiteral("INSERT INTO metadata VALUES ('format', 'jpeg')")));
+        QVERIFY(query.prepare(QStringLiteral("INSERT INTO tiles VALUES (?, ?, ?, ?)")));
+        // Rows numbered from the south: zoom level 2, row 0 is y 3
+        query.addBindValue(2);
+        query.addBindValue(1);
+        query.addBindValue(0);
+        query.addBindValue(QByteArray("tile"));
+        QVERIFY(query.exec());
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QStringLiteral("writer"));
+
+    std::unique_ptr<QGeoTileArchive> archive(QGeoTileArchive::create(fileName));
+    QVERIFY(archive);
+    QCOMPARE(archive->kind(), QStringLiteral("mbtiles"));
+    QCOMPARE(archive->format(), QStringLiteral("jpg"));
+    QCOMPARE(archive->minimumZoomLevel(), 2);
+    QCOMPARE(archive->maximumZoomLevel(), 2);
+    QVERIFY(archive->contains(2, 1, 3));
+    QVERIFY(!archive->contains(2, 1, 0));
+    QCOMPARE(archive->tile(2, 1, 3), QByteArray("tile"));
+
+    // From another thread, with its own connection
+    QByteArray bytes;
+    std::unique_ptr<QThread> thread(QThread::create([&]() { bytes = archive->read(QStringLiteral("2/1/3.jpg")); }));
+    thread->start();
+    QVERIFY(thread->wait());
+    QCOMPARE(bytes, QByteArray("tile"));
+}
+#endif
+
+QTEST_GUILESS_MAIN(tst_QGeoTileArchive)
+
+#include "tst_qgeotilearchive.moc"
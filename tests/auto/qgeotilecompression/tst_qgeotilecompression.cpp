@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qgeotilecompression_p.h>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoCompressedTileImage::Format)
+
+class tst_QGeoTileCompression : public QObject
+{
+    Q_OBJECT
+
+private:
+    static void addFormats();
+    static double rootMeanSquareError(const QImage &a, const QImage &b);
+
+private Q_SLOTS:
+    void flatColor_data();
+    void flatColor();
+    void gradient_data();
+    void gradient();
+    void bc1Layout();
+    void notCompressed_data();
+    void notCompressed();
+};
+
+void tst_QGeoTileCompression::addFormats()
+{
+    QTest::addColumn<QGeoCompressedTileImage::Format>("format");
+    QTest::newRow("bc1") << QGeoCompressedTileImage::BC1;
+    QTest::newRow("etc2") << QGeoCompressedTileImage::ETC2_RGB8;
+}
+
+double tst_QGeoTileCompression::rootMeanSquareError(const QImage &a, const QImage &b)
+{
+    double sum = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const QRgb p = a.pixel(x, y);
+            const QRgb q = b.pixel(x, y);
+            sum += qPow(qRed(p) - qRed(q), 2) + qPow(qGreen(p) - qGreen(q), 2)
+                    + qPow(qBlue(p) - qBlue(q), 2);
+        }
+    }
+    return qSqrt(sum / (3.0 * a.width() * a.height()));
+}
+
+void tst_QGeoTileCompression::flatColor_data()
+{
+    addFormats();
+}
+
+void tst_QGeoTileCompression::flatColor()
+{
+    QFETCH(QGeoCompressedTileImage::Format, format);
+
+    const QList<QColor> colors = { Qt::red, Qt::white, Qt::black, QColor(0xf2, 0xef, 0xe9),
+                                   QColor(0xaa, 0xd3, 0xdf) };
+    for (const QColor &color : colors) {
+        QImage image(256, 256, QImage::Format_RGB32);
+        image.fill(color);
+
+        const QGeoCompressedTileImage compressed = QGeoCompressedTileImage::compress(image, format);
+        QCOMPARE(compressed.format(), format);
+        QCOMPARE(compressed.size(), QSize(256, 256));
+        // 4 bits per pixel
+        QCOMPARE(compressed.data().size(), 256 * 256 / 2);
+
+        const QImage decoded = compressed.toImage();
+        QCOMPARE(decoded.size(), image.size());
+        QVERIFY2(rootMeanSquareError(image, decoded) < 5, qPrintable(color.name()));
+    }
+}
+
+void tst_QGeoTileCompression::gradient_data()
+{
+    addFormats();
+}
+
+void tst_QGeoTileCompression::gradient()
+{
+    QFETCH(QGeoCompressedTileImage::Format, format);
+
+    QImage image(64, 64, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x)
+            image.setPixel(x, y, qRgb(x * 4, y * 4, 255 - (x + y) * 2));
+    }
+
+    const QGeoCompressedTileImage compressed = QGeoCompressedTileImage::compress(image, format);
+    QVERIFY(!compressed.isNull());
+    QVERIFY(rootMeanSquareError(image, compressed.toImage()) < 8);
+}
+
+void tst_QGeoTileCompression::bc1Layout()
+{
+    QImage image(4, 4, QImage::Format_RGB32);
+    image.fill(Qt::red);
+
+    // Both endpoints pure red in RGB565, all the pixels on the first one
+    const QGeoCompressedTileImage compressed =
+            QGeoCompressedTileImage::compress(image, QGeoCompressedTileImage::BC1);
+    QCOMPARE(compressed.data(), QByteArray::fromHex("00f800f800000000"));
+}
+
+void tst_QGeoTileCompression::notCompressed_data()
+{
+    QTest::addColumn<QImage>("image");
+
+    QImage transparent(256, 256, QImage::Format_ARGB32_Premultiplied);
+    transparent.fill(Qt::transparent);
+    QImage oddSize(255, 255, QImage::Format_RGB32);
+    oddSize.fill(Qt::red);
+    QImage notSquare(256, 128, QImage::Format_RGB32);
+    notSquare.fill(Qt::red);
+
+    QTest::newRow("null") << QImage();
+    QTest::newRow("transparent") << transparent;
+    QTest::newRow("odd size") << oddSize;
+    QTest::newRow("not square") << notSquare;
+}
+
+void tst_QGeoTileCompression::notCompressed()
+{
+    QFETCH(QImage, image);
+
+    QVERIFY(!QGeoCompressedTileImage::canCompress(image));
+    QVERIFY(QGeoCompressedTileImage::compress(image, QGeoCompressedTileImage::BC1).isNull());
+    QVERIFY(QGeoCompressedTileImage::compress(image, QGeoCompressedTileImage::ETC2_RGB8).isNull());
+    QVERIFY(QGeoCompressedTileImage().toImage().isNull());
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileCompression)
+
+#include "tst_qgeotilecompression.moc"
@@ -32,14 +32,19 @@
 #include <QtCore/QString>
 #include <QtTest/QtTest>
 #include <QtTest/QSignalSpy>
+#include <QtCore/QTemporaryDir>
+#include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/private/qgeotiledmap_p.h>
+#include <QtLocation/private/qabstractgeotilecache_p.h>
 #include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeocameratiles_p.h>
 #include <QtLocation/private/qgeocameradata_p.h>
 #include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtLocation/private/qgeotileseedjob_p.h>
 
 QT_USE_NAMESPACE
 
@@ -71,6 +76,9 @@ private Q_SLOTS:
     void initTestCase();
     void fetchTiles();
     void fetchTiles_data();
+    void prefetchCameraTarget();
+    void fetchedTilesLoaded();
+    void seedJob();
 
 private:
     std::unique_ptr<QGeoServiceProvider> m_provider;
@@ -201,6 +209,160 @@ void tst_QGeoTiledMap::fetchTiles_data()
     QTest::newRow("zoomLevel: 4.6 ,visible count: 4 : prefetch count: 4") << 4.6 << 4 << 4 + 4  + 4 << QGeoTiledMap::PrefetchTwoNeighbourLayers << 5;
 }
 
+void tst_QGeoTiledMap::prefetchCameraTarget()
+{
+    m_map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setCameraData(camera);
+    waitForFetch(4);
+    const QSet<QGeoTileSpec> visible = m_tilesCounter->m_tiles;
+    QCOMPARE(visible.size(), 4);
+
+    // A flick towards a target four screens to the east
+    QGeoCameraData target = camera;
+    target.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.75, 0.5)));
+    QGeoCameraTiles targetTiles;
+    targetTiles.setTileSize(256);
+    targetTiles.setScreenSize(QSize(256, 256));
+    targetTiles.setCameraData(target);
+    QSet<QPair<int, int>> expected;
+    for (const QGeoTileKey &tile : targetTiles.createTiles())
+        expected.insert(qMakePair(tile.x(), tile.y()));
+
+    m_tilesCounter->m_tiles.clear();
+    m_map->prefetchCameraTarget(target, 1000);
+    waitForFetch(8);
+    const QSet<QGeoTileSpec> prefetched = m_tilesCounter->m_tiles;
+
+    QSet<QPair<int, int>> fetched;
+    for (const QGeoTileSpec &tile : prefetched) {
+        QCOMPARE(tile.zoom(), 4);
+        QVERIFY2(!visible.contains(tile), "visible tile prefetched again");
+        fetched.insert(qMakePair(tile.x(), tile.y()));
+    }
+    QVERIFY2(fetched.contains(expected), "target tiles missing from prefetched tiles");
+    // Ahead of the camera only
+    for (const auto &tile : qAsConst(fetched))
+        QVERIFY(tile.first >= 7);
+}
+
+void tst_QGeoTiledMap::fetchedTilesLoaded()
+{
+    QAbstractGeoTileCache *cache = m_map->m_engine->tileCache();
+    cache->clearAll();
+    QSignalSpy loadedSpy(cache, &QAbstractGeoTileCache::tileLoaded);
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(6);
+    QTest::qWait(10);
+    m_map->clearData();
+    m_tilesCounter->m_tiles.clear();
+    m_map->setCameraData(camera);
+    waitForFetch(4);
+    const QSet<QGeoTileSpec> fetched = m_tilesCounter->m_tiles;
+    QCOMPARE(fetched.size(), 4);
+
+    // Visible tiles are decoded in the load pool before the map gets them
+    QTRY_COMPARE(loadedSpy.count(), fetched.size());
+    QSet<QGeoTileSpec> loaded;
+    for (const QList<QVariant> &arguments : qAsConst(loadedSpy))
+        loaded.insert(arguments.at(0).value<QGeoTileSpec>());
+    QCOMPARE(loaded, fetched);
+    for (const QGeoTileSpec &spec : fetched)
+        QVERIFY(cache->getLoaded(spec));
+}
+
+void tst_QGeoTiledMap::seedJob()
+{
+    // Tiles 1-2 at zoom level 2 and 2-5 at zoom level 3, in both directions
+    const QGeoRectangle region(QWebMercator::mercatorToCoord(QDoubleVector2D(0.3, 0.3)),
+                               QWebMercator::mercatorToCoord(QDoubleVector2D(0.7, 0.7)));
+    const QGeoMapType mapType = m_map->m_engine->supportedMapTypes().first();
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString progressFile = dir.filePath(QStringLiteral("seed.progress"));
+    m_map->m_engine->tileCache()->clearAll();
+
+    std::unique_ptr<QGeoTileSeedJob> job(m_map->m_engine->createSeedJob(region, 2, 3, mapType));
+    QCOMPARE(job->tileCount(), qint64(4 + 16));
+    QCOMPARE(job->estimatedBytes(), qint64(20 * 16 * 1024));
+    job->setMaxConcurrentRequests(3);
+    job->setProgressFile(progressFile);
+
+    QSignalSpy finishedSpy(job.get(), &QGeoTileSeedJob::finished);
+    QSignalSpy progressSpy(job.get(), &QGeoTileSeedJob::progress);
+    m_tilesCounter->m_tiles.clear();
+    job->start();
+    QCOMPARE(job->state(), QGeoTileSeedJob::Running);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(job->state(), QGeoTileSeedJob::Finished);
+    QCOMPARE(job->completedTiles(), qint64(20));
+    QCOMPARE(job->failedTiles(), qint64(0));
+    QCOMPARE(progressSpy.count(), 20);
+    QCOMPARE(progressSpy.last().at(0).toLongLong(), qint64(20));
+    QVERIFY(job->downloadedBytes() > 0);
+    QCOMPARE(job->estimatedBytes(), job->downloadedBytes());
+
+    QSet<QGeoTileSpec> expected;
+    for (int x = 1; x <= 2; ++x) {
+        for (int y = 1; y <= 2; ++y)
+            expected.insert(QGeoTileSpec(QString(), mapType.mapId(), 2, x, y));
+    }
+    for (int x = 2; x <= 5; ++x) {
+        for (int y = 2; y <= 5; ++y)
+            expected.insert(QGeoTileSpec(QString(), mapType.mapId(), 3, x, y));
+    }
+    QSet<QGeoTileSpec> seeded;
+    for (const QGeoTileSpec &tile : qAsConst(m_tilesCounter->m_tiles)) {
+        if (tile.zoom() == 2 || tile.zoom() == 3)
+            seeded.insert(QGeoTileSpec(QString(), tile.mapId(), tile.zoom(), tile.x(), tile.y()));
+    }
+    QCOMPARE(seeded, expected);
+
+    // Over the same region, a new job resumes from the progress file
+    m_tilesCounter->m_tiles.clear();
+    std::unique_ptr<QGeoTileSeedJob> resumed(m_map->m_engine->createSeedJob(region, 2, 3, mapType));
+    resumed->setProgressFile(progressFile);
+    QSignalSpy resumedSpy(resumed.get(), &QGeoTileSeedJob::finished);
+    resumed->start();
+    QCOMPARE(resumedSpy.count(), 1);
+    QCOMPARE(resumed->completedTiles(), qint64(20));
+    QCOMPARE(resumed->downloadedBytes(), job->downloadedBytes());
+    QTest::qWait(50);
+    QVERIFY(m_tilesCounter->m_tiles.isEmpty());
+
+    // Without it, the tiles are found on disk and not fetched again
+    std::unique_ptr<QGeoTileSeedJob> cached(m_map->m_engine->createSeedJob(region, 2, 3, mapType));
+    QSignalSpy cachedSpy(cached.get(), &QGeoTileSeedJob::finished);
+    cached->start();
+    QTRY_COMPARE(cachedSpy.count(), 1);
+    QCOMPARE(cached->completedTiles(), qint64(20));
+    QCOMPARE(cached->downloadedBytes(), job->downloadedBytes());
+    QTest::qWait(50);
+    QVERIFY(m_tilesCounter->m_tiles.isEmpty());
+
+    // Pausing cancels the requests in flight, fetched again once restarted
+    QFile::remove(progressFile);
+    m_map->m_engine->tileCache()->clearAll();
+    std::unique_ptr<QGeoTileSeedJob> paused(m_map->m_engine->createSeedJob(region, 3, 3, mapType));
+    QSignalSpy pausedSpy(paused.get(), &QGeoTileSeedJob::finished);
+    paused->setMaxRequestsPerSecond(20);
+    paused->start();
+    paused->pause();
+    QCOMPARE(paused->state(), QGeoTileSeedJob::Paused);
+    QCOMPARE(paused->completedTiles(), qint64(0));
+    paused->start();
+    QTRY_COMPARE(pausedSpy.count(), 1);
+    QCOMPARE(paused->completedTiles(), qint64(16));
+}
+
 void tst_QGeoTiledMap::waitForFetch(int count)
 {
     int timeout = 0;
@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qgeotilefetcher_p_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileFetchQueue : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int zoom, int x, int y);
+    static QList<QGeoTileSpec> drain(QGeoTileFetchQueue &queue);
+
+private Q_SLOTS:
+    void fifoWithoutFocus();
+    void closestToFocusFirst();
+    void focusZoomFirst();
+    void wrapsAroundDateline();
+    void refocus();
+    void remove();
+};
+
+QGeoTileSpec tst_QGeoTileFetchQueue::tile(int zoom, int x, int y)
+{
+    return QGeoTileSpec(QStringLiteral("test"), 1, zoom, x, y);
+}
+
+QList<QGeoTileSpec> tst_QGeoTileFetchQueue::drain(QGeoTileFetchQueue &queue)
+{
+    QList<QGeoTileSpec> tiles;
+    while (!queue.isEmpty())
+        tiles.append(queue.takeFirst());
+    return tiles;
+}
+
+void tst_QGeoTileFetchQueue::fifoWithoutFocus()
+{
+    QGeoTileFetchQueue queue;
+    queue.enqueue(tile(3, 7, 7));
+    queue.enqueue(tile(3, 0, 0));
+    queue.enqueue(tile(5, 1, 1));
+    queue.enqueue(tile(3, 0, 0));
+
+    QCOMPARE(queue.size(), 3);
+    QCOMPARE(drain(queue), QList<QGeoTileSpec>({ tile(3, 7, 7), tile(3, 0, 0), tile(5, 1, 1) }));
+}
+
+void tst_QGeoTileFetchQueue::closestToFocusFirst()
+{
+    QGeoTileFetchQueue queue;
+    queue.setFocus(tile(4, 5, 5));
+    queue.enqueue(tile(4, 8, 5));
+    queue.enqueue(tile(4, 5, 6));
+    queue.enqueue(tile(4, 3, 3));
+    queue.enqueue(tile(4, 5, 5));
+
+    QCOMPARE(drain(queue), QList<QGeoTileSpec>({ tile(4, 5, 5), tile(4, 5, 6),
+                                                 tile(4, 3, 3), tile(4, 8, 5) }));
+}
+
+void tst_QGeoTileFetchQueue::focusZoomFirst()
+{
+    QGeoTileFetchQueue queue;
+    queue.setFocus(tile(4, 5, 5));
+    queue.enqueue(tile(3, 2, 2));
+    queue.enqueue(tile(5, 10, 10));
+    queue.enqueue(tile(4, 0, 0));
+
+    const QList<QGeoTileSpec> tiles = drain(queue);
+    QCOMPARE(tiles.size(), 3);
+    QCOMPARE(tiles.first(), tile(4, 0, 0));
+}
+
+void tst_QGeoTileFetchQueue::wrapsAroundDateline()
+{
+    QGeoTileFetchQueue queue;
+    queue.setFocus(tile(3, 0, 4));
+    queue.enqueue(tile(3, 3, 4));
+    queue.enqueue(tile(3, 7, 4));
+
+    QCOMPARE(queue.takeFirst(), tile(3, 7, 4));
+}
+
+void tst_QGeoTileFetchQueue::refocus()
+{
+    QGeoTileFetchQueue queue;
+    queue.setFocus(tile(4, 0, 0));
+    queue.enqueue(tile(4, 1, 1));
+    queue.enqueue(tile(4, 9, 9));
+
+    queue.setFocus(tile(4, 9, 8));
+    QCOMPARE(drain(queue), QList<QGeoTileSpec>({ tile(4, 9, 9), tile(4, 1, 1) }));
+}
+
+void tst_QGeoTileFetchQueue::remove()
+{
+    QGeoTileFetchQueue queue;
+    queue.setFocus(tile(6, 32, 32));
+    for (int x = 0; x < 64; ++x)
+        queue.enqueue(tile(6, x, 32));
+
+    for (int x = 0; x < 64; ++x) {
+        if (x != 5)
+            QVERIFY(queue.remove(tile(6, x, 32)));
+    }
+    QVERIFY(!queue.remove(tile(6, 0, 32)));
+    QCOMPARE(queue.size(), 1);
+
+    // A cancelled tile requested again is queued again
+    queue.enqueue(tile(6, 40, 32));
+    QCOMPARE(drain(queue), QList<QGeoTileSpec>({ tile(6, 40, 32), tile(6, 5, 32) }));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileFetchQueue)
+
+#include "tst_qgeotilefetchqueue.moc"
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qgeotilemetrics_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileMetrics : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void percentiles();
+    void emptyHistogram();
+    void disabled();
+    void reset();
+    void variantMap();
+};
+
+void tst_QGeoTileMetrics::percentiles()
+{
+    QGeoTileMetrics::Histogram histogram;
+    for (int i = 0; i < 90; ++i)
+        histogram.record(10);
+    for (int i = 0; i < 10; ++i)
+        histogram.record(1000);
+
+    QCOMPARE(histogram.count(), quint64(100));
+    // Exact up to the power of two bucket
+    const qint64 p50 = histogram.percentile(0.5);
+    QVERIFY(p50 >= 8 && p50 <= 16);
+    const qint64 p90 = histogram.percentile(0.9);
+    QVERIFY(p90 >= 8 && p90 <= 16);
+    const qint64 p99 = histogram.percentile(0.99);
+    QVERIFY(p99 >= 512 && p99 <= 1024);
+
+    // Out of range samples are clamped instead of lost
+    histogram.record(-5);
+    histogram.record(Q_INT64_C(1) << 50);
+    QCOMPARE(histogram.count(), quint64(102));
+    QVERIFY(histogram.percentile(1.0) >= 1024);
+}
+
+void tst_QGeoTileMetrics::emptyHistogram()
+{
+    QGeoTileMetrics::Histogram histogram;
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.percentile(0.5), qint64(0));
+}
+
+void tst_QGeoTileMetrics::disabled()
+{
+    QGeoTileMetrics metrics;
+    QVERIFY(!metrics.isEnabled());
+    metrics.record(QGeoTileMetrics::DecodeStage, 100);
+    metrics.increment(QGeoTileMetrics::FetchRequests);
+    QCOMPARE(metrics.histogram(QGeoTileMetrics::DecodeStage).count(), quint64(0));
+    QCOMPARE(metrics.counter(QGeoTileMetrics::FetchRequests), quint64(0));
+
+    metrics.setEnabled(true);
+    metrics.record(QGeoTileMetrics::DecodeStage, 100);
+    metrics.increment(QGeoTileMetrics::FetchRequests, 3);
+    QCOMPARE(metrics.histogram(QGeoTileMetrics::DecodeStage).count(), quint64(1));
+    QCOMPARE(metrics.counter(QGeoTileMetrics::FetchRequests), quint64(3));
+}
+
+void tst_QGeoTileMetrics::reset()
+{
+    QGeoTileMetrics metrics;
+    metrics.setEnabled(true);
+    metrics.record(QGeoTileMetrics::FetchStage, 100);
+    metrics.increment(QGeoTileMetrics::FetchErrors);
+    metrics.reset();
+
+    QVERIFY(metrics.isEnabled());
+    QCOMPARE(metrics.histogram(QGeoTileMetrics::FetchStage).count(), quint64(0));
+    QCOMPARE(metrics.counter(QGeoTileMetrics::FetchErrors), quint64(0));
+}
+
+void tst_QGeoTileMetrics::variantMap()
+{
+    QGeoTileMetrics metrics;
+    metrics.setEnabled(true);
+    for (int i = 0; i < 4; ++i)
+        metrics.record(QGeoTileMetrics::UploadStage, 300);
+    metrics.increment(QGeoTileMetrics::FetchCancels, 2);
+
+    QGeoTileMetrics::Snapshot snapshot;
+    metrics.snapshot(&snapshot);
+    snapshot.tiers[QGeoTileMetrics::DiskTier].hits = 7;
+    snapshot.requestsInFlight = 5;
+    const QVariantMap map = snapshot.toVariantMap();
+
+    QCOMPARE(map.value(QStringLiteral("enabled")).toBool(), true);
+    const QVariantMap caches = map.value(QStringLiteral("caches")).toMap();
+    QCOMPARE(caches.size(), 3);
+    QCOMPARE(caches.value(QStringLiteral("disk")).toMap().value(QStringLiteral("hits")).toLongLong(), 7);
+    const QVariantMap upload = map.value(QStringLiteral("latencies")).toMap()
+                                  .value(QStringLiteral("upload")).toMap();
+    QCOMPARE(upload.value(QStringLiteral("count")).toLongLong(), 4);
+    const qint64 p50 = upload.value(QStringLiteral("p50")).toLongLong();
+    QVERIFY(p50 >= 256 && p50 <= 512);
+    const QVariantMap requests = map.value(QStringLiteral("requests")).toMap();
+    QCOMPARE(requests.value(QStringLiteral("inFlight")).toInt(), 5);
+    QCOMPARE(requests.value(QStringLiteral("cancelled")).toLongLong(), 2);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileMetrics)
+
+#include "tst_qgeotilemetrics.moc"
@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QBuffer>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotilepackstorage_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTilePackStorage : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray tileData(int i);
+
+private Q_SLOTS:
+    void writeRead();
+    void interleavedWriteRead();
+    void overwrite();
+    void remove();
+    void clear();
+    void reopen();
+    void rebuildIndex();
+    void truncateTornRecord();
+    void compact();
+    void sync();
+    void cacheWriteBehind();
+};
+
+QByteArray tst_QGeoTilePackStorage::tileData(int i)
+{
+    return QByteArray::number(i).repeated(64 + i);
+}
+
+void tst_QGeoTilePackStorage::writeRead()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QVERIFY(storage.entries().isEmpty());
+
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(storage.write(QString("osm-1-%1-0-0.png").arg(i), tileData(i)));
+
+    QCOMPARE(storage.entries().size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(storage.read(QString("osm-1-%1-0-0.png").arg(i)), tileData(i));
+    QVERIFY(storage.read(QStringLiteral("osm-1-10-0-0.png")).isEmpty());
+    QCOMPARE(storage.wastedBytes(), 0);
+
+    // Only the pack and its index live in the directory
+    QVERIFY(!QFile::exists(dir.filePath(QStringLiteral("osm-1-0-0-0.png"))));
+    QVERIFY(QFile::exists(dir.filePath(QStringLiteral("tiles.pack"))));
+}
+
+void tst_QGeoTilePackStorage::interleavedWriteRead()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+
+    // Records past the mapped part of the pack are read from the file
+    for (int i = 0; i < 200; ++i) {
+        const QString name = QString("osm-1-%1-0-0.png").arg(i);
+        QVERIFY(storage.write(name, tileData(i)));
+        QCOMPARE(storage.read(name), tileData(i));
+        QCOMPARE(storage.read(QStringLiteral("osm-1-0-0-0.png")), tileData(0));
+    }
+
+    // A large record moves the tail over the remapping threshold
+    const QByteArray large(20 * 1024 * 1024, 'x');
+    QVERIFY(storage.write(QStringLiteral("large.png"), large));
+    QCOMPARE(storage.read(QStringLiteral("large.png")), large);
+    for (int i = 0; i < 200; ++i)
+        QCOMPARE(storage.read(QString("osm-1-%1-0-0.png").arg(i)), tileData(i));
+}
+
+void tst_QGeoTilePackStorage::overwrite()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QVERIFY(storage.write(QStringLiteral("tile.png"), tileData(1)));
+    QVERIFY(storage.write(QStringLiteral("tile.png"), tileData(2)));
+
+    QCOMPARE(storage.entries().size(), 1);
+    QCOMPARE(storage.entries().first().size, qint64(tileData(2).size()));
+    QCOMPARE(storage.read(QStringLiteral("tile.png")), tileData(2));
+    QVERIFY(storage.wastedBytes() > tileData(1).size());
+}
+
+void tst_QGeoTilePackStorage::remove()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    {
+        QGeoTilePackStorage storage;
+        QVERIFY(storage.open(dir.path()));
+        QVERIFY(storage.write(QStringLiteral("a.png"), tileData(1)));
+        QVERIFY(storage.write(QStringLiteral("b.png"), tileData(2)));
+        storage.remove(QStringLiteral("a.png"));
+        storage.remove(QStringLiteral("missing.png"));
+
+        QCOMPARE(storage.entries().size(), 1);
+        QVERIFY(storage.read(QStringLiteral("a.png")).isEmpty());
+        QCOMPARE(storage.read(QStringLiteral("b.png")), tileData(2));
+    }
+
+    // The removal is persisted
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QCOMPARE(storage.entries().size(), 1);
+    QVERIFY(storage.read(QStringLiteral("a.png")).isEmpty());
+}
+
+void tst_QGeoTilePackStorage::clear()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(storage.write(QString("tile%1.png").arg(i), tileData(i)));
+    storage.clear();
+
+    QVERIFY(storage.entries().isEmpty());
+    QCOMPARE(storage.wastedBytes(), 0);
+    QVERIFY(storage.write(QStringLiteral("tile0.png"), tileData(0)));
+    QCOMPARE(storage.read(QStringLiteral("tile0.png")), tileData(0));
+}
+
+void tst_QGeoTilePackStorage::reopen()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    {
+        QGeoTilePackStorage storage;
+        QVERIFY(storage.open(dir.path()));
+        for (int i = 0; i < 20; ++i)
+            QVERIFY(storage.write(QString("tile%1.png").arg(i), tileData(i)));
+    }
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QCOMPARE(storage.entries().size(), 20);
+    for (int i = 0; i < 20; ++i)
+        QCOMPARE(storage.read(QString("tile%1.png").arg(i)), tileData(i));
+}
+
+void tst_QGeoTilePackStorage::rebuildIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    {
+        QGeoTilePackStorage storage;
+        QVERIFY(storage.open(dir.path()));
+        for (int i = 0; i < 20; ++i)
+            QVERIFY(storage.write(QString("tile%1.png").arg(i), tileData(i)));
+        storage.remove(QStringLiteral("tile3.png"));
+    }
+
+    // Corrupt the index, the pack alone has to be enough
+    QFile index(dir.filePath(QStringLiteral("tiles.idx")));
+    QVERIFY(index.open(QIODevice::ReadWrite));
+    QVERIFY(index.seek(index.size() / 2));
+    QVERIFY(index.write("garbage") == 7);
+    index.close();
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QCOMPARE(storage.entries().size(), 19);
+    QVERIFY(storage.read(QStringLiteral("tile3.png")).isEmpty());
+    for (int i = 0; i < 20; ++i) {
+        if (i != 3)
+            QCOMPARE(storage.read(QString("tile%1.png").arg(i)), tileData(i));
+    }
+}
+
+void tst_QGeoTilePackStorage::truncateTornRecord()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    qint64 packSize = 0;
+    {
+        QGeoTilePackStorage storage;
+        QVERIFY(storage.open(dir.path()));
+        QVERIFY(storage.write(QStringLiteral("a.png"), tileData(1)));
+        QVERIFY(storage.write(QStringLiteral("b.png"), tileData(2)));
+        packSize = storage.packSize();
+    }
+
+    // Simulate a write interrupted half way
+    QFile pack(dir.filePath(QStringLiteral("tiles.pack")));
+    QVERIFY(pack.open(QIODevice::Append));
+    QVERIFY(pack.write("QGTR\x01\x00", 6) == 6);
+    pack.close();
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QCOMPARE(storage.packSize(), packSize);
+    QCOMPARE(QFileInfo(dir.filePath(QStringLiteral("tiles.pack"))).size(), packSize);
+    QCOMPARE(storage.entries().size(), 2);
+    QVERIFY(storage.write(QStringLiteral("c.png"), tileData(3)));
+    QCOMPARE(storage.read(QStringLiteral("c.png")), tileData(3));
+}
+
+void tst_QGeoTilePackStorage::compact()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    for (int i = 0; i < 50; ++i)
+        QVERIFY(storage.write(QString("tile%1.png").arg(i), tileData(i)));
+    for (int i = 0; i < 50; i += 2)
+        storage.remove(QString("tile%1.png").arg(i));
+
+    const qint64 sizeBefore = storage.packSize();
+    QVERIFY(storage.wastedBytes() > 0);
+    QVERIFY(storage.compact());
+    QCOMPARE(storage.wastedBytes(), 0);
+    QVERIFY(storage.packSize() < sizeBefore);
+
+    QCOMPARE(storage.entries().size(), 25);
+    for (int i = 1; i < 50; i += 2)
+        QCOMPARE(storage.read(QString("tile%1.png").arg(i)), tileData(i));
+
+    // Appending keeps working after the pack was replaced
+    QVERIFY(storage.write(QStringLiteral("tile0.png"), tileData(0)));
+    QCOMPARE(storage.read(QStringLiteral("tile0.png")), tileData(0));
+}
+
+void tst_QGeoTilePackStorage::sync()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QVERIFY(storage.write(QStringLiteral("tile.png"), tileData(1)));
+    QVERIFY(storage.sync());
+
+    QGeoTileFileStorage files;
+    QVERIFY(files.open(dir.path()));
+    QVERIFY(files.write(QStringLiteral("osm-1-0-0-0.png"), tileData(1)));
+    QVERIFY(files.sync());
+    QCOMPARE(files.read(QStringLiteral("osm-1-0-0-0.png")), tileData(1));
+}
+
+void tst_QGeoTilePackStorage::cacheWriteBehind()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QImage image(8, 8, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::red);
+    QByteArray png;
+    QBuffer buffer(&png);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(image.save(&buffer, "PNG"));
+
+    const QGeoTileSpec first(QStringLiteral("test"), 1, 2, 1, 1);
+    const QGeoTileSpec second(QStringLiteral("test"), 1, 2, 1, 2);
+    {
+        QGeoFileTileCache cache(dir.path());
+        QGeoTilePackStorage *storage = new QGeoTilePackStorage;
+        cache.setDiskStorage(storage);
+        cache.setDiskSyncPolicy(QGeoFileTileCache::SyncEachBatch);
+        static_cast<QAbstractGeoTileCache &>(cache).init();
+
+        // Served from the pending batch before it reaches the storage
+        cache.insert(first, png, QGeoTileFormat::Png, QAbstractGeoTileCache::DiskCache);
+        QVERIFY(storage->entries().isEmpty());
+        QVERIFY(cache.get(first));
+
+        QTRY_COMPARE(storage->entries().size(), 1);
+        QCOMPARE(storage->read(QStringLiteral("test-1-2-1-1.png")), png);
+
+        // Left in the queue, written when the cache goes away
+        cache.insert(second, png, QGeoTileFormat::Png, QAbstractGeoTileCache::DiskCache);
+    }
+
+    QGeoTilePackStorage storage;
+    QVERIFY(storage.open(dir.path()));
+    QCOMPARE(storage.entries().size(), 2);
+    QCOMPARE(storage.read(QStringLiteral("test-1-2-1-2.png")), png);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTilePackStorage)
+
+#include "tst_qgeotilepackstorage.moc"
@@ -59,6 +59,8 @@ private Q_SLOTS:
     void lessThanOperatorTest();
     void qHashTest_data();
     void qHashTest();
+    void keyTest_data();
+    void keyTest();
 };
 
 tst_QGeoTileSpec::tst_QGeoTileSpec()
@@ -312,6 +314,55 @@ void tst_QGeoTileSpec::qHashTest()
     QVERIFY(hash2 != hash3);
 }
 
+void tst_QGeoTileSpec::keyTest_data()
+{
+    populateGeoTileSpecData();
+}
+
+void tst_QGeoTileSpec::keyTest()
+{
+    QCOMPARE(QGeoTileSpec().key(), QGeoTileKey());
+
+    QFETCH(QString,plugin);
+    QFETCH(int,mapId);
+    QFETCH(int,zoom);
+    QFETCH(int,x);
+    QFETCH(int,y);
+
+    QGeoTileSpec testObj(plugin, mapId, zoom, x, y, 7);
+    QGeoTileKey key = testObj.key();
+    QCOMPARE(key.plugin(), plugin);
+    QCOMPARE(key.mapId(), mapId);
+    QCOMPARE(key.zoom(), zoom);
+    QCOMPARE(key.x(), x);
+    QCOMPARE(key.y(), y);
+    QCOMPARE(key.version(), 7);
+    QCOMPARE(QGeoTileSpec(key), testObj);
+    QCOMPARE(QGeoTileSpec(key).plugin(), plugin);
+
+    // Same plugin name, same key, whatever the string instance
+    QGeoTileSpec testObj2(QString(plugin.constData(), plugin.size()), mapId, zoom, x, y, 7);
+    QCOMPARE(testObj2.key(), key);
+    QCOMPARE(qHash(testObj2.key()), qHash(key));
+    QCOMPARE(qHash(testObj2), qHash(testObj));
+
+    QGeoTileKey key2 = key;
+    key2.setZoom(zoom + 1);
+    key2.setX(x + 1);
+    key2.setY(y - 1);
+    QCOMPARE(key2.zoom(), zoom + 1);
+    QCOMPARE(key2.x(), x + 1);
+    QCOMPARE(key2.y(), y - 1);
+    QCOMPARE(key2.mapId(), mapId);
+    QCOMPARE(key2.pluginId(), key.pluginId());
+    QVERIFY(key2 != key);
+
+    QGeoTileSpec other(plugin + QLatin1String(" other"), mapId, zoom, x, y, 7);
+    QVERIFY(other.key().pluginId() != key.pluginId());
+    QVERIFY(other.key() != key);
+    QVERIFY(other != testObj);
+}
+
 QTEST_APPLESS_MAIN(tst_QGeoTileSpec)
 
 #include "tst_qgeotilespec.moc"
@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtLocation/private/qgeotiletextureatlas_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileTextureAtlas : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QImage tileImage(int size);
+
+private Q_SLOTS:
+    void allocate();
+    void recycleSlots();
+    void pageSizes();
+    void pageGrowth();
+    void compressedPages();
+    void textureRect();
+    void collectGarbage();
+};
+
+QImage tst_QGeoTileTextureAtlas::tileImage(int size)
+{
+    QImage image(size, size, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    return image;
+}
+
+void tst_QGeoTileTextureAtlas::allocate()
+{
+    // Four 256 pixel slots per row with their 4 texel gutters
+    QGeoTileTextureAtlas atlas(1056);
+    QSet<int> indices;
+    for (int i = 0; i < 16; ++i) {
+        const QGeoTileTextureAtlas::Slot slot = atlas.allocate(tileImage(256));
+        QVERIFY(slot.isValid());
+        QCOMPARE(slot.page, 0);
+        indices.insert(slot.index);
+    }
+    QCOMPARE(indices.size(), 16);
+    QCOMPARE(atlas.page(0)->usedSlots(), 16);
+    QVERIFY(atlas.page(0)->isFull());
+    QCOMPARE(atlas.page(0)->textureSize(), QSize(1056, 1056));
+
+    // The 17th tile opens a second page
+    const QGeoTileTextureAtlas::Slot slot = atlas.allocate(tileImage(256));
+    QCOMPARE(slot.page, 1);
+    QCOMPARE(slot.index, 0);
+
+    QVERIFY(!atlas.allocate(QImage()).isValid());
+}
+
+void tst_QGeoTileTextureAtlas::recycleSlots()
+{
+    QGeoTileTextureAtlas atlas(528);
+    QList<QGeoTileTextureAtlas::Slot> slots_;
+    for (int i = 0; i < 4; ++i)
+        slots_.append(atlas.allocate(tileImage(256)));
+
+    atlas.release(slots_.at(2));
+    QCOMPARE(atlas.page(0)->usedSlots(), 3);
+    const QGeoTileTextureAtlas::Slot reused = atlas.allocate(tileImage(256));
+    QCOMPARE(reused.page, 0);
+    QCOMPARE(reused.index, slots_.at(2).index);
+    QCOMPARE(atlas.page(0)->usedSlots(), 4);
+}
+
+void tst_QGeoTileTextureAtlas::pageSizes()
+{
+    QGeoTileTextureAtlas atlas(1024);
+    const QGeoTileTextureAtlas::Slot small = atlas.allocate(tileImage(256));
+    const QGeoTileTextureAtlas::Slot large = atlas.allocate(tileImage(512));
+    QVERIFY(small.page != large.page);
+    QCOMPARE(atlas.page(small.page)->slotSize(), 256);
+    QCOMPARE(atlas.page(large.page)->slotSize(), 512);
+}
+
+void tst_QGeoTileTextureAtlas::pageGrowth()
+{
+    QGeoTileTextureAtlas atlas(1056);
+    QGeoTileTextureAtlas::Slot slot = atlas.allocate(tileImage(256));
+    QGeoTileAtlasPage *page = atlas.page(slot.page);
+    QVERIFY(page->hasMipmaps());
+    QCOMPARE(page->gutter(), 4);
+
+    // A row of four slots first, then the rows double
+    QCOMPARE(page->textureSize(), QSize(1056, 264));
+    for (int i = 1; i < 5; ++i)
+        slot = atlas.allocate(tileImage(256));
+    QCOMPARE(slot.page, 0);
+    QCOMPARE(page->textureSize(), QSize(1056, 528));
+    for (int i = 5; i < 9; ++i)
+        atlas.allocate(tileImage(256));
+    QCOMPARE(page->textureSize(), QSize(1056, 1056));
+
+    // Reused slots don't grow the page
+    atlas.release(slot);
+    atlas.allocate(tileImage(256));
+    QCOMPARE(page->textureSize(), QSize(1056, 1056));
+
+    // No room for the gutter: no mipmaps
+    QGeoTileTextureAtlas small(256);
+    QGeoTileAtlasPage *smallPage = small.page(small.allocate(tileImage(256)).page);
+    QVERIFY(!smallPage->hasMipmaps());
+    QCOMPARE(smallPage->textureSize(), QSize(256, 256));
+}
+
+void tst_QGeoTileTextureAtlas::compressedPages()
+{
+    QGeoTileTextureAtlas atlas(1024);
+    const QGeoCompressedTileImage etc2 =
+            QGeoCompressedTileImage::compress(tileImage(256), QGeoCompressedTileImage::ETC2_RGB8);
+    const QGeoCompressedTileImage bc1 =
+            QGeoCompressedTileImage::compress(tileImage(256), QGeoCompressedTileImage::BC1);
+    QVERIFY(!etc2.isNull());
+    QVERIFY(!bc1.isNull());
+
+    // One page per format, images and compressed tiles never share one
+    const QGeoTileTextureAtlas::Slot image = atlas.allocate(tileImage(256));
+    const QGeoTileTextureAtlas::Slot first = atlas.allocate(etc2);
+    const QGeoTileTextureAtlas::Slot second = atlas.allocate(etc2);
+    const QGeoTileTextureAtlas::Slot other = atlas.allocate(bc1);
+    QCOMPARE(first.page, second.page);
+    QVERIFY(first.index != second.index);
+    QVERIFY(first.page != image.page);
+    QVERIFY(other.page != image.page && other.page != first.page);
+    QCOMPARE(atlas.page(image.page)->compression(), QGeoCompressedTileImage::NoCompression);
+    QCOMPARE(atlas.page(first.page)->compression(), QGeoCompressedTileImage::ETC2_RGB8);
+    QCOMPARE(atlas.page(other.page)->compression(), QGeoCompressedTileImage::BC1);
+    QVERIFY(!atlas.page(first.page)->hasAlphaChannel());
+    QVERIFY(!atlas.page(first.page)->hasMipmaps());
+    QCOMPARE(atlas.page(first.page)->gutter(), 0);
+
+    QVERIFY(!atlas.allocate(QGeoCompressedTileImage()).isValid());
+}
+
+void tst_QGeoTileTextureAtlas::textureRect()
+{
+    QGeoTileTextureAtlas atlas(1056);
+    atlas.allocate(tileImage(256));
+    const QGeoTileTextureAtlas::Slot slot = atlas.allocate(tileImage(256));
+    QGeoTileAtlasPage *page = atlas.page(slot.page);
+    QCOMPARE(page->textureSize(), QSize(1056, 264));
+
+    // Second slot of the first row, past the gutters: the gutters repeat the
+    // edges, no inset needed
+    const QRectF full = page->textureRect(slot.index, QRectF(0, 0, 1, 1));
+    QCOMPARE(full.left(), 268.0 / 1056);
+    QCOMPARE(full.top(), 4.0 / 264);
+    QCOMPARE(full.right(), 524.0 / 1056);
+    QCOMPARE(full.bottom(), 260.0 / 264);
+
+    // Bottom right quarter, as used when overzooming, is not scaled
+    const QRectF quarter = page->textureRect(slot.index, QRectF(0.5, 0.5, 0.5, 0.5));
+    QCOMPARE(quarter.left(), 396.0 / 1056);
+    QCOMPARE(quarter.top(), 132.0 / 264);
+    QCOMPARE(quarter.width(), 128.0 / 1056);
+
+    // Compressed pages have no gutter, the rect is clamped to the texel
+    // centers at the border of the slot
+    const QGeoCompressedTileImage etc2 =
+            QGeoCompressedTileImage::compress(tileImage(256), QGeoCompressedTileImage::ETC2_RGB8);
+    atlas.allocate(etc2);
+    const QGeoTileTextureAtlas::Slot compressed = atlas.allocate(etc2);
+    QGeoTileAtlasPage *compressedPage = atlas.page(compressed.page);
+    QCOMPARE(compressedPage->textureSize(), QSize(1024, 256));
+    const QRectF clamped = compressedPage->textureRect(compressed.index, QRectF(0.5, 0.5, 0.5, 0.5));
+    QCOMPARE(clamped.left(), 384.0 / 1024);
+    QCOMPARE(clamped.top(), 128.0 / 256);
+    QCOMPARE(clamped.right(), 511.5 / 1024);
+    QCOMPARE(clamped.bottom(), 255.5 / 256);
+}
+
+void tst_QGeoTileTextureAtlas::collectGarbage()
+{
+    QGeoTileTextureAtlas atlas(256);
+    const QGeoTileTextureAtlas::Slot first = atlas.allocate(tileImage(256));
+    const QGeoTileTextureAtlas::Slot second = atlas.allocate(tileImage(256));
+    const QGeoTileTextureAtlas::Slot third = atlas.allocate(tileImage(256));
+    QCOMPARE(third.page, 2);
+
+    atlas.release(first);
+    atlas.release(second);
+    atlas.collectGarbage();
+    // The first page is kept even if empty
+    QVERIFY(atlas.page(0));
+    QVERIFY(!atlas.page(1));
+    QVERIFY(atlas.page(2));
+
+    // Freed page indices are reused
+    QCOMPARE(atlas.allocate(tileImage(256)).page, 0);
+    QCOMPARE(atlas.allocate(tileImage(256)).page, 1);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileTextureAtlas)
+
+#include "tst_qgeotiletextureatlas.moc"
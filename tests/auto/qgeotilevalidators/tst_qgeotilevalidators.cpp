@@ -0,0 +1,388 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QBuffer>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+
+#include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotiledmappingmanagerengine_p.h>
+#include <QtLocation/private/qgeotiledmapreply_p.h>
+#include <QtLocation/private/qgeotilefetcher_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtLocation/private/qgeotilevalidators_p.h>
+
+QT_USE_NAMESPACE
+
+// Answers each request with the next queued response, holding it until there is one
+class TileServer : public QTcpServer
+{
+public:
+    TileServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, &TileServer::acceptConnections);
+    }
+
+    void respond(const QByteArray &response)
+    {
+        m_responses.enqueue(response);
+        flush();
+    }
+
+    // Lower case header names
+    QList<QHash<QByteArray, QByteArray>> requests;
+
+private:
+    void acceptConnections()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readRequest(socket); });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+    void readRequest(QTcpSocket *socket)
+    {
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        const int end = buffer.indexOf("\r\n\r\n");
+        if (end < 0)
+            return;
+
+        QHash<QByteArray, QByteArray> headers;
+        const QList<QByteArray> lines = buffer.left(end).split('\n');
+        for (qsizetype i = 1; i < lines.size(); ++i) {
+            const int colon = lines.at(i).indexOf(':');
+            if (colon > 0)
+                headers.insert(lines.at(i).left(colon).trimmed().toLower(), lines.at(i).mid(colon + 1).trimmed());
+        }
+        requests.append(headers);
+        buffer.remove(0, end + 4);
+
+        m_waiting.enqueue(socket);
+        flush();
+    }
+
+    void flush()
+    {
+        while (!m_waiting.isEmpty() && !m_responses.isEmpty()) {
+            QPointer<QTcpSocket> socket = m_waiting.dequeue();
+            if (socket)
+                socket->write(m_responses.dequeue());
+        }
+    }
+
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QQueue<QPointer<QTcpSocket>> m_waiting;
+    QQueue<QByteArray> m_responses;
+};
+
+class TileReplyTest : public QGeoTiledMapReply
+{
+    Q_OBJECT
+public:
+    TileReplyTest(QNetworkReply *reply, const QGeoTileSpec &spec, QObject *parent)
+        : QGeoTiledMapReply(spec, parent)
+    {
+        setMapImageFormat(QStringLiteral("png"));
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+            reply->deleteLater();
+            if (reply->error() != QNetworkReply::NoError) {
+                setError(QGeoTiledMapReply::CommunicationError, reply->errorString());
+                return;
+            }
+            setValidators(QGeoTileValidators::fromHeaders(reply->rawHeader("ETag"),
+                                                          reply->rawHeader("Last-Modified"),
+                                                          reply->rawHeader("Cache-Control"),
+                                                          reply->rawHeader("Expires")));
+            if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+                setNotModified(true);
+            else
+                setMapImageData(reply->readAll());
+            setFinished(true);
+        });
+        connect(this, &QGeoTiledMapReply::aborted, reply, &QNetworkReply::abort);
+    }
+};
+
+// Sends the validators of stale tiles like the network plugins do
+class TileFetcherTest : public QGeoTileFetcher
+{
+    Q_OBJECT
+public:
+    TileFetcherTest(const QUrl &baseUrl, QGeoMappingManagerEngine *parent)
+        : QGeoTileFetcher(parent), m_baseUrl(baseUrl), m_networkManager(new QNetworkAccessManager(this))
+    {
+    }
+
+private:
+    QGeoTiledMapReply *getTileImage(const QGeoTileSpec &spec) override
+    {
+        QNetworkRequest request(m_baseUrl.resolved(
+                QUrl(QStringLiteral("%1/%2/%3.png").arg(spec.zoom()).arg(spec.x()).arg(spec.y()))));
+        const QGeoTileValidators validators = tileValidators(spec);
+        if (!validators.etag.isEmpty())
+            request.setRawHeader("If-None-Match", validators.etag);
+        if (!validators.lastModified.isEmpty())
+            request.setRawHeader("If-Modified-Since", validators.lastModified);
+        return new TileReplyTest(m_networkManager->get(request), spec, this);
+    }
+
+    QUrl m_baseUrl;
+    QNetworkAccessManager *m_networkManager;
+};
+
+class TileCacheTest : public QGeoFileTileCache
+{
+public:
+    using QGeoFileTileCache::QGeoFileTileCache;
+
+    // Only tiles read from disk are checked for freshness
+    void dropFromMemory(const QGeoTileSpec &spec)
+    {
+        textureCache_.remove(spec);
+        memoryCache_.remove(spec);
+    }
+};
+
+class TiledEngineTest : public QGeoTiledMappingManagerEngine
+{
+    Q_OBJECT
+public:
+    TiledEngineTest(const QUrl &baseUrl, const QString &cacheDirectory)
+    {
+        QGeoCameraCapabilities capabilities;
+        capabilities.setMinimumZoomLevel(0.0);
+        capabilities.setMaximumZoomLevel(20.0);
+        setCameraCapabilities(capabilities);
+        setTileSize(QSize(256, 256));
+        m_cache = new TileCacheTest(cacheDirectory);
+        setTileCache(m_cache);
+        setTileFetcher(new TileFetcherTest(baseUrl, this));
+    }
+
+    TileCacheTest *m_cache;
+};
+
+class tst_QGeoTileValidators : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void maxAge();
+    void noCache();
+    void expires();
+    void invalidExpires();
+    void noLifetime();
+    void dataStream();
+    void revalidation();
+
+private:
+    static QByteArray tileData(Qt::GlobalColor color);
+    static QByteArray response(const QByteArray &status, const QByteArray &etag,
+                               const QByteArray &body = QByteArray());
+};
+
+static const QDateTime received(QDate(2022, 5, 1), QTime(12, 0), Qt::UTC);
+
+void tst_QGeoTileValidators::maxAge()
+{
+    const QGeoTileValidators validators = QGeoTileValidators::fromHeaders(
+                "\"abc\"", "Sat, 30 Apr 2022 10:00:00 GMT", "public, max-age=3600",
+                "Sun, 01 May 2022 20:00:00 GMT", received);
+    QCOMPARE(validators.etag, QByteArray("\"abc\""));
+    QCOMPARE(validators.lastModified, QByteArray("Sat, 30 Apr 2022 10:00:00 GMT"));
+    // max-age wins over Expires
+    QCOMPARE(validators.expires, received.addSecs(3600));
+    QVERIFY(validators.canRevalidate());
+    QVERIFY(!validators.isStale(received.addSecs(3599)));
+    QVERIFY(validators.isStale(received.addSecs(3600)));
+}
+
+void tst_QGeoTileValidators::noCache()
+{
+    const QGeoTileValidators validators = QGeoTileValidators::fromHeaders(
+                "W/\"abc\"", QByteArray(), "max-age=3600, No-Cache", QByteArray(), received);
+    QCOMPARE(validators.expires, received);
+    QVERIFY(validators.isStale(received));
+}
+
+void tst_QGeoTileValidators::expires()
+{
+    const QGeoTileValidators validators = QGeoTileValidators::fromHeaders(
+                QByteArray(), "Sat, 30 Apr 2022 10:00:00 GMT", QByteArray(),
+                "Sun, 01 May 2022 20:00:00 GMT", received);
+    QCOMPARE(validators.expires, received.addSecs(8 * 3600));
+}
+
+void tst_QGeoTileValidators::invalidExpires()
+{
+    const QGeoTileValidators validators = QGeoTileValidators::fromHeaders(
+                QByteArray(), QByteArray(), QByteArray(), "0", received);
+    QVERIFY(validators.isStale(received));
+    QVERIFY(!validators.canRevalidate());
+}
+
+void tst_QGeoTileValidators::noLifetime()
+{
+    const QGeoTileValidators validators = QGeoTileValidators::fromHeaders(
+                "\"abc\"", QByteArray(), QByteArray(), QByteArray(), received);
+    QVERIFY(!validators.expires.isValid());
+    QVERIFY(!validators.isStale(received.addYears(10)));
+    QVERIFY(!validators.isNull());
+    QVERIFY(QGeoTileValidators().isNull());
+}
+
+void tst_QGeoTileValidators::dataStream()
+{
+    const QGeoTileValidators validators = QGeoTileValidators::fromHeaders(
+                "\"abc\"", "Sat, 30 Apr 2022 10:00:00 GMT", "max-age=60", QByteArray(), received);
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << validators;
+    }
+    QGeoTileValidators restored;
+    QDataStream in(data);
+    in >> restored;
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(restored.etag, validators.etag);
+    QCOMPARE(restored.lastModified, validators.lastModified);
+    QCOMPARE(restored.expires, validators.expires);
+}
+
+QByteArray tst_QGeoTileValidators::tileData(Qt::GlobalColor color)
+{
+    QImage image(8, 8, QImage::Format_ARGB32);
+    image.fill(color);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return png;
+}
+
+QByteArray tst_QGeoTileValidators::response(const QByteArray &status, const QByteArray &etag,
+                                            const QByteArray &body)
+{
+    return "HTTP/1.1 " + status + "\r\n"
+           "ETag: " + etag + "\r\n"
+           "Last-Modified: Sat, 30 Apr 2022 10:00:00 GMT\r\n"
+           "Cache-Control: max-age=3600\r\n"
+           "Content-Type: image/png\r\n"
+           "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+           "\r\n" + body;
+}
+
+void tst_QGeoTileValidators::revalidation()
+{
+    TileServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TiledEngineTest engine(QUrl(QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort())), dir.path());
+    TileCacheTest *cache = engine.m_cache;
+
+    const QGeoTileSpec spec(QStringLiteral("test"), 0, 3, 2, 1);
+    const QByteArray red = tileData(Qt::red);
+    const QByteArray blue = tileData(Qt::blue);
+    cache->insert(spec, red, QGeoTileFormat::Png, QAbstractGeoTileCache::DiskCache);
+    cache->setTileValidators(spec, QGeoTileValidators::fromHeaders(
+            "\"v1\"", "Sat, 30 Apr 2022 10:00:00 GMT", "max-age=3600", QByteArray(),
+            QDateTime::currentDateTimeUtc()));
+    QCOMPARE(cache->diskTileSize(spec), qint64(red.size()));
+
+    QSignalSpy staleSpy(cache, &QAbstractGeoTileCache::tileStale);
+    QSignalSpy loadedSpy(cache, &QAbstractGeoTileCache::tileLoaded);
+    QSignalSpy notModifiedSpy(engine.tileFetcher(), &QGeoTileFetcher::tileNotModified);
+    QSignalSpy finishedSpy(engine.tileFetcher(), &QGeoTileFetcher::tileFinished);
+    QSignalSpy updatedSpy(&engine, &QGeoTiledMappingManagerEngine::tileUpdated);
+
+    // Expired, shown while a conditional request is sent
+    cache->expireMapId(spec.mapId());
+    QCOMPARE(cache->diskTileSize(spec), qint64(-1));
+    QVERIFY(cache->loadAsync(spec));
+    QCOMPARE(staleSpy.count(), 1);
+    QTRY_COMPARE(loadedSpy.count(), 1);
+    QCOMPARE(QColor(cache->getLoaded(spec)->image.pixel(0, 0)), QColor(Qt::red));
+    QTRY_COMPARE(server.requests.size(), 1);
+    QCOMPARE(server.requests.at(0).value("if-none-match"), QByteArray("\"v1\""));
+    QCOMPARE(server.requests.at(0).value("if-modified-since"), QByteArray("Sat, 30 Apr 2022 10:00:00 GMT"));
+
+    // Not modified: the bytes are kept and fresh again
+    server.respond(response("304 Not Modified", "\"v1\""));
+    QTRY_COMPARE(notModifiedSpy.count(), 1);
+    QTRY_COMPARE(cache->diskTileSize(spec), qint64(red.size()));
+    QCOMPARE(finishedSpy.count(), 0);
+    QCOMPARE(updatedSpy.count(), 0);
+    cache->dropFromMemory(spec);
+    QVERIFY(cache->loadAsync(spec));
+    QTRY_COMPARE(loadedSpy.count(), 2);
+    QCOMPARE(staleSpy.count(), 1);
+    QCOMPARE(QColor(cache->getLoaded(spec)->image.pixel(0, 0)), QColor(Qt::red));
+
+    // Modified: the new bytes replace the old ones and the maps are told
+    cache->expireMapId(spec.mapId());
+    cache->dropFromMemory(spec);
+    QVERIFY(cache->loadAsync(spec));
+    QCOMPARE(staleSpy.count(), 2);
+    QTRY_COMPARE(loadedSpy.count(), 3);
+    QTRY_COMPARE(server.requests.size(), 2);
+    QCOMPARE(server.requests.at(1).value("if-none-match"), QByteArray("\"v1\""));
+    server.respond(response("200 OK", "\"v2\"", blue));
+    QTRY_COMPARE(updatedSpy.count(), 1);
+    QCOMPARE(updatedSpy.first().at(0).value<QGeoTileSpec>(), spec);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(notModifiedSpy.count(), 1);
+    QCOMPARE(cache->diskTileSize(spec), qint64(blue.size()));
+    QVERIFY(!cache->getLoaded(spec));
+    QVERIFY(cache->loadAsync(spec));
+    QTRY_COMPARE(loadedSpy.count(), 4);
+    QCOMPARE(QColor(cache->getLoaded(spec)->image.pixel(0, 0)), QColor(Qt::blue));
+
+    // The next refresh sends the new validators
+    cache->expireMapId(spec.mapId());
+    cache->dropFromMemory(spec);
+    QVERIFY(cache->loadAsync(spec));
+    QTRY_COMPARE(server.requests.size(), 3);
+    QCOMPARE(server.requests.at(2).value("if-none-match"), QByteArray("\"v2\""));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileValidators)
+
+#include "tst_qgeotilevalidators.moc"
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2023 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+#include <QtLocation/private/qdeclarativerectanglemapitem_p.h>
+
+#include "qmaplibreglstylechange_p.h"
+
+#include <memory>
+#include <vector>
+
+QT_USE_NAMESPACE
+
+using Items = QList<QDeclarativeGeoMapItemBase *>;
+
+class tst_QMaplibreGLItemPool : public QObject
+{
+    Q_OBJECT
+
+private:
+    QDeclarativeGeoMapItemBase *rectangle(qreal z = 0);
+    QDeclarativeGeoMapItemBase *polyline(qreal z = 0);
+
+private Q_SLOTS:
+    void cleanup();
+    void insert();
+    void changeZ();
+    void removeMerges();
+    void splitFullGroup();
+
+private:
+    std::vector<std::unique_ptr<QDeclarativeGeoMapItemBase>> m_items;
+};
+
+QDeclarativeGeoMapItemBase *tst_QMaplibreGLItemPool::rectangle(qreal z)
+{
+    QDeclarativeRectangleMapItem *item = new QDeclarativeRectangleMapItem;
+    item->setTopLeft(QGeoCoordinate(10, 10));
+    item->setBottomRight(QGeoCoordinate(0, 20));
+    item->setZ(z);
+    m_items.emplace_back(item);
+    return item;
+}
+
+QDeclarativeGeoMapItemBase *tst_QMaplibreGLItemPool::polyline(qreal z)
+{
+    QDeclarativePolylineMapItem *item = new QDeclarativePolylineMapItem;
+    item->setPath(QList<QGeoCoordinate>{ QGeoCoordinate(10, 10), QGeoCoordinate(0, 20) });
+    item->setZ(z);
+    m_items.emplace_back(item);
+    return item;
+}
+
+void tst_QMaplibreGLItemPool::cleanup()
+{
+    m_items.clear();
+}
+
+void tst_QMaplibreGLItemPool::insert()
+{
+    QMaplibreGLItemPool pool;
+    QDeclarativeGeoMapItemBase *r0 = rectangle();
+    QDeclarativeGeoMapItemBase *r1 = rectangle();
+    QDeclarativeGeoMapItemBase *l0 = polyline();
+    QDeclarativeGeoMapItemBase *r2 = rectangle();
+    QDeclarativeGeoMapItemBase *r3 = rectangle(-1);
+    for (QDeclarativeGeoMapItemBase *item : { r0, r1, l0, r2, r3 })
+        pool.insert(item);
+
+    // Runs of the same kind and z, in drawing order
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r3 }, { r0, r1 }, { l0 }, { r2 } }));
+
+    // A source and a layer per group
+    QCOMPARE(pool.takeChanges(QString()).size(), 8);
+    QVERIFY(pool.takeChanges(QString()).isEmpty());
+
+    // Only the group of the changed item is sent again
+    pool.updateGeometry(r1);
+    pool.updateGeometry(r0);
+    QCOMPARE(pool.takeChanges(QString()).size(), 1);
+    pool.updateProperties(l0);
+    QCOMPARE(pool.takeChanges(QString()).size(), 1);
+}
+
+void tst_QMaplibreGLItemPool::changeZ()
+{
+    QMaplibreGLItemPool pool;
+    QDeclarativeGeoMapItemBase *r0 = rectangle();
+    QDeclarativeGeoMapItemBase *r1 = rectangle();
+    QDeclarativeGeoMapItemBase *r2 = rectangle();
+    QDeclarativeGeoMapItemBase *l0 = polyline();
+    for (QDeclarativeGeoMapItemBase *item : { r0, r1, r2, l0 })
+        pool.insert(item);
+    pool.takeChanges(QString());
+
+    // Out of the middle of its group, which is split around it
+    r1->setZ(2);
+    pool.updateProperties(r1);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r0, r2 }, { l0 }, { r1 } }));
+
+    // Back in the middle of a group, splitting it
+    r1->setZ(0);
+    pool.updateProperties(r1);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r0, r1, r2 }, { l0 } }));
+
+    l0->setZ(-1);
+    pool.updateProperties(l0);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { l0 }, { r0, r1, r2 } }));
+
+    // The items are found in their new groups
+    pool.takeChanges(QString());
+    pool.updateGeometry(r1);
+    QCOMPARE(pool.takeChanges(QString()).size(), 1);
+}
+
+void tst_QMaplibreGLItemPool::removeMerges()
+{
+    QMaplibreGLItemPool pool;
+    QDeclarativeGeoMapItemBase *r0 = rectangle();
+    QDeclarativeGeoMapItemBase *l0 = polyline();
+    QDeclarativeGeoMapItemBase *r1 = rectangle();
+    QDeclarativeGeoMapItemBase *l1 = polyline();
+    QDeclarativeGeoMapItemBase *r2 = rectangle();
+    for (QDeclarativeGeoMapItemBase *item : { r0, l0, r1, l1, r2 })
+        pool.insert(item);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r0 }, { l0 }, { r1 }, { l1 }, { r2 } }));
+    QCOMPARE(pool.takeChanges(QString()).size(), 10);
+
+    // The groups below and above the emptied one become one run
+    pool.remove(l1);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r0 }, { l0 }, { r1, r2 } }));
+    // Removed: the layers and sources of the emptied and of the merged group,
+    // sent again: the source of the merged one
+    QCOMPARE(pool.takeChanges(QString()).size(), 5);
+
+    pool.remove(l0);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r0, r1, r2 } }));
+    pool.remove(r1);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ { r0, r2 } }));
+
+    pool.takeChanges(QString());
+    pool.updateGeometry(r2);
+    QCOMPARE(pool.takeChanges(QString()).size(), 1);
+    pool.remove(r0);
+    pool.remove(r2);
+    QVERIFY(pool.groupItems().isEmpty());
+    // Removed: the layer and source of the last group
+    QCOMPARE(pool.takeChanges(QString()).size(), 2);
+}
+
+void tst_QMaplibreGLItemPool::splitFullGroup()
+{
+    QMaplibreGLItemPool pool;
+    Items items;
+    for (int i = 0; i < 64; ++i) {
+        items.append(rectangle());
+        pool.insert(items.last());
+    }
+    QCOMPARE(pool.groupItems(), QList<Items>{ items });
+
+    // The 65th item splits the group in halves
+    items.append(rectangle());
+    pool.insert(items.last());
+    QCOMPARE(pool.groupItems(), (QList<Items>{ items.mid(0, 32), items.mid(32) }));
+
+    // Each half re-sent on its own
+    pool.takeChanges(QString());
+    pool.updateGeometry(items.first());
+    QCOMPARE(pool.takeChanges(QString()).size(), 1);
+    pool.updateGeometry(items.last());
+    QCOMPARE(pool.takeChanges(QString()).size(), 1);
+
+    // Too many for one group together again
+    pool.remove(items.at(10));
+    items.removeAt(10);
+    QCOMPARE(pool.groupItems(), (QList<Items>{ items.mid(0, 31), items.mid(31) }));
+
+    // Raised items go to a group of their own
+    for (int i = 0; i < 3; ++i) {
+        items.at(i)->setZ(1);
+        pool.updateProperties(items.at(i));
+    }
+    QCOMPARE(pool.groupItems(), (QList<Items>{ items.mid(3, 28), items.mid(31), items.mid(0, 3) }));
+}
+
+QTEST_MAIN(tst_QMaplibreGLItemPool)
+
+#include "tst_qmaplibreglitempool.moc"
@@ -0,0 +1,512 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QAbstractEventDispatcher>
+#include <QtCore/QBuffer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTimer>
+#include <QtCore/qmath.h>
+#include <QtGui/QImage>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtTest/QtTest>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeocameratiles_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeomaptype_p.h>
+#include <QtLocation/private/qgeotiledmap_p.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+// Counts the allocations made through operator new: QObjects, hash tables,
+// shared pointers and the like. Containers backed by QArrayData allocate
+// with malloc() and are not counted.
+static std::atomic<quint64> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        std::abort();
+    return p;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+QT_USE_NAMESPACE
+
+/* A minimal HTTP/1.1 server, the tile server fixture. It answers every
+ * GET of a .png with the same tile, after the given latency */
+class TileServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit TileServer(QObject *parent = nullptr)
+        : QTcpServer(parent)
+    {
+        QImage image(256, 256, QImage::Format_RGB32);
+        image.fill(QColor(0xe8, 0xe0, 0xd0));
+        QBuffer buffer(&m_tile);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+    }
+
+    void setLatency(int msecs) { m_latency = msecs; }
+    void resetRequestCount() { m_requests = 0; }
+    int requestCount() const { return m_requests; }
+    QString urlPrefix() const { return QStringLiteral("http://127.0.0.1:%1/").arg(serverPort()); }
+
+protected:
+    void incomingConnection(qintptr handle) override
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(handle);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+
+private:
+    void readRequests(QTcpSocket *socket)
+    {
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+
+        qsizetype end;
+        while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+            const QList<QByteArray> requestLine = buffer.left(buffer.indexOf("\r\n")).split(' ');
+            buffer.remove(0, end + 4);
+
+            QByteArray response;
+            if (requestLine.size() >= 2 && requestLine.at(0) == "GET"
+                    && requestLine.at(1).endsWith(".png")) {
+                ++m_requests;
+                response = "HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nContent-Length: "
+                        + QByteArray::number(m_tile.size()) + "\r\n\r\n" + m_tile;
+            } else {
+                response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            }
+            // Same latency for all, so pipelined responses stay in order
+            QTimer::singleShot(m_latency, socket, [socket, response]() { socket->write(response); });
+        }
+    }
+
+    QByteArray m_tile;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    int m_latency = 0;
+    int m_requests = 0;
+};
+
+/* Time the GUI thread spends working, as opposed to blocked waiting for
+ * events, measured between the awake() and aboutToBlock() signals of the
+ * event dispatcher */
+class BusyClock : public QObject
+{
+public:
+    BusyClock()
+    {
+        m_clock.start();
+        QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+        connect(dispatcher, &QAbstractEventDispatcher::awake, this, [this]() {
+            m_busySince = m_clock.nsecsElapsed();
+        });
+        connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, [this]() {
+            if (m_busySince >= 0)
+                m_busy += m_clock.nsecsElapsed() - m_busySince;
+            m_busySince = -1;
+        });
+    }
+
+    qint64 nsecsElapsed() const { return m_clock.nsecsElapsed(); }
+
+    qint64 takeBusy()
+    {
+        const qint64 busy = m_busy;
+        m_busy = 0;
+        return busy;
+    }
+
+    // Runs the event loop until the deadline, in nanoseconds on this clock
+    void waitUntil(qint64 deadline)
+    {
+        const int remaining = int((deadline - m_clock.nsecsElapsed()) / 1000000);
+        if (remaining <= 0) {
+            QCoreApplication::processEvents();
+            return;
+        }
+        QEventLoop loop;
+        QTimer::singleShot(remaining, Qt::PreciseTimer, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+private:
+    QElapsedTimer m_clock;
+    qint64 m_busySince = -1;
+    qint64 m_busy = 0;
+};
+
+/*
+    Drives a tiled map through scripted camera paths against a local tile
+    server, at 60 frames per second, without rendering.
+
+    Each row reports the time until the viewport is fully textured once the
+    camera stopped as its benchmark result. The frame time percentiles, the
+    allocations, the cache hit ratios and the tile metrics go into a JSON
+    document, written to the file named by QT_LOCATION_BENCHMARK_RESULTS, or
+    printed. The cost of QGeoCameraTiles::createTiles() is a regular
+    QBENCHMARK, see the -csv and -xml options of the test for its output.
+*/
+class tst_bench_QGeoTiledMap : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum CameraPath {
+        Pan,
+        Zoom,
+        TiltRotate,
+        Fly
+    };
+    Q_ENUM(CameraPath)
+
+    enum CacheState {
+        Cold,
+        WarmDisk,
+        WarmMemory
+    };
+    Q_ENUM(CacheState)
+
+private:
+    struct Run
+    {
+        QList<qint64> frameTimes; // microseconds
+        quint64 allocations = 0;
+        qint64 timeToFullViewport = -1; // milliseconds
+    };
+
+    static QGeoCameraData cameraAt(CameraPath path, double t);
+    std::unique_ptr<QGeoServiceProvider> createProvider(const QString &cacheDirectory);
+    static QGeoTiledMap *createMap(QGeoServiceProvider *provider);
+    static Run runPath(QGeoTiledMap *map, CameraPath path);
+    static QJsonObject hitRatios(const QVariantMap &before, const QVariantMap &after);
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void cameraPath_data();
+    void cameraPath();
+    void createTiles_data();
+    void createTiles();
+
+private:
+    static constexpr int FrameCount = 120;
+    static constexpr qint64 FrameInterval = 16666667; // nanoseconds
+    static constexpr qint64 ViewportTimeout = Q_INT64_C(10000000000);
+
+    TileServer m_server;
+    QJsonArray m_results;
+};
+
+QGeoCameraData tst_bench_QGeoTiledMap::cameraAt(CameraPath path, double t)
+{
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(59.91, 10.75));
+    camera.setZoomLevel(12.0);
+
+    switch (path) {
+    case Pan:
+        camera.setCenter(QGeoCoordinate(59.91, 10.75 + 0.6 * t));
+        break;
+    case Zoom:
+        camera.setZoomLevel(8.0 + 6.0 * t);
+        break;
+    case TiltRotate:
+        camera.setTilt(60.0 * t);
+        camera.setBearing(90.0 * t);
+        break;
+    case Fly:
+        // Zooming out and back in on the way to a point a degree away
+        camera.setCenter(QGeoCoordinate(59.91 - 0.5 * t, 10.75 + 1.0 * t));
+        camera.setZoomLevel(12.0 - 3.0 * std::sin(M_PI * t));
+        break;
+    }
+    return camera;
+}
+
+std::unique_ptr<QGeoServiceProvider> tst_bench_QGeoTiledMap::createProvider(const QString &cacheDirectory)
+{
+    QVariantMap parameters;
+    parameters[QStringLiteral("osm.mapping.custom.host")] = m_server.urlPrefix();
+    parameters[QStringLiteral("osm.mapping.providersrepository.disabled")] = true;
+    parameters[QStringLiteral("osm.mapping.cache.directory")] = cacheDirectory;
+    return std::make_unique<QGeoServiceProvider>(QStringLiteral("osm"), parameters);
+}
+
+QGeoTiledMap *tst_bench_QGeoTiledMap::createMap(QGeoServiceProvider *provider)
+{
+    QGeoMappingManager *mappingManager = provider->mappingManager();
+    if (!mappingManager || !mappingManager->isInitialized())
+        return nullptr;
+
+    QGeoTiledMap *map = qobject_cast<QGeoTiledMap *>(mappingManager->createMap(nullptr));
+    if (!map)
+        return nullptr;
+    map->setViewportSize(QSize(1024, 768));
+    const QList<QGeoMapType> mapTypes = mappingManager->supportedMapTypes();
+    for (const QGeoMapType &mapType : mapTypes) {
+        if (mapType.style() == QGeoMapType::CustomMap)
+            map->setActiveMapType(mapType);
+    }
+    return map;
+}
+
+tst_bench_QGeoTiledMap::Run tst_bench_QGeoTiledMap::runPath(QGeoTiledMap *map, CameraPath path)
+{
+    Run run;
+    BusyClock clock;
+
+    const quint64 allocations = allocationCount.load(std::memory_order_relaxed);
+    for (int frame = 0; frame <= FrameCount; ++frame) {
+        const qint64 frameStart = clock.nsecsElapsed();
+        clock.takeBusy();
+        map->setCameraData(cameraAt(path, double(frame) / FrameCount));
+        const qint64 cameraTime = clock.nsecsElapsed() - frameStart;
+        clock.waitUntil(frameStart + FrameInterval);
+        run.frameTimes.append((cameraTime + clock.takeBusy()) / 1000);
+    }
+    run.allocations = allocationCount.load(std::memory_order_relaxed) - allocations;
+
+    const qint64 stopped = clock.nsecsElapsed();
+    while (map->pendingVisibleTiles() > 0 && clock.nsecsElapsed() - stopped < ViewportTimeout)
+        clock.waitUntil(clock.nsecsElapsed() + FrameInterval);
+    if (!map->pendingVisibleTiles())
+        run.timeToFullViewport = (clock.nsecsElapsed() - stopped) / 1000000;
+    return run;
+}
+
+// Hits over lookups of each cache tier, between two metrics() snapshots
+QJsonObject tst_bench_QGeoTiledMap::hitRatios(const QVariantMap &before, const QVariantMap &after)
+{
+    const QVariantMap cachesBefore = before.value(QStringLiteral("caches")).toMap();
+    const QVariantMap cachesAfter = after.value(QStringLiteral("caches")).toMap();
+    QJsonObject ratios;
+    for (auto it = cachesAfter.cbegin(); it != cachesAfter.cend(); ++it) {
+        const QVariantMap tierBefore = cachesBefore.value(it.key()).toMap();
+        const QVariantMap tierAfter = it.value().toMap();
+        const qint64 hits = tierAfter.value(QStringLiteral("hits")).toLongLong()
+                - tierBefore.value(QStringLiteral("hits")).toLongLong();
+        const qint64 misses = tierAfter.value(QStringLiteral("misses")).toLongLong()
+                - tierBefore.value(QStringLiteral("misses")).toLongLong();
+        ratios.insert(it.key(), hits + misses ? double(hits) / double(hits + misses) : -1.0);
+    }
+    return ratios;
+}
+
+void tst_bench_QGeoTiledMap::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install plugins
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+    QVERIFY(m_server.listen(QHostAddress::LocalHost));
+}
+
+void tst_bench_QGeoTiledMap::cleanupTestCase()
+{
+    const QByteArray json = QJsonDocument(m_results).toJson(QJsonDocument::Indented);
+    const QString fileName = qEnvironmentVariable("QT_LOCATION_BENCHMARK_RESULTS");
+    if (fileName.isEmpty()) {
+        qInfo().noquote() << json;
+        return;
+    }
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(file.errorString()));
+    file.write(json);
+}
+
+void tst_bench_QGeoTiledMap::cameraPath_data()
+{
+    QTest::addColumn<CameraPath>("path");
+    QTest::addColumn<CacheState>("cache");
+    QTest::addColumn<int>("latency");
+
+    const QMetaEnum paths = QMetaEnum::fromType<CameraPath>();
+    for (int i = 0; i < paths.keyCount(); ++i) {
+        const CameraPath path = CameraPath(paths.value(i));
+        QTest::addRow("%s-cold", paths.key(i)) << path << Cold << 0;
+        QTest::addRow("%s-cold-50ms", paths.key(i)) << path << Cold << 50;
+        QTest::addRow("%s-disk", paths.key(i)) << path << WarmDisk << 0;
+        QTest::addRow("%s-memory", paths.key(i)) << path << WarmMemory << 0;
+    }
+}
+
+void tst_bench_QGeoTiledMap::cameraPath()
+{
+    QFETCH(CameraPath, path);
+    QFETCH(CacheState, cache);
+    QFETCH(int, latency);
+
+    QTemporaryDir cacheDirectory;
+    QVERIFY(cacheDirectory.isValid());
+    m_server.setLatency(latency);
+
+    std::unique_ptr<QGeoServiceProvider> provider = createProvider(cacheDirectory.path());
+    std::unique_ptr<QGeoTiledMap> map(createMap(provider.get()));
+    QVERIFY2(map, qPrintable(provider->errorString()));
+
+    if (cache != Cold) {
+        QVERIFY(runPath(map.get(), path).timeToFullViewport >= 0);
+        if (cache == WarmDisk) {
+            // Only the disk cache survives the plugin
+            map.reset();
+            provider = createProvider(cacheDirectory.path());
+            map.reset(createMap(provider.get()));
+            QVERIFY(map);
+        }
+    }
+
+    map->setMetricsEnabled(true);
+    m_server.resetRequestCount();
+    const QVariantMap before = map->metrics();
+    const Run run = runPath(map.get(), path);
+    const QVariantMap after = map->metrics();
+    map->setMetricsEnabled(false);
+    QVERIFY2(run.timeToFullViewport >= 0, "The viewport was not complete in time");
+
+    QList<qint64> frameTimes = run.frameTimes;
+    std::sort(frameTimes.begin(), frameTimes.end());
+    const auto percentile = [&frameTimes](double p) {
+        return frameTimes.at(qMin(frameTimes.size() - 1, qsizetype(p * frameTimes.size())));
+    };
+    QJsonObject frameTime;
+    frameTime.insert(QStringLiteral("p50"), percentile(0.50));
+    frameTime.insert(QStringLiteral("p90"), percentile(0.90));
+    frameTime.insert(QStringLiteral("p99"), percentile(0.99));
+    frameTime.insert(QStringLiteral("max"), frameTimes.last());
+
+    QJsonObject result;
+    result.insert(QStringLiteral("test"), QLatin1String(QTest::currentDataTag()));
+    result.insert(QStringLiteral("path"), QLatin1String(QMetaEnum::fromType<CameraPath>().valueToKey(path)));
+    result.insert(QStringLiteral("cache"), QLatin1String(QMetaEnum::fromType<CacheState>().valueToKey(cache)));
+    result.insert(QStringLiteral("latency"), latency);
+    result.insert(QStringLiteral("frames"), frameTimes.size());
+    result.insert(QStringLiteral("frameTime"), frameTime);
+    result.insert(QStringLiteral("timeToFullViewport"), run.timeToFullViewport);
+    result.insert(QStringLiteral("allocationsPerFrame"), double(run.allocations) / frameTimes.size());
+    result.insert(QStringLiteral("serverRequests"), m_server.requestCount());
+    result.insert(QStringLiteral("hitRatio"), hitRatios(before, after));
+    result.insert(QStringLiteral("metrics"), QJsonObject::fromVariantMap(after));
+    m_results.append(result);
+
+    QTest::setBenchmarkResult(run.timeToFullViewport, QTest::WalltimeMilliseconds);
+}
+
+void tst_bench_QGeoTiledMap::createTiles_data()
+{
+    QTest::addColumn<double>("zoomLevel");
+    QTest::addColumn<double>("tilt");
+    QTest::addColumn<QSize>("screenSize");
+
+    QTest::newRow("z4") << 4.0 << 0.0 << QSize(1024, 768);
+    QTest::newRow("z12") << 12.0 << 0.0 << QSize(1024, 768);
+    QTest::newRow("z12-tilt45") << 12.0 << 45.0 << QSize(1024, 768);
+    QTest::newRow("z12-tilt80") << 12.0 << 80.0 << QSize(1024, 768);
+    QTest::newRow("z16-4k") << 16.0 << 0.0 << QSize(3840, 2160);
+    QTest::newRow("z16-4k-tilt80") << 16.0 << 80.0 << QSize(3840, 2160);
+}
+
+void tst_bench_QGeoTiledMap::createTiles()
+{
+    QFETCH(double, zoomLevel);
+    QFETCH(double, tilt);
+    QFETCH(QSize, screenSize);
+
+    QGeoCameraTiles cameraTiles;
+    cameraTiles.setMapType(QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("street"),
+                                       QStringLiteral("street"), false, false, 1,
+                                       QByteArrayLiteral("bench"), QGeoCameraCapabilities()));
+    cameraTiles.setTileSize(256);
+    cameraTiles.setScreenSize(screenSize);
+
+    // Alternating between two cameras, so that each call does the whole work
+    QGeoCameraData cameras[2];
+    for (int i = 0; i < 2; ++i) {
+        cameras[i].setCenter(QGeoCoordinate(59.91, 10.75 + 0.001 * i));
+        cameras[i].setZoomLevel(zoomLevel);
+        cameras[i].setTilt(tilt);
+        cameras[i].setBearing(30.0);
+    }
+
+    int i = 0;
+    QBENCHMARK {
+        cameraTiles.setCameraData(cameras[i ^= 1]);
+        QVERIFY(!cameraTiles.createTiles().isEmpty());
+    }
+}
+
+QTEST_MAIN(tst_bench_QGeoTiledMap)
+
+#include "tst_bench_qgeotiledmap.moc"